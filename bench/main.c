@@ -0,0 +1,1815 @@
+/*
+    Copyright (c) 2023 BB-301 <fw3dg3@gmail.com>
+
+    Permission is hereby granted, free of charge, to any person
+    obtaining a copy of this software and associated documentation
+    files (the “Software”), to deal in the Software without restriction,
+    including without limitation the rights to use, copy, modify, merge,
+    publish, distribute, sublicense, and/or sell copies of the Software,
+    and to permit persons to whom the Software is furnished to do so,
+    subject to the following conditions:
+
+    The above copyright notice and this permission notice shall be included
+    in all copies or substantial portions of the Software.
+
+    THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+    THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+    OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+    THE SOFTWARE.
+*/
+
+// NOTE: This file is not a unit test. It contains a few simple benchmarks that
+// can be used to compare the library's methods against each other (or against
+// their previous implementations, which are reproduced here, using the public API,
+// under the "LEGACY IMPLEMENTATIONS" section). Usage:
+//
+//      ./build/bench [benchmark_name|all] [max_size_in_bytes]
+//
+// For meaningful numbers, the library should be built with optimizations enabled
+// (e.g., `make clean bench OPTIMIZATION_LEVEL=-O2`).
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <ctype.h>
+#include <time.h>
+
+#include "fancy_string.h"
+
+#define BIG_TEXT_FILE_PATH "./test/assets/big-text-file.txt"
+#define DEFAULT_MAX_SIZE ((size_t)64 * 1024 * 1024)
+#define MIN_SIZE ((size_t)1024 * 1024)
+#define LEGACY_MAX_SIZE ((size_t)8 * 1024 * 1024)
+#define SHORT_SEARCH_WORK_SIZE ((size_t)16 * 1024 * 1024)
+#define MULTI_REPLACE_MIN_SIZE ((size_t)64 * 1024)
+#define MULTI_REPLACE_LEGACY_MAX_SIZE ((size_t)64 * 1024)
+#define MULTI_REPLACE_N_TOKENS 5000
+#define REPLACE_MIN_SIZE ((size_t)16 * 1024)
+#define REPLACE_LEGACY_MAX_SIZE ((size_t)256 * 1024)
+#define SPLIT_LINE_MIN_SIZE ((size_t)64 * 1024)
+#define SPLIT_LINE_LEGACY_MAX_SIZE ((size_t)1024 * 1024)
+#define SPLIT_ANY_REGEX_MAX_SIZE ((size_t)256 * 1024)
+#define CASE_N_HEADER_KEYS 100000
+#define TRIM_PAD_N_STRINGS 100000
+#define REPEAT_LEGACY_MAX_SIZE ((size_t)4 * 1024 * 1024)
+#define PATTERN_N_PATTERNS 200
+#define PATTERN_MIN_SIZE ((size_t)4 * 1024)
+#define PATTERN_MAX_SIZE ((size_t)256 * 1024)
+#define PATTERN_LEGACY_MAX_SIZE ((size_t)4 * 1024)
+#define PREFILTER_MIN_SIZE ((size_t)64 * 1024)
+#define DFA_MIN_SIZE ((size_t)4 * 1024)
+#define DFA_LEGACY_MAX_SIZE ((size_t)16 * 1024)
+#define STREAM_MIN_SIZE ((size_t)64 * 1024)
+
+typedef void (*benchmark_t)(size_t max_size);
+
+typedef struct benchmark_entry_s
+{
+    char const *name;
+    benchmark_t fn;
+} benchmark_entry_t;
+
+void bench_from_stream(size_t max_size);
+void bench_next_line(size_t max_size);
+void bench_split(size_t max_size);
+void bench_array_walk(size_t max_size);
+void bench_parse(size_t max_size);
+void bench_array_get(size_t max_size);
+void bench_search(size_t max_size);
+void bench_short_search(size_t max_size);
+void bench_multi_replace(size_t max_size);
+void bench_replace(size_t max_size);
+void bench_split_line(size_t max_size);
+void bench_split_iter(size_t max_size);
+void bench_split_any(size_t max_size);
+void bench_case(size_t max_size);
+void bench_trim_pad_repeat(size_t max_size);
+void bench_pattern(size_t max_size);
+void bench_prefilter(size_t max_size);
+void bench_dfa(size_t max_size);
+void bench_stream(size_t max_size);
+
+static benchmark_entry_t benchmarks[] = {
+    {"from_stream", bench_from_stream},
+    {"next_line", bench_next_line},
+    {"split", bench_split},
+    {"array_walk", bench_array_walk},
+    {"parse", bench_parse},
+    {"array_get", bench_array_get},
+    {"search", bench_search},
+    {"short_search", bench_short_search},
+    {"multi_replace", bench_multi_replace},
+    {"replace", bench_replace},
+    {"split_line", bench_split_line},
+    {"split_iter", bench_split_iter},
+    {"split_any", bench_split_any},
+    {"case", bench_case},
+    {"trim_pad_repeat", bench_trim_pad_repeat},
+    {"pattern", bench_pattern},
+    {"prefilter", bench_prefilter},
+    {"dfa", bench_dfa},
+    {"stream", bench_stream},
+};
+
+// -----------------------------------------------
+//                    HELPERS
+// -----------------------------------------------
+
+// NOTE: With glibc, the executable can interpose `malloc` and friends (the
+// original implementations remain available through their `__libc_` aliases),
+// which is used here to count the heap allocations made during a benchmark.
+#if defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t n, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+static size_t n_allocations = 0;
+
+void *malloc(size_t size)
+{
+    n_allocations++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t n, size_t size)
+{
+    n_allocations++;
+    return __libc_calloc(n, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    if (ptr == NULL)
+    {
+        n_allocations++;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+static size_t allocation_count(void)
+{
+    return n_allocations;
+}
+#else
+static size_t allocation_count(void)
+{
+    return 0;
+}
+#endif
+
+static double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_row(char const *label, size_t size, double seconds)
+{
+    double mib = (double)size / (1024.0 * 1024.0);
+    fprintf(
+        stdout, "\t%-28s %12zu bytes %10.3f ms %10.1f MiB/s %8.3f ns/byte\n",
+        label, size, seconds * 1e3, mib / seconds, seconds * 1e9 / (double)size);
+}
+
+static void print_allocations(char const *label, size_t n_allocations, size_t n_items, char const *item_name)
+{
+    fprintf(
+        stdout, "\t%-28s %12zu allocations %10zu %-10s %8.2f allocations/%s\n",
+        label, n_allocations, n_items, item_name, (double)n_allocations / (double)n_items, item_name);
+}
+
+static fancy_string_t *load_big_text_file(void)
+{
+    FILE *file_pointer = fopen(BIG_TEXT_FILE_PATH, "r");
+    if (file_pointer == NULL)
+    {
+        perror("fopen on " BIG_TEXT_FILE_PATH " failed (benchmarks should be run from the project's root directory)");
+        exit(EXIT_FAILURE);
+    }
+    return fancy_string_from_stream(file_pointer);
+}
+
+// NOTE: Grows `stream` (a temporary file) by repeating `content` until
+// it contains exactly `size` bytes.
+static void fill_stream(FILE *stream, size_t *current_size, fancy_string_t const *content, size_t size)
+{
+    char *value = fancy_string_value(content);
+    size_t n = fancy_string_size(content);
+    fseek(stream, 0, SEEK_END);
+    while (*current_size < size)
+    {
+        size_t n_write = size - *current_size < n ? size - *current_size : n;
+        if (fwrite(value, sizeof(char), n_write, stream) != n_write)
+        {
+            perror("fwrite on temporary file failed");
+            exit(EXIT_FAILURE);
+        }
+        *current_size += n_write;
+    }
+    fflush(stream);
+    free(value);
+}
+
+// -----------------------------------------------
+//             LEGACY IMPLEMENTATIONS
+// -----------------------------------------------
+
+static fancy_string_t *legacy_from_stream_without_closing(FILE *stream)
+{
+    fancy_string_t *s = fancy_string_create_empty();
+    char tmp[2] = {'\0', '\0'};
+    int c;
+    flockfile(stream);
+    while ((c = getc_unlocked(stream)) != EOF)
+    {
+        tmp[0] = (char)c;
+        fancy_string_append_value(s, tmp);
+    }
+    funlockfile(stream);
+    return s;
+}
+
+static ssize_t legacy_last_index_of(char const *haystack, size_t n, char const *value, size_t n_value)
+{
+    // NOTE: A straightforward scalar version (i.e., `memrchr` on the first byte, then
+    // `memcmp`), used as a reference for `fancy_string_last_index_of_value_n`.
+    if (n_value == 0 || n_value > n)
+    {
+        return -1;
+    }
+    size_t n_candidates = n - n_value + 1;
+    char const *p;
+    while ((p = memrchr(haystack, value[0], n_candidates)) != NULL)
+    {
+        if (memcmp(p, value, n_value) == 0)
+        {
+            return (ssize_t)(p - haystack);
+        }
+        n_candidates = (size_t)(p - haystack);
+    }
+    return -1;
+}
+
+static void legacy_replace_value(fancy_string_t *const self, char const *const old_value, char const *const new_value)
+{
+    // NOTE: The previous implementation, which rebuilds (and copies) the whole string for each
+    // occurrence, such that replacing `k` occurrences in an `n`-byte string is O(n * k).
+    fancy_string_t *tmp = fancy_string_clone(self);
+    size_t n_old_value = strlen(old_value);
+    size_t index_offset = 0;
+    while (true)
+    {
+        ssize_t index = fancy_string_index_of_value(tmp, old_value);
+        if (index == -1)
+        {
+            break;
+        }
+        fancy_string_t *prefix = fancy_string_substring(self, 0, index + (ssize_t)index_offset);
+        fancy_string_t *suffix = fancy_string_substring(self, index + (ssize_t)index_offset + (ssize_t)n_old_value, -1);
+        fancy_string_append_value(prefix, new_value);
+        index_offset = fancy_string_size(prefix);
+        fancy_string_append(prefix, suffix);
+        fancy_string_update(self, prefix);
+        fancy_string_destroy(prefix);
+        fancy_string_destroy(tmp);
+        tmp = suffix;
+    }
+    fancy_string_destroy(tmp);
+}
+
+static fancy_string_array_t *legacy_split_by_value(fancy_string_t const *const self, char const *const separator)
+{
+    // NOTE: The previous implementation, which copies everything after each separator into
+    // a new remainder, such that splitting into `k` components is O(n * k).
+    fancy_string_array_t *array = fancy_string_array_create();
+    fancy_string_t *remainder = fancy_string_clone(self);
+    while (true)
+    {
+        ssize_t index = fancy_string_index_of_value(remainder, separator);
+        if (index == -1)
+        {
+            fancy_string_array_push(array, remainder);
+            fancy_string_destroy(remainder);
+            break;
+        }
+        fancy_string_t *substring = fancy_string_substring(remainder, 0, index);
+        fancy_string_array_push(array, substring);
+        fancy_string_destroy(substring);
+        fancy_string_t *new_remainder = fancy_string_substring(remainder, index + (ssize_t)strlen(separator), -1);
+        fancy_string_destroy(remainder);
+        remainder = new_remainder;
+    }
+    return array;
+}
+
+static void legacy_lowercase(fancy_string_t *const self)
+{
+    // NOTE: The previous implementation, which converts the value into a temporary buffer
+    // (one `tolower` call per byte), and then copies that buffer back into the string.
+    size_t n = fancy_string_size(self);
+    if (n == 0)
+    {
+        return;
+    }
+    char const *value = fancy_string_view(self).value;
+    char *new_value = malloc(n + 1);
+    for (size_t i = 0; i < n; i++)
+    {
+        new_value[i] = (char)tolower((unsigned char)value[i]);
+    }
+    new_value[n] = '\0';
+    fancy_string_update_value_n(self, new_value, n);
+    free(new_value);
+}
+
+static fancy_string_t *legacy_create_repeat(char const *const value, size_t n_repeat)
+{
+    // NOTE: The previous implementation, which appends a clone of the value `n_repeat` times.
+    fancy_string_t *self = fancy_string_create(value);
+    fancy_string_t *clone = fancy_string_clone(self);
+    for (size_t i = 0; i < n_repeat; i++)
+    {
+        fancy_string_append(self, clone);
+    }
+    fancy_string_destroy(clone);
+    return self;
+}
+
+static void legacy_trim(fancy_string_t *const self)
+{
+    // NOTE: The previous implementation, which copies what is left after trimming each side into
+    // a substring, and then copies that substring back into the string.
+    char const *value = fancy_string_view(self).value;
+    size_t n = fancy_string_size(self);
+    size_t i = 0;
+    while (i < n && isspace((unsigned char)value[i]))
+    {
+        i++;
+    }
+    if (i != 0)
+    {
+        fancy_string_t *substring = fancy_string_substring(self, (ssize_t)i, -1);
+        fancy_string_update(self, substring);
+        fancy_string_destroy(substring);
+    }
+    value = fancy_string_view(self).value;
+    n = fancy_string_size(self);
+    size_t j = n;
+    while (j > 0 && isspace((unsigned char)value[j - 1]))
+    {
+        j--;
+    }
+    if (j != n)
+    {
+        fancy_string_t *substring = fancy_string_substring(self, 0, (ssize_t)j);
+        fancy_string_update(self, substring);
+        fancy_string_destroy(substring);
+    }
+}
+
+static void legacy_pad_start(fancy_string_t *const self, size_t target_size, char value)
+{
+    // NOTE: The previous implementation, which builds the padding with (the previous)
+    // `fancy_string_create_repeat`, and then prepends it.
+    size_t n = fancy_string_size(self);
+    if (n >= target_size)
+    {
+        return;
+    }
+    char *tmp_value = malloc(2);
+    tmp_value[0] = value;
+    tmp_value[1] = '\0';
+    fancy_string_t *tmp = legacy_create_repeat(tmp_value, target_size - n - 1);
+    free(tmp_value);
+    fancy_string_prepend(self, tmp);
+    fancy_string_destroy(tmp);
+}
+
+static fancy_string_t *legacy_from_stream_next_line(FILE *stream)
+{
+    char *line = NULL;
+    size_t line_size = 0;
+    ssize_t size = getline(&line, &line_size, stream);
+    if (size == -1)
+    {
+        free(line);
+        return NULL;
+    }
+    fancy_string_t *s = fancy_string_create(line);
+    free(line);
+    fancy_string_replace_value(s, "\n", "", -1);
+    return s;
+}
+
+// -----------------------------------------------
+//                   BENCHMARKS
+// -----------------------------------------------
+
+void bench_from_stream(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    FILE *stream = tmpfile();
+    if (stream == NULL)
+    {
+        perror("tmpfile failed");
+        exit(EXIT_FAILURE);
+    }
+    size_t current_size = 0;
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 2)
+    {
+        fill_stream(stream, &current_size, content, size);
+
+        rewind(stream);
+        double start = now();
+        fancy_string_t *s = fancy_string_from_stream_without_closing(stream);
+        double elapsed = now() - start;
+        assert(fancy_string_size(s) == size);
+        fancy_string_destroy(s);
+        print_row("fancy_string_from_stream", size, elapsed);
+
+        if (size <= LEGACY_MAX_SIZE)
+        {
+            rewind(stream);
+            start = now();
+            s = legacy_from_stream_without_closing(stream);
+            elapsed = now() - start;
+            assert(fancy_string_size(s) == size);
+            fancy_string_destroy(s);
+            print_row("legacy (per-byte append)", size, elapsed);
+        }
+    }
+    fclose(stream);
+    fancy_string_destroy(content);
+}
+
+void bench_next_line(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    FILE *stream = tmpfile();
+    if (stream == NULL)
+    {
+        perror("tmpfile failed");
+        exit(EXIT_FAILURE);
+    }
+    size_t current_size = 0;
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 2)
+    {
+        fill_stream(stream, &current_size, content, size);
+
+        rewind(stream);
+        double start = now();
+        size_t n_lines = 0;
+        fancy_string_t *line;
+        while ((line = fancy_string_from_stream_next_line(stream)) != NULL)
+        {
+            n_lines += 1;
+            fancy_string_destroy(line);
+        }
+        double elapsed = now() - start;
+        print_row("from_stream_next_line", size, elapsed);
+
+        rewind(stream);
+        start = now();
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        line = fancy_string_create_empty();
+        size_t n_reader_lines = 0;
+        while (fancy_string_line_reader_next(reader, line))
+        {
+            n_reader_lines += 1;
+        }
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        elapsed = now() - start;
+        assert(n_reader_lines == n_lines);
+        print_row("line_reader_next", size, elapsed);
+
+        rewind(stream);
+        start = now();
+        reader = fancy_string_line_reader_create(stream);
+        char const *value;
+        size_t n;
+        n_reader_lines = 0;
+        while (fancy_string_line_reader_next_borrowed(reader, &value, &n))
+        {
+            n_reader_lines += 1;
+        }
+        fancy_string_line_reader_destroy(reader);
+        elapsed = now() - start;
+        assert(n_reader_lines == n_lines);
+        print_row("line_reader_next_borrowed", size, elapsed);
+
+        if (size <= LEGACY_MAX_SIZE)
+        {
+            rewind(stream);
+            start = now();
+            while ((line = legacy_from_stream_next_line(stream)) != NULL)
+            {
+                fancy_string_destroy(line);
+            }
+            elapsed = now() - start;
+            print_row("legacy (getline + replace)", size, elapsed);
+        }
+    }
+    fclose(stream);
+    fancy_string_destroy(content);
+}
+
+void bench_split(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    FILE *stream = tmpfile();
+    if (stream == NULL)
+    {
+        perror("tmpfile failed");
+        exit(EXIT_FAILURE);
+    }
+    size_t current_size = 0;
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 2)
+    {
+        fill_stream(stream, &current_size, content, size);
+
+        // NOTE: The lines are loaded up front so that only the splitting is measured.
+        rewind(stream);
+        size_t n_lines = 0;
+        size_t lines_capacity = 1024;
+        fancy_string_t **lines = malloc(sizeof(fancy_string_t *) * lines_capacity);
+        fancy_string_t *line;
+        while ((line = fancy_string_from_stream_next_line(stream)) != NULL)
+        {
+            if (n_lines == lines_capacity)
+            {
+                lines_capacity *= 2;
+                lines = realloc(lines, sizeof(fancy_string_t *) * lines_capacity);
+            }
+            lines[n_lines++] = line;
+        }
+
+        size_t n_tokens = 0;
+        size_t n_allocations_before = allocation_count();
+        double start = now();
+        for (size_t i = 0; i < n_lines; i++)
+        {
+            fancy_string_array_t *tokens = fancy_string_split_by_value(lines[i], " ", -1);
+            n_tokens += fancy_string_array_size(tokens);
+            fancy_string_array_destroy(tokens);
+        }
+        double elapsed = now() - start;
+        print_row("split_by_value (words)", size, elapsed);
+        print_allocations("split_by_value (words)", allocation_count() - n_allocations_before, n_tokens, "token");
+
+        for (size_t i = 0; i < n_lines; i++)
+        {
+            fancy_string_destroy(lines[i]);
+        }
+        free(lines);
+    }
+    fclose(stream);
+    fancy_string_destroy(content);
+}
+
+static void count_strings_starting_with_t(fancy_string_t *const string, size_t index, fancy_string_array_t const *const array, void *context)
+{
+    (void)index;
+    (void)array;
+    if (fancy_string_starts_with_value(string, "t"))
+    {
+        *(size_t *)context += 1;
+    }
+}
+
+static void array_walk(fancy_string_t *const *values, size_t n_values, size_t size, char const *label)
+{
+    char push_label[64];
+    char for_each_label[64];
+    char destroy_label[64];
+    snprintf(push_label, sizeof(push_label), "array_push (%s)", label);
+    snprintf(for_each_label, sizeof(for_each_label), "array_for_each (%s)", label);
+    snprintf(destroy_label, sizeof(destroy_label), "array_destroy (%s)", label);
+
+    // NOTE: `size` is the total number of characters that get copied into the array.
+    size_t n_allocations_before = allocation_count();
+    double start = now();
+    fancy_string_array_t *array = fancy_string_array_create();
+    size_t n_strings = 0;
+    size_t n_copied = 0;
+    while (n_copied < size)
+    {
+        fancy_string_t *value = values[n_strings % n_values];
+        fancy_string_array_push(array, value);
+        n_copied += fancy_string_size(value);
+        n_strings++;
+    }
+    double elapsed = now() - start;
+    print_row(push_label, n_copied, elapsed);
+    print_allocations(push_label, allocation_count() - n_allocations_before, n_strings, "string");
+
+    start = now();
+    size_t n_matches = 0;
+    for (size_t i = 0; i < 10; i++)
+    {
+        fancy_string_array_for_each(array, count_strings_starting_with_t, &n_matches);
+    }
+    elapsed = (now() - start) / 10.0;
+    print_row(for_each_label, n_copied, elapsed);
+
+    start = now();
+    fancy_string_array_destroy(array);
+    elapsed = now() - start;
+    print_row(destroy_label, n_copied, elapsed);
+}
+
+static fancy_string_t **split_into_values(fancy_string_t const *content, char const *separator, size_t *n_values)
+{
+    fancy_string_array_t *array = fancy_string_split_by_value(content, separator, -1);
+    *n_values = fancy_string_array_size(array);
+    fancy_string_t **values = malloc(sizeof(fancy_string_t *) * *n_values);
+    for (size_t i = 0; i < *n_values; i++)
+    {
+        values[i] = fancy_string_array_get(array, i);
+    }
+    fancy_string_array_destroy(array);
+    return values;
+}
+
+static void destroy_values(fancy_string_t **values, size_t n_values)
+{
+    for (size_t i = 0; i < n_values; i++)
+    {
+        fancy_string_destroy(values[i]);
+    }
+    free(values);
+}
+
+void bench_array_walk(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    size_t n_words;
+    fancy_string_t **words = split_into_values(content, " ", &n_words);
+    size_t n_lines;
+    fancy_string_t **lines = split_into_values(content, "\n", &n_lines);
+
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 2)
+    {
+        array_walk(words, n_words, size, "words");
+        array_walk(lines, n_lines, size, "lines");
+    }
+
+    destroy_values(words, n_words);
+    destroy_values(lines, n_lines);
+    fancy_string_destroy(content);
+}
+
+void bench_parse(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    FILE *stream = tmpfile();
+    if (stream == NULL)
+    {
+        perror("tmpfile failed");
+        exit(EXIT_FAILURE);
+    }
+    fancy_string_view_t prefix = fancy_string_view_from_value("The");
+    size_t current_size = 0;
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 2)
+    {
+        fill_stream(stream, &current_size, content, size);
+
+        // NOTE: Both passes take the first word of each (trimmed) line, and count
+        // the lines whose first word starts with "The".
+        rewind(stream);
+        size_t n_lines = 0;
+        size_t n_matches = 0;
+        size_t n_allocations_before = allocation_count();
+        double start = now();
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_t *line = fancy_string_create_empty();
+        while (fancy_string_line_reader_next(reader, line))
+        {
+            n_lines += 1;
+            fancy_string_t *trimmed = fancy_string_trimmed(line);
+            fancy_string_t *word = fancy_string_substring(trimmed, -1, fancy_string_index_of_value(trimmed, " "));
+            n_matches += fancy_string_starts_with_value(word, "The");
+            fancy_string_destroy(word);
+            fancy_string_destroy(trimmed);
+        }
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        double elapsed = now() - start;
+        print_row("trimmed + substring", size, elapsed);
+        print_allocations("trimmed + substring", allocation_count() - n_allocations_before, n_lines, "line");
+
+        rewind(stream);
+        size_t n_view_lines = 0;
+        size_t n_view_matches = 0;
+        n_allocations_before = allocation_count();
+        start = now();
+        reader = fancy_string_line_reader_create(stream);
+        fancy_string_view_t view;
+        while (fancy_string_line_reader_next_view(reader, &view))
+        {
+            n_view_lines += 1;
+            fancy_string_view_t trimmed = fancy_string_view_trimmed(view);
+            fancy_string_view_t word = fancy_string_view_substring(trimmed, -1, fancy_string_view_index_of(trimmed, fancy_string_view_from_value(" ")));
+            n_view_matches += fancy_string_view_starts_with(word, prefix);
+        }
+        fancy_string_line_reader_destroy(reader);
+        elapsed = now() - start;
+        assert(n_view_lines == n_lines);
+        assert(n_view_matches == n_matches);
+        print_row("trimmed_view + view_substring", size, elapsed);
+        print_allocations("trimmed_view + view_substring", allocation_count() - n_allocations_before, n_view_lines, "line");
+    }
+    fclose(stream);
+    fancy_string_destroy(content);
+}
+
+static void array_get(fancy_string_array_t const *array, size_t size, char const *label)
+{
+    // NOTE: Each element is retrieved (and released) as many times as needed to
+    // go through `size` bytes, which mimics read-mostly code.
+    size_t n_elements = fancy_string_array_size(array);
+    size_t n_bytes = 0;
+    size_t n_gets = 0;
+    size_t n_allocations_before = allocation_count();
+    double start = now();
+    while (n_bytes < size)
+    {
+        for (size_t i = 0; i < n_elements && n_bytes < size; i++)
+        {
+            fancy_string_t *string = fancy_string_array_get(array, i);
+            n_bytes += fancy_string_size(string) + 1;
+            n_gets += 1;
+            fancy_string_destroy(string);
+        }
+    }
+    double elapsed = now() - start;
+    print_row(label, size, elapsed);
+    print_allocations(label, allocation_count() - n_allocations_before, n_gets, "get");
+}
+
+void bench_array_get(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    fancy_string_array_t *lines = fancy_string_split_by_value(content, "\n", -1);
+    fancy_string_array_t *shared_lines = fancy_string_array_clone(lines);
+    fancy_string_array_share(shared_lines);
+    fancy_string_array_t *blocks = fancy_string_array_create();
+    size_t block_size = 64 * 1024;
+    for (size_t i = 0; i < fancy_string_size(content); i += block_size)
+    {
+        fancy_string_t *block = fancy_string_substring(content, (ssize_t)i, (ssize_t)(i + block_size));
+        fancy_string_array_push(blocks, block);
+        fancy_string_destroy(block);
+    }
+    fancy_string_array_t *shared_blocks = fancy_string_array_clone(blocks);
+    fancy_string_array_share(shared_blocks);
+
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 2)
+    {
+        array_get(lines, size, "array_get lines (deep copy)");
+        array_get(shared_lines, size, "array_get lines (shared)");
+        array_get(blocks, size, "array_get 64k (deep copy)");
+        array_get(shared_blocks, size, "array_get 64k (shared)");
+    }
+
+    fancy_string_array_destroy(shared_blocks);
+    fancy_string_array_destroy(blocks);
+    fancy_string_array_destroy(shared_lines);
+    fancy_string_array_destroy(lines);
+    fancy_string_destroy(content);
+}
+
+void bench_search(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    size_t needle_sizes[] = {2, 4, 8, 16, 32, 64, 256};
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 4)
+    {
+        fancy_string_t *haystack = fancy_string_create_empty();
+        while (fancy_string_size(haystack) < size)
+        {
+            fancy_string_append(haystack, content);
+        }
+        // NOTE: The needle is made unique by a character that does not appear in the text,
+        // such that the whole haystack gets scanned.
+        fancy_string_append_value(haystack, "~");
+        size_t n = fancy_string_size(haystack);
+        fancy_string_view_t view = fancy_string_view(haystack);
+
+        for (size_t i = 0; i < sizeof(needle_sizes) / sizeof(needle_sizes[0]); i++)
+        {
+            size_t n_needle = needle_sizes[i];
+            fancy_string_view_t needle = fancy_string_view_substring(view, (ssize_t)(n - n_needle), -1);
+            char label[64];
+
+            double start = now();
+            ssize_t index = fancy_string_index_of_view(haystack, needle);
+            double elapsed = now() - start;
+            assert(index == (ssize_t)(n - n_needle));
+            snprintf(label, sizeof(label), "index_of_view (needle = %zu)", n_needle);
+            print_row(label, n, elapsed);
+
+            fancy_string_searcher_t *searcher = fancy_string_searcher_create(needle);
+            start = now();
+            index = fancy_string_searcher_find(searcher, view);
+            elapsed = now() - start;
+            assert(index == (ssize_t)(n - n_needle));
+            snprintf(label, sizeof(label), "searcher_find (needle = %zu)", n_needle);
+            print_row(label, n, elapsed);
+            fancy_string_searcher_destroy(searcher);
+        }
+
+        // NOTE: Searching line by line shows the cost of preparing the search on each call.
+        fancy_string_view_t needle = fancy_string_view_from_value("consectetur adipiscing");
+        fancy_string_view_t line_break = fancy_string_view_from_value("\n");
+        size_t n_found = 0;
+        double start = now();
+        for (size_t offset = 0; offset < n;)
+        {
+            fancy_string_view_t remainder = fancy_string_view_substring(view, (ssize_t)offset, -1);
+            ssize_t line_end = fancy_string_view_index_of(remainder, line_break);
+            fancy_string_view_t line = fancy_string_view_substring(remainder, -1, line_end);
+            n_found += fancy_string_view_index_of(line, needle) != -1;
+            offset += line.n + 1;
+        }
+        double elapsed = now() - start;
+        print_row("index_of_view (per line)", n, elapsed);
+
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(needle);
+        size_t n_searcher_found = 0;
+        start = now();
+        for (size_t offset = 0; offset < n;)
+        {
+            fancy_string_view_t remainder = fancy_string_view_substring(view, (ssize_t)offset, -1);
+            ssize_t line_end = fancy_string_view_index_of(remainder, line_break);
+            fancy_string_view_t line = fancy_string_view_substring(remainder, -1, line_end);
+            n_searcher_found += fancy_string_searcher_find(searcher, line) != -1;
+            offset += line.n + 1;
+        }
+        elapsed = now() - start;
+        assert(n_searcher_found == n_found);
+        print_row("searcher_find (per line)", n, elapsed);
+        fancy_string_searcher_destroy(searcher);
+        fancy_string_destroy(haystack);
+    }
+    fancy_string_destroy(content);
+}
+
+void bench_short_search(size_t max_size)
+{
+    fancy_string_t *content = load_big_text_file();
+    size_t needle_sizes[] = {1, 2, 3, 4, 8, 16, 32};
+    size_t haystack_sizes[] = {16, 256, 4096, 65536, 1048576, 16777216, 67108864};
+    for (size_t j = 0; j < sizeof(haystack_sizes) / sizeof(haystack_sizes[0]) && haystack_sizes[j] <= max_size; j++)
+    {
+        size_t size = haystack_sizes[j];
+        fancy_string_t *haystack = fancy_string_create_empty();
+        fancy_string_reserve(haystack, size);
+        while (fancy_string_size(haystack) < size)
+        {
+            fancy_string_append(haystack, content);
+        }
+        // NOTE: Small haystacks are searched many times, such that every measurement
+        // covers the same amount of data.
+        size_t n_repeat = size >= SHORT_SEARCH_WORK_SIZE ? 1 : SHORT_SEARCH_WORK_SIZE / size;
+
+        for (size_t i = 0; i < sizeof(needle_sizes) / sizeof(needle_sizes[0]) && needle_sizes[i] <= size; i++)
+        {
+            // NOTE: The needle is made of text (starting at "ipsum", such that its first byte is a
+            // common one), except for a byte in its middle that does not appear in the text, such that
+            // its first and last bytes produce realistic false positives. It is placed at both ends of
+            // the haystack (for the forward and backward searches).
+            size_t n_needle = needle_sizes[i];
+            char needle[32];
+            memcpy(needle, &fancy_string_view(content).value[6], n_needle);
+            needle[n_needle / 2] = '#';
+            fancy_string_t *tmp = fancy_string_substring(haystack, 0, (ssize_t)size);
+            fancy_string_destroy(haystack);
+            haystack = tmp;
+            fancy_string_t *reversed = fancy_string_clone(haystack);
+            fancy_string_view_t view = fancy_string_view(haystack);
+            memcpy((char *)&view.value[size - n_needle], needle, n_needle);
+            fancy_string_view_t reversed_view = fancy_string_view(reversed);
+            memcpy((char *)reversed_view.value, needle, n_needle);
+            char label[64];
+
+            // NOTE: `memmem` is known to the compiler, which could hoist it out of the loop.
+            char const *volatile memmem_haystack = view.value;
+            ssize_t expected = (ssize_t)(size - n_needle);
+            double start = now();
+            for (size_t k = 0; k < n_repeat; k++)
+            {
+                char *p = memmem(memmem_haystack, size, needle, n_needle);
+                assert(p - view.value == expected);
+            }
+            double elapsed = (now() - start) / (double)n_repeat;
+            snprintf(label, sizeof(label), "memmem (needle = %zu)", n_needle);
+            print_row(label, size, elapsed);
+
+            start = now();
+            for (size_t k = 0; k < n_repeat; k++)
+            {
+                ssize_t index = fancy_string_index_of_value_n(haystack, needle, n_needle);
+                assert(index == expected);
+            }
+            elapsed = (now() - start) / (double)n_repeat;
+            snprintf(label, sizeof(label), "index_of_value_n (needle = %zu)", n_needle);
+            print_row(label, size, elapsed);
+
+            start = now();
+            for (size_t k = 0; k < n_repeat; k++)
+            {
+                ssize_t index = legacy_last_index_of(reversed_view.value, size, needle, n_needle);
+                assert(index == 0);
+            }
+            elapsed = (now() - start) / (double)n_repeat;
+            snprintf(label, sizeof(label), "legacy last_index_of (needle = %zu)", n_needle);
+            print_row(label, size, elapsed);
+
+            start = now();
+            for (size_t k = 0; k < n_repeat; k++)
+            {
+                ssize_t index = fancy_string_last_index_of_value_n(reversed, needle, n_needle);
+                assert(index == 0);
+            }
+            elapsed = (now() - start) / (double)n_repeat;
+            snprintf(label, sizeof(label), "last_index_of_value_n (needle = %zu)", n_needle);
+            print_row(label, size, elapsed);
+            fancy_string_destroy(reversed);
+        }
+        fancy_string_destroy(haystack);
+    }
+    fancy_string_destroy(content);
+}
+
+void bench_multi_replace(size_t max_size)
+{
+    // NOTE: Redacts a list of "sensitive tokens" from every line of a log, which used to
+    // take one `fancy_string_replace_value` call per token and per line.
+    fancy_string_t *content = load_big_text_file();
+    fancy_string_array_t *content_lines = fancy_string_split_by_value(content, "\n", -1);
+    fancy_string_array_t *tokens = fancy_string_array_create();
+    unsigned int seed = 1;
+    for (size_t i = 0; i < MULTI_REPLACE_N_TOKENS; i++)
+    {
+        char token[32];
+        seed = seed * 1103515245u + 12345u;
+        snprintf(token, sizeof(token), "key-%08x", seed);
+        fancy_string_array_push_value(tokens, token);
+    }
+    fancy_string_array_t *replacements = fancy_string_array_create_with_values("[redacted]", NULL);
+
+    double start = now();
+    fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(tokens);
+    fprintf(stdout, "\tcompiled %d tokens in %.3f ms\n", MULTI_REPLACE_N_TOKENS, (now() - start) * 1e3);
+
+    for (size_t size = MULTI_REPLACE_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        // NOTE: Every fourth line gets one of the tokens appended to it.
+        fancy_string_array_t *lines = fancy_string_array_create();
+        size_t n_lines = 0;
+        for (size_t total = 0; total < size; n_lines++)
+        {
+            fancy_string_t *line = fancy_string_array_get(content_lines, n_lines % fancy_string_array_size(content_lines));
+            if (n_lines % 4 == 0)
+            {
+                fancy_string_t *token = fancy_string_array_get(tokens, (n_lines * 7919) % MULTI_REPLACE_N_TOKENS);
+                fancy_string_append_value(line, " token=");
+                fancy_string_append(line, token);
+                fancy_string_destroy(token);
+            }
+            total += fancy_string_size(line) + 1;
+            fancy_string_array_push(lines, line);
+            fancy_string_destroy(line);
+        }
+        fancy_string_array_t *copies = fancy_string_array_clone(lines);
+
+        size_t n_replaced = 0;
+        start = now();
+        for (size_t i = 0; i < n_lines; i++)
+        {
+            fancy_string_t *line = fancy_string_array_get(copies, i);
+            n_replaced += (size_t)fancy_string_multi_replace(line, matcher, replacements);
+            fancy_string_destroy(line);
+        }
+        print_row("multi_replace", size, now() - start);
+        assert(n_replaced == (n_lines + 3) / 4);
+
+        if (size <= MULTI_REPLACE_LEGACY_MAX_SIZE)
+        {
+            fancy_string_t *replacement = fancy_string_array_first(replacements);
+            start = now();
+            for (size_t i = 0; i < n_lines; i++)
+            {
+                fancy_string_t *line = fancy_string_array_get(copies, i);
+                for (size_t j = 0; j < MULTI_REPLACE_N_TOKENS; j++)
+                {
+                    fancy_string_t *token = fancy_string_array_get(tokens, j);
+                    fancy_string_replace(line, token, replacement, -1);
+                    fancy_string_destroy(token);
+                }
+                fancy_string_destroy(line);
+            }
+            print_row("replace (one call per token)", size, now() - start);
+            fancy_string_destroy(replacement);
+        }
+
+        fancy_string_array_destroy(copies);
+        fancy_string_array_destroy(lines);
+    }
+    fancy_string_multi_matcher_destroy(matcher);
+    fancy_string_array_destroy(replacements);
+    fancy_string_array_destroy(tokens);
+    fancy_string_array_destroy(content_lines);
+    fancy_string_destroy(content);
+}
+
+void bench_replace(size_t max_size)
+{
+    // NOTE: Replaces every space (i.e., an occurrence every few bytes) with a shorter, an equally
+    // long, and a longer value.
+    fancy_string_t *content = load_big_text_file();
+    char const *new_values[] = {"", "_", "___"};
+    for (size_t size = REPLACE_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        fancy_string_t *s = fancy_string_create_empty();
+        while (fancy_string_size(s) < size)
+        {
+            fancy_string_append(s, content);
+        }
+        for (size_t i = 0; i < sizeof(new_values) / sizeof(new_values[0]); i++)
+        {
+            char label[64];
+            fancy_string_t *copy = fancy_string_clone(s);
+            size_t n_allocations = allocation_count();
+            double start = now();
+            fancy_string_replace_value(copy, " ", new_values[i], -1);
+            double elapsed = now() - start;
+            n_allocations = allocation_count() - n_allocations;
+            snprintf(label, sizeof(label), "replace_value (\" \" -> \"%s\")", new_values[i]);
+            print_row(label, size, elapsed);
+            print_allocations(label, n_allocations, 1, "call");
+
+            if (size <= REPLACE_LEGACY_MAX_SIZE)
+            {
+                fancy_string_t *legacy_copy = fancy_string_clone(s);
+                start = now();
+                legacy_replace_value(legacy_copy, " ", new_values[i]);
+                elapsed = now() - start;
+                assert(fancy_string_equals(legacy_copy, copy));
+                snprintf(label, sizeof(label), "legacy (\" \" -> \"%s\")", new_values[i]);
+                print_row(label, size, elapsed);
+                fancy_string_destroy(legacy_copy);
+            }
+            fancy_string_destroy(copy);
+        }
+        fancy_string_destroy(s);
+    }
+    fancy_string_destroy(content);
+}
+
+void bench_split_line(size_t max_size)
+{
+    // NOTE: Splits a single long line (e.g., a CSV record) into fields of ~100 bytes.
+    fancy_string_t *content = load_big_text_file();
+    fancy_string_replace_value(content, "\n", " ", -1);
+    char *value = fancy_string_value(content);
+    size_t n_content = fancy_string_size(content);
+    for (size_t size = SPLIT_LINE_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        char *buffer = malloc(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            buffer[i] = i % 100 == 99 ? ',' : value[i % n_content];
+        }
+        fancy_string_t *line = fancy_string_from_copied_memory(buffer, size);
+        free(buffer);
+
+        size_t n_allocations = allocation_count();
+        double start = now();
+        fancy_string_array_t *fields = fancy_string_split_by_value(line, ",", -1);
+        double elapsed = now() - start;
+        n_allocations = allocation_count() - n_allocations;
+        print_row("split_by_value (fields)", size, elapsed);
+        print_allocations("split_by_value (fields)", n_allocations, fancy_string_array_size(fields), "field");
+
+        if (size <= SPLIT_LINE_LEGACY_MAX_SIZE)
+        {
+            start = now();
+            fancy_string_array_t *legacy_fields = legacy_split_by_value(line, ",");
+            elapsed = now() - start;
+            assert(fancy_string_array_size(legacy_fields) == fancy_string_array_size(fields));
+            fancy_string_t *joined = fancy_string_array_join_by_value(legacy_fields, ",");
+            assert(fancy_string_equals(joined, line));
+            fancy_string_destroy(joined);
+            print_row("legacy (remainder copies)", size, elapsed);
+            fancy_string_array_destroy(legacy_fields);
+        }
+
+        n_allocations = allocation_count();
+        start = now();
+        fancy_string_array_t *arena_fields = fancy_string_split_arena(line, fancy_string_view_from_value(","), -1);
+        elapsed = now() - start;
+        n_allocations = allocation_count() - n_allocations;
+        assert(fancy_string_array_size(arena_fields) == fancy_string_array_size(fields));
+        print_row("split_arena (fields)", size, elapsed);
+        print_allocations("split_arena (fields)", n_allocations, fancy_string_array_size(arena_fields), "field");
+
+        start = now();
+        fancy_string_array_destroy(fields);
+        print_row("array_destroy (split_by_value)", size, now() - start);
+        start = now();
+        fancy_string_array_destroy(arena_fields);
+        print_row("array_destroy (split_arena)", size, now() - start);
+        fancy_string_destroy(line);
+    }
+    free(value);
+    fancy_string_destroy(content);
+}
+
+void bench_split_iter(size_t max_size)
+{
+    // NOTE: Gets the third field of (and then walks through all the fields of) a single long line.
+    fancy_string_t *content = load_big_text_file();
+    fancy_string_replace_value(content, "\n", " ", -1);
+    char *value = fancy_string_value(content);
+    size_t n_content = fancy_string_size(content);
+    for (size_t size = SPLIT_LINE_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        char *buffer = malloc(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            buffer[i] = i % 100 == 99 ? ',' : value[i % n_content];
+        }
+        fancy_string_t *line = fancy_string_from_copied_memory(buffer, size);
+        free(buffer);
+
+        size_t n_allocations = allocation_count();
+        double start = now();
+        fancy_string_split_iter_t iter = fancy_string_split_iter(line, fancy_string_view_from_value(","), -1);
+        fancy_string_view_t field = {.value = NULL, .n = 0};
+        for (size_t i = 0; i < 3 && fancy_string_split_iter_next(&iter, &field); i++)
+        {
+        }
+        double elapsed = now() - start;
+        print_row("split_iter (third field)", size, elapsed);
+        print_allocations("split_iter (third field)", allocation_count() - n_allocations, 1, "call");
+
+        start = now();
+        fancy_string_array_t *fields = fancy_string_split_by_value(line, ",", -1);
+        fancy_string_t *third = fancy_string_array_get(fields, 2);
+        elapsed = now() - start;
+        assert(fancy_string_equals_view(third, field));
+        print_row("split_by_value + get (third field)", size, elapsed);
+
+        n_allocations = allocation_count();
+        start = now();
+        iter = fancy_string_split_iter(line, fancy_string_view_from_value(","), -1);
+        size_t n_fields = 0;
+        size_t n_bytes = 0;
+        while (fancy_string_split_iter_next(&iter, &field))
+        {
+            n_fields++;
+            n_bytes += field.n;
+        }
+        elapsed = now() - start;
+        assert(n_fields == fancy_string_array_size(fields));
+        assert(n_bytes + n_fields - 1 == size);
+        print_row("split_iter (all fields)", size, elapsed);
+        print_allocations("split_iter (all fields)", allocation_count() - n_allocations, n_fields, "field");
+
+        fancy_string_t *pattern = fancy_string_create(", *");
+        fancy_string_pattern_t *compiled_pattern = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        iter = fancy_string_split_iter_by_pattern(line, compiled_pattern, -1);
+        // NOTE: The first search builds the DFA's states.
+        fancy_string_split_iter_next(&iter, &field);
+        n_allocations = allocation_count();
+        start = now();
+        size_t n_pattern_fields = 1;
+        while (fancy_string_split_iter_next(&iter, &field))
+        {
+            n_pattern_fields++;
+        }
+        elapsed = now() - start;
+        assert(n_pattern_fields == n_fields);
+        print_row("split_iter_by_pattern (all)", size, elapsed);
+        print_allocations("split_iter_by_pattern (all)", allocation_count() - n_allocations, n_fields, "field");
+        fancy_string_pattern_destroy(compiled_pattern);
+        fancy_string_destroy(pattern);
+
+        fancy_string_destroy(third);
+        fancy_string_array_destroy(fields);
+        fancy_string_destroy(line);
+    }
+    free(value);
+    fancy_string_destroy(content);
+}
+
+void bench_split_any(size_t max_size)
+{
+    // NOTE: Splits a single long line on any of ",;|\t" (once with fields of ~100 bytes, and once with
+    // words, i.e., also on spaces), against the previous way of doing it (i.e., a regular expression).
+    fancy_string_t *content = load_big_text_file();
+    fancy_string_replace_value(content, "\n", " ", -1);
+    char *value = fancy_string_value(content);
+    size_t n_content = fancy_string_size(content);
+    char const *delimiters = ",;|\t";
+    char const *charsets[] = {",;|\t", " ,;|\t"};
+    char const *patterns[] = {"[,;|\t]", "[ ,;|\t]"};
+    char const *labels[] = {"fields", "words"};
+    for (size_t size = SPLIT_LINE_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        char *buffer = malloc(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            buffer[i] = i % 100 == 99 ? delimiters[(i / 100) % 4] : value[i % n_content];
+        }
+        fancy_string_t *line = fancy_string_from_copied_memory(buffer, size);
+        free(buffer);
+        for (size_t i = 0; i < sizeof(charsets) / sizeof(charsets[0]); i++)
+        {
+            char label[64];
+            double start = now();
+            fancy_string_array_t *components = fancy_string_split_by_any(line, charsets[i], -1);
+            double elapsed = now() - start;
+            snprintf(label, sizeof(label), "split_by_any (%s)", labels[i]);
+            print_row(label, size, elapsed);
+
+            if (size <= SPLIT_ANY_REGEX_MAX_SIZE)
+            {
+                fancy_string_t *pattern = fancy_string_create(patterns[i]);
+                start = now();
+                fancy_string_regex_t *regex = fancy_string_regex_create(line, pattern, -1);
+                fancy_string_array_t *regex_components = fancy_string_regex_split_at_matches(regex);
+                elapsed = now() - start;
+                assert(fancy_string_array_size(regex_components) == fancy_string_array_size(components));
+                snprintf(label, sizeof(label), "regex (%s)", labels[i]);
+                print_row(label, size, elapsed);
+                fancy_string_array_destroy(regex_components);
+                fancy_string_regex_destroy(regex);
+                fancy_string_destroy(pattern);
+            }
+            fancy_string_array_destroy(components);
+        }
+        fancy_string_destroy(line);
+    }
+    free(value);
+    fancy_string_destroy(content);
+}
+
+void bench_case(size_t max_size)
+{
+    // NOTE: Lowercases many short header keys (in place, and into new strings), and then
+    // a long text, against the previous implementation.
+    char const *keys[] = {"Content-Type", "Content-Length", "Accept-Encoding", "X-Forwarded-For", "Cache-Control", "User-Agent"};
+    size_t n_keys = sizeof(keys) / sizeof(keys[0]);
+    fancy_string_t **headers = malloc(sizeof(fancy_string_t *) * CASE_N_HEADER_KEYS);
+    size_t n_bytes = 0;
+    for (size_t i = 0; i < CASE_N_HEADER_KEYS; i++)
+    {
+        headers[i] = fancy_string_create(keys[i % n_keys]);
+        n_bytes += fancy_string_size(headers[i]);
+    }
+    size_t n_allocations = allocation_count();
+    double start = now();
+    for (size_t i = 0; i < CASE_N_HEADER_KEYS; i++)
+    {
+        fancy_string_lowercase(headers[i]);
+    }
+    double elapsed = now() - start;
+    n_allocations = allocation_count() - n_allocations;
+    print_row("lowercase (header keys)", n_bytes, elapsed);
+    print_allocations("lowercase (header keys)", n_allocations, CASE_N_HEADER_KEYS, "key");
+    n_allocations = allocation_count();
+    start = now();
+    for (size_t i = 0; i < CASE_N_HEADER_KEYS; i++)
+    {
+        fancy_string_t *lowercased = fancy_string_lowercased(headers[i]);
+        fancy_string_destroy(lowercased);
+    }
+    elapsed = now() - start;
+    n_allocations = allocation_count() - n_allocations;
+    print_row("lowercased (header keys)", n_bytes, elapsed);
+    print_allocations("lowercased (header keys)", n_allocations, CASE_N_HEADER_KEYS, "key");
+    for (size_t i = 0; i < CASE_N_HEADER_KEYS; i++)
+    {
+        fancy_string_update_value(headers[i], keys[i % n_keys]);
+    }
+    n_allocations = allocation_count();
+    start = now();
+    for (size_t i = 0; i < CASE_N_HEADER_KEYS; i++)
+    {
+        legacy_lowercase(headers[i]);
+    }
+    elapsed = now() - start;
+    n_allocations = allocation_count() - n_allocations;
+    print_row("legacy (header keys)", n_bytes, elapsed);
+    print_allocations("legacy (header keys)", n_allocations, CASE_N_HEADER_KEYS, "key");
+    for (size_t i = 0; i < CASE_N_HEADER_KEYS; i++)
+    {
+        fancy_string_destroy(headers[i]);
+    }
+    free(headers);
+
+    fancy_string_t *content = load_big_text_file();
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 4)
+    {
+        fancy_string_t *s = fancy_string_create_empty();
+        while (fancy_string_size(s) < size)
+        {
+            fancy_string_append(s, content);
+        }
+        fancy_string_t *copy = fancy_string_clone(s);
+        start = now();
+        fancy_string_lowercase(copy);
+        elapsed = now() - start;
+        print_row("lowercase", size, elapsed);
+
+        start = now();
+        fancy_string_t *lowercased = fancy_string_lowercased(s);
+        elapsed = now() - start;
+        assert(fancy_string_equals(lowercased, copy));
+        print_row("lowercased", size, elapsed);
+
+        if (size <= LEGACY_MAX_SIZE)
+        {
+            fancy_string_t *legacy_copy = fancy_string_clone(s);
+            start = now();
+            legacy_lowercase(legacy_copy);
+            elapsed = now() - start;
+            assert(fancy_string_equals(legacy_copy, copy));
+            print_row("legacy", size, elapsed);
+            fancy_string_destroy(legacy_copy);
+        }
+        fancy_string_destroy(lowercased);
+        fancy_string_destroy(copy);
+        fancy_string_destroy(s);
+    }
+    fancy_string_destroy(content);
+}
+
+void bench_trim_pad_repeat(size_t max_size)
+{
+    // NOTE: Trims and pads many short values (e.g., the fields of a fixed-width record), and then
+    // repeats a short value into a long string, against the previous implementations.
+    fancy_string_t **strings = malloc(sizeof(fancy_string_t *) * TRIM_PAD_N_STRINGS);
+    size_t n_allocations;
+    double start;
+    double elapsed;
+    for (size_t k = 0; k < 2; k++)
+    {
+        bool use_legacy = k == 1;
+        size_t n_bytes = 0;
+        for (size_t i = 0; i < TRIM_PAD_N_STRINGS; i++)
+        {
+            strings[i] = fancy_string_create(i % 2 == 0 ? "   12345   " : "\t 42 \n");
+            n_bytes += fancy_string_size(strings[i]);
+        }
+        n_allocations = allocation_count();
+        start = now();
+        for (size_t i = 0; i < TRIM_PAD_N_STRINGS; i++)
+        {
+            if (use_legacy)
+            {
+                legacy_trim(strings[i]);
+            }
+            else
+            {
+                fancy_string_trim(strings[i]);
+            }
+        }
+        elapsed = now() - start;
+        n_allocations = allocation_count() - n_allocations;
+        print_row(use_legacy ? "legacy trim" : "trim", n_bytes, elapsed);
+        print_allocations(use_legacy ? "legacy trim" : "trim", n_allocations, TRIM_PAD_N_STRINGS, "string");
+
+        n_allocations = allocation_count();
+        start = now();
+        for (size_t i = 0; i < TRIM_PAD_N_STRINGS; i++)
+        {
+            if (use_legacy)
+            {
+                legacy_pad_start(strings[i], 12, '0');
+            }
+            else
+            {
+                fancy_string_pad_start(strings[i], 12, '0');
+            }
+        }
+        elapsed = now() - start;
+        n_allocations = allocation_count() - n_allocations;
+        print_row(use_legacy ? "legacy pad_start" : "pad_start", TRIM_PAD_N_STRINGS * 12, elapsed);
+        print_allocations(use_legacy ? "legacy pad_start" : "pad_start", n_allocations, TRIM_PAD_N_STRINGS, "string");
+        for (size_t i = 0; i < TRIM_PAD_N_STRINGS; i++)
+        {
+            assert(fancy_string_equals_value(strings[i], i % 2 == 0 ? "000000012345" : "000000000042"));
+            fancy_string_destroy(strings[i]);
+        }
+    }
+    free(strings);
+
+    for (size_t size = MIN_SIZE; size <= max_size; size *= 4)
+    {
+        // NOTE: The value is followed by `n_repeat` copies of itself.
+        size_t n_repeat = size / 8 - 1;
+        n_allocations = allocation_count();
+        start = now();
+        fancy_string_t *s = fancy_string_create_repeat("repeat! ", n_repeat);
+        elapsed = now() - start;
+        n_allocations = allocation_count() - n_allocations;
+        print_row("create_repeat", size, elapsed);
+        print_allocations("create_repeat", n_allocations, 1, "call");
+
+        if (size <= REPEAT_LEGACY_MAX_SIZE)
+        {
+            n_allocations = allocation_count();
+            start = now();
+            fancy_string_t *legacy = legacy_create_repeat("repeat! ", n_repeat);
+            elapsed = now() - start;
+            n_allocations = allocation_count() - n_allocations;
+            assert(fancy_string_equals(legacy, s));
+            print_row("legacy create_repeat", size, elapsed);
+            print_allocations("legacy create_repeat", n_allocations, 1, "call");
+            fancy_string_destroy(legacy);
+        }
+        fancy_string_destroy(s);
+    }
+}
+
+void bench_pattern(size_t max_size)
+{
+    // NOTE: Routes messages by matching each of them against the same set of patterns (one of
+    // which matches), either compiling the patterns for each message (i.e., `fancy_string_regex_create`),
+    // or compiling them once.
+    fancy_string_t *patterns[PATTERN_N_PATTERNS];
+    for (size_t i = 0; i < PATTERN_N_PATTERNS; i++)
+    {
+        char value[64];
+        snprintf(value, sizeof(value), "^(GET|POST) /api/v[12]/resource%zu(/[a-z]+)?$", i);
+        patterns[i] = fancy_string_create(value);
+    }
+    fancy_string_pattern_t *compiled_patterns[PATTERN_N_PATTERNS];
+    double start = now();
+    for (size_t i = 0; i < PATTERN_N_PATTERNS; i++)
+    {
+        compiled_patterns[i] = fancy_string_pattern_create(patterns[i]);
+    }
+    double elapsed = now() - start;
+    fprintf(stdout, "\t%-28s %12d patterns %10.3f ms\n", "pattern_create", PATTERN_N_PATTERNS, elapsed * 1e3);
+
+    for (size_t size = PATTERN_MIN_SIZE; size <= max_size && size <= PATTERN_MAX_SIZE; size *= 4)
+    {
+        fancy_string_array_t *messages = fancy_string_array_create();
+        size_t n_bytes = 0;
+        for (size_t i = 0; n_bytes < size; i++)
+        {
+            char value[64];
+            snprintf(value, sizeof(value), "GET /api/v1/resource%zu/items", (i * 7) % PATTERN_N_PATTERNS);
+            fancy_string_array_push_value(messages, value);
+            n_bytes += strlen(value);
+        }
+        size_t n_messages = fancy_string_array_size(messages);
+
+        size_t n_matches = 0;
+        start = now();
+        for (size_t i = 0; i < n_messages; i++)
+        {
+            fancy_string_t *message = fancy_string_array_get(messages, i);
+            fancy_string_view_t subject = fancy_string_view(message);
+            for (size_t j = 0; j < PATTERN_N_PATTERNS; j++)
+            {
+                n_matches += fancy_string_pattern_has_match(compiled_patterns[j], subject);
+            }
+            fancy_string_destroy(message);
+        }
+        elapsed = now() - start;
+        assert(n_matches == n_messages);
+        print_row("pattern_has_match", n_bytes, elapsed);
+
+        n_matches = 0;
+        start = now();
+        for (size_t i = 0; i < n_messages; i++)
+        {
+            fancy_string_t *message = fancy_string_array_get(messages, i);
+            for (size_t j = 0; j < PATTERN_N_PATTERNS; j++)
+            {
+                fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(message, compiled_patterns[j], 1);
+                n_matches += fancy_string_regex_has_match(regex);
+                fancy_string_regex_destroy(regex);
+            }
+            fancy_string_destroy(message);
+        }
+        elapsed = now() - start;
+        assert(n_matches == n_messages);
+        print_row("regex_create_with_pattern", n_bytes, elapsed);
+
+        if (size <= PATTERN_LEGACY_MAX_SIZE)
+        {
+            n_matches = 0;
+            start = now();
+            for (size_t i = 0; i < n_messages; i++)
+            {
+                fancy_string_t *message = fancy_string_array_get(messages, i);
+                for (size_t j = 0; j < PATTERN_N_PATTERNS; j++)
+                {
+                    fancy_string_regex_t *regex = fancy_string_regex_create(message, patterns[j], 1);
+                    n_matches += fancy_string_regex_has_match(regex);
+                    fancy_string_regex_destroy(regex);
+                }
+                fancy_string_destroy(message);
+            }
+            elapsed = now() - start;
+            assert(n_matches == n_messages);
+            print_row("regex_create", n_bytes, elapsed);
+        }
+
+        // NOTE: The same calls, with the patterns cache enabled (and large enough for all of them).
+        fancy_string_regex_cache_set_capacity(PATTERN_N_PATTERNS);
+        n_matches = 0;
+        start = now();
+        for (size_t i = 0; i < n_messages; i++)
+        {
+            fancy_string_t *message = fancy_string_array_get(messages, i);
+            for (size_t j = 0; j < PATTERN_N_PATTERNS; j++)
+            {
+                fancy_string_regex_t *regex = fancy_string_regex_create(message, patterns[j], 1);
+                n_matches += fancy_string_regex_has_match(regex);
+                fancy_string_regex_destroy(regex);
+            }
+            fancy_string_destroy(message);
+        }
+        elapsed = now() - start;
+        assert(n_matches == n_messages);
+        print_row("regex_create (cached)", n_bytes, elapsed);
+        fancy_string_regex_cache_stats_t stats = fancy_string_regex_cache_stats();
+        fprintf(
+            stdout, "\t%-28s %12zu hits %12zu misses %12zu evictions\n",
+            "regex_create (cached)", stats.n_hits, stats.n_misses, stats.n_evictions);
+        fancy_string_regex_cache_set_capacity(0);
+        fancy_string_regex_cache_clear();
+        fancy_string_array_destroy(messages);
+    }
+    for (size_t i = 0; i < PATTERN_N_PATTERNS; i++)
+    {
+        fancy_string_pattern_destroy(compiled_patterns[i]);
+        fancy_string_destroy(patterns[i]);
+    }
+}
+
+void bench_prefilter(size_t max_size)
+{
+    // NOTE: Looks for the error lines of a log (1 line out of 100), line by line and in the whole log at
+    // once. Wrapping the pattern in a group gives the same matches, but disables its prefilter.
+    fancy_string_t *pattern = fancy_string_create("error: [0-9]+");
+    fancy_string_t *grouped = fancy_string_create("(error: [0-9]+)");
+    fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+    fancy_string_pattern_t *reference = fancy_string_pattern_create(grouped);
+    for (size_t size = PREFILTER_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        fancy_string_t *log = fancy_string_create_empty();
+        size_t n_errors = 0;
+        for (size_t i = 0; fancy_string_size(log) < size; i++)
+        {
+            char value[128];
+            if (i % 100 == 99)
+            {
+                snprintf(value, sizeof(value), "2026-01-01 12:00:%02zu worker-%zu error: %zu while serving request\n", i % 60, i % 8, i);
+                n_errors += 1;
+            }
+            else
+            {
+                snprintf(value, sizeof(value), "2026-01-01 12:00:%02zu worker-%zu info: request %zu served in %zu ms\n", i % 60, i % 8, i, i % 97);
+            }
+            fancy_string_append_value(log, value);
+        }
+        fancy_string_view_t text = fancy_string_view(log);
+
+        fancy_string_pattern_t *compiled[] = {p, reference};
+        char const *labels[][2] = {
+            {"pattern_find (lines)", "regex_create_with_pattern"},
+            {"pattern_find (grouped)", "regex_with_pattern (grouped)"},
+        };
+        for (size_t k = 0; k < 2; k++)
+        {
+            size_t n_matches = 0;
+            double start = now();
+            for (size_t i = 0; i < text.n;)
+            {
+                char const *end = memchr(text.value + i, '\n', text.n - i);
+                size_t n = end == NULL ? text.n - i : (size_t)(end - (text.value + i));
+                fancy_string_view_t line = {.value = text.value + i, .n = n};
+                n_matches += fancy_string_pattern_find(compiled[k], line).index == 0;
+                i += n + 1;
+            }
+            double elapsed = now() - start;
+            assert(n_matches == n_errors);
+            print_row(labels[k][0], text.n, elapsed);
+
+            start = now();
+            fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(log, compiled[k], -1);
+            elapsed = now() - start;
+            assert(fancy_string_regex_match_count(regex) == n_errors);
+            fancy_string_regex_destroy(regex);
+            print_row(labels[k][1], text.n, elapsed);
+        }
+        fancy_string_prefilter_stats_t stats = fancy_string_pattern_prefilter_stats(p);
+        fprintf(
+            stdout, "\t%-28s %12zu checks %12zu rejections %12zu skipped bytes\n",
+            "prefilter", stats.n_checks, stats.n_rejections, stats.n_skipped_bytes);
+        fancy_string_destroy(log);
+    }
+    fancy_string_pattern_destroy(reference);
+    fancy_string_pattern_destroy(p);
+    fancy_string_destroy(grouped);
+    fancy_string_destroy(pattern);
+}
+
+void bench_dfa(size_t max_size)
+{
+    // NOTE: Compares both engines on a pattern that makes `regexec` backtrack (on a subject without
+    // any match, but with the `y` that its prefilter looks for), and on an ordinary one (looking for the email addresses of a text). The former is
+    // only run with the POSIX engine up to a smaller size, since its time grows much faster.
+    fancy_string_t *pathological = fancy_string_create("(x+x+)+y");
+    fancy_string_t *email = fancy_string_create("[a-z0-9._]+@[a-z0-9]+\\.[a-z]+");
+    fancy_string_pattern_t *posix[] = {fancy_string_pattern_create(pathological), fancy_string_pattern_create(email)};
+    fancy_string_pattern_t *dfa[] = {
+        fancy_string_pattern_create_with_engine(pathological, FANCY_STRING_REGEX_ENGINE_DFA),
+        fancy_string_pattern_create_with_engine(email, FANCY_STRING_REGEX_ENGINE_DFA),
+    };
+    assert(dfa[0] != NULL && dfa[1] != NULL);
+    for (size_t size = DFA_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        fancy_string_t *xs = fancy_string_create_repeat("x", size);
+        fancy_string_prepend_value(xs, "y");
+        fancy_string_t *text = fancy_string_create_empty();
+        size_t n_emails = 0;
+        for (size_t i = 0; fancy_string_size(text) < size; i++)
+        {
+            char value[128];
+            if (i % 10 == 9)
+            {
+                snprintf(value, sizeof(value), "write to user.%zu@example.com for details ", i);
+                n_emails += 1;
+            }
+            else
+            {
+                snprintf(value, sizeof(value), "the quick brown fox %zu jumps over the lazy dog ", i);
+            }
+            fancy_string_append_value(text, value);
+        }
+
+        fancy_string_t *subjects[] = {xs, text};
+        size_t expected[] = {0, n_emails};
+        char const *labels[][2] = {
+            {"backtracking (posix)", "backtracking (dfa)"},
+            {"emails (posix)", "emails (dfa)"},
+        };
+        for (size_t k = 0; k < 2; k++)
+        {
+            if (k != 0 || size <= DFA_LEGACY_MAX_SIZE)
+            {
+                double start = now();
+                fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(subjects[k], posix[k], -1);
+                double elapsed = now() - start;
+                assert(fancy_string_regex_match_count(regex) == expected[k]);
+                fancy_string_regex_destroy(regex);
+                print_row(labels[k][0], fancy_string_size(subjects[k]), elapsed);
+            }
+            double start = now();
+            fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(subjects[k], dfa[k], -1);
+            double elapsed = now() - start;
+            assert(fancy_string_regex_match_count(regex) == expected[k]);
+            fancy_string_regex_destroy(regex);
+            print_row(labels[k][1], fancy_string_size(subjects[k]), elapsed);
+        }
+        fancy_string_destroy(text);
+        fancy_string_destroy(xs);
+    }
+    for (size_t k = 0; k < 2; k++)
+    {
+        fancy_string_pattern_destroy(dfa[k]);
+        fancy_string_pattern_destroy(posix[k]);
+    }
+    fancy_string_destroy(email);
+    fancy_string_destroy(pathological);
+}
+
+void bench_stream(size_t max_size)
+{
+    // NOTE: Counts the error lines of a log (1 line out of 100) and the words of a text, with a regex object
+    // (which holds a copy of the input and all of the matches), and with the callback-based search, on the
+    // input in memory and read from a stream.
+    char const *patterns[] = {"error: [0-9]+", "[a-z]+"};
+    char const *labels[][4] = {
+        {"regex_with_pattern (errors)", "dfa regex_with_pattern", "pattern_find_all", "pattern_find_all_in_stream"},
+        {"regex_with_pattern (words)", "dfa regex_with_pattern", "pattern_find_all", "pattern_find_all_in_stream"},
+    };
+    for (size_t size = STREAM_MIN_SIZE; size <= max_size; size *= 4)
+    {
+        fancy_string_t *log = fancy_string_create_empty();
+        for (size_t i = 0; fancy_string_size(log) < size; i++)
+        {
+            char value[128];
+            if (i % 100 == 99)
+            {
+                snprintf(value, sizeof(value), "2026-01-01 12:00:%02zu worker-%zu error: %zu while serving request\n", i % 60, i % 8, i);
+            }
+            else
+            {
+                snprintf(value, sizeof(value), "2026-01-01 12:00:%02zu worker-%zu info: request %zu served in %zu ms\n", i % 60, i % 8, i, i % 97);
+            }
+            fancy_string_append_value(log, value);
+        }
+        fancy_string_view_t text = fancy_string_view(log);
+        for (size_t k = 0; k < 2; k++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[k]);
+            fancy_string_pattern_t *posix = fancy_string_pattern_create(pattern);
+            fancy_string_pattern_t *dfa = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+            assert(dfa != NULL);
+
+            double start = now();
+            fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(log, posix, -1);
+            double elapsed = now() - start;
+            size_t n_matches = fancy_string_regex_match_count(regex);
+            fancy_string_regex_destroy(regex);
+            print_row(labels[k][0], text.n, elapsed);
+
+            start = now();
+            regex = fancy_string_regex_create_with_pattern(log, dfa, -1);
+            elapsed = now() - start;
+            assert(fancy_string_regex_match_count(regex) == n_matches);
+            fancy_string_regex_destroy(regex);
+            print_row(labels[k][1], text.n, elapsed);
+
+            start = now();
+            ssize_t count = fancy_string_pattern_find_all(dfa, text, NULL, NULL);
+            elapsed = now() - start;
+            assert(count == (ssize_t)n_matches);
+            print_row(labels[k][2], text.n, elapsed);
+
+            FILE *stream = fmemopen((void *)text.value, text.n, "r");
+            start = now();
+            count = fancy_string_pattern_find_all_in_stream(dfa, stream, NULL, NULL);
+            elapsed = now() - start;
+            assert(count == (ssize_t)n_matches);
+            fclose(stream);
+            print_row(labels[k][3], text.n, elapsed);
+
+            fancy_string_pattern_destroy(dfa);
+            fancy_string_pattern_destroy(posix);
+            fancy_string_destroy(pattern);
+        }
+        fancy_string_destroy(log);
+    }
+}
+
+// -----------------------------------------------
+//                     MAIN
+// -----------------------------------------------
+
+int main(int argc, char **argv)
+{
+    char const *name = argc > 1 ? argv[1] : "all";
+    size_t max_size = argc > 2 ? (size_t)strtoull(argv[2], NULL, 10) : DEFAULT_MAX_SIZE;
+    if (max_size < MIN_SIZE)
+    {
+        max_size = MIN_SIZE;
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++)
+    {
+        if (strcmp(name, "all") != 0 && strcmp(name, benchmarks[i].name) != 0)
+        {
+            continue;
+        }
+        found = true;
+        fprintf(stdout, "Running \033[32m%s\033[0m (max size = %zu bytes) ...\n", benchmarks[i].name, max_size);
+        benchmarks[i].fn(max_size);
+    }
+
+    if (!found)
+    {
+        fprintf(stderr, "Unknown benchmark '%s'. Available benchmarks:\n", name);
+        for (size_t i = 0; i < sizeof(benchmarks) / sizeof(benchmarks[0]); i++)
+        {
+            fprintf(stderr, "\t- %s\n", benchmarks[i].name);
+        }
+        return EXIT_FAILURE;
+    }
+
+    return 0;
+}
@@ -27,11 +27,13 @@ int main(void)
         }
     }
     {
-        char tmp[6] = {'h', 'e', 'l', 'l', 'o', '\0'};
+        char tmp[8] = {'h', 'e', 'l', 'l', 'o', '\0', '!', '!'};
         {
-            // NOTE: Beyond tmp[5], The size `n` does not matter, because we have a null character.
-            fancy_string_t *s = fancy_string_from_copied_memory(tmp, 10);
-            assert(fancy_string_equals_value(s, "hello"));
+            // NOTE: Null characters are copied like any other byte (i.e., all `n` bytes are kept).
+            fancy_string_t *s = fancy_string_from_copied_memory(tmp, 8);
+            assert(fancy_string_size(s) == 8);
+            assert(fancy_string_starts_with_value(s, "hello"));
+            assert(!fancy_string_equals_value(s, "hello"));
             fancy_string_destroy(s);
         }
     }
@@ -36,6 +36,20 @@
 #include <stddef.h>
 #include <sys/types.h>
 
+// -----------------------------------------------
+//                     MACROS
+// -----------------------------------------------
+
+/**
+ * @brief Expands to a string literal followed by its length (computed at compile time), which
+ * is meant to be used with the `_n` variants of the library's methods (e.g.,
+ * `fancy_string_equals_value_n(s, FANCY_STRING_LIT("hello"))`), such that the length of literal
+ * arguments does not need to be computed at run time.
+ * @param literal A string literal (anything else fails to compile).
+ * @see fancy_string_equals_value_n, fancy_string_append_value_n
+ */
+#define FANCY_STRING_LIT(literal) ("" literal ""), (sizeof(literal) - 1)
+
 // -----------------------------------------------
 //                  OPAQUE TYPES
 // -----------------------------------------------
@@ -81,6 +95,58 @@ typedef struct fancy_string_array_s fancy_string_array_t;
  */
 typedef struct fancy_string_regex_s fancy_string_regex_t;
 
+/**
+ * @brief The opaque type used to represent a "pattern object", which holds a regular expression
+ * that has been compiled once, such that it can be matched against many strings without
+ * compiling it again.
+ * @note Since the \ref fancy_string_pattern_t type is opaque, the only
+ * way to work with it is through a pointer whose memory
+ * has been heap-allocated by \ref fancy_string_pattern_create().
+ * @warning Once the pattern object is no longer needed, it is the application's job to call
+ * \ref fancy_string_pattern_destroy() to free the memory.
+ * @see fancy_string_pattern_create, fancy_string_pattern_destroy, fancy_string_regex_create_with_pattern
+ */
+typedef struct fancy_string_pattern_s fancy_string_pattern_t;
+
+/**
+ * @brief An opaque type that reads a stream line by line through an internal buffer
+ * that is reused from one line to the next, and which is passed to the library's
+ * "line reader" methods.
+ * @note Since the \ref fancy_string_line_reader_t type is opaque, the only
+ * way to work with it is through a pointer whose memory
+ * has been heap-allocated by \ref fancy_string_line_reader_create().
+ * @warning Once the line reader object is no longer needed, it is the application's job to call
+ * \ref fancy_string_line_reader_destroy() to free the internal buffer's memory.
+ * @see fancy_string_line_reader_destroy, fancy_string_line_reader_create
+ */
+typedef struct fancy_string_line_reader_s fancy_string_line_reader_t;
+
+/**
+ * @brief The opaque type used to represent a "searcher object", which holds a needle
+ * along with the tables that were precomputed for it, such that it can be searched
+ * for inside many strings (or many times inside the same string) without redoing that work.
+ * @note Since the \ref fancy_string_searcher_t type is opaque, the only
+ * way to work with it is through a pointer whose memory
+ * has been heap-allocated by \ref fancy_string_searcher_create().
+ * @warning Once the searcher object is no longer needed, it is the application's job to call
+ * \ref fancy_string_searcher_destroy() to free the memory.
+ * @see fancy_string_searcher_create, fancy_string_searcher_destroy
+ */
+typedef struct fancy_string_searcher_s fancy_string_searcher_t;
+
+/**
+ * @brief The opaque type used to represent a "multi matcher object", which holds a list of needles
+ * compiled into a single automaton, such that all of them can be searched for (or replaced) in a
+ * single pass over a string.
+ * @note Since the \ref fancy_string_multi_matcher_t type is opaque, the only
+ * way to work with it is through a pointer whose memory
+ * has been heap-allocated by \ref fancy_string_multi_matcher_create().
+ * @warning Once the multi matcher object is no longer needed, it is the application's job to call
+ * \ref fancy_string_multi_matcher_destroy() to free the memory.
+ * @see fancy_string_multi_matcher_create, fancy_string_multi_matcher_destroy
+ */
+typedef struct fancy_string_multi_matcher_s fancy_string_multi_matcher_t;
+
 /**
  * @brief A type (i.e., a structure), returned by the \ref fancy_string_regex_match_info_for_index()
  * method, containing information about a particular match.
@@ -108,6 +174,156 @@ typedef struct fancy_string_regex_match_info_s
     size_t end;
 } fancy_string_regex_match_info_t;
 
+/**
+ * @brief A type (i.e., a structure) describing a borrowed, read-only view on \p n bytes of memory
+ * (e.g., a string object's internal value, or a part of it).
+ * @note A view does not own the memory it points to, and creating or copying one never allocates. It
+ * is typically obtained through \ref fancy_string_view(), \ref fancy_string_view_from_value() or
+ * \ref fancy_string_view_from_memory(), and passed by value.
+ * @warning A view is only valid as long as the memory it points to is. For instance, a view on a string
+ * object's internal value becomes invalid as soon as that string object is modified or destroyed.
+ * @see fancy_string_view, fancy_string_from_view
+ */
+typedef struct fancy_string_view_s
+{
+    /**
+     * @brief A pointer to the first byte of the view.
+     * @note The view is not necessarily null-terminated.
+     */
+    char const *value;
+    /**
+     * @brief The number of bytes in the view.
+     */
+    size_t n;
+} fancy_string_view_t;
+
+/**
+ * @brief A type (i.e., a structure) that splits a string lazily, one component at a time, such that
+ * the components that are never asked for are never searched for.
+ * @note A split iterator is obtained through \ref fancy_string_split_iter() or \ref fancy_string_split_iter_by_pattern(),
+ * and is typically kept on the stack: it is not heap-allocated, so there is nothing to destroy. Its components
+ * are returned by \ref fancy_string_split_iter_next() as views, such that iterating never allocates.
+ * @warning The fields are internal, and should only be accessed through the iterator's methods. The iterator
+ * (and the components it returns) are only valid as long as the string object (and the pattern object)
+ * it was obtained from is not modified or destroyed.
+ * @see fancy_string_split_iter, fancy_string_split_iter_by_pattern, fancy_string_split_iter_next
+ */
+typedef struct fancy_string_split_iter_s
+{
+    char const *value;
+    size_t n;
+    char const *separator;
+    size_t n_separator;
+    fancy_string_pattern_t const *pattern;
+    size_t n_splits;
+    ssize_t n_max_splits;
+    size_t position;
+    bool is_done;
+} fancy_string_split_iter_t;
+
+/**
+ * @brief A type (i.e., a structure), returned by the \ref fancy_string_regex_cache_stats()
+ * method, containing a snapshot of the state of the compiled patterns cache.
+ * @see fancy_string_regex_cache_stats, fancy_string_regex_cache_set_capacity
+ */
+typedef struct fancy_string_regex_cache_stats_s
+{
+    /**
+     * @brief The maximum number of compiled patterns kept by the cache (`0` meaning that the cache is disabled).
+     */
+    size_t capacity;
+    /**
+     * @brief The number of compiled patterns currently kept by the cache.
+     */
+    size_t size;
+    /**
+     * @brief The number of times that a pattern was found in the cache (i.e., was not compiled again).
+     */
+    size_t n_hits;
+    /**
+     * @brief The number of times that a pattern was not found in the cache, and had to be compiled.
+     */
+    size_t n_misses;
+    /**
+     * @brief The number of compiled patterns that were removed from the cache to make room for other ones
+     * (i.e., the least recently used ones), or because its capacity was reduced.
+     */
+    size_t n_evictions;
+} fancy_string_regex_cache_stats_t;
+
+/**
+ * @brief An enumeration whose members describe the prefilter of a compiled pattern (see
+ * \ref fancy_string_pattern_prefilter_kind()), i.e., what every one of its matches is known to contain, and is
+ * searched for before (internally) calling \ref regexec().
+ * @see fancy_string_pattern_prefilter_kind, fancy_string_pattern_prefilter_stats
+ */
+typedef enum fancy_string_prefilter_kind_e
+{
+    /**
+     * @brief The pattern has no prefilter (e.g., it uses alternation at its top level, or is case-insensitive),
+     * such that \ref regexec() is always called.
+     */
+    FANCY_STRING_PREFILTER_KIND_NONE,
+    /**
+     * @brief Every match contains a literal substring of the pattern (e.g., `"error: "` for `"error: [0-9]+"`).
+     */
+    FANCY_STRING_PREFILTER_KIND_LITERAL,
+    /**
+     * @brief Every match contains one of a set of bytes (e.g., a digit for `"[0-9]+"`).
+     */
+    FANCY_STRING_PREFILTER_KIND_BYTE_SET,
+} fancy_string_prefilter_kind_t;
+
+/**
+ * @brief A type (i.e., a structure), returned by the \ref fancy_string_pattern_prefilter_stats() and
+ * \ref fancy_string_regex_prefilter_stats() methods, containing the counters of a prefilter.
+ * @see fancy_string_pattern_prefilter_stats, fancy_string_regex_prefilter_stats
+ */
+typedef struct fancy_string_prefilter_stats_s
+{
+    /**
+     * @brief The number of times that the prefilter was searched for (i.e., before a call to \ref regexec()).
+     */
+    size_t n_checks;
+    /**
+     * @brief The number of times that the prefilter was not found, such that \ref regexec() was not called.
+     */
+    size_t n_rejections;
+    /**
+     * @brief The number of bytes that were skipped (i.e., not given to \ref regexec()) because the
+     * prefilter, which every match starts with, was only found after them.
+     */
+    size_t n_skipped_bytes;
+} fancy_string_prefilter_stats_t;
+
+/**
+ * @brief An enumeration whose members can be used to select, through the \ref fancy_string_pattern_create_with_engine()
+ * method, the regex engine used by a pattern object.
+ * @see fancy_string_pattern_create_with_engine, fancy_string_pattern_engine
+ */
+typedef enum fancy_string_regex_engine_e
+{
+    /**
+     * @brief Matches using the system's POSIX regex implementation (i.e., \ref regcomp() and \ref regexec()).
+     * This is the default.
+     */
+    FANCY_STRING_REGEX_ENGINE_POSIX,
+    /**
+     * @brief Matches using the library's built-in engine, which runs the pattern as an automaton (i.e., a DFA
+     * built lazily from the pattern's NFA), such that there is no backtracking (e.g., `(x+x+)+y` does not take
+     * exponential time). The matches are the same as those of \ref FANCY_STRING_REGEX_ENGINE_POSIX (i.e., the
+     * leftmost-longest ones).
+     * @note The engine supports the extended regular expressions (EREs) made of literals, escaped special
+     * characters, `.`, bracket expressions (with character classes), groups, alternations, the `*`, `+`, `?`
+     * and `{m,n}` quantifiers, and the `^` and `$` anchors, in single-byte locales (e.g., the "C" locale). It
+     * does not support back-references and the GNU extensions (e.g., `\\w` or `\\b`), nor quantified groups
+     * that contain `^` or `$` (e.g., `(^a|b)+`), for which glibc does not always enforce the anchor. Nothing may
+     * precede a `^`, and nothing may follow a `$`, in their alternative, nor in the ones that contain their groups
+     * (e.g., `b$.`, `.^c` and `(b|$)[^a]` are not supported), since glibc matches them around newlines otherwise.
+     */
+    FANCY_STRING_REGEX_ENGINE_DFA,
+} fancy_string_regex_engine_t;
+
 /**
  * @brief An enumeration whose members can be used to specify, through the \ref fancy_string_memory_usage_init()
  * static method, the memory usage tracking mode to be used by the library. By default,
@@ -146,6 +362,34 @@ typedef enum fancy_string_memory_usage_mode_e
     FANCY_STRING_MEMORY_USAGE_MODE_GLOBAL_SYNC
 } fancy_string_memory_usage_mode_t;
 
+/**
+ * @brief An enumeration whose members can be passed to \ref fancy_string_from_file_mapped() and
+ * \ref fancy_string_from_fd_mapped() to tell the operating system how the mapped memory is going to be
+ * accessed (internally, they are forwarded to \ref posix_madvise() ).
+ * @see fancy_string_from_file_mapped, fancy_string_from_fd_mapped
+ */
+typedef enum fancy_string_map_advice_e
+{
+    /**
+     * @brief No particular advice (i.e., the operating system's default behaviour).
+     */
+    FANCY_STRING_MAP_ADVICE_NORMAL,
+    /**
+     * @brief The memory will be accessed sequentially (e.g., when searching or splitting the
+     * whole file from start to end), such that aggressive read-ahead is beneficial.
+     */
+    FANCY_STRING_MAP_ADVICE_SEQUENTIAL,
+    /**
+     * @brief The memory will be accessed in random order, such that read-ahead is not beneficial.
+     */
+    FANCY_STRING_MAP_ADVICE_RANDOM,
+    /**
+     * @brief The whole memory will be needed soon, such that the operating system may start
+     * reading it in ahead of time.
+     */
+    FANCY_STRING_MAP_ADVICE_WILLNEED
+} fancy_string_map_advice_t;
+
 // -----------------------------------------------
 //                     MISC
 // -----------------------------------------------
@@ -243,13 +487,12 @@ fancy_string_t *fancy_string_create(char const *const value);
  * @param n The number of bytes to be copied from the memory pointed to by \p pointer .
  * @return \ref fancy_string_t* A pointer to the created string object.
  * @see fancy_string_create, fancy_string_create_empty
- * @note Internally, this method temporarily allocates `sizeof(char*) * (n + 1)` bytes and
- * uses them to make a copy of \p pointer 's first \p n bytes using \ref memcpy , and then
- * adds the null character `\0` to it, and passes that temporary null-terminated string
- * to \ref fancy_string_create to create the string object.
- * Obviously, this method should only be used when a null-terminated
- * string is not already available to be passed to \ref fancy_string_create directly, or when
- * only a specific segment of a string is needed.
+ * @note The \p n bytes are copied (once) directly inside the new string object, and a null
+ * character `\0` is added after them. Null characters found among the \p n bytes are kept
+ * as is (i.e., string objects are binary-safe, since all of the library's methods rely on the
+ * string object's size rather than on its first null character), which makes this method the
+ * way to create string objects from binary data. This method is also useful when only a
+ * specific segment of a string is needed.
  * @par Example:
  * @include examples/fancy_string_from_copied_memory.c
  */
@@ -261,18 +504,103 @@ fancy_string_t *fancy_string_from_copied_memory(void const *const pointer, size_
  * @param stream A pointer to readable stream (e.g., a file pointer that has
  * been opened for reading).
  * @return \ref fancy_string_t* A pointer to the created string object.
- * @note Internally, this method calls \ref fgetc() repeatedly until \ref EOF is reached,
- * after which it calls \ref fclose() to close the stream. This method assumes that \p value
- * has been opened for reading.
- * @see fancy_string_from_stream_next_line, fancy_string_create
+ * @note Internally, this method reads \p stream in large blocks using \ref fread() until
+ * \ref EOF is reached, after which it calls \ref fclose() to close the stream. When \p stream
+ * is backed by a regular file, the internal buffer is sized up front (using \ref fstat()),
+ * such that a single allocation is made. This method assumes that \p stream has been
+ * opened for reading.
+ * @see fancy_string_from_stream_without_closing, fancy_string_from_stream_next_line, fancy_string_create
  * @warning - Trying to read from \p stream if the latter has not been opened with
  * read permission will crash the application.
- * @warning - Internally, this method makes calls to \ref getc_unlocked() until
- * \ref EOF is returned, but the method does not bother setting nor checking (and resetting)
- * \ref errno before and after calling \ref getc_unlocked().
+ * @warning - Internally, this method makes calls to \ref fread() until
+ * \ref EOF is reached, but the method does not bother setting nor checking (and resetting)
+ * \ref errno before and after calling \ref fread().
  */
 fancy_string_t *fancy_string_from_stream(FILE *stream);
 
+/**
+ * @brief Same as \ref fancy_string_from_stream(), except that \p stream is left open, such that
+ * the application remains responsible for closing it.
+ * @param stream A pointer to readable stream (e.g., a file pointer that has
+ * been opened for reading).
+ * @return \ref fancy_string_t* A pointer to the created string object. If \p stream is \ref NULL ,
+ * an empty string object is returned.
+ * @note Reading starts at the stream's current position.
+ * @see fancy_string_from_stream
+ */
+fancy_string_t *fancy_string_from_stream_without_closing(FILE *stream);
+
+/**
+ * @brief Instantiates a read-only string object whose internal state is the content of the
+ * file located at \p path , which gets mapped into memory (using \ref mmap() ) instead of being
+ * copied into heap-allocated memory.
+ * @param path The path (i.e., a pointer to a null-terminated string) of the file to be mapped.
+ * @param advice A value indicating how the mapped memory is going to be accessed (see
+ * \ref fancy_string_map_advice_t ).
+ * @return \ref fancy_string_t* A pointer to the created string object, or the \ref NULL pointer if the file
+ * could not be opened or mapped (or if it is not a regular file).
+ * @note The returned string object can be used with all of the library's methods. Non-mutating methods
+ * (e.g., \ref fancy_string_index_of_value(), \ref fancy_string_split(), \ref fancy_string_regex_create(), etc.)
+ * read the mapped memory directly, and \ref fancy_string_clone() returns a string object that references the
+ * same mapping. The first call to a mutating method (e.g., \ref fancy_string_append_value() ) makes a
+ * heap-allocated copy of the content, after which the string object behaves like any other string object. The
+ * file is unmapped once the last string object referencing it has been destroyed or mutated.
+ * @warning If the file gets truncated by another process while it is mapped, accessing the string object
+ * may crash the application (i.e., `SIGBUS`).
+ * @see fancy_string_from_fd_mapped, fancy_string_is_mapped, fancy_string_from_stream
+ */
+fancy_string_t *fancy_string_from_file_mapped(char const *const path, fancy_string_map_advice_t advice);
+
+/**
+ * @brief Same as \ref fancy_string_from_file_mapped(), except that the file is specified through
+ * an open file descriptor.
+ * @param fd A file descriptor, opened for reading, that refers to a regular file. The method
+ * does not close \p fd (which may be closed as soon as the method returns).
+ * @param advice A value indicating how the mapped memory is going to be accessed (see
+ * \ref fancy_string_map_advice_t ).
+ * @return \ref fancy_string_t* A pointer to the created string object, or the \ref NULL pointer if the file
+ * could not be mapped (or if it is not a regular file).
+ * @note The whole file is mapped, regardless of \p fd 's current offset.
+ * @see fancy_string_from_file_mapped, fancy_string_is_mapped
+ */
+fancy_string_t *fancy_string_from_fd_mapped(int fd, fancy_string_map_advice_t advice);
+
+/**
+ * @brief Checks whether the string object's internal state still lives inside a memory-mapped file (i.e.,
+ * whether it has not been copied yet by a mutating method).
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @return \ref bool A value that is `true` if the string object's internal state is memory-mapped (else it is `false`).
+ * @see fancy_string_from_file_mapped, fancy_string_from_fd_mapped, fancy_string_is_shared
+ */
+bool fancy_string_is_mapped(fancy_string_t const *const self);
+
+/**
+ * @brief Switches the string object to "shared mode", in which its internal value is stored inside a
+ * reference-counted, read-only buffer, such that cloning it (e.g., through \ref fancy_string_clone() or
+ * \ref fancy_string_array_get()) only increments a reference count instead of copying the value.
+ * @param self A pointer to the \ref fancy_string_t instance to be shared.
+ * @note Switching to shared mode costs one copy of the internal value. Afterwards, the string object
+ * and all of its clones keep on sharing the same buffer until they get mutated, at which point the
+ * mutated string object makes its own copy (i.e., copy-on-write) and leaves shared mode.
+ * @note The reference count is atomic, so clones of a shared string object can be used (and destroyed)
+ * on different threads. Calling this method on a string object that is already in shared mode (or that
+ * is memory-mapped) does nothing.
+ * @warning Like any other mutating method, this method must not be called while \p self is being
+ * accessed by another thread.
+ * @see fancy_string_is_shared, fancy_string_array_share
+ */
+void fancy_string_share(fancy_string_t *const self);
+
+/**
+ * @brief Checks whether the string object's internal value lives inside a shared, read-only buffer
+ * (i.e., whether cloning it is an O(1) operation).
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @return \ref bool A value that is `true` if the string object is in shared mode or memory-mapped (else
+ * it is `false`).
+ * @see fancy_string_share, fancy_string_is_mapped
+ */
+bool fancy_string_is_shared(fancy_string_t const *const self);
+
 /**
  * @brief Reads the next line from the \p stream and
  * instantiates a string object with internal state set as the "line" that
@@ -293,6 +621,92 @@ fancy_string_t *fancy_string_from_stream(FILE *stream);
  */
 fancy_string_t *fancy_string_from_stream_next_line(FILE *stream);
 
+/**
+ * @brief Instantiates a line reader object that reads \p stream in large blocks
+ * and hands out its lines one at a time, through \ref fancy_string_line_reader_next() or
+ * \ref fancy_string_line_reader_next_borrowed().
+ * @param stream A pointer to a readable stream (e.g., a file pointer that has
+ * been opened for reading).
+ * @return \ref fancy_string_line_reader_t* A pointer to the created line reader object.
+ * @see fancy_string_line_reader_destroy, fancy_string_line_reader_next, fancy_string_from_stream_next_line
+ * @note Unlike \ref fancy_string_from_stream_next_line(), which makes one call to \ref getline()
+ * and one allocation per line, the line reader fills a single internal buffer using \ref fread()
+ * and only grows it when a line does not fit inside of it.
+ * @note When \p stream is not a regular file (e.g., a pipe or a terminal), the buffer is only filled
+ * up to the next line break, such that each line is returned as soon as it has been written, rather
+ * than once a whole block of input is available.
+ * @warning The line reader does not close \p stream , and since it reads ahead, the position of
+ * \p stream no longer corresponds to the end of the last line that was returned.
+ */
+fancy_string_line_reader_t *fancy_string_line_reader_create(FILE *stream);
+
+/**
+ * @brief Frees the memory used by the line reader object.
+ * @param self A pointer to the \ref fancy_string_line_reader_t instance to be destroyed.
+ * @see fancy_string_line_reader_create
+ * @note The stream from which the line reader was reading is left open.
+ */
+void fancy_string_line_reader_destroy(fancy_string_line_reader_t *const self);
+
+/**
+ * @brief Reads the next line and stores it inside \p line , whose internal buffer is
+ * reused whenever it is large enough.
+ * @param self A pointer to the \ref fancy_string_line_reader_t instance from which to read.
+ * @param line A pointer to the \ref fancy_string_t instance whose internal value is replaced
+ * by the line that was read.
+ * @return \ref bool A value that is `true` if a line was read, or `false` if the end of the
+ * stream has been reached (in which case \p line is left unchanged).
+ * @see fancy_string_line_reader_next_borrowed
+ * @note The line break (i.e., `\n` or `\r\n`) is not part of the line. If the stream does not
+ * end with a line break, the last line is returned anyway.
+ */
+bool fancy_string_line_reader_next(fancy_string_line_reader_t *const self, fancy_string_t *const line);
+
+/**
+ * @brief Same as \ref fancy_string_line_reader_next(), except that no copy is made: \p value is
+ * set to point to the line inside the line reader's internal buffer, and \p n to its length.
+ * @param self A pointer to the \ref fancy_string_line_reader_t instance from which to read.
+ * @param value A pointer that is set to the (null-terminated) line that was read.
+ * @param n A pointer that is set to the length of the line that was read.
+ * @return \ref bool A value that is `true` if a line was read, or `false` if the end of the
+ * stream has been reached.
+ * @see fancy_string_line_reader_next
+ * @warning The memory pointed to by \p value belongs to the line reader, and it is only valid
+ * until the next call to one of the line reader's methods.
+ */
+bool fancy_string_line_reader_next_borrowed(fancy_string_line_reader_t *const self, char const **value, size_t *n);
+
+/**
+ * @brief Same as \ref fancy_string_line_reader_next_borrowed(), except that the line is returned
+ * as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_line_reader_t instance from which to read.
+ * @param line A pointer to the \ref fancy_string_view_t that is set to the line that was read.
+ * @return \ref bool A value that is `true` if a line was read, or `false` if the end of the
+ * stream has been reached (in which case \p line is left unchanged).
+ * @see fancy_string_line_reader_next_borrowed
+ * @warning The memory that \p line points to belongs to the line reader, and it is only valid
+ * until the next call to one of the line reader's methods.
+ */
+bool fancy_string_line_reader_next_view(fancy_string_line_reader_t *const self, fancy_string_view_t *const line);
+
+/**
+ * @brief Gets the number of the last line that was read, starting at `1`.
+ * @param self A pointer to the \ref fancy_string_line_reader_t instance to be checked.
+ * @return \ref size_t The number of the last line that was read, or `0` if no line has been read yet.
+ * @see fancy_string_line_reader_offset
+ */
+size_t fancy_string_line_reader_line_number(fancy_string_line_reader_t const *const self);
+
+/**
+ * @brief Gets the byte offset of the start of the last line that was read, relative to the
+ * position of the stream when the line reader was created.
+ * @param self A pointer to the \ref fancy_string_line_reader_t instance to be checked.
+ * @return \ref size_t The byte offset of the start of the last line that was read (`0` if no
+ * line has been read yet).
+ * @see fancy_string_line_reader_line_number
+ */
+size_t fancy_string_line_reader_offset(fancy_string_line_reader_t const *const self);
+
 /**
  * @brief Similarly to \ref fancy_string_create(), instantiates
  * a string object, but repeats the initial value the specified number
@@ -316,6 +730,9 @@ fancy_string_t *fancy_string_create_empty(void);
  * @brief Creates a memory-independent copy of the \ref fancy_string_t instance (i.e., \p self ).
  * @param self A pointer to the \ref fancy_string_t instance to be cloned.
  * @return \ref fancy_string_t* A memory-independent copy of \p self .
+ * @note If \p self is in shared mode (see \ref fancy_string_share()) or memory-mapped, the clone
+ * references the same read-only buffer (which makes cloning O(1)), and only copies it when it gets
+ * mutated.
  */
 fancy_string_t *fancy_string_clone(fancy_string_t const *const self);
 
@@ -336,6 +753,7 @@ void fancy_string_destroy(fancy_string_t *const self);
  * @param debug Whether to use the debug format (`true`) or not (`false`). With the debug
  * format, in addition to printing the data itself, information the container and the data
  * size is also printed, while the standard format simply writes the string data as is.
+ * @note The string data is written using \ref fwrite(), such that null characters are written too.
  * @see fancy_string_array_print
  */
 void fancy_string_print(fancy_string_t const *const self, FILE *stream, bool debug);
@@ -357,6 +775,9 @@ bool fancy_string_is_empty(fancy_string_t const *const self);
 /**
  * @brief Clears the internal string data (i.e., makes \p self an empty string object).
  * @param self A pointer to the \ref fancy_string_t instance to be cleared (i.e., emptied).
+ * @note The internal buffer is kept (i.e., \ref fancy_string_capacity() is unchanged), such that
+ * refilling the string object does not require a new allocation. Use \ref fancy_string_shrink_to_fit()
+ * if that memory should be released.
  */
 void fancy_string_clear(fancy_string_t *const self);
 
@@ -371,6 +792,16 @@ void fancy_string_clear(fancy_string_t *const self);
  */
 void fancy_string_update_value(fancy_string_t *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_update_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance whose value needs updating.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @see fancy_string_update_value
+ */
+void fancy_string_update_value_n(fancy_string_t *const self, char const *const value, size_t n_value);
+
 /**
  * @brief Updates the internal state of the string object using that of another string object (i.e., \p string ).
  * @param self A pointer to the \ref fancy_string_t instance whose value needs updating.
@@ -384,12 +815,45 @@ void fancy_string_update(fancy_string_t *const self, fancy_string_t const *const
  * @param self A pointer to the \ref fancy_string_t instance for which a copy of the internal state is requested.
  * @return \ref char* A pointer to a heap-allocated copy of the string object's internal
  * state (i.e., a pointer to a null-terminated string).
+ * @note If the string object contains null characters, the copy contains them too, such that
+ * \ref fancy_string_size() should be used to get its actual length.
  * @warning Calling this method creates an heap-alloacted copy of the string object's internal
  * state, such that it becomes the application's responsibility to free that memory (using the
  * standard library's \ref free() function) once it is no longer needed.
  */
 char *fancy_string_value(fancy_string_t const *const self);
 
+/**
+ * @brief Returns the number of characters that the string object can hold before its
+ * internal buffer needs to be re-allocated (not counting the terminating null character).
+ * @param self A pointer to the \ref fancy_string_t instance for which the capacity is to be returned.
+ * @return \ref size_t A value that is always greater than or equal to \ref fancy_string_size() .
+ * @see fancy_string_reserve, fancy_string_shrink_to_fit
+ */
+size_t fancy_string_capacity(fancy_string_t const *const self);
+
+/**
+ * @brief Makes sure that the string object can hold at least \p capacity characters
+ * without having to re-allocate its internal buffer.
+ * @param self A pointer to the \ref fancy_string_t instance for which to reserve memory.
+ * @param capacity The minimum number of characters (not counting the terminating null character)
+ * that the string object should be able to hold. If \p capacity is smaller than or equal to the
+ * current capacity, this method does nothing.
+ * @note Appending methods such as \ref fancy_string_append_value() already grow the internal buffer
+ * geometrically, so calling this method is never required, but it can save a few re-allocations
+ * when the final size is known in advance (e.g., when assembling a message from many fragments).
+ * @see fancy_string_capacity, fancy_string_shrink_to_fit
+ */
+void fancy_string_reserve(fancy_string_t *const self, size_t capacity);
+
+/**
+ * @brief Releases the unused part of the string object's internal buffer, such that its
+ * capacity becomes equal to its size.
+ * @param self A pointer to the \ref fancy_string_t instance to be shrunk.
+ * @see fancy_string_capacity, fancy_string_reserve
+ */
+void fancy_string_shrink_to_fit(fancy_string_t *const self);
+
 /**
  * @brief Appends a (string) value to the current string object's internal state.
  * @param self A pointer to the \ref fancy_string_t instance to which to append a copy
@@ -400,6 +864,16 @@ char *fancy_string_value(fancy_string_t const *const self);
  */
 void fancy_string_append_value(fancy_string_t *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_append_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to which to append a copy of \p value .
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @see fancy_string_append_value
+ */
+void fancy_string_append_value_n(fancy_string_t *const self, char const *const value, size_t n_value);
+
 /**
  * @brief Appends a string object's data (in this case \p string ) to the current string
  * object's internal state (i.e., to \p self ).
@@ -420,6 +894,16 @@ void fancy_string_append(fancy_string_t *const self, fancy_string_t const *const
  */
 void fancy_string_prepend_value(fancy_string_t *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_prepend_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to which to prepend a copy of \p value .
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @see fancy_string_prepend_value
+ */
+void fancy_string_prepend_value_n(fancy_string_t *const self, char const *const value, size_t n_value);
+
 /**
  * @brief Prepends a string object's data (in this case \p string ) to the current
  * string object's internal state (i.e., to \p self ).
@@ -440,6 +924,26 @@ void fancy_string_prepend(fancy_string_t *const self, fancy_string_t const *cons
  */
 bool fancy_string_equals_value(fancy_string_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_equals_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance for which to check for equality.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref bool A value indicating whether equality was found (`true`) or not (`false`).
+ * @see fancy_string_equals_value
+ */
+bool fancy_string_equals_value_n(fancy_string_t const *const self, char const *const value, size_t n_value);
+
+/**
+ * @brief Same as \ref fancy_string_equals_value_n(), except that the value is given as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param view The \ref fancy_string_view_t against which to check for equality.
+ * @return \ref bool A value indicating whether equality was found (`true`) or not (`false`).
+ * @see fancy_string_equals_value_n
+ */
+bool fancy_string_equals_view(fancy_string_t const *const self, fancy_string_view_t view);
+
 /**
  * @brief Checks whether the string object's internal value equals to \p string 's internal value.
  * @param self A pointer to the \ref fancy_string_t instance for which to check for equality.
@@ -460,6 +964,26 @@ bool fancy_string_equals(fancy_string_t const *const self, fancy_string_t const
  */
 bool fancy_string_starts_with_value(fancy_string_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_starts_with_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref bool A value indicating whether the object's data starts with \p value (`true`) or not (`false`).
+ * @see fancy_string_starts_with_value
+ */
+bool fancy_string_starts_with_value_n(fancy_string_t const *const self, char const *const value, size_t n_value);
+
+/**
+ * @brief Same as \ref fancy_string_starts_with_value_n(), except that the value is given as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param view The \ref fancy_string_view_t against which to check for "leading equality".
+ * @return \ref bool A value indicating whether the object's data starts with \p view (`true`) or not (`false`).
+ * @see fancy_string_starts_with_value_n
+ */
+bool fancy_string_starts_with_view(fancy_string_t const *const self, fancy_string_view_t view);
+
 /**
  * @brief Checks whether the string object's internal value starts with \p string 's internal value.
  * @param self A pointer to the \ref fancy_string_t instance to be checked.
@@ -482,6 +1006,26 @@ bool fancy_string_starts_with(fancy_string_t const *const self, fancy_string_t c
  */
 bool fancy_string_ends_with_value(fancy_string_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_ends_with_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref bool A value indicating whether the object's data ends with \p value (`true`) or not (`false`).
+ * @see fancy_string_ends_with_value
+ */
+bool fancy_string_ends_with_value_n(fancy_string_t const *const self, char const *const value, size_t n_value);
+
+/**
+ * @brief Same as \ref fancy_string_ends_with_value_n(), except that the value is given as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param view The \ref fancy_string_view_t against which to check for "trailing equality".
+ * @return \ref bool A value indicating whether the object's data ends with \p view (`true`) or not (`false`).
+ * @see fancy_string_ends_with_value_n
+ */
+bool fancy_string_ends_with_view(fancy_string_t const *const self, fancy_string_view_t view);
+
 /**
  * @brief Checks whether the string object's internal value ends with \p string 's internal value.
  * @param self A pointer to the \ref fancy_string_t instance to be checked.
@@ -501,10 +1045,33 @@ bool fancy_string_ends_with(fancy_string_t const *const self, fancy_string_t con
  * @param value The value (i.e., a pointer to a null-terminated string) whose first occurrence
  * is being sought inside the string object's data.
  * @return \ref ssize_t The index of the first match, if any. If none, `-1` will be returned.
+ * @note On x86-64, short values (up to 32 bytes) are searched for using SSE2 or AVX2 instructions (depending on
+ * what the processor supports), unless the library was built using the `FANCY_STRING_SIMD_FEATURE_ENABLED=0`
+ * preprocessor flag.
  * @see fancy_string_index_of
  */
 ssize_t fancy_string_index_of_value(fancy_string_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_index_of_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance in which to search.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref ssize_t The index of the first match, if any. If none, `-1` will be returned.
+ * @see fancy_string_index_of_value
+ */
+ssize_t fancy_string_index_of_value_n(fancy_string_t const *const self, char const *const value, size_t n_value);
+
+/**
+ * @brief Same as \ref fancy_string_index_of_value_n(), except that the value is given as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_t instance in which to search.
+ * @param view The \ref fancy_string_view_t whose first occurrence is being sought inside \p self .
+ * @return \ref ssize_t The index of the first match, if any. If none, `-1` will be returned.
+ * @see fancy_string_index_of_value_n
+ */
+ssize_t fancy_string_index_of_view(fancy_string_t const *const self, fancy_string_view_t view);
+
 /**
  * @brief Finds and returns the index of the first occurrence of \p string 's internal value
  * in \p self 's internal value, if any.
@@ -517,6 +1084,50 @@ ssize_t fancy_string_index_of_value(fancy_string_t const *const self, char const
  */
 ssize_t fancy_string_index_of(fancy_string_t const *const self, fancy_string_t const *const string);
 
+/**
+ * @brief Finds and returns the index of the last occurrence of \p value in the string object's
+ * internal value, if any.
+ * @param self A pointer to the \ref fancy_string_t instance for which to find the last matching index
+ * for \p value .
+ * @param value The value (i.e., a pointer to a null-terminated string) whose last occurrence
+ * is being sought inside the string object's data.
+ * @return \ref ssize_t The index of the last match, if any. If none, `-1` will be returned.
+ * @see fancy_string_last_index_of, fancy_string_index_of_value
+ */
+ssize_t fancy_string_last_index_of_value(fancy_string_t const *const self, char const *const value);
+
+/**
+ * @brief Same as \ref fancy_string_last_index_of_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance in which to search.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref ssize_t The index of the last match, if any. If none, `-1` will be returned.
+ * @see fancy_string_last_index_of_value
+ */
+ssize_t fancy_string_last_index_of_value_n(fancy_string_t const *const self, char const *const value, size_t n_value);
+
+/**
+ * @brief Same as \ref fancy_string_last_index_of_value_n(), except that the value is given as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_t instance in which to search.
+ * @param view The \ref fancy_string_view_t whose last occurrence is being sought inside \p self .
+ * @return \ref ssize_t The index of the last match, if any. If none, `-1` will be returned.
+ * @see fancy_string_last_index_of_value_n
+ */
+ssize_t fancy_string_last_index_of_view(fancy_string_t const *const self, fancy_string_view_t view);
+
+/**
+ * @brief Finds and returns the index of the last occurrence of \p string 's internal value
+ * in \p self 's internal value, if any.
+ * @param self A pointer to the \ref fancy_string_t instance for which to find the last matching index
+ * for \p string 's internal value.
+ * @param string A pointer to another \ref fancy_string_t instance whose internal value
+ * is being sought inside \p self 's internal data.
+ * @return \ref ssize_t The index of the last match, if any. If none, `-1` will be returned.
+ * @see fancy_string_last_index_of_value, fancy_string_index_of
+ */
+ssize_t fancy_string_last_index_of(fancy_string_t const *const self, fancy_string_t const *const string);
+
 /**
  * @brief Checks whether the string object's data contains at least one occurrence of \p value .
  * @param self A pointer to the \ref fancy_string_t instance to be checked.
@@ -526,6 +1137,26 @@ ssize_t fancy_string_index_of(fancy_string_t const *const self, fancy_string_t c
  */
 bool fancy_string_contains_value(fancy_string_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_contains_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref bool A boolean value indicating whether \p value was found (`true`) or not (`false`).
+ * @see fancy_string_contains_value
+ */
+bool fancy_string_contains_value_n(fancy_string_t const *const self, char const *const value, size_t n_value);
+
+/**
+ * @brief Same as \ref fancy_string_contains_value_n(), except that the value is given as a \ref fancy_string_view_t .
+ * @param self A pointer to the \ref fancy_string_t instance to be checked.
+ * @param view The \ref fancy_string_view_t for which to check inside \p self .
+ * @return \ref bool A boolean value indicating whether \p view was found (`true`) or not (`false`).
+ * @see fancy_string_contains_value_n
+ */
+bool fancy_string_contains_view(fancy_string_t const *const self, fancy_string_view_t view);
+
 /**
  * @brief Checks whether the string object's data contains at least one occurrence of \p string 's
  * internal value.
@@ -607,6 +1238,49 @@ void fancy_string_trim(fancy_string_t *const self);
  */
 fancy_string_t *fancy_string_trimmed(fancy_string_t const *const self);
 
+/**
+ * @brief Same as \ref fancy_string_trimmed(), except that no copy is made: the returned view
+ * points inside \p self 's internal value.
+ * @param self A pointer to the \ref fancy_string_t instance for which to create a trimmed view.
+ * @return \ref fancy_string_view_t A view on \p self 's internal value, without its leading and
+ * trailing white spaces.
+ * @see fancy_string_trimmed, fancy_string_view_trimmed
+ * @warning The returned view becomes invalid as soon as \p self is modified or destroyed.
+ */
+fancy_string_view_t fancy_string_trimmed_view(fancy_string_t const *const self);
+
+/**
+ * @brief Trims (i.e., removes all the characters that belong to \p charset from) both the right and left-hand sides of the
+ * string object's internal value.
+ * @param self A pointer to the \ref fancy_string_t instance to be trimmed.
+ * @param charset A value (i.e., a pointer to a null-terminated string) whose characters are the ones to be removed
+ * (e.g., `" \t\r\n"`, or `"0"` for removing the leading and trailing zeros).
+ * @note The set is turned into a byte lookup table once per call, such that each character is tested in O(1), whatever
+ * the size of \p charset .
+ * @see fancy_string_trim_chars_n, fancy_string_trimmed_chars, fancy_string_trim
+ */
+void fancy_string_trim_chars(fancy_string_t *const self, char const *const charset);
+
+/**
+ * @brief Same as \ref fancy_string_trim_chars(), except that the length of \p charset is given by \p n_charset (i.e., \p charset
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be trimmed.
+ * @param charset A pointer to the first of the \p n_charset bytes of the set.
+ * @param n_charset The number of bytes pointed to by \p charset .
+ * @see fancy_string_trim_chars
+ */
+void fancy_string_trim_chars_n(fancy_string_t *const self, char const *const charset, size_t n_charset);
+
+/**
+ * @brief Creates a version of the string object with all the leading and trailing characters that belong to \p charset removed.
+ * @param self A pointer to the \ref fancy_string_t instance for which to create a trimmed copy.
+ * @param charset See \ref fancy_string_trim_chars().
+ * @return \ref fancy_string_t* A pointer to a new, memory-independent string object that
+ * is the same as \p self , except that it has been trimmed at both the right and the left.
+ * @see fancy_string_trim_chars
+ */
+fancy_string_t *fancy_string_trimmed_chars(fancy_string_t const *const self, char const *const charset);
+
 /**
  * @brief Splits the string into an array (i.e., a list) of string objects based on the \p separator .
  * @param self A pointer to the \ref fancy_string_t instance whose internal string is to
@@ -622,6 +1296,18 @@ fancy_string_t *fancy_string_trimmed(fancy_string_t const *const self);
  */
 fancy_string_array_t *fancy_string_split_by_value(fancy_string_t const *const self, char const *const separator, ssize_t n_max_splits);
 
+/**
+ * @brief Same as \ref fancy_string_split_by_value(), except that the length of \p separator is given by \p n_separator (i.e., \p separator
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be split.
+ * @param separator A pointer to the first of the \p n_separator bytes of the value.
+ * @param n_separator The number of bytes pointed to by \p separator .
+ * @param n_max_splits See \ref fancy_string_split_by_value().
+ * @return \ref fancy_string_array_t* A pointer to the array object containing the resulting fragments.
+ * @see fancy_string_split_by_value
+ */
+fancy_string_array_t *fancy_string_split_by_value_n(fancy_string_t const *const self, char const *const separator, size_t n_separator, ssize_t n_max_splits);
+
 /**
  * @brief Splits the string into an array (i.e., a list) of string objects based on the \p separator string object's
  * internal value.
@@ -639,6 +1325,95 @@ fancy_string_array_t *fancy_string_split_by_value(fancy_string_t const *const se
  */
 fancy_string_array_t *fancy_string_split(fancy_string_t const *const self, fancy_string_t const *const separator, ssize_t n_max_splits);
 
+/**
+ * @brief Splits the string into an array (i.e., a list) of string objects, using each of the characters that belong
+ * to \p charset as a separator (e.g., `",;| \t"`).
+ * @param self A pointer to the \ref fancy_string_t instance whose internal string is to be split.
+ * @param charset A value (i.e., a pointer to a null-terminated string) whose characters are the separators.
+ * @param n_max_splits See \ref fancy_string_split().
+ * @return \ref fancy_string_array_t* A pointer to a newly created, memory-independent array
+ * object containing the "splitted" string components.
+ * @note Like with \ref fancy_string_split(), consecutive separators give empty components. The string is scanned
+ * once, with a byte lookup table (classifying 16 or 32 bytes at a time where SIMD instructions are available),
+ * whatever the size of \p charset .
+ * @see fancy_string_split_by_any_n, fancy_string_split
+ */
+fancy_string_array_t *fancy_string_split_by_any(fancy_string_t const *const self, char const *const charset, ssize_t n_max_splits);
+
+/**
+ * @brief Same as \ref fancy_string_split_by_any(), except that the length of \p charset is given by \p n_charset (i.e., \p charset
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be split.
+ * @param charset A pointer to the first of the \p n_charset bytes of the set.
+ * @param n_charset The number of bytes pointed to by \p charset .
+ * @param n_max_splits See \ref fancy_string_split().
+ * @return \ref fancy_string_array_t* A pointer to the array object containing the resulting fragments.
+ * @see fancy_string_split_by_any
+ */
+fancy_string_array_t *fancy_string_split_by_any_n(fancy_string_t const *const self, char const *const charset, size_t n_charset, ssize_t n_max_splits);
+
+/**
+ * @brief Same as \ref fancy_string_split(), except that the string objects of the resulting array are slices of
+ * a single (shared) copy of \p self , and are themselves stored inside a single block of memory.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal string is to be split.
+ * @param separator A \ref fancy_string_view_t on the value to be used as the splitting pattern.
+ * @param n_max_splits See \ref fancy_string_split().
+ * @return \ref fancy_string_array_t* A pointer to an array object containing the same components as the
+ * one returned by \ref fancy_string_split() .
+ * @note Whatever the number of components, the result takes a constant number of allocations (instead of
+ * one per component), which makes this method a better fit for splitting large inputs. The array object is
+ * in shared mode (see \ref fancy_string_array_share()), and behaves like any other array object (e.g., it is
+ * freed by a single call to \ref fancy_string_array_destroy()).
+ * @note The copy of \p self is only freed once all the components (and their clones) have been destroyed, such
+ * that keeping a single component around keeps the whole copy in memory.
+ * @see fancy_string_split, fancy_string_split_iter
+ */
+fancy_string_array_t *fancy_string_split_arena(fancy_string_t const *const self, fancy_string_view_t separator, ssize_t n_max_splits);
+
+/**
+ * @brief Creates an iterator that lazily splits the string based on \p separator (i.e., each call to
+ * \ref fancy_string_split_iter_next() only searches for the next separator).
+ * @param self A pointer to the \ref fancy_string_t instance whose internal string is to be split.
+ * @param separator A \ref fancy_string_view_t on the value to be used as the splitting pattern.
+ * @param n_max_splits See \ref fancy_string_split().
+ * @return \ref fancy_string_split_iter_t An iterator whose components are the same as those of the
+ * array object returned by \ref fancy_string_split() .
+ * @note Creating the iterator does not allocate, and neither does iterating, which makes it a better
+ * fit than \ref fancy_string_split() when only a few components are needed (e.g., the third field).
+ * @warning Neither \p self nor the memory \p separator points to may be modified or destroyed while the
+ * iterator is in use.
+ * @see fancy_string_split_iter_next, fancy_string_split
+ */
+fancy_string_split_iter_t fancy_string_split_iter(fancy_string_t const *const self, fancy_string_view_t separator, ssize_t n_max_splits);
+
+/**
+ * @brief Creates an iterator that lazily splits the string at the matches of \p pattern (i.e., each call to
+ * \ref fancy_string_split_iter_next() only searches for the next match).
+ * @param self A pointer to the \ref fancy_string_t instance whose internal string is to be split.
+ * @param pattern A pointer to the \ref fancy_string_pattern_t instance whose matches are used as separators.
+ * @param n_max_splits See \ref fancy_string_split().
+ * @return \ref fancy_string_split_iter_t An iterator whose components are the same as those of the
+ * array object returned by \ref fancy_string_regex_split_at_matches() for a regular expression object created
+ * by \ref fancy_string_regex_create_with_pattern() (with at most \p n_max_splits matches).
+ * @note Neither creating the iterator nor iterating allocates, and each call to \ref fancy_string_split_iter_next()
+ * only searches the input that follows the previous match up to where the next match is known (i.e., usually
+ * up to its end), rather than the whole remainder.
+ * @warning Neither \p self nor \p pattern may be modified or destroyed while the iterator is in use.
+ * @see fancy_string_split_iter_next, fancy_string_regex_split_at_matches
+ */
+fancy_string_split_iter_t fancy_string_split_iter_by_pattern(fancy_string_t const *const self, fancy_string_pattern_t const *const pattern, ssize_t n_max_splits);
+
+/**
+ * @brief Gets the next component of the split iterator.
+ * @param self A pointer to the \ref fancy_string_split_iter_t instance to be advanced.
+ * @param component A pointer to the \ref fancy_string_view_t that is set to the next component.
+ * @return \ref bool A value that is `true` if there was a next component, or `false` if all the
+ * components have been returned already (in which case \p component is left unchanged).
+ * @note Each call only scans the next component (and the separator that follows it).
+ * @see fancy_string_split_iter, fancy_string_split_iter_by_pattern
+ */
+bool fancy_string_split_iter_next(fancy_string_split_iter_t *const self, fancy_string_view_t *const component);
+
 /**
  * @brief Pads the left-hand side of the string with the specified character (i.e., \p value ).
  * @param self A pointer to the \ref fancy_string_t instance whose internal data is to be left-padded.
@@ -697,6 +1472,19 @@ fancy_string_t *fancy_string_padded_end(fancy_string_t const *const self, size_t
  */
 void fancy_string_replace_value(fancy_string_t *const self, char const *const old_value, char const *const new_value, ssize_t replace_n);
 
+/**
+ * @brief Same as \ref fancy_string_replace_value(), except that the lengths of \p old_value and \p new_value are given by \p n_old_value and
+ * \p n_new_value (i.e., they do not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance whose value is to be updated.
+ * @param old_value A pointer to the first of the \p n_old_value bytes of the value.
+ * @param n_old_value The number of bytes pointed to by \p old_value .
+ * @param new_value A pointer to the first of the \p n_new_value bytes of the value.
+ * @param n_new_value The number of bytes pointed to by \p new_value .
+ * @param replace_n See \ref fancy_string_replace_value().
+ * @see fancy_string_replace_value
+ */
+void fancy_string_replace_value_n(fancy_string_t *const self, char const *const old_value, size_t n_old_value, char const *const new_value, size_t n_new_value, ssize_t replace_n);
+
 /**
  * @brief Replaces the specified number of occurrences (i.e., \p replace_n ) of \p old_substring 's internal
  * value with \p new_substring 's internal value in the string object's internal data.
@@ -726,6 +1514,20 @@ void fancy_string_replace(fancy_string_t *const self, fancy_string_t const *cons
  */
 fancy_string_t *fancy_string_replaced_value(fancy_string_t const *const self, char const *const old_value, char const *const new_value, ssize_t replace_n);
 
+/**
+ * @brief Same as \ref fancy_string_replaced_value(), except that the lengths of \p old_value and \p new_value are given by \p n_old_value and
+ * \p n_new_value (i.e., they do not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_t instance to be copied.
+ * @param old_value A pointer to the first of the \p n_old_value bytes of the value.
+ * @param n_old_value The number of bytes pointed to by \p old_value .
+ * @param new_value A pointer to the first of the \p n_new_value bytes of the value.
+ * @param n_new_value The number of bytes pointed to by \p new_value .
+ * @param replace_n See \ref fancy_string_replaced_value().
+ * @return \ref fancy_string_t* A pointer to the new string object.
+ * @see fancy_string_replaced_value
+ */
+fancy_string_t *fancy_string_replaced_value_n(fancy_string_t const *const self, char const *const old_value, size_t n_old_value, char const *const new_value, size_t n_new_value, ssize_t replace_n);
+
 /**
  * @brief Creates a string object with the specified number of occurrences
  * (i.e., \p replace_n ) of \p old_substring 's internal value replaced with \p new_substring 's internal value.
@@ -745,11 +1547,10 @@ fancy_string_t *fancy_string_replaced(fancy_string_t const *const self, fancy_st
  * @brief Applies a lowercase transformation to the string object's internal data.
  * @param self A pointer to the \ref fancy_string_t instance whose internal data is
  * to be lowercased.
- * @note Internally, this method uses the \ref tolower() function defined in the C Standard
- * Library \ref ctype.h header file. This means, among other things, that lowercasing of accented
- * characters may not behave as expected. For instance, depending on the implementation, a character
- * such as `À` will likely not be transformed to `à`.
- * @see fancy_string_lowercased
+ * @note Only the ASCII letters are transformed, in place, and independently of the current
+ * locale, which means that every other byte (e.g., those of the UTF-8 encoded character `À`)
+ * is left untouched. Use \ref fancy_string_lowercase_locale for a locale-aware transformation.
+ * @see fancy_string_lowercased, fancy_string_lowercase_locale
  */
 void fancy_string_lowercase(fancy_string_t *const self);
 
@@ -760,23 +1561,45 @@ void fancy_string_lowercase(fancy_string_t *const self);
  * to be copied and then lowercased.
  * @return \ref fancy_string_t* A pointer to a newly created, memory-independent string object
  * that contains a lowercased version of \p self 's internal data.
- * @note Internally, this method uses the \ref tolower() function defined in the C Standard
- * Library \ref ctype.h header file. This means, among other things, that lowercasing of accented
- * characters may not behave as expected. For instance, depending on the implementation, a character
- * such as `À` will likely not be transformed to `à`.
- * @see fancy_string_lowercase
+ * @note Only the ASCII letters are transformed (see \ref fancy_string_lowercase).
+ * @see fancy_string_lowercase, fancy_string_lowercased_locale
  */
 fancy_string_t *fancy_string_lowercased(fancy_string_t const *const self);
 
+/**
+ * @brief Applies a lowercase transformation to the string object's internal data,
+ * according to the current locale.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal data is
+ * to be lowercased.
+ * @note Internally, this method uses the \ref tolower() function defined in the C Standard
+ * Library \ref ctype.h header file, one byte at a time, which makes it noticeably slower than
+ * \ref fancy_string_lowercase. This means, among other things, that only single-byte locales
+ * are supported. For instance, a UTF-8 encoded character such as `À` will not be transformed to `à`.
+ * @see fancy_string_lowercased_locale, fancy_string_lowercase
+ */
+void fancy_string_lowercase_locale(fancy_string_t *const self);
+
+/**
+ * @brief Creates a new string object whose internal data corresponds
+ * to a copy of \p self with a lowercase transformation performed on it,
+ * according to the current locale.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal data is
+ * to be copied and then lowercased.
+ * @return \ref fancy_string_t* A pointer to a newly created, memory-independent string object
+ * that contains a lowercased version of \p self 's internal data.
+ * @note See \ref fancy_string_lowercase_locale.
+ * @see fancy_string_lowercase_locale, fancy_string_lowercased
+ */
+fancy_string_t *fancy_string_lowercased_locale(fancy_string_t const *const self);
+
 /**
  * @brief Applies an uppercase transformation to the string object's internal data.
  * @param self A pointer to the \ref fancy_string_t instance whose internal data is
  * to be uppercased.
- * @note Internally, this method uses the \ref toupper() function defined in the C Standard
- * Library \ref ctype.h header file. This means, among other things, that uppercasing of accented
- * characters may not behave as expected. For instance, depending on the implementation, a character
- * such as `à` will likely not be transformed to `À`.
- * @see fancy_string_uppercased
+ * @note Only the ASCII letters are transformed, in place, and independently of the current
+ * locale, which means that every other byte (e.g., those of the UTF-8 encoded character `à`)
+ * is left untouched. Use \ref fancy_string_uppercase_locale for a locale-aware transformation.
+ * @see fancy_string_uppercased, fancy_string_uppercase_locale
  */
 void fancy_string_uppercase(fancy_string_t *const self);
 
@@ -787,14 +1610,37 @@ void fancy_string_uppercase(fancy_string_t *const self);
  * to be copied and then uppercased.
  * @return \ref fancy_string_t* A pointer to a newly created, memory-independent string object
  * that contains an uppercased version of \p self 's internal data.
- * @note Internally, this method uses the \ref toupper() function defined in the C Standard
- * Library \ref ctype.h header file. This means, among other things, that uppercasing of accented
- * characters may not behave as expected. For instance, depending on the implementation, a character
- * such as `à` will likely not be transformed to `À`.
- * @see fancy_string_uppercase
+ * @note Only the ASCII letters are transformed (see \ref fancy_string_uppercase).
+ * @see fancy_string_uppercase, fancy_string_uppercased_locale
  */
 fancy_string_t *fancy_string_uppercased(fancy_string_t const *const self);
 
+/**
+ * @brief Applies an uppercase transformation to the string object's internal data,
+ * according to the current locale.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal data is
+ * to be uppercased.
+ * @note Internally, this method uses the \ref toupper() function defined in the C Standard
+ * Library \ref ctype.h header file, one byte at a time, which makes it noticeably slower than
+ * \ref fancy_string_uppercase. This means, among other things, that only single-byte locales
+ * are supported. For instance, a UTF-8 encoded character such as `à` will not be transformed to `À`.
+ * @see fancy_string_uppercased_locale, fancy_string_uppercase
+ */
+void fancy_string_uppercase_locale(fancy_string_t *const self);
+
+/**
+ * @brief Creates a new string object whose internal data corresponds
+ * to a copy of \p self with an uppercase transformation performed on it,
+ * according to the current locale.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal data is
+ * to be copied and then uppercased.
+ * @return \ref fancy_string_t* A pointer to a newly created, memory-independent string object
+ * that contains an uppercased version of \p self 's internal data.
+ * @note See \ref fancy_string_uppercase_locale.
+ * @see fancy_string_uppercase_locale, fancy_string_uppercased
+ */
+fancy_string_t *fancy_string_uppercased_locale(fancy_string_t const *const self);
+
 /**
  * @brief Appends a line break character (i.e., `\\n`) at the end of the object's
  * internal string data.
@@ -807,6 +1653,298 @@ fancy_string_t *fancy_string_uppercased(fancy_string_t const *const self);
  */
 void fancy_string_line_break(fancy_string_t *const self, bool with_carriage_return);
 
+// -----------------------------------------------
+//                  VIEW (methods)
+// -----------------------------------------------
+
+/**
+ * @brief Creates a view on the string object's internal value.
+ * @param self A pointer to the \ref fancy_string_t instance on which to create a view.
+ * @return \ref fancy_string_view_t A view on \p self 's internal value.
+ * @see fancy_string_from_view
+ * @warning The returned view becomes invalid as soon as \p self is modified or destroyed.
+ */
+fancy_string_view_t fancy_string_view(fancy_string_t const *const self);
+
+/**
+ * @brief Creates a view on a null-terminated string.
+ * @param value The value (i.e., a pointer to a null-terminated string) on which to create a view.
+ * @return \ref fancy_string_view_t A view on \p value (the null character is not part of it).
+ * @see fancy_string_view_from_memory
+ */
+fancy_string_view_t fancy_string_view_from_value(char const *const value);
+
+/**
+ * @brief Creates a view on \p n bytes of memory.
+ * @param value A pointer to the first of the \p n bytes of memory (which does not need to be
+ * null-terminated, and may contain null characters).
+ * @param n The number of bytes pointed to by \p value .
+ * @return \ref fancy_string_view_t A view on \p value .
+ * @see fancy_string_view_from_value
+ */
+fancy_string_view_t fancy_string_view_from_memory(char const *const value, size_t n);
+
+/**
+ * @brief Instantiates a string object whose internal value is a copy of the view's bytes.
+ * @param view The \ref fancy_string_view_t to be copied.
+ * @return \ref fancy_string_t* A pointer to the created, memory-independent string object.
+ * @see fancy_string_view
+ * @warning Once the string object is no longer needed, it is the application's job to call
+ * \ref fancy_string_destroy() to free the memory.
+ */
+fancy_string_t *fancy_string_from_view(fancy_string_view_t view);
+
+/**
+ * @brief Same as \ref fancy_string_substring(), except that no copy is made: the returned view
+ * points inside \p view .
+ * @param view The \ref fancy_string_view_t for which to create a substring.
+ * @param start The start index of the substring. If this value is set to `-1`, the start index will be `0`.
+ * @param end The end index (not included) of the substring. If this value is set to `-1`, the end index
+ * will be the view's size.
+ * @return \ref fancy_string_view_t A view on the specified substring.
+ * @note The \p start and \p end index values are handled in the same permissive way as by
+ * \ref fancy_string_substring(). If the specified range is completely out of bounds, an empty
+ * view is returned.
+ * @see fancy_string_substring
+ */
+fancy_string_view_t fancy_string_view_substring(fancy_string_view_t view, ssize_t start, ssize_t end);
+
+/**
+ * @brief Creates a view with all the leading and trailing white spaces of \p view removed.
+ * @param view The \ref fancy_string_view_t to be trimmed.
+ * @return \ref fancy_string_view_t A view that points inside \p view .
+ * @see fancy_string_trimmed_view
+ */
+fancy_string_view_t fancy_string_view_trimmed(fancy_string_view_t view);
+
+/**
+ * @brief Checks whether two views have the same bytes.
+ * @param view The first \ref fancy_string_view_t to compare.
+ * @param other The second \ref fancy_string_view_t to compare.
+ * @return \ref bool A value indicating whether equality was found (`true`) or not (`false`).
+ * @see fancy_string_equals_view
+ */
+bool fancy_string_view_equals(fancy_string_view_t view, fancy_string_view_t other);
+
+/**
+ * @brief Checks whether \p view starts with \p prefix .
+ * @param view The \ref fancy_string_view_t to be checked.
+ * @param prefix The \ref fancy_string_view_t against which to check for "leading equality".
+ * @return \ref bool A value indicating whether \p view starts with \p prefix (`true`) or not (`false`).
+ * @see fancy_string_starts_with_view
+ */
+bool fancy_string_view_starts_with(fancy_string_view_t view, fancy_string_view_t prefix);
+
+/**
+ * @brief Checks whether \p view ends with \p suffix .
+ * @param view The \ref fancy_string_view_t to be checked.
+ * @param suffix The \ref fancy_string_view_t against which to check for "trailing equality".
+ * @return \ref bool A value indicating whether \p view ends with \p suffix (`true`) or not (`false`).
+ * @see fancy_string_ends_with_view
+ */
+bool fancy_string_view_ends_with(fancy_string_view_t view, fancy_string_view_t suffix);
+
+/**
+ * @brief Finds and returns the index of the first occurrence of \p needle in \p view , if any.
+ * @param view The \ref fancy_string_view_t in which to search.
+ * @param needle The \ref fancy_string_view_t whose first occurrence is being sought inside \p view .
+ * @return \ref ssize_t The index of the first match, if any. If none, `-1` will be returned.
+ * @see fancy_string_index_of_view
+ */
+ssize_t fancy_string_view_index_of(fancy_string_view_t view, fancy_string_view_t needle);
+
+// -----------------------------------------------
+//                SEARCHER (methods)
+// -----------------------------------------------
+
+/**
+ * @brief Instantiates a searcher object for \p needle .
+ * @param needle The \ref fancy_string_view_t to be searched for (e.g., obtained through \ref fancy_string_view()
+ * or \ref fancy_string_view_from_value()). Its bytes are copied, so it does not need to outlive the searcher object.
+ * @return \ref fancy_string_searcher_t* A pointer to the created searcher object.
+ * @note The searcher object uses the Boyer-Moore-Horspool algorithm, whose "bad character" tables are computed
+ * once, here. For long needles, this allows skipping up to the needle's size at each step, such that the search
+ * is sublinear on average. Short needles are searched for using \ref memmem().
+ * @warning Once the searcher object is no longer needed, it is the application's job to call
+ * \ref fancy_string_searcher_destroy() to free the memory.
+ * @see fancy_string_searcher_destroy, fancy_string_searcher_find
+ */
+fancy_string_searcher_t *fancy_string_searcher_create(fancy_string_view_t needle);
+
+/**
+ * @brief Frees the memory used by the searcher object.
+ * @param self A pointer to the \ref fancy_string_searcher_t instance to be destroyed.
+ * @see fancy_string_searcher_create
+ */
+void fancy_string_searcher_destroy(fancy_string_searcher_t *const self);
+
+/**
+ * @brief Returns a view on the searcher object's needle.
+ * @param self A pointer to the \ref fancy_string_searcher_t instance whose needle to return.
+ * @return \ref fancy_string_view_t A view on the needle, which remains valid until \p self is destroyed.
+ */
+fancy_string_view_t fancy_string_searcher_needle(fancy_string_searcher_t const *const self);
+
+/**
+ * @brief Finds and returns the index of the first occurrence of the searcher object's needle inside \p haystack , if any.
+ * @param self A pointer to the \ref fancy_string_searcher_t instance to be used.
+ * @param haystack The \ref fancy_string_view_t in which to search (use \ref fancy_string_view() to search
+ * inside a string object).
+ * @return \ref ssize_t The index of the first match, if any. If none (or if the needle is empty), `-1` will be returned.
+ * @see fancy_string_searcher_find_from, fancy_string_searcher_find_last, fancy_string_index_of_view
+ */
+ssize_t fancy_string_searcher_find(fancy_string_searcher_t const *const self, fancy_string_view_t haystack);
+
+/**
+ * @brief Same as \ref fancy_string_searcher_find(), except that the search starts at index \p offset .
+ * @param self A pointer to the \ref fancy_string_searcher_t instance to be used.
+ * @param haystack The \ref fancy_string_view_t in which to search.
+ * @param offset The index at which to start searching. An \p offset that is beyond the end of \p haystack
+ * simply results in no match.
+ * @return \ref ssize_t The index (relative to the beginning of \p haystack ) of the first match found at or
+ * after \p offset , if any. If none, `-1` will be returned.
+ * @see fancy_string_searcher_find
+ */
+ssize_t fancy_string_searcher_find_from(fancy_string_searcher_t const *const self, fancy_string_view_t haystack, size_t offset);
+
+/**
+ * @brief Finds and returns the index of the last occurrence of the searcher object's needle inside \p haystack , if any.
+ * @param self A pointer to the \ref fancy_string_searcher_t instance to be used.
+ * @param haystack The \ref fancy_string_view_t in which to search.
+ * @return \ref ssize_t The index of the last match, if any. If none (or if the needle is empty), `-1` will be returned.
+ * @see fancy_string_searcher_find
+ */
+ssize_t fancy_string_searcher_find_last(fancy_string_searcher_t const *const self, fancy_string_view_t haystack);
+
+/**
+ * @brief Counts the (non-overlapping) occurrences of the searcher object's needle inside \p haystack .
+ * @param self A pointer to the \ref fancy_string_searcher_t instance to be used.
+ * @param haystack The \ref fancy_string_view_t in which to search.
+ * @return \ref size_t The number of occurrences. For instance, `"aa"` occurs twice in `"aaaaa"`.
+ * @see fancy_string_searcher_find
+ */
+size_t fancy_string_searcher_count(fancy_string_searcher_t const *const self, fancy_string_view_t haystack);
+
+// -----------------------------------------------
+//              MULTI MATCHER (methods)
+// -----------------------------------------------
+
+/**
+ * @brief Instantiates a multi matcher object for the needles contained in \p needles .
+ * @param needles A pointer to the \ref fancy_string_array_t instance whose elements are the needles to be
+ * searched for. The needles are copied, so the array object does not need to outlive the multi matcher object.
+ * @return \ref fancy_string_multi_matcher_t* A pointer to the created multi matcher object.
+ * @note The needles are compiled into an Aho-Corasick automaton, whose transitions are stored in a dense table,
+ * such that searching costs a single table lookup per byte of the haystack, no matter how many needles there are.
+ * @note Empty needles never match. If the same needle appears more than once, matches are reported for its
+ * first occurrence only.
+ * @warning Once the multi matcher object is no longer needed, it is the application's job to call
+ * \ref fancy_string_multi_matcher_destroy() to free the memory.
+ * @see fancy_string_multi_matcher_destroy, fancy_string_multi_matcher_find_all, fancy_string_multi_replace
+ */
+fancy_string_multi_matcher_t *fancy_string_multi_matcher_create(fancy_string_array_t const *const needles);
+
+/**
+ * @brief Frees the memory used by the multi matcher object.
+ * @param self A pointer to the \ref fancy_string_multi_matcher_t instance to be destroyed.
+ * @see fancy_string_multi_matcher_create
+ */
+void fancy_string_multi_matcher_destroy(fancy_string_multi_matcher_t *const self);
+
+/**
+ * @brief Returns the number of needles held by the multi matcher object.
+ * @param self A pointer to the \ref fancy_string_multi_matcher_t instance to be used.
+ * @return \ref size_t The number of needles (i.e., the size of the array object it was created from).
+ */
+size_t fancy_string_multi_matcher_size(fancy_string_multi_matcher_t const *const self);
+
+/**
+ * @brief Returns a view on the multi matcher object's needle at position \p index .
+ * @param self A pointer to the \ref fancy_string_multi_matcher_t instance to be used.
+ * @param index The position of the needle in the array object the multi matcher object was created from.
+ * @return \ref fancy_string_view_t A view on the needle, which remains valid until \p self is destroyed. If
+ * \p index is out of bounds, an empty view will be returned.
+ */
+fancy_string_view_t fancy_string_multi_matcher_needle(fancy_string_multi_matcher_t const *const self, size_t index);
+
+/**
+ * @brief The signature a callback function needs to implement to be allowed
+ * to be passed as argument to the \ref fancy_string_multi_matcher_find_all() and
+ * \ref fancy_string_multi_matcher_find_all_in_stream() methods.
+ * @param matcher A pointer to the \ref fancy_string_multi_matcher_t instance that found the match.
+ * @param needle_index The position of the matched needle (see \ref fancy_string_multi_matcher_needle()).
+ * @param start The position of the match's first byte inside the haystack.
+ * @param end The position right after the match's last byte inside the haystack (i.e., `end - start` is
+ * the needle's size).
+ * @param context An application-defined context object.
+ * @return \ref bool `true` to keep searching, or `false` to stop.
+ * @see fancy_string_multi_matcher_find_all
+ */
+typedef bool (*fancy_string_multi_match_t)(fancy_string_multi_matcher_t const *const matcher, size_t needle_index, size_t start, size_t end, void *context);
+
+/**
+ * @brief Finds all the occurrences of the multi matcher object's needles inside \p haystack , in a single pass, and
+ * calls \p fn with each of them.
+ * @param self A pointer to the \ref fancy_string_multi_matcher_t instance to be used.
+ * @param haystack The \ref fancy_string_view_t in which to search (use \ref fancy_string_view() to search
+ * inside a string object).
+ * @param fn A pointer to the function to be called for each match. It may be \ref NULL , in which case the
+ * matches are only counted.
+ * @param context An application-defined context object that will be passed to \p fn .
+ * @return \ref size_t The number of matches that were found (including the one for which \p fn returned `false`, if any).
+ * @note All the occurrences are reported, including overlapping ones (e.g., both `"he"` and `"she"` match inside
+ * `"ushers"`), in the order of their end position. Occurrences that end at the same position are reported from
+ * the longest to the shortest.
+ * @see fancy_string_multi_match_t, fancy_string_multi_matcher_find_all_in_stream
+ */
+size_t fancy_string_multi_matcher_find_all(fancy_string_multi_matcher_t const *const self, fancy_string_view_t haystack, fancy_string_multi_match_t fn, void *context);
+
+/**
+ * @brief Same as \ref fancy_string_multi_matcher_find_all(), except that the haystack is read from \p stream
+ * (block by block, until `EOF` is reached), such that it never needs to be held in memory as a whole.
+ * @param self A pointer to the \ref fancy_string_multi_matcher_t instance to be used.
+ * @param stream A pointer to a valid "readable" stream (e.g., a file opened with \ref fopen()). The stream is
+ * left open.
+ * @param fn A pointer to the function to be called for each match (or \ref NULL ).
+ * @param context An application-defined context object that will be passed to \p fn .
+ * @return \ref size_t The number of matches that were found.
+ * @note The positions passed to \p fn are relative to the stream's position when this method was called. Matches
+ * that straddle two blocks are found too.
+ * @see fancy_string_multi_matcher_find_all
+ */
+size_t fancy_string_multi_matcher_find_all_in_stream(fancy_string_multi_matcher_t const *const self, FILE *stream, fancy_string_multi_match_t fn, void *context);
+
+/**
+ * @brief Replaces the occurrences of the \p matcher 's needles inside the string object with the corresponding
+ * elements of \p replacements , in a single pass.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal value is to be updated.
+ * @param matcher A pointer to the \ref fancy_string_multi_matcher_t instance holding the needles.
+ * @param replacements A pointer to a \ref fancy_string_array_t instance that contains either one replacement
+ * per needle (i.e., needle `i` is replaced with element `i`), or a single element, which is used for all
+ * the needles.
+ * @return \ref ssize_t The number of occurrences that were replaced, or `-1` if the size of \p replacements
+ * is neither `1` nor that of \p matcher (in which case \p self is left untouched).
+ * @note Occurrences are selected from left to right, without overlapping, and when several needles match
+ * at the same position, the longest one is replaced. For instance, with the needles `"ab"`, `"abcd"` and
+ * `"cd"`, `"abcdcd"` has two occurrences: `"abcd"` and `"cd"`.
+ * @note The new value is written into a single buffer, allocated once its size is known.
+ * @see fancy_string_multi_replaced
+ */
+ssize_t fancy_string_multi_replace(fancy_string_t *const self, fancy_string_multi_matcher_t const *const matcher, fancy_string_array_t const *const replacements);
+
+/**
+ * @brief Same as \ref fancy_string_multi_replace(), except that \p self is left untouched and the result
+ * is returned as a new string object.
+ * @param self A pointer to the \ref fancy_string_t instance whose internal value is to be used.
+ * @param matcher A pointer to the \ref fancy_string_multi_matcher_t instance holding the needles.
+ * @param replacements A pointer to a \ref fancy_string_array_t instance that contains either one replacement
+ * per needle, or a single element, which is used for all the needles.
+ * @return \ref fancy_string_t* A pointer to the created string object, or \ref NULL if the size of
+ * \p replacements is neither `1` nor that of \p matcher .
+ * @see fancy_string_multi_replace
+ */
+fancy_string_t *fancy_string_multi_replaced(fancy_string_t const *const self, fancy_string_multi_matcher_t const *const matcher, fancy_string_array_t const *const replacements);
+
 // -----------------------------------------------
 //                  REGEX (methods)
 // -----------------------------------------------
@@ -831,11 +1969,263 @@ void fancy_string_line_break(fancy_string_t *const self, bool with_carriage_retu
  * POSIX functions. \ref regcomp() is called using the `REG_EXTENDED` flag, which means
  * that the [POSIX-Extended Regular Expressions](https://en.wikibooks.org/wiki/Regular_Expressions/POSIX-Extended_Regular_Expressions)
  * syntax is used. Read more: [POSIX Regular Expression](https://www.gnu.org/software/libc/manual/html_node/POSIX-Regexp-Compilation.html)
+ * @note - Where supported (e.g., glibc and the BSDs), \ref regexec() is called with the `REG_STARTEND`
+ * flag, such that \p string may contain null characters. The pattern itself ends at its first null character.
  * @par Example:
  * @include examples/fancy_string_regex_create.c
  */
 fancy_string_regex_t *fancy_string_regex_create(fancy_string_t const *const string, fancy_string_t const *const pattern, ssize_t n_max_matches);
 
+/**
+ * @brief Compiles the \p pattern regular expression into a pattern object, which can then be
+ * used, any number of times, to create regex objects (see \ref fancy_string_regex_create_with_pattern())
+ * or to look for a match (see \ref fancy_string_pattern_find()).
+ * @param pattern A pointer to a \ref fancy_string_t instance containing the regular expression pattern.
+ * @return \ref fancy_string_pattern_t* A pointer to the created pattern object. The \ref NULL pointer will
+ * be returned if \p pattern is empty, or if an error occurs while (internally) calling \ref regcomp().
+ * @note - The pattern is compiled using the same flags as \ref fancy_string_regex_create().
+ * @note - The pattern object is never modified after its creation, such that it can be shared between threads
+ * (e.g., compiled once at startup, and used by all the worker threads): the state of each match lives in the regex
+ * object (or on the stack of the call) that uses it. The exception being that, when the memory usage mode is
+ * \ref FANCY_STRING_MEMORY_USAGE_MODE_THREAD_LOCAL, the pattern object should be destroyed by the thread that created it.
+ * @warning Once the pattern object is no longer needed, it is the application's job to call
+ * \ref fancy_string_pattern_destroy() to free the memory.
+ * @see fancy_string_pattern_destroy, fancy_string_regex_create_with_pattern
+ */
+fancy_string_pattern_t *fancy_string_pattern_create(fancy_string_t const *const pattern);
+
+/**
+ * @brief Same as \ref fancy_string_pattern_create(), but the regex engine used by the pattern object
+ * can be selected.
+ * @param pattern A pointer to a \ref fancy_string_t instance containing the regex pattern to be compiled
+ * (using the `REG_EXTENDED` flag).
+ * @param engine The \ref fancy_string_regex_engine_t to be used.
+ * @return \ref fancy_string_pattern_t* A pointer to the created pattern object. The \ref NULL pointer is returned
+ * if \p pattern is empty or invalid, or if it uses a feature that \p engine does not support (see
+ * \ref FANCY_STRING_REGEX_ENGINE_DFA), in which case \ref FANCY_STRING_REGEX_ENGINE_POSIX can be used instead.
+ * @note - With \ref FANCY_STRING_REGEX_ENGINE_DFA, the automaton's states are built as they are needed by the
+ * searches, and are shared by all of the threads that use the pattern object. A thread that finds them in use
+ * by another thread builds its own (temporary) ones instead of waiting.
+ * @note - With \ref FANCY_STRING_REGEX_ENGINE_DFA, a single search (e.g., \ref fancy_string_pattern_find()) reads
+ * the input a bounded number of times. \ref fancy_string_regex_create_with_pattern() finds where all of the matches
+ * can start with a single scan of the string, then extends each match forward from its start. When these forward
+ * scans read much more than the string (i.e., when the matches are only known well after their end, e.g.,
+ * `"a|a[^z]*z"` on a run of `"a"`), the remaining matches are found the way \ref fancy_string_pattern_find_all()
+ * does (see its notes).
+ * @see fancy_string_pattern_create, fancy_string_pattern_engine
+ */
+fancy_string_pattern_t *fancy_string_pattern_create_with_engine(fancy_string_t const *const pattern, fancy_string_regex_engine_t engine);
+
+/**
+ * @brief Returns the regex engine used by the pattern object.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be inspected.
+ * @return \ref fancy_string_regex_engine_t The pattern object's regex engine.
+ * @see fancy_string_pattern_create_with_engine
+ */
+fancy_string_regex_engine_t fancy_string_pattern_engine(fancy_string_pattern_t const *const self);
+
+/**
+ * @brief Frees the memory used by the pattern object.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be destroyed.
+ * @note The regex objects created using \p self do not depend on it, such that they can outlive it.
+ * @warning The pattern object must not be in use by another thread when it is destroyed.
+ * @see fancy_string_pattern_create
+ */
+void fancy_string_pattern_destroy(fancy_string_pattern_t *const self);
+
+/**
+ * @brief Same as \ref fancy_string_regex_create(), but uses an already compiled pattern
+ * object (see \ref fancy_string_pattern_create()) instead of compiling the pattern again.
+ * @param string A pointer to a \ref fancy_string_t instance containing the string data to be searched.
+ * @param pattern A pointer to the \ref fancy_string_pattern_t instance to be used.
+ * @param n_max_matches A value that can be used to specify a maximum number of matches allowed during the
+ * search. If set `-1`, the search will go on, from left to right, until no more matches are found.
+ * @return \ref fancy_string_regex_t* A pointer to the created regular expression object. Note that if \p string
+ * is empty, this method will return the \ref NULL pointer. The \ref NULL pointer will also be returned if an
+ * error occurs while (internally) calling \ref regexec().
+ * @see fancy_string_regex_create, fancy_string_pattern_find
+ */
+fancy_string_regex_t *fancy_string_regex_create_with_pattern(fancy_string_t const *const string, fancy_string_pattern_t const *const pattern, ssize_t n_max_matches);
+
+/**
+ * @brief Finds the first (non-empty) match of the pattern object inside \p subject , without
+ * allocating any memory (where the `REG_STARTEND` flag is supported, and unless the pattern object uses
+ * \ref FANCY_STRING_REGEX_ENGINE_DFA, whose states are built lazily).
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be used.
+ * @param subject The \ref fancy_string_view_t in which to search (use \ref fancy_string_view() to search
+ * inside a string object).
+ * @return \ref fancy_string_regex_match_info_t The position of the first match, with `.index = 0`. If there is
+ * no such match, `.index` will be set to `-1` (and both `.start` and `.end` will be set to `0`).
+ * @note Empty matches are ignored, just like they are by \ref fancy_string_regex_create().
+ * @see fancy_string_pattern_has_match, fancy_string_regex_create_with_pattern
+ */
+fancy_string_regex_match_info_t fancy_string_pattern_find(fancy_string_pattern_t const *const self, fancy_string_view_t subject);
+
+/**
+ * @brief Checks whether the pattern object has a (non-empty) match inside \p subject .
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be used.
+ * @param subject The \ref fancy_string_view_t in which to search.
+ * @return \ref bool `true` if there is a match, `false` otherwise.
+ * @see fancy_string_pattern_find
+ */
+bool fancy_string_pattern_has_match(fancy_string_pattern_t const *const self, fancy_string_view_t subject);
+
+/**
+ * @brief The signature a callback function needs to implement to be allowed to be passed as argument
+ * to the \ref fancy_string_pattern_find_all(), \ref fancy_string_pattern_find_all_in_stream() and
+ * \ref fancy_string_pattern_find_all_in_fd() methods.
+ * @param pattern A pointer to the \ref fancy_string_pattern_t instance that found the match.
+ * @param start The position of the match's first byte inside the input.
+ * @param end The position right after the match's last byte inside the input.
+ * @param context An application-defined context object.
+ * @return \ref bool `true` to keep searching, or `false` to stop.
+ * @see fancy_string_pattern_find_all
+ */
+typedef bool (*fancy_string_pattern_match_t)(fancy_string_pattern_t const *const pattern, size_t start, size_t end, void *context);
+
+/**
+ * @brief Finds all the (non-empty) matches of the pattern object inside \p subject , from left to right, and
+ * calls \p fn with each of them, without keeping them (or any part of \p subject ) in memory.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be used, which must have been created
+ * with \ref FANCY_STRING_REGEX_ENGINE_DFA.
+ * @param subject The \ref fancy_string_view_t in which to search (e.g., a view on a string object created by
+ * \ref fancy_string_from_file_mapped(), to search inside a mapped file).
+ * @param fn A pointer to the function to be called for each match. It may be \ref NULL , in which case the
+ * matches are only counted.
+ * @param context An application-defined context object that will be passed to \p fn .
+ * @return \ref ssize_t The number of matches that were found (including the one for which \p fn returned `false`,
+ * if any), or `-1` if \p self does not use \ref FANCY_STRING_REGEX_ENGINE_DFA.
+ * @note - The matches are the same as those of \ref fancy_string_regex_create_with_pattern() (with
+ * `n_max_matches = -1`) on a string object holding \p subject .
+ * @note - Between matches, the input is read by the pattern's lazy DFA (see \ref FANCY_STRING_REGEX_ENGINE_DFA),
+ * whose states are made of the automaton's threads that started before the current position, while the input that
+ * precedes the next byte that can start a match (or the next occurrence of the pattern's prefilter, when every match
+ * starts with it) is skipped using the SIMD search kernels. Once a match is reached, it is found the way
+ * \ref fancy_string_regex_create_with_pattern() finds it (i.e., its bytes are read again by the reverse DFA and the
+ * longest-match scan) when this can be done without reading past the end of the block. Otherwise (or when the
+ * pattern contains `^`, or when a match may be empty or begin with an assertion, in which case the DFA is not used),
+ * the input is read again from the last position where no thread was left, byte by byte, by a simulation of the
+ * automaton in which each thread remembers where it started, until no thread is left again. That simulation costs
+ * several times more per byte than the DFA (in proportion to the number of threads, i.e., to the size of the
+ * pattern), such that patterns whose matches are long, dense, or may straddle many blocks are slower to search.
+ * @note - A match is reported once no thread that started before (or at) its start is left. The search for the
+ * next match does not wait for it: the threads that start at or after the end of a pending match carry on with the
+ * following search (e.g., with `"ab|a"`, the input after `"a"` is not read again once it is known that no `"b"`
+ * follows).
+ * @see fancy_string_pattern_match_t, fancy_string_pattern_find_all_in_stream, fancy_string_pattern_find_all_in_fd
+ */
+ssize_t fancy_string_pattern_find_all(fancy_string_pattern_t const *const self, fancy_string_view_t subject, fancy_string_pattern_match_t fn, void *context);
+
+/**
+ * @brief Same as \ref fancy_string_pattern_find_all(), except that the input is read from \p stream (block
+ * by block, until `EOF` is reached), such that it never needs to be held in memory as a whole.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be used, which must have been created
+ * with \ref FANCY_STRING_REGEX_ENGINE_DFA.
+ * @param stream A pointer to a valid "readable" stream (e.g., a file opened with \ref fopen()). The stream is
+ * left open.
+ * @param fn A pointer to the function to be called for each match (or \ref NULL ).
+ * @param context An application-defined context object that will be passed to \p fn .
+ * @return \ref ssize_t The number of matches that were found, or `-1` if \p self does not use
+ * \ref FANCY_STRING_REGEX_ENGINE_DFA or if an error occurs while reading from \p stream (in which case
+ * \p fn may already have been called with the matches found before the error).
+ * @note - The positions passed to \p fn are relative to the stream's position when this method was called. Matches
+ * that straddle two blocks are found too, since the automaton's threads (simulated from the last position where
+ * none was left, see \ref fancy_string_pattern_find_all()) are carried over from one block to the next.
+ * @note - The only input that is kept in memory is the block that is being read. Apart from it, the memory usage
+ * is bounded by the size of the pattern's automaton, plus the positions of the pending matches (i.e., the ones that
+ * a thread that started earlier may still override, e.g., each `"a"` of a run of `"a"` with `"a|a[^z]*z"`, until
+ * a `"z"` or the end of the input is reached).
+ * @see fancy_string_pattern_find_all, fancy_string_pattern_find_all_in_fd
+ */
+ssize_t fancy_string_pattern_find_all_in_stream(fancy_string_pattern_t const *const self, FILE *stream, fancy_string_pattern_match_t fn, void *context);
+
+/**
+ * @brief Same as \ref fancy_string_pattern_find_all_in_stream(), except that the input is read from the \p fd
+ * file descriptor (e.g., a pipe or a socket), until its end is reached.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be used, which must have been created
+ * with \ref FANCY_STRING_REGEX_ENGINE_DFA.
+ * @param fd A file descriptor opened for reading. It is left open.
+ * @param fn A pointer to the function to be called for each match (or \ref NULL ).
+ * @param context An application-defined context object that will be passed to \p fn .
+ * @return \ref ssize_t The number of matches that were found, or `-1` if \p self does not use
+ * \ref FANCY_STRING_REGEX_ENGINE_DFA or if \ref read() fails (for another reason than being interrupted).
+ * @note The positions passed to \p fn are relative to the file descriptor's offset when this method was called.
+ * @see fancy_string_pattern_find_all, fancy_string_pattern_find_all_in_stream
+ */
+ssize_t fancy_string_pattern_find_all_in_fd(fancy_string_pattern_t const *const self, int fd, fancy_string_pattern_match_t fn, void *context);
+
+/**
+ * @brief Sets the capacity of the (process-wide) cache of the patterns compiled by
+ * \ref fancy_string_regex_create(), which is disabled (i.e., has a capacity of `0`) by default.
+ * @param capacity The maximum number of compiled patterns to be kept by the cache. When it is reached,
+ * the least recently used pattern is evicted to make room for the new one. A value of `0` disables
+ * the cache (and frees all of its entries).
+ * @note - When the cache is enabled, \ref fancy_string_regex_create() only compiles a pattern (i.e., calls
+ * \ref regcomp()) if the same pattern (i.e., the same bytes, compiled with the same flags) is not
+ * in the cache already. The results are the same either way.
+ * @note - The cache is protected by a mutex, such that it can be used (and configured) from many threads at once.
+ * Its entries are allocated by whichever thread misses them, and freed by whichever thread evicts them, which
+ * should be kept in mind when the memory usage mode is \ref FANCY_STRING_MEMORY_USAGE_MODE_THREAD_LOCAL.
+ * @see fancy_string_regex_cache_stats, fancy_string_regex_cache_clear, fancy_string_pattern_create
+ */
+void fancy_string_regex_cache_set_capacity(size_t capacity);
+
+/**
+ * @brief Returns a snapshot of the state of the compiled patterns cache (i.e., its capacity, its size,
+ * and its hit, miss and eviction counters).
+ * @return \ref fancy_string_regex_cache_stats_t The cache's current state.
+ * @see fancy_string_regex_cache_set_capacity, fancy_string_regex_cache_clear
+ */
+fancy_string_regex_cache_stats_t fancy_string_regex_cache_stats(void);
+
+/**
+ * @brief Removes (and frees) all of the compiled patterns cache's entries, and resets its counters,
+ * without changing its capacity.
+ * @see fancy_string_regex_cache_set_capacity, fancy_string_regex_cache_stats
+ */
+void fancy_string_regex_cache_clear(void);
+
+/**
+ * @brief Returns the kind of prefilter that was extracted from the pattern object when it was compiled.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be inspected.
+ * @return \ref fancy_string_prefilter_kind_t The kind of the pattern's prefilter.
+ * @note - The prefilter is a literal (or a set of bytes) that every match of the pattern contains. Before
+ * (internally) calling \ref regexec() on some input, the input is searched for the prefilter (which is much
+ * faster), and \ref regexec() is not called at all if it is not found. When every match starts with the
+ * prefilter (e.g., for `"sensor/[a-z]+"`), the input that precedes its first occurrence is also skipped.
+ * @note - The prefilter is only a shortcut: the results are the same as without it.
+ * @see fancy_string_pattern_prefilter_literal, fancy_string_pattern_prefilter_stats
+ */
+fancy_string_prefilter_kind_t fancy_string_pattern_prefilter_kind(fancy_string_pattern_t const *const self);
+
+/**
+ * @brief Returns the literal that every match of the pattern object contains (i.e., the longest one
+ * that could be extracted from the pattern), if its prefilter is a literal.
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be inspected.
+ * @return \ref fancy_string_view_t A view of the literal, which is valid as long as \p self is. If the pattern's
+ * prefilter is not \ref FANCY_STRING_PREFILTER_KIND_LITERAL, the view is empty.
+ * @see fancy_string_pattern_prefilter_kind
+ */
+fancy_string_view_t fancy_string_pattern_prefilter_literal(fancy_string_pattern_t const *const self);
+
+/**
+ * @brief Returns the counters of the pattern object's prefilter, which are updated by every search
+ * made using the pattern object (from any thread).
+ * @param self A pointer to the \ref fancy_string_pattern_t instance to be inspected.
+ * @return \ref fancy_string_prefilter_stats_t The pattern's prefilter counters. Their `.n_rejections / .n_checks`
+ * ratio is the share of the (internal) calls to \ref regexec() that the prefilter avoided.
+ * @see fancy_string_pattern_prefilter_kind, fancy_string_regex_prefilter_stats
+ */
+fancy_string_prefilter_stats_t fancy_string_pattern_prefilter_stats(fancy_string_pattern_t const *const self);
+
+/**
+ * @brief Returns the sums of the prefilter counters of all of the patterns used since the process
+ * started, including the ones compiled (and destroyed) internally by \ref fancy_string_regex_create().
+ * @return \ref fancy_string_prefilter_stats_t The process-wide prefilter counters.
+ * @see fancy_string_pattern_prefilter_stats
+ */
+fancy_string_prefilter_stats_t fancy_string_regex_prefilter_stats(void);
+
 /**
  * @brief Destroys the regular expression object.
  * @param self A pointer to the \ref fancy_string_regex_t instance to be destroyed.
@@ -883,7 +2273,7 @@ fancy_string_t *fancy_string_regex_replaced_matches(fancy_string_regex_t *const
  * to be split into an array object.
  * @return \ref fancy_string_array_t* A pointer to an array object created by splitting the regular
  * expression object's internal string object using the matches as separators.
- * @see fancy_string_split, fancy_string_split_by_value
+ * @see fancy_string_split, fancy_string_split_by_value, fancy_string_split_iter_by_pattern
  */
 fancy_string_array_t *fancy_string_regex_split_at_matches(fancy_string_regex_t const *const self);
 
@@ -936,6 +2326,8 @@ bool fancy_string_regex_max_number_of_matches_reached(fancy_string_regex_t const
  * @param self A pointer to a \ref fancy_string_regex_t instance for which to retrieve the "content string".
  * @return \ref fancy_string_t* A pointer to a memory-independent string object containing a copy of the regular expression object's
  * internal "content string".
+ * @note The regular expression object keeps its copy in shared mode (see \ref fancy_string_share()), so
+ * the returned string object shares its buffer until it gets mutated (i.e., this method is O(1)).
  */
 fancy_string_t *fancy_string_regex_string(fancy_string_regex_t const *const self);
 
@@ -946,6 +2338,8 @@ fancy_string_t *fancy_string_regex_string(fancy_string_regex_t const *const self
  * pattern.
  * @return \ref fancy_string_t* A pointer to a memory-independent string object containing a copy of the regular expression object's
  * internal pattern.
+ * @note The regular expression object keeps its copy in shared mode (see \ref fancy_string_share()), so
+ * the returned string object shares its buffer until it gets mutated (i.e., this method is O(1)).
  */
 fancy_string_t *fancy_string_regex_pattern(fancy_string_regex_t const *const self);
 
@@ -1053,6 +2447,27 @@ fancy_string_array_t *fancy_string_array_create_with_values(char const *const fi
  */
 fancy_string_array_t *fancy_string_array_clone(fancy_string_array_t const *const self);
 
+/**
+ * @brief Switches the array object to "shared mode", in which all of its current and future elements are
+ * in shared mode (see \ref fancy_string_share()), such that accessors such as \ref fancy_string_array_get(),
+ * \ref fancy_string_array_first() and \ref fancy_string_array_last() (as well as \ref fancy_string_array_clone())
+ * no longer copy the elements' values.
+ * @param self A pointer to the \ref fancy_string_array_t instance to be shared.
+ * @note Storing a value inside an array object in shared mode takes one more allocation, so this mode is
+ * best suited for read-mostly arrays. Array objects created by cloning an array object in shared mode are
+ * also in shared mode.
+ * @see fancy_string_array_is_shared, fancy_string_share
+ */
+void fancy_string_array_share(fancy_string_array_t *const self);
+
+/**
+ * @brief Checks whether the array object is in shared mode.
+ * @param self A pointer to the \ref fancy_string_array_t instance to be checked.
+ * @return \ref bool A value that is `true` if the array object is in shared mode (else it is `false`).
+ * @see fancy_string_array_share
+ */
+bool fancy_string_array_is_shared(fancy_string_array_t const *const self);
+
 /**
  * @brief Appends the elements of another array object (i.e., \p array ) into the current
  * array object (i.e., \p self ).
@@ -1132,6 +2547,16 @@ bool fancy_string_array_is_empty(fancy_string_array_t const *const self);
  */
 void fancy_string_array_push_value(fancy_string_array_t *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_array_push_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_array_t instance to which to push a copy of \p value .
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @see fancy_string_array_push_value
+ */
+void fancy_string_array_push_value_n(fancy_string_array_t *const self, char const *const value, size_t n_value);
+
 /**
  * @brief Instantiates a variable number of string objects with internal states set
  * to \p first_value and `...` , and appends those in order at the end of the array object's internal list.
@@ -1272,6 +2697,17 @@ void fancy_string_array_shift_and_destroy(fancy_string_array_t *const self);
  */
 void fancy_string_array_insert_value(fancy_string_array_t *const self, char const *const value, size_t index);
 
+/**
+ * @brief Same as \ref fancy_string_array_insert_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_array_t instance in which to insert a copy of \p value .
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @param index See \ref fancy_string_array_insert_value().
+ * @see fancy_string_array_insert_value
+ */
+void fancy_string_array_insert_value_n(fancy_string_array_t *const self, char const *const value, size_t n_value, size_t index);
+
 /**
  * @brief Inserts a memory-independent copy of the string object \p string at the specified
  * position \p index inside the array object's internal list.
@@ -1341,6 +2777,17 @@ char *fancy_string_array_last_value(fancy_string_array_t const *const self);
  */
 fancy_string_t *fancy_string_array_join_by_value(fancy_string_array_t const *const self, char const *const separator);
 
+/**
+ * @brief Same as \ref fancy_string_array_join_by_value(), except that the length of \p separator is given by \p n_separator (i.e., \p separator
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_array_t instance whose elements are to be joined.
+ * @param separator A pointer to the first of the \p n_separator bytes of the value.
+ * @param n_separator The number of bytes pointed to by \p separator .
+ * @return \ref fancy_string_t* A pointer to the new string object.
+ * @see fancy_string_array_join_by_value
+ */
+fancy_string_t *fancy_string_array_join_by_value_n(fancy_string_array_t const *const self, char const *const separator, size_t n_separator);
+
 /**
  * @brief Creates (and returns a pointer to) a \ref fancy_string_t instance and populates
  * it with copies of the array object's elements' string data, from first to last, using
@@ -1782,6 +3229,17 @@ ssize_t fancy_string_array_index_of(fancy_string_array_t const *const self, fanc
  */
 ssize_t fancy_string_array_index_of_value(fancy_string_array_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_array_index_of_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_array_t instance to be searched.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref ssize_t The index of the first matching element, if any. If none, `-1` will be returned.
+ * @see fancy_string_array_index_of_value
+ */
+ssize_t fancy_string_array_index_of_value_n(fancy_string_array_t const *const self, char const *const value, size_t n_value);
+
 /**
  * @brief Finds the index of the last element in the array object's internal list whose internal value is equal
  * to \p string 's internal value.
@@ -1811,6 +3269,17 @@ ssize_t fancy_string_array_last_index_of(fancy_string_array_t const *const self,
  */
 ssize_t fancy_string_array_last_index_of_value(fancy_string_array_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_array_last_index_of_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_array_t instance to be searched.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref ssize_t The index of the last matching element, if any. If none, `-1` will be returned.
+ * @see fancy_string_array_last_index_of_value
+ */
+ssize_t fancy_string_array_last_index_of_value_n(fancy_string_array_t const *const self, char const *const value, size_t n_value);
+
 /**
  * @brief Checks whether a string object's internal value is contained inside the array object's internal list.
  * @param self A pointer to the \ref fancy_string_array_t instance to be searched for the presence of at least
@@ -1837,4 +3306,15 @@ bool fancy_string_array_includes(fancy_string_array_t const *const self, fancy_s
  */
 bool fancy_string_array_includes_value(fancy_string_array_t const *const self, char const *const value);
 
+/**
+ * @brief Same as \ref fancy_string_array_includes_value(), except that the length of \p value is given by \p n_value (i.e., \p value
+ * does not need to be null-terminated, and may contain null characters).
+ * @param self A pointer to the \ref fancy_string_array_t instance to be searched.
+ * @param value A pointer to the first of the \p n_value bytes of the value.
+ * @param n_value The number of bytes pointed to by \p value .
+ * @return \ref bool A boolean value that indicates whether or not (`true` or `false`) at least one match was found.
+ * @see fancy_string_array_includes_value
+ */
+bool fancy_string_array_includes_value_n(fancy_string_array_t const *const self, char const *const value, size_t n_value);
+
 #endif
@@ -21,24 +21,73 @@
     THE SOFTWARE.
 */
 
+#ifndef _GNU_SOURCE
+// NOTE: Needed for `memmem`.
+#define _GNU_SOURCE
+#endif
+
 #ifndef FANCY_STRING_MEMORY_USAGE_FEATURE_ENABLED
 #define FANCY_STRING_MEMORY_USAGE_FEATURE_ENABLED 1
 #endif
 
+#ifndef FANCY_STRING_SIMD_FEATURE_ENABLED
+#define FANCY_STRING_SIMD_FEATURE_ENABLED 1
+#endif
+
+// NOTE: The SIMD search kernels are only available on x86-64, and they rely on
+// GCC/Clang's `target` attribute and `__builtin_cpu_supports` to pick, at runtime,
+// between AVX2 and SSE2 (which all x86-64 processors support).
+#if (FANCY_STRING_SIMD_FEATURE_ENABLED == 1) && defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FANCY_STRING_SIMD_X86_64 1
+#else
+#define FANCY_STRING_SIMD_X86_64 0
+#endif
+
 #include <ctype.h>
+#include <limits.h>
+#include <locale.h>
 #include <assert.h>
 #include <stdarg.h>
 #include <regex.h>
-#if (FANCY_STRING_MEMORY_USAGE_FEATURE_ENABLED == 1)
-#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdatomic.h>
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+#include <immintrin.h>
 #endif
+#include <pthread.h>
 
 #include "fancy_string.h"
 #include "fancy_memory.h"
 
 #define __FANCY_STRING_LIB_VERSION_MAJOR__ 0
-#define __FANCY_STRING_LIB_VERSION_MINOR__ 1
-#define __FANCY_STRING_LIB_VERSION_REVISION__ 1
+#define __FANCY_STRING_LIB_VERSION_MINOR__ 2
+#define __FANCY_STRING_LIB_VERSION_REVISION__ 0
+
+#define FANCY_STRING_MINIMUM_GROWTH_CAPACITY 15
+#define FANCY_STRING_STREAM_BLOCK_SIZE 65536
+#define FANCY_STRING_MINIMUM_INLINE_CAPACITY 22
+#define FANCY_STRING_ALLOCATION_GRANULE 16
+#define FANCY_STRING_SEARCHER_MINIMUM_SKIP_SIZE 3
+#define FANCY_STRING_SIMD_MAXIMUM_NEEDLE_SIZE 32
+#define FANCY_STRING_MULTI_MATCHER_NONE UINT32_MAX
+#define FANCY_STRING_MULTI_MATCHER_OUTPUT ((uint32_t)1 << 31)
+#define FANCY_STRING_CHARSET_BATCH_SIZE 256
+#define FANCY_STRING_REGEX_MAXIMUM_DEPTH 256
+#define FANCY_STRING_NFA_MAXIMUM_STATES 16384
+#define FANCY_STRING_NFA_NONE UINT32_MAX
+#define FANCY_STRING_DFA_MAXIMUM_STATES 2048
+#define FANCY_STRING_DFA_MAXIMUM_SET_SIZE ((size_t)1 << 20)
+#define FANCY_STRING_DFA_MAXIMUM_READ_FACTOR 2
+#define FANCY_STRING_DFA_MINIMUM_DEAD_RUN 2
+#define FANCY_STRING_DFA_UNKNOWN UINT32_MAX
+#define FANCY_STRING_DFA_DEAD 0
+// NOTE: The size of an array element's slot inside an arena (see `split_arena_memory`), which
+// leaves room for (at least) the inline buffer's null character.
+#define FANCY_STRING_ARRAY_SLOT_SIZE ((sizeof(fancy_string_t) + _Alignof(fancy_string_t)) / _Alignof(fancy_string_t) * _Alignof(fancy_string_t))
 
 #define FANCY_STRING_MEMORY_USAGE_FEATURE_ENABLED_REQUIRED_ERROR_MESSAGE "This method requires that the library has been built using the 'FANCY_STRING_MEMORY_USAGE_FEATURE_ENABLED = 1' preprocessor flag in order to be used."
 
@@ -58,26 +107,645 @@ static void my_free(void *ptr);
 
 static void *my_realloc(void *ptr, size_t size);
 
-static char *copy_value(char const *const value);
+static fancy_string_t *allocate_string(size_t capacity);
+
+static size_t inline_capacity_for(size_t capacity);
+
+static fancy_string_t *create_from_memory(char const *const value, size_t n);
+
+static void update_memory(fancy_string_t *const self, char const *const value, size_t n_value);
+
+static void reserve_capacity(fancy_string_t *const self, size_t n_required);
+
+static void resize_buffer(fancy_string_t *const self, size_t capacity);
+
+static void release_value(fancy_string_t *const self);
+
+static void adopt_buffer(fancy_string_t *const self, char *const value, size_t n);
+
+static bool points_inside_value(fancy_string_t const *const self, char const *const pointer);
+
+static void apply_map_advice(void *address, size_t n, fancy_string_map_advice_t advice);
+
+static void append_memory(fancy_string_t *const self, char const *const value, size_t n_value);
+
+static void prepend_memory(fancy_string_t *const self, char const *const value, size_t n_value);
+
+static bool equals_memory(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static bool starts_with_memory(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static bool ends_with_memory(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static ssize_t index_of_memory(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static ssize_t last_index_of_memory(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static ssize_t last_index_of_memory_scalar(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+static ssize_t index_of_memory_sse2(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static ssize_t last_index_of_memory_sse2(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static ssize_t index_of_memory_avx2(char const *const haystack, size_t n, char const *const value, size_t n_value);
+
+static ssize_t last_index_of_memory_avx2(char const *const haystack, size_t n, char const *const value, size_t n_value);
+#endif
+
+static fancy_string_array_t *split_memory(fancy_string_t const *const self, char const *const separator, size_t n_separator, ssize_t n_max_splits);
+
+static fancy_string_array_t *split_arena_memory(fancy_string_t const *const self, char const *const separator, size_t n_separator, ssize_t n_max_splits);
+
+static void replace_memory(fancy_string_t *const self, char const *const old_value, size_t n_old_value, char const *const new_value, size_t n_new_value, ssize_t replace_n);
+
+static void print_memory(FILE *stream, char const *const value, size_t n);
+
+static void array_push_string(fancy_string_array_t *const self, fancy_string_t *const string);
+
+static void array_insert_string(fancy_string_array_t *const self, fancy_string_t *const string, size_t index);
+
+static bool array_owns_slot(fancy_string_array_t const *const self, fancy_string_t const *const string);
+
+static void array_destroy_element(fancy_string_array_t const *const self, fancy_string_t *const string);
+
+static fancy_string_t *array_join_memory(fancy_string_array_t const *const self, char const *const separator, size_t n_separator);
+
+static int regex_exec(regex_t const *const re, char const *const value, size_t n, regmatch_t *const match);
+
+static fancy_string_pattern_t *compile_pattern(fancy_string_t const *const pattern, int flags);
+
+static fancy_string_pattern_t *pattern_retain(fancy_string_pattern_t *const self);
+
+static void pattern_release(fancy_string_pattern_t *const self);
+
+static void read_stream(fancy_string_t *const self, FILE *stream);
+
+static void line_reader_fill(fancy_string_line_reader_t *const self);
+
+static size_t searcher_hash(char const *const pair_end);
 
-static bool is_whitespace(char *c);
+static void searcher_init(fancy_string_searcher_t *const self, char const *const needle, size_t n);
 
-static void to_lower_or_upper_case(fancy_string_t *const self, bool use_lower);
+static ssize_t searcher_find(fancy_string_searcher_t const *const self, char const *const haystack, size_t n, size_t offset);
+
+static ssize_t searcher_find_last(fancy_string_searcher_t const *const self, char const *const haystack, size_t n);
+
+static void multi_matcher_build(fancy_string_multi_matcher_t *const self);
+
+static bool multi_matcher_scan(fancy_string_multi_matcher_t const *const self, char const *const haystack, size_t n, size_t offset, uint32_t *const row, fancy_string_multi_match_t fn, void *context, size_t *const count);
+
+static size_t multi_replace_memory(fancy_string_multi_matcher_t const *const self, char const *const value, size_t n, fancy_string_array_t const *const replacements, char *const output, size_t *const n_replaced);
+
+static bool is_whitespace(char const *c);
+
+static void whitespace_bounds(fancy_string_t const *const self, bool trim_left, bool trim_right, size_t *const start, size_t *const end);
+
+static void keep_range(fancy_string_t *const self, size_t start, size_t end);
+
+static void pad_memory(fancy_string_t *const self, size_t target_size, char value, bool at_start);
+
+static fancy_string_t *padded_memory(fancy_string_t const *const self, size_t target_size, char value, bool at_start);
+
+static void to_lower_or_upper_case(fancy_string_t *const self, bool use_lower, bool use_locale);
+
+static fancy_string_t *to_lower_or_upper_cased(fancy_string_t const *const self, bool use_lower, bool use_locale);
+
+static void change_case_memory(char *const output, char const *const value, size_t n, bool use_lower, bool use_locale);
+
+static void change_case_memory_scalar(char *const output, char const *const value, size_t n, bool use_lower);
+
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+static void change_case_memory_sse2(char *const output, char const *const value, size_t n, bool use_lower);
+
+static void change_case_memory_avx2(char *const output, char const *const value, size_t n, bool use_lower);
+#endif
 
 // -----------------------------------------------
 //             OPAQUE TYPES DEFINITIONS
 // -----------------------------------------------
 
+// NOTE: A read-only buffer that can be referenced by several string objects at
+// once (e.g., a memory-mapped file, or the shared value of a string object that
+// was passed to `fancy_string_share`). The buffer is released when its last
+// reference goes away.
+typedef struct fancy_string_storage_s
+{
+    _Atomic size_t references;
+    // NOTE: `address` and `length` describe the mapping of a memory-mapped file. For
+    // a shared heap value, `address` is `NULL` and the value is stored in `value`
+    // (i.e., right after the storage itself, in the same block).
+    void *address;
+    size_t length;
+    char value[];
+} fancy_string_storage_t;
+
+static fancy_string_storage_t *storage_retain(fancy_string_storage_t *const storage);
+
+static void storage_release(fancy_string_storage_t *const storage);
+
+static fancy_string_storage_t *create_storage(char const *const value, size_t n);
+
+static void share_value(fancy_string_t *const self);
+
+static fancy_string_t *create_shared_from_memory(char const *const value, size_t n);
+
+static fancy_string_t *create_shared_clone(fancy_string_t const *const string);
+
+static fancy_string_t *create_array_element(fancy_string_array_t const *const self, char const *const value, size_t n);
+
+// NOTE: A set of bytes (e.g., the delimiters given to `fancy_string_split_by_any`), precomputed
+// once per call so that testing a byte is a single lookup. `bits` is a plain bitmap, while
+// `low_nibbles` is what the SIMD kernels use: bit `h % 8` of `low_nibbles[h / 8][l]` is set
+// when the byte `(h << 4) | l` is in the set (see `find_any_memory_ssse3`).
+typedef struct charset_s
+{
+    uint8_t bits[(UCHAR_MAX + 1) / 8];
+    uint8_t low_nibbles[2][16];
+} charset_t;
+
+static void charset_init(charset_t *const self, char const *const chars, size_t n);
+
+static bool charset_contains(charset_t const *const self, char c);
+
+static size_t find_any_memory(char const *const haystack, size_t n, charset_t const *const charset, size_t *const positions, size_t n_max_positions);
+
+static size_t find_any_memory_scalar(char const *const haystack, size_t start, size_t n, charset_t const *const charset, size_t *const positions, size_t n_positions, size_t n_max_positions);
+
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+static size_t find_any_memory_ssse3(char const *const haystack, size_t n, charset_t const *const charset, size_t *const positions, size_t n_max_positions);
+
+static size_t find_any_memory_avx2(char const *const haystack, size_t n, charset_t const *const charset, size_t *const positions, size_t n_max_positions);
+#endif
+
+static fancy_string_array_t *split_any_memory(fancy_string_t const *const self, charset_t const *const charset, ssize_t n_max_splits);
+
+static void charset_bounds(fancy_string_t const *const self, charset_t const *const charset, size_t *const start, size_t *const end);
+
+static void trim_charset(fancy_string_t *const self, charset_t const *const charset);
+
+// NOTE: The (process-wide) cache of the patterns compiled by `fancy_string_regex_create`. The
+// entries are kept in a doubly-linked list, from the most recently used one to the least recently
+// used one (i.e., the next one to be evicted), and in the singly-linked list of their hash table bucket.
+typedef struct regex_cache_entry_s
+{
+    fancy_string_pattern_t *pattern;
+    uint64_t hash;
+    struct regex_cache_entry_s *previous;
+    struct regex_cache_entry_s *next;
+    struct regex_cache_entry_s *next_in_bucket;
+} regex_cache_entry_t;
+
+typedef struct regex_cache_s
+{
+    pthread_mutex_t mutex;
+    regex_cache_entry_t **buckets;
+    size_t n_buckets;
+    regex_cache_entry_t *first;
+    regex_cache_entry_t *last;
+    size_t capacity;
+    size_t size;
+    size_t n_hits;
+    size_t n_misses;
+    size_t n_evictions;
+} regex_cache_t;
+
+static regex_cache_t regex_cache = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+
+static void regex_cache_lock(void);
+
+static void regex_cache_unlock(void);
+
+static uint64_t regex_cache_hash(char const *const value, size_t n, int flags);
+
+static regex_cache_entry_t *regex_cache_find(uint64_t hash, char const *const value, size_t n, int flags);
+
+static void regex_cache_link(regex_cache_entry_t *const entry);
+
+static void regex_cache_unlink(regex_cache_entry_t *const entry);
+
+static void regex_cache_resize(size_t n_buckets);
+
+static regex_cache_entry_t *regex_cache_evict(size_t capacity);
+
+static void regex_cache_release_entries(regex_cache_entry_t *entry);
+
+static fancy_string_pattern_t *regex_cache_acquire(fancy_string_t const *const pattern, int flags);
+
+// NOTE: The prefilter counters of a pattern object (see `pattern_prefilter`), which are updated
+// once per search (i.e., not once per `regexec` call) by whichever thread makes it.
+typedef struct prefilter_counters_s
+{
+    _Atomic size_t n_checks;
+    _Atomic size_t n_rejections;
+    _Atomic size_t n_skipped_bytes;
+} prefilter_counters_t;
+
+// NOTE: The sums of the prefilter counters of all of the pattern objects (see `fancy_string_regex_prefilter_stats`).
+static prefilter_counters_t prefilter_counters;
+
+static void prefilter_counters_add(prefilter_counters_t *const self, fancy_string_prefilter_stats_t const *const stats);
+
+static fancy_string_prefilter_stats_t prefilter_counters_load(prefilter_counters_t const *const self);
+
+static void pattern_analyze(fancy_string_pattern_t *const self);
+
+static size_t regex_group_end(char const *const value, size_t n, size_t start, bool *const is_context_free);
+
+static size_t regex_bracket_parse(char const *const value, size_t n, size_t start, charset_t *const charset, size_t *const n_members, bool *const is_supported);
+
+static size_t regex_quantifier_parse(char const *const value, size_t n, size_t start, bool *const is_optional, bool *const is_repeated);
+
+static bool pattern_prefilter(fancy_string_pattern_t const *const self, char const *const value, size_t n, size_t *const skip, fancy_string_prefilter_stats_t *const stats);
+
+static void pattern_record_prefilter_stats(fancy_string_pattern_t const *const self, fancy_string_prefilter_stats_t const *const stats);
+
+static bool pattern_next_match(fancy_string_pattern_t const *const self, char const *const value, size_t n, size_t position, size_t *const start, size_t *const end);
+
+// NOTE: The built-in regex engine (see `fancy_string_pattern_create_with_engine`). The pattern is parsed into
+// a tree of `regex_node_t`, which is compiled into two (Thompson) NFAs: one for the pattern, and one for its
+// reverse, which finds where the matches start (see `regex_search_exec`). Both are run as lazily built DFAs.
+typedef enum regex_node_kind_e
+{
+    REGEX_NODE_EMPTY,
+    REGEX_NODE_BYTES,
+    REGEX_NODE_BEGIN,
+    REGEX_NODE_END,
+    REGEX_NODE_CONCATENATION,
+    REGEX_NODE_ALTERNATION,
+    REGEX_NODE_REPETITION,
+} regex_node_kind_t;
+
+typedef struct regex_node_s
+{
+    regex_node_kind_t kind;
+    // NOTE: The children of a node are linked through their `sibling` member.
+    uint32_t child;
+    uint32_t sibling;
+    // NOTE: The bounds of a repetition (`max` is `-1` when there is none).
+    int min;
+    int max;
+    // NOTE: The bytes matched by a `REGEX_NODE_BYTES` node.
+    uint8_t bits[(UCHAR_MAX + 1) / 8];
+} regex_node_t;
+
+typedef struct regex_parser_s
+{
+    char const *value;
+    size_t n;
+    size_t i;
+    regex_node_t *nodes;
+    size_t n_nodes;
+    size_t capacity;
+    size_t depth;
+    // NOTE: Set to `false` when the pattern uses a feature that the engine does not have (e.g., a back-reference).
+    bool is_supported;
+    bool has_begin;
+} regex_parser_t;
+
+typedef enum nfa_state_kind_e
+{
+    NFA_STATE_BYTES,
+    NFA_STATE_SPLIT,
+    // NOTE: The assertions that only hold where the scan starts (e.g., `^` when scanning forward)
+    // and where it ends (e.g., `$` when scanning forward).
+    NFA_STATE_SCAN_START,
+    NFA_STATE_SCAN_END,
+    NFA_STATE_MATCH,
+} nfa_state_kind_t;
+
+typedef struct nfa_state_s
+{
+    nfa_state_kind_t kind;
+    uint32_t out;
+    uint32_t out1;
+    uint8_t bits[(UCHAR_MAX + 1) / 8];
+} nfa_state_t;
+
+typedef struct nfa_s
+{
+    nfa_state_t *states;
+    size_t n_states;
+    size_t capacity;
+    uint32_t start;
+    // NOTE: `loop` is where an unanchored scan starts (i.e., it leads both to `start` and to `any`, which reads any
+    // byte and goes back to `loop`), such that a match can start at every position.
+    uint32_t loop;
+    uint32_t any;
+    bool is_too_large;
+    // NOTE: The bytes that no state tells apart share a class (i.e., a column of the DFA's transition table).
+    uint8_t classes[UCHAR_MAX + 1];
+    size_t n_classes;
+} nfa_t;
+
+typedef struct dfa_state_s
+{
+    // NOTE: The (sorted) NFA states of the DFA state are `sets[first]` to `sets[first + n - 1]`.
+    size_t first;
+    size_t n;
+    uint32_t next_in_bucket;
+    bool is_match;
+    bool is_match_at_end;
+} dfa_state_t;
+
+// NOTE: A DFA whose states (i.e., sets of NFA states) are only built when the scan first reaches them, which
+// avoids the exponential blow-up of building all of them upfront. When there are too many of them, all of the
+// states are dropped and built again as needed, such that scanning a byte never costs more than computing
+// one transition (i.e., the scan is linear in the input's size, whatever the pattern).
+typedef struct dfa_s
+{
+    nfa_t const *nfa;
+    dfa_state_t *states;
+    size_t n_states;
+    size_t capacity;
+    // NOTE: One row of `nfa->n_classes` entries per state, set to `FANCY_STRING_DFA_UNKNOWN` until built.
+    uint32_t *transitions;
+    uint32_t *sets;
+    size_t n_sets;
+    size_t sets_capacity;
+    uint32_t *buckets;
+    size_t n_buckets;
+    // NOTE: The start states, without and with the scan start assertions, and the start state of an unanchored scan.
+    uint32_t starts[2];
+    uint32_t unanchored_start;
+    // NOTE: When `seeds` is not `NULL`, the NFA states that a match begins with (without the scan start assertions)
+    // read each byte along with those of the current state, such that a state is made of the threads that started
+    // before the current position (i.e., the dead state means that none of them is left).
+    uint32_t *seeds;
+    size_t n_seeds;
+    size_t n_flushes;
+    // NOTE: The scratch space of `dfa_closure`.
+    uint32_t *marks;
+    uint32_t generation;
+    uint32_t *stack;
+    uint32_t *closure;
+} dfa_t;
+
+// NOTE: The state of a search made by `fancy_string_regex_create_with_pattern` or `fancy_string_pattern_find`.
+typedef struct regex_search_s
+{
+    fancy_string_pattern_t const *pattern;
+    dfa_t *forward;
+    dfa_t *reverse;
+    // NOTE: Whether `forward` and `reverse` are the pattern's own DFAs (i.e., its mutex is held), or private ones.
+    bool is_shared;
+    // NOTE: When a search is made of many calls to `regex_search_exec` on suffixes of the same input,
+    // the positions where a match can start are all found by a single (reverse) scan of the input.
+    // Otherwise, the input is only read up to where the match is known (see `dfa_find`).
+    bool is_single;
+    uint64_t *starts;
+    char const *begin;
+    // NOTE: The number of bytes read by the scans for the longest matches, which is only bounded by the size of the
+    // input times the number of matches (e.g., with `"a|a[^z]*z"` on a run of `"a"`, each scan reads up to the end).
+    size_t n_read;
+} regex_search_t;
+
+static bool pattern_compile_dfa(fancy_string_pattern_t *const self);
+
+static uint32_t regex_parser_add(regex_parser_t *const self, regex_node_kind_t kind);
+
+static uint32_t regex_parse_alternation(regex_parser_t *const self);
+
+static uint32_t regex_parse_concatenation(regex_parser_t *const self);
+
+static uint32_t regex_parse_repetition(regex_parser_t *const self);
+
+static uint32_t regex_parse_atom(regex_parser_t *const self);
+
+static nfa_t *nfa_create(regex_node_t const *const nodes, uint32_t root, bool is_reverse);
+
+static void nfa_destroy(nfa_t *const self);
+
+static uint32_t nfa_add(nfa_t *const self, nfa_state_kind_t kind, uint32_t out, uint32_t out1);
+
+static uint32_t nfa_compile(nfa_t *const self, regex_node_t const *const nodes, uint32_t node, uint32_t next, bool is_reverse);
+
+static void nfa_build_classes(nfa_t *const self);
+
+static dfa_t *dfa_create(nfa_t const *const nfa, bool is_seeded);
+
+static void dfa_destroy(dfa_t *const self);
+
+static void dfa_flush(dfa_t *const self);
+
+static int compare_uint32(void const *a, void const *b);
+
+static size_t dfa_closure(dfa_t *const self, size_t n_seeds, bool is_scan_start, bool is_end);
+
+static uint32_t dfa_add(dfa_t *const self, size_t n);
+
+static uint32_t dfa_start(dfa_t *const self, bool is_scan_start);
+
+static uint32_t dfa_unanchored_start(dfa_t *const self);
+
+static uint32_t dfa_anchor(dfa_t *const self, uint32_t state);
+
+static uint32_t dfa_next(dfa_t *const self, uint32_t state, unsigned char byte);
+
+static bool dfa_longest(dfa_t *const self, char const *const value, size_t n, size_t start, size_t *const end, size_t *const n_read);
+
+static bool dfa_scan_starts(dfa_t *const self, char const *const value, size_t n, bool is_scan_start, uint64_t *const starts, size_t *const leftmost);
+
+static bool dfa_find(dfa_t *const forward, dfa_t *const reverse, char const *const value, size_t n, size_t *const start, size_t *const end, size_t *const limit);
+
+static void regex_search_init(regex_search_t *const self, fancy_string_pattern_t const *const pattern, bool is_single);
+
+static void regex_search_release(regex_search_t *const self);
+
+static int regex_search_exec(regex_search_t *const self, char const *const value, size_t n, regmatch_t *const match);
+
+typedef struct regex_stream_s
+{
+    fancy_string_pattern_t const *pattern;
+    fancy_string_pattern_match_t fn;
+    void *context;
+    // NOTE: The threads (i.e., the NFA states that read a byte, match, or assert the input's end, each with
+    // the position where it started), sorted by start. Each NFA state has at most one thread (the leftmost one).
+    uint32_t *states;
+    size_t *starts;
+    size_t n_threads;
+    uint32_t *next_states;
+    size_t *next_starts;
+    size_t n_next;
+    uint32_t *marks;
+    uint32_t generation;
+    uint32_t *stack;
+    // NOTE: Unless one of the threads that a match starting at some position (other than the start of a search)
+    // begins with matches right away, the bytes that they read.
+    bool has_first_bytes;
+    charset_t first_bytes;
+    // NOTE: When these threads all read a byte (i.e., a match can neither be empty nor start with `$`), the input
+    // is scanned by the pattern's seeded DFA while there is no thread (see `regex_stream_scan`), which, just like
+    // the DFAs of `search`, is either shared (i.e., the pattern's mutex is held) or a private one. Otherwise, it
+    // is `NULL`.
+    regex_search_t search;
+    dfa_t *dfa;
+    // NOTE: The position of the threads (i.e., of the next byte to be read) inside the input.
+    size_t position;
+    // NOTE: The matches that have been found but not reported yet (from `first_candidate` to `n_candidates - 1`).
+    // The first one is the leftmost-longest match of the current search so far, and each of the others is the one
+    // of the search that starts at the end of the previous one. Since these searches are run along with the current
+    // one, the input never has to be read again once the current search's match is known.
+    size_t *candidate_starts;
+    size_t *candidate_ends;
+    size_t first_candidate;
+    size_t n_candidates;
+    size_t candidates_capacity;
+    // NOTE: Where the current search started (i.e., the end of the last reported match).
+    size_t search_start;
+    size_t count;
+    bool is_done;
+} regex_stream_t;
+
+static void regex_stream_init(regex_stream_t *const self, fancy_string_pattern_t const *const pattern, fancy_string_pattern_match_t fn, void *context);
+
+static void regex_stream_release(regex_stream_t *const self);
+
+static void regex_stream_prepare(regex_stream_t *const self);
+
+static void regex_stream_add(regex_stream_t *const self, uint32_t state, size_t start, bool is_scan_start, bool is_end);
+
+static void regex_stream_swap(regex_stream_t *const self);
+
+static size_t regex_stream_search(regex_stream_t const *const self, size_t start);
+
+static void regex_stream_propose(regex_stream_t *const self, size_t start, size_t end);
+
+static void regex_stream_check(regex_stream_t *const self);
+
+static void regex_stream_seed(regex_stream_t *const self, bool has_byte, unsigned char byte);
+
+static void regex_stream_step(regex_stream_t *const self, unsigned char byte);
+
+static void regex_stream_scan(regex_stream_t *const self, char const *const data, size_t end);
+
+static void regex_stream_emit(regex_stream_t *const self);
+
+static void regex_stream_run(regex_stream_t *const self, char const *const data, size_t n);
+
+static void regex_stream_finish(regex_stream_t *const self);
+
+// NOTE: Where `fancy_string_regex_create_with_pattern` adds the matches that a `regex_stream_t` reports, which are
+// relative to `offset`.
+typedef struct regex_collector_s
+{
+    fancy_string_regex_t *regex;
+    size_t offset;
+} regex_collector_t;
+
+static void regex_add_match(fancy_string_regex_t *const self, size_t start, size_t end);
+
+static bool regex_collect_match(fancy_string_pattern_t const *const pattern, size_t start, size_t end, void *context);
+
 struct fancy_string_s
 {
     char *value;
     size_t n;
+    // NOTE: `capacity` is the number of characters that `value` can hold without
+    // being re-allocated, not counting the terminating null character (i.e.,
+    // `value` always points to at least `capacity + 1` bytes).
+    size_t capacity;
+    // NOTE: When not `NULL`, `value` points inside this (read-only, possibly shared)
+    // storage instead of pointing to a buffer owned by the string object, in which
+    // case the content gets copied before the first mutation (i.e., copy-on-write).
+    fancy_string_storage_t *storage;
+    // NOTE: The string object and its initial value are allocated as a single block
+    // (i.e., `value` points to `inline_value`, which holds `inline_capacity + 1` bytes),
+    // which saves one allocation per string object. The string object itself cannot
+    // be moved (the application holds a pointer to it), so a value that outgrows the
+    // inline buffer is moved to a separate heap buffer.
+    size_t inline_capacity;
+    char inline_value[];
+};
+
+struct fancy_string_line_reader_s
+{
+    FILE *stream;
+    // NOTE: `buffer` holds `capacity + 1` bytes, of which `[start, end)` have been
+    // read from the stream but not yet returned. `scanned` is the position up to
+    // which we already know that there is no line break.
+    char *buffer;
+    size_t capacity;
+    size_t start;
+    size_t end;
+    size_t scanned;
+    bool eof;
+    // NOTE: `is_interactive` is set for streams that are not regular files (pipes,
+    // terminals, sockets...), which are filled up to the next line break only.
+    bool is_interactive;
+    size_t line_number;
+    size_t line_offset;
+    size_t consumed;
+};
+
+struct fancy_string_searcher_s
+{
+    // NOTE: `needle` points to `value` for searchers created through `fancy_string_searcher_create`,
+    // but the library's internal searchers (which live on the stack) point to the caller's memory.
+    char const *needle;
+    size_t n;
+    // NOTE: Horspool's "bad character" tables. Going forward, the table is indexed by a hash
+    // of the window's last two bytes rather than by its last byte, since the skips are much
+    // longer on text (whose alphabet is small): `pair_position[h]` is the (largest) position
+    // in the needle at which a pair with hash `h` ends, or `0` if there is none, and
+    // `last_pair_shift` is how far the window moves after a failed comparison. Going backward,
+    // `reverse_shift[c]` is how far the window can move when its first byte is `c`.
+    size_t pair_position[UCHAR_MAX + 1];
+    size_t last_pair_shift;
+    size_t reverse_shift[UCHAR_MAX + 1];
+    char value[];
+};
+
+// NOTE: A state of the (Aho-Corasick) automaton, i.e., a node of the needles' trie.
+typedef struct multi_matcher_state_s
+{
+    // NOTE: The state reached by dropping the first byte(s) of this state's prefix until
+    // what is left is (the prefix of) a needle.
+    uint32_t fail;
+    uint32_t depth;
+    // NOTE: The index of the (first) needle that ends at this state, if any.
+    uint32_t needle;
+    // NOTE: The first state, on the chain of failure links starting at this state (included),
+    // at which a needle ends, if any. It is also the longest needle that ends here.
+    uint32_t output;
+} multi_matcher_state_t;
+
+struct fancy_string_multi_matcher_s
+{
+    // NOTE: The needles are stored one after the other; needle `i` starts at
+    // `needles[offsets[i]]` and ends right before `needles[offsets[i + 1]]`.
+    char *needles;
+    size_t *offsets;
+    size_t n_needles;
+    // NOTE: All the bytes that appear in none of the needles behave the same, so the
+    // transition table has one column per "byte class" (i.e., one per distinct needle
+    // byte, plus one for all the other bytes) instead of 256, which keeps it small
+    // enough to stay in cache.
+    uint8_t classes[UCHAR_MAX + 1];
+    size_t n_classes;
+    // NOTE: The complete transition table (i.e., the failure links have already been
+    // followed), with one row of `n_classes` entries per state. An entry holds the offset
+    // of the target state's row (i.e., `state * n_classes`), such that scanning needs no
+    // multiplication, and has its `FANCY_STRING_MULTI_MATCHER_OUTPUT` bit set when a
+    // needle ends at the target state.
+    uint32_t *transitions;
+    multi_matcher_state_t *states;
+    size_t n_states;
 };
 
 struct fancy_string_array_s
 {
     fancy_string_t **array;
     size_t n;
+    // NOTE: When `true`, the array's elements are stored in shared mode (see
+    // `fancy_string_array_share`), so that they can be cloned in O(1).
+    bool shared;
+    // NOTE: When not `NULL`, some of the elements live inside this single block of `n_slots`
+    // slots (of `FANCY_STRING_ARRAY_SLOT_SIZE` bytes each) instead of being heap-allocated
+    // one by one (see `fancy_string_split_arena`), such that they must be released (instead
+    // of destroyed) when they leave the array.
+    char *slots;
+    size_t n_slots;
 };
 
 struct fancy_string_regex_s
@@ -90,6 +758,36 @@ struct fancy_string_regex_s
     size_t *end_array;
 };
 
+struct fancy_string_pattern_s
+{
+    // NOTE: Neither member is modified after `fancy_string_pattern_create` returns (the pattern is
+    // kept in shared mode, such that the regex objects that use it only increment a reference count).
+    fancy_string_t *pattern;
+    int flags;
+    regex_t re;
+    // NOTE: The pattern objects cached by `fancy_string_regex_create` can be evicted while in use.
+    _Atomic size_t references;
+    // NOTE: The prefilter (see `pattern_analyze`) is either a literal or a set of bytes that every match
+    // contains, and that the input is searched for before calling `regexec`. When `is_prefix` is `true`,
+    // every match starts with it, such that the input that precedes its first occurrence can be skipped.
+    fancy_string_prefilter_kind_t prefilter;
+    char *literal;
+    size_t n_literal;
+    charset_t charset;
+    bool is_prefix;
+    prefilter_counters_t counters;
+    // NOTE: With `FANCY_STRING_REGEX_ENGINE_DFA`, the DFAs are shared by the threads that use the pattern
+    // object, and built as they go (under `dfa_mutex`).
+    fancy_string_regex_engine_t engine;
+    bool has_begin;
+    nfa_t *forward_nfa;
+    nfa_t *reverse_nfa;
+    dfa_t *forward_dfa;
+    dfa_t *reverse_dfa;
+    dfa_t *stream_dfa;
+    pthread_mutex_t dfa_mutex;
+};
+
 // -----------------------------------------------
 //                      MISC
 // -----------------------------------------------
@@ -120,2091 +818,6681 @@ fancy_string_t *fancy_string_create(char const *const value)
 {
     assert(value != NULL);
 
-    fancy_string_t *self = my_malloc(sizeof(fancy_string_t));
-    self->value = copy_value(value);
-    self->n = strlen(self->value);
-    return self;
+    return create_from_memory(value, strlen(value));
 }
 
 fancy_string_t *fancy_string_from_copied_memory(void const *const pointer, size_t n)
 {
     assert(pointer != NULL);
 
-    if (n == 0)
+    return create_from_memory(pointer, n);
+}
+
+fancy_string_t *fancy_string_from_stream(FILE *stream)
+{
+    fancy_string_t *s = fancy_string_from_stream_without_closing(stream);
+    if (stream != NULL)
     {
-        return fancy_string_create_empty();
+        fclose(stream);
     }
-    char *tmp = my_malloc(sizeof(char) * (n + 1));
-    memcpy(tmp, pointer, n);
-    tmp[n] = '\0';
-    fancy_string_t *s = fancy_string_create(tmp);
-    my_free(tmp);
     return s;
 }
 
-fancy_string_t *fancy_string_from_stream(FILE *stream)
+fancy_string_t *fancy_string_from_stream_without_closing(FILE *stream)
 {
     fancy_string_t *s = fancy_string_create_empty();
     if (stream == NULL)
     {
         return s;
     }
-    char *tmp = my_malloc(sizeof(char) * 2);
-    tmp[1] = '\0';
-    int c;
-    // NOTE: [With GNU C Library, EOF is -1](https://www.gnu.org/software/libc/manual/html_node/EOF-and-Errors.html)
-    // NOTE 2: Using flockfile + getc_unlocked instead of fgetc
-    // - [flockfile](https://www.gnu.org/software/libc/manual/html_node/Streams-and-Threads.html)
-    // - [getc_unlocked](https://www.gnu.org/software/libc/manual/html_node/Character-Input.html)
-    flockfile(stream);
-    // while ((c = fgetc(stream)) != EOF)
-    while ((c = getc_unlocked(stream)) != EOF)
-    {
-        tmp[0] = (char)c;
-        fancy_string_append_value(s, tmp);
-    }
-    funlockfile(stream);
-    my_free(tmp);
-    fclose(stream);
+    read_stream(s, stream);
     return s;
 }
 
-fancy_string_t *fancy_string_from_stream_next_line(FILE *stream)
+fancy_string_t *fancy_string_from_file_mapped(char const *const path, fancy_string_map_advice_t advice)
 {
-    // [main reference](https://man7.org/linux/man-pages/man3/getline.3.html)
-    if (stream == NULL)
-    {
-        return NULL;
-    }
-
-    char *line = NULL;
-    size_t line_size = 0;
+    assert(path != NULL);
 
-    ssize_t size = getline(&line, &line_size, stream);
-    if (size == -1)
+    int fd = open(path, O_RDONLY);
+    if (fd == -1)
     {
-        free(line);
         return NULL;
     }
-
-    fancy_string_t *s = fancy_string_create(line);
-
-    free(line);
-
-    fancy_string_replace_value(s, "\n", "", -1);
-
+    fancy_string_t *s = fancy_string_from_fd_mapped(fd, advice);
+    // NOTE: The mapping remains valid after the file descriptor has been closed.
+    close(fd);
     return s;
 }
 
-fancy_string_t *fancy_string_create_repeat(char const *const value, size_t n_repeat)
+fancy_string_t *fancy_string_from_fd_mapped(int fd, fancy_string_map_advice_t advice)
 {
-    assert(value != NULL);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        return NULL;
+    }
+    if (info.st_size == 0)
+    {
+        // NOTE: `mmap` does not accept a zero length.
+        return fancy_string_create_empty();
+    }
 
-    fancy_string_t *self = fancy_string_create(value);
-    if (n_repeat == 0)
+    size_t n = (size_t)info.st_size;
+    long page_size = sysconf(_SC_PAGESIZE);
+    if (page_size <= 0)
     {
-        return self;
+        return NULL;
     }
-    fancy_string_t *clone = fancy_string_clone(self);
-    size_t i = 0;
-    while (i < n_repeat)
+    // NOTE: The internal value must be null-terminated (e.g., for `regexec`). The
+    // end of the file's last page is zero-filled by `mmap`, but, if the file's size
+    // is a multiple of the page size, there is no such "padding", so we first reserve
+    // an anonymous (i.e., zeroed) region that is at least one byte larger than the
+    // file and then map the file over it.
+    size_t length = ((n / (size_t)page_size) + 1) * (size_t)page_size;
+    void *address = mmap(NULL, length, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED)
+    {
+        return NULL;
+    }
+    if (mmap(address, n, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
     {
-        fancy_string_append(self, clone);
-        i++;
+        munmap(address, length);
+        return NULL;
     }
-    fancy_string_destroy(clone);
+    apply_map_advice(address, n, advice);
+
+    fancy_string_storage_t *storage = my_malloc(sizeof(fancy_string_storage_t));
+    atomic_init(&storage->references, 1);
+    storage->address = address;
+    storage->length = length;
+
+    fancy_string_t *self = allocate_string(0);
+    self->value = address;
+    self->n = n;
+    self->capacity = n;
+    self->storage = storage;
     return self;
 }
 
-fancy_string_t *fancy_string_create_empty(void)
+bool fancy_string_is_mapped(fancy_string_t const *const self)
 {
-    return fancy_string_create("");
+    assert(self != NULL);
+
+    return self->storage != NULL && self->storage->address != NULL;
 }
 
-fancy_string_t *fancy_string_clone(fancy_string_t const *const self)
+void fancy_string_share(fancy_string_t *const self)
 {
     assert(self != NULL);
 
-    return fancy_string_create(self->value);
+    share_value(self);
 }
 
-void fancy_string_destroy(fancy_string_t *const self)
+bool fancy_string_is_shared(fancy_string_t const *const self)
 {
     assert(self != NULL);
 
-    my_free(self->value);
-    my_free(self);
+    return self->storage != NULL;
 }
 
-void fancy_string_print(fancy_string_t const *const self, FILE *stream, bool debug)
+fancy_string_t *fancy_string_from_stream_next_line(FILE *stream)
 {
-    assert(self != NULL);
-    assert(stream != NULL);
+    // [main reference](https://man7.org/linux/man-pages/man3/getline.3.html)
+    if (stream == NULL)
+    {
+        return NULL;
+    }
 
-    if (debug)
+    char *line = NULL;
+    size_t line_size = 0;
+
+    ssize_t size = getline(&line, &line_size, stream);
+    if (size == -1)
     {
-        fprintf(stream, "fancy_string_t[%zu](%s)\n", fancy_string_size(self), self->value);
+        free(line);
+        return NULL;
     }
-    else
+
+    // NOTE: `getline` keeps the line break (if any), which is simply left out here.
+    size_t n = (size_t)size;
+    if (n > 0 && line[n - 1] == '\n')
     {
-        fprintf(stream, "%s", self->value);
+        n -= 1;
     }
+    fancy_string_t *s = create_from_memory(line, n);
+
+    free(line);
+
+    return s;
 }
 
-size_t fancy_string_size(fancy_string_t const *const self)
+fancy_string_line_reader_t *fancy_string_line_reader_create(FILE *stream)
 {
-    assert(self != NULL);
+    assert(stream != NULL);
 
-    return self->n;
+    fancy_string_line_reader_t *self = my_malloc(sizeof(fancy_string_line_reader_t));
+    self->stream = stream;
+    self->capacity = FANCY_STRING_STREAM_BLOCK_SIZE;
+    self->buffer = my_malloc(sizeof(char) * (self->capacity + 1));
+    self->start = 0;
+    self->end = 0;
+    self->scanned = 0;
+    self->eof = false;
+    struct stat info;
+    int fd = fileno(stream);
+    self->is_interactive = fd != -1 && fstat(fd, &info) == 0 && !S_ISREG(info.st_mode);
+    self->line_number = 0;
+    self->line_offset = 0;
+    self->consumed = 0;
+    return self;
 }
 
-bool fancy_string_is_empty(fancy_string_t const *const self)
+void fancy_string_line_reader_destroy(fancy_string_line_reader_t *const self)
 {
     assert(self != NULL);
 
-    return fancy_string_size(self) == 0;
+    my_free(self->buffer);
+    my_free(self);
 }
 
-void fancy_string_clear(fancy_string_t *const self)
+bool fancy_string_line_reader_next_borrowed(fancy_string_line_reader_t *const self, char const **value, size_t *n)
 {
     assert(self != NULL);
+    assert(value != NULL);
+    assert(n != NULL);
 
-    my_free(self->value);
-    self->value = my_malloc(sizeof(char));
-    self->value[0] = '\0';
-    self->n = 0;
+    while (true)
+    {
+        char *line_break = memchr(&self->buffer[self->scanned], '\n', self->end - self->scanned);
+        size_t line_end;
+        size_t next_start;
+        if (line_break != NULL)
+        {
+            line_end = (size_t)(line_break - self->buffer);
+            next_start = line_end + 1;
+        }
+        else if (self->eof)
+        {
+            if (self->start == self->end)
+            {
+                return false;
+            }
+            // NOTE: The last line does not end with a line break.
+            line_end = self->end;
+            next_start = self->end;
+        }
+        else
+        {
+            self->scanned = self->end;
+            line_reader_fill(self);
+            continue;
+        }
+
+        size_t line_start = self->start;
+        if (line_break != NULL && line_end > line_start && self->buffer[line_end - 1] == '\r')
+        {
+            line_end -= 1;
+        }
+        // NOTE: We own the buffer, so the borrowed value can be null-terminated in place.
+        self->buffer[line_end] = '\0';
+        *value = &self->buffer[line_start];
+        *n = line_end - line_start;
+
+        self->line_number += 1;
+        self->line_offset = self->consumed;
+        self->consumed += next_start - line_start;
+        self->start = next_start;
+        self->scanned = next_start;
+        return true;
+    }
 }
 
-void fancy_string_update_value(fancy_string_t *const self, char const *const value)
+bool fancy_string_line_reader_next_view(fancy_string_line_reader_t *const self, fancy_string_view_t *const line)
 {
     assert(self != NULL);
-    assert(value != NULL);
+    assert(line != NULL);
 
-    // I don't know why, but using `fancy_string_clear(self)`
-    //  here instead of simply `my_free(self->value)` causes a memory
-    //  leak each time this method gets called.
-    // fancy_string_clear(self);
-    // The `fancy_string_clear` call expends to:
-    // - my_free(self->value);
-    //  - self->value = my_malloc(sizeof(char));
-    // - self->value[0] = '\0';
-    // - self->n = 0;
-    // Obviously, this is wasteful since we will again replace
-    // the memory. Maybe the compiler does an optimization, or something, which
-    //  result in something funny?
-
-    my_free(self->value);
-    self->value = copy_value(value);
-    self->n = strlen(self->value);
+    return fancy_string_line_reader_next_borrowed(self, &line->value, &line->n);
 }
 
-void fancy_string_update(fancy_string_t *const self, fancy_string_t const *const string)
+bool fancy_string_line_reader_next(fancy_string_line_reader_t *const self, fancy_string_t *const line)
 {
     assert(self != NULL);
-    assert(string != NULL);
+    assert(line != NULL);
 
-    fancy_string_update_value(self, string->value);
+    char const *value;
+    size_t n;
+    if (!fancy_string_line_reader_next_borrowed(self, &value, &n))
+    {
+        return false;
+    }
+    update_memory(line, value, n);
+    return true;
 }
 
-char *fancy_string_value(fancy_string_t const *const self)
+size_t fancy_string_line_reader_line_number(fancy_string_line_reader_t const *const self)
 {
     assert(self != NULL);
 
-    size_t n = fancy_string_size(self);
-    char *value = malloc(sizeof(char) * (n + 1));
-    memcpy(value, self->value, n);
-    value[n] = '\0';
-    return value;
+    return self->line_number;
 }
 
-void fancy_string_append_value(fancy_string_t *const self, char const *const value)
+size_t fancy_string_line_reader_offset(fancy_string_line_reader_t const *const self)
 {
     assert(self != NULL);
+
+    return self->line_offset;
+}
+
+fancy_string_t *fancy_string_create_repeat(char const *const value, size_t n_repeat)
+{
     assert(value != NULL);
 
+    // NOTE: The initial value is followed by `n_repeat` copies of itself.
     size_t n_value = strlen(value);
-    if (n_value == 0)
-    {
-        return;
-    }
-    size_t n = fancy_string_size(self);
-    if (n == 0)
+    if (n_value != 0 && n_repeat >= SIZE_MAX / n_value)
+    {
+        FAIL_WITH_MESSAGE("The size of the repeated value overflows 'size_t'.");
+    }
+    size_t n = n_value * (n_repeat + 1);
+    // NOTE: Long values get their own buffer (i.e., a single allocation), which, unlike the
+    // inline buffer, can later be released by `fancy_string_shrink_to_fit`.
+    fancy_string_t *self = allocate_string(0);
+    resize_buffer(self, n);
+    memcpy(self->value, value, n_value);
+    // NOTE: Each copy doubles the filled part, such that there are O(log(n_repeat)) calls to `memcpy`.
+    size_t n_filled = n_value;
+    while (n_filled < n)
+    {
+        size_t n_copied = n_filled < n - n_filled ? n_filled : n - n_filled;
+        memcpy(&self->value[n_filled], self->value, n_copied);
+        n_filled += n_copied;
+    }
+    self->value[n] = '\0';
+    self->n = n;
+    return self;
+}
+
+fancy_string_t *fancy_string_create_empty(void)
+{
+    return fancy_string_create("");
+}
+
+fancy_string_t *fancy_string_clone(fancy_string_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->storage != NULL)
     {
-        fancy_string_update_value(self, value);
-        return;
+        // NOTE: The storage is read-only, so the clone can safely reference
+        // it too (it will make its own copy if it ever gets mutated). This is
+        // what makes cloning a shared or memory-mapped string object O(1).
+        fancy_string_t *clone = allocate_string(0);
+        clone->value = self->value;
+        clone->n = self->n;
+        clone->capacity = self->capacity;
+        clone->storage = storage_retain(self->storage);
+        return clone;
     }
-    self->value = my_realloc(self->value, sizeof(char) * (n + n_value + 1));
-    memcpy(&self->value[n], value, n_value);
-    self->value[n + n_value] = '\0';
-    self->n = strlen(self->value);
+
+    return create_from_memory(self->value, self->n);
 }
 
-void fancy_string_append(fancy_string_t *const self, fancy_string_t const *const string)
+void fancy_string_destroy(fancy_string_t *const self)
 {
     assert(self != NULL);
-    assert(string != NULL);
 
-    fancy_string_append_value(self, string->value);
+    release_value(self);
+    my_free(self);
 }
 
-void fancy_string_prepend_value(fancy_string_t *const self, char const *const value)
+void fancy_string_print(fancy_string_t const *const self, FILE *stream, bool debug)
 {
     assert(self != NULL);
-    assert(value != NULL);
+    assert(stream != NULL);
 
-    size_t n_value = strlen(value);
-    if (n_value == 0)
+    if (debug)
     {
-        return;
+        fprintf(stream, "fancy_string_t[%zu](", fancy_string_size(self));
+        print_memory(stream, self->value, self->n);
+        fprintf(stream, ")\n");
     }
-    size_t n = fancy_string_size(self);
-    if (n == 0)
+    else
     {
-        fancy_string_update_value(self, value);
-        return;
+        print_memory(stream, self->value, self->n);
     }
-    fancy_string_t *tmp = fancy_string_create(value);
-    fancy_string_append(tmp, self);
-    fancy_string_update(self, tmp);
-    fancy_string_destroy(tmp);
 }
 
-void fancy_string_prepend(fancy_string_t *const self, fancy_string_t const *const string)
+size_t fancy_string_size(fancy_string_t const *const self)
 {
     assert(self != NULL);
-    assert(string != NULL);
 
-    fancy_string_prepend_value(self, string->value);
+    return self->n;
 }
 
-bool fancy_string_equals_value(fancy_string_t const *const self, char const *const value)
+bool fancy_string_is_empty(fancy_string_t const *const self)
 {
     assert(self != NULL);
-    assert(value != NULL);
 
-    size_t n_value = strlen(value);
-    size_t n = fancy_string_size(self);
-    if (n_value != n)
+    return fancy_string_size(self) == 0;
+}
+
+void fancy_string_clear(fancy_string_t *const self)
+{
+    assert(self != NULL);
+
+    if (self->storage != NULL)
     {
-        return false;
+        release_value(self);
+        self->value = self->inline_value;
+        self->capacity = self->inline_capacity;
     }
-    return memcmp(self->value, value, n) == 0;
+    // NOTE: The buffer is kept (i.e., the capacity is preserved) so that a string
+    // object that gets cleared and refilled inside a loop does not need to be
+    // re-allocated each time. `fancy_string_shrink_to_fit` can be used to release it.
+    self->value[0] = '\0';
+    self->n = 0;
 }
 
-bool fancy_string_equals(fancy_string_t const *const self, fancy_string_t const *const string)
+void fancy_string_update_value(fancy_string_t *const self, char const *const value)
 {
     assert(self != NULL);
-    assert(string != NULL);
+    assert(value != NULL);
 
-    return fancy_string_equals_value(self, string->value);
+    update_memory(self, value, strlen(value));
 }
 
-bool fancy_string_starts_with_value(fancy_string_t const *const self, char const *const value)
+void fancy_string_update_value_n(fancy_string_t *const self, char const *const value, size_t n_value)
 {
     assert(self != NULL);
     assert(value != NULL);
 
-    size_t n_value = strlen(value);
-    size_t n = fancy_string_size(self);
-    if (n_value == 0 && n == 0)
-    {
-        // NOTE: The rational behind this is that if both values are "empty",
-        // then they are equal, and if they are equal, then it makes sense to
-        // say that they start with the same value.
-        return true;
-    }
-    if (n_value == 0 || n_value > n)
-    {
-        return false;
-    }
-    return memcmp(self->value, value, n_value) == 0;
+    update_memory(self, value, n_value);
 }
 
-bool fancy_string_starts_with(fancy_string_t const *const self, fancy_string_t const *const string)
+void fancy_string_update(fancy_string_t *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
     assert(string != NULL);
 
-    return fancy_string_starts_with_value(self, string->value);
+    update_memory(self, string->value, string->n);
 }
 
-bool fancy_string_ends_with_value(fancy_string_t const *const self, char const *const value)
+char *fancy_string_value(fancy_string_t const *const self)
 {
     assert(self != NULL);
-    assert(value != NULL);
 
-    size_t n_value = strlen(value);
     size_t n = fancy_string_size(self);
-    if (n_value == 0 && n == 0)
-    {
-        // NOTE: The rational behind this is that if both values are "empty",
-        // then they are equal, and if they are equal, then it makes sense to
-        // say that they end with the same value.
-        return true;
-    }
-    if (n_value == 0 || n_value > n)
-    {
-        return false;
-    }
-    return memcmp(&self->value[n - n_value], value, n_value) == 0;
+    char *value = malloc(sizeof(char) * (n + 1));
+    memcpy(value, self->value, n);
+    value[n] = '\0';
+    return value;
 }
 
-bool fancy_string_ends_with(fancy_string_t const *const self, fancy_string_t const *const string)
+size_t fancy_string_capacity(fancy_string_t const *const self)
 {
     assert(self != NULL);
-    assert(string != NULL);
 
-    return fancy_string_ends_with_value(self, string->value);
+    return self->capacity;
 }
 
-ssize_t fancy_string_index_of_value(fancy_string_t const *const self, char const *const value)
+void fancy_string_reserve(fancy_string_t *const self, size_t capacity)
 {
     assert(self != NULL);
-    assert(value != NULL);
 
-    size_t n_value = strlen(value);
-    size_t n = fancy_string_size(self);
-    if (n_value > n)
-    {
-        return -1;
-    }
-    else if (n_value == 0 || n == 0)
+    if (capacity <= self->capacity)
     {
-        return -1;
+        return;
     }
-    char *p = strstr(self->value, value);
-    if (p == NULL)
+    resize_buffer(self, capacity);
+}
+
+void fancy_string_shrink_to_fit(fancy_string_t *const self)
+{
+    assert(self != NULL);
+
+    if (self->capacity == self->n || self->storage != NULL)
     {
-        return -1;
+        return;
     }
-    return (ssize_t)(p - self->value);
+    resize_buffer(self, self->n);
 }
 
-ssize_t fancy_string_index_of(fancy_string_t const *const self, fancy_string_t const *const string)
+void fancy_string_append_value(fancy_string_t *const self, char const *const value)
 {
     assert(self != NULL);
-    assert(string != NULL);
+    assert(value != NULL);
 
-    return fancy_string_index_of_value(self, string->value);
+    append_memory(self, value, strlen(value));
 }
 
-bool fancy_string_contains_value(fancy_string_t const *const self, char const *const value)
+void fancy_string_append_value_n(fancy_string_t *const self, char const *const value, size_t n_value)
 {
     assert(self != NULL);
     assert(value != NULL);
 
-    return fancy_string_index_of_value(self, value) != -1;
+    append_memory(self, value, n_value);
 }
 
-bool fancy_string_contains(fancy_string_t const *const self, fancy_string_t const *const string)
+void fancy_string_append(fancy_string_t *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
     assert(string != NULL);
 
-    return fancy_string_index_of(self, string) != -1;
+    append_memory(self, string->value, string->n);
 }
 
-fancy_string_t *fancy_string_substring(fancy_string_t const *const self, ssize_t start, ssize_t end)
+void fancy_string_prepend_value(fancy_string_t *const self, char const *const value)
 {
     assert(self != NULL);
+    assert(value != NULL);
 
-    size_t n = fancy_string_size(self);
-    if (n == 0)
-    {
-        return fancy_string_create_empty();
-    }
+    prepend_memory(self, value, strlen(value));
+}
 
-    size_t index_start = start == -1 ? 0 : (size_t)start;
-    size_t index_end = end == -1 ? n : (size_t)end;
+void fancy_string_prepend_value_n(fancy_string_t *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-    if (index_start == index_end)
-    {
-        return fancy_string_create_empty();
-    }
+    prepend_memory(self, value, n_value);
+}
 
-    if (index_start > index_end)
-    {
-        size_t index_tmp = index_start;
-        index_start = index_end;
-        index_end = index_tmp;
-    }
+void fancy_string_prepend(fancy_string_t *const self, fancy_string_t const *const string)
+{
+    assert(self != NULL);
+    assert(string != NULL);
 
-    size_t substring_size = index_end - index_start;
-    if (n < substring_size)
-    {
-        if (index_start >= n)
-        {
-            return fancy_string_create_empty();
-        }
-        substring_size = n - index_start;
-    }
+    prepend_memory(self, string->value, string->n);
+}
+
+bool fancy_string_equals_value(fancy_string_t const *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-    char *value = self->value;
-    value += index_start;
-    char *substring = my_malloc(sizeof(char) * (substring_size + 1));
-    memcpy(substring, value, substring_size);
-    substring[substring_size] = '\0';
-    fancy_string_t *out = fancy_string_create(substring);
-    my_free(substring);
-    return out;
+    return equals_memory(self->value, self->n, value, strlen(value));
 }
 
-void fancy_string_trim_left(fancy_string_t *const self)
+bool fancy_string_equals_value_n(fancy_string_t const *const self, char const *const value, size_t n_value)
 {
     assert(self != NULL);
+    assert(value != NULL);
 
-    size_t n = fancy_string_size(self);
-    if (n == 0)
-    {
-        return;
-    }
-    size_t i = 0;
-    while (is_whitespace(&self->value[i]))
-    {
-        i++;
-    }
-    if (i == 0)
-    {
-        return;
-    }
-    fancy_string_t *substring = fancy_string_substring(self, i, -1);
-    fancy_string_update(self, substring);
-    fancy_string_destroy(substring);
+    return equals_memory(self->value, self->n, value, n_value);
 }
 
-fancy_string_t *fancy_string_trimmed_left(fancy_string_t const *const self)
+bool fancy_string_equals_view(fancy_string_t const *const self, fancy_string_view_t view)
 {
     assert(self != NULL);
+    assert(view.value != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_trim_left(clone);
-    return clone;
+    return equals_memory(self->value, self->n, view.value, view.n);
 }
 
-void fancy_string_trim_right(fancy_string_t *const self)
+bool fancy_string_equals(fancy_string_t const *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
+    assert(string != NULL);
 
-    size_t n = fancy_string_size(self);
-    if (n == 0)
-    {
-        return;
-    }
-    size_t i = n - 1;
-    while (is_whitespace(&self->value[i]))
-    {
-        if (i == 0)
-        {
-            break;
-        }
-        i--;
-    }
-    if (i == n - 1)
-    {
-        return;
-    }
-    fancy_string_t *substring = fancy_string_substring(self, 0, i + 1);
-    fancy_string_update(self, substring);
-    fancy_string_destroy(substring);
+    return equals_memory(self->value, self->n, string->value, string->n);
 }
 
-fancy_string_t *fancy_string_trimmed_right(fancy_string_t const *const self)
+bool fancy_string_starts_with_value(fancy_string_t const *const self, char const *const value)
 {
     assert(self != NULL);
+    assert(value != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_trim_right(clone);
-    return clone;
+    return starts_with_memory(self->value, self->n, value, strlen(value));
 }
 
-void fancy_string_trim(fancy_string_t *const self)
+bool fancy_string_starts_with_value_n(fancy_string_t const *const self, char const *const value, size_t n_value)
 {
     assert(self != NULL);
+    assert(value != NULL);
 
-    fancy_string_trim_left(self);
-    fancy_string_trim_right(self);
+    return starts_with_memory(self->value, self->n, value, n_value);
 }
 
-fancy_string_t *fancy_string_trimmed(fancy_string_t const *const self)
+bool fancy_string_starts_with_view(fancy_string_t const *const self, fancy_string_view_t view)
 {
     assert(self != NULL);
+    assert(view.value != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_trim(clone);
-    return clone;
+    return starts_with_memory(self->value, self->n, view.value, view.n);
 }
 
-fancy_string_array_t *fancy_string_split_by_value(fancy_string_t const *const self, char const *const separator, ssize_t n_max_splits)
+bool fancy_string_starts_with(fancy_string_t const *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
-    assert(separator != NULL);
+    assert(string != NULL);
 
-    if (n_max_splits == 0)
-    {
-        fancy_string_array_t *a = fancy_string_array_create();
-        fancy_string_array_push(a, self);
-        return a;
-    }
-
-    fancy_string_array_t *array = fancy_string_array_create();
-    fancy_string_t *remainder = fancy_string_clone(self);
-    size_t n_separator = strlen(separator);
+    return starts_with_memory(self->value, self->n, string->value, string->n);
+}
 
-    size_t split_counter = 0;
+bool fancy_string_ends_with_value(fancy_string_t const *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-    while (true)
-    {
-        if (n_max_splits != -1 && (size_t)n_max_splits <= split_counter)
-        {
-            fancy_string_array_push(array, remainder);
-            fancy_string_destroy(remainder);
-            break;
-        }
+    return ends_with_memory(self->value, self->n, value, strlen(value));
+}
 
-        split_counter += 1;
+bool fancy_string_ends_with_value_n(fancy_string_t const *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-        ssize_t index = fancy_string_index_of_value(remainder, separator);
-        if (index == -1)
-        {
-            fancy_string_array_push(array, remainder);
-            fancy_string_destroy(remainder);
-            break;
-        }
-        else
-        {
-            fancy_string_t *substring = fancy_string_substring(remainder, 0, index);
-            fancy_string_array_push(array, substring);
-            fancy_string_destroy(substring);
+    return ends_with_memory(self->value, self->n, value, n_value);
+}
 
-            fancy_string_t *new_remainder = fancy_string_substring(remainder, index + n_separator, -1);
-            fancy_string_destroy(remainder);
-            remainder = new_remainder;
-        }
-    }
+bool fancy_string_ends_with_view(fancy_string_t const *const self, fancy_string_view_t view)
+{
+    assert(self != NULL);
+    assert(view.value != NULL);
 
-    return array;
+    return ends_with_memory(self->value, self->n, view.value, view.n);
 }
 
-fancy_string_array_t *fancy_string_split(fancy_string_t const *const self, fancy_string_t const *const separator, ssize_t n_max_splits)
+bool fancy_string_ends_with(fancy_string_t const *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
-    assert(separator != NULL);
+    assert(string != NULL);
 
-    return fancy_string_split_by_value(self, separator->value, n_max_splits);
+    return ends_with_memory(self->value, self->n, string->value, string->n);
 }
 
-void fancy_string_pad_start(fancy_string_t *const self, size_t target_size, char value)
+ssize_t fancy_string_index_of_value(fancy_string_t const *const self, char const *const value)
 {
     assert(self != NULL);
+    assert(value != NULL);
 
-    size_t n = fancy_string_size(self);
-    if (n >= target_size)
-    {
-        return;
-    }
-    char *tmp_value = my_malloc(sizeof(char) * 2);
-    tmp_value[0] = value;
-    tmp_value[1] = '\0';
-    fancy_string_t *tmp = fancy_string_create_repeat(tmp_value, target_size - n - 1);
-    my_free(tmp_value);
-    fancy_string_prepend(self, tmp);
-    fancy_string_destroy(tmp);
+    return index_of_memory(self->value, self->n, value, strlen(value));
 }
 
-fancy_string_t *fancy_string_padded_start(fancy_string_t const *const self, size_t target_size, char value)
+ssize_t fancy_string_index_of_value_n(fancy_string_t const *const self, char const *const value, size_t n_value)
 {
     assert(self != NULL);
+    assert(value != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_pad_start(clone, target_size, value);
-    return clone;
+    return index_of_memory(self->value, self->n, value, n_value);
 }
 
-void fancy_string_pad_end(fancy_string_t *const self, size_t target_size, char value)
+ssize_t fancy_string_index_of_view(fancy_string_t const *const self, fancy_string_view_t view)
 {
     assert(self != NULL);
+    assert(view.value != NULL);
 
-    size_t n = fancy_string_size(self);
-    if (n >= target_size)
-    {
-        return;
-    }
-    char *tmp_value = my_malloc(sizeof(char) * 2);
-    tmp_value[0] = value;
-    tmp_value[1] = '\0';
-    fancy_string_t *tmp = fancy_string_create_repeat(tmp_value, target_size - n - 1);
-    my_free(tmp_value);
-    fancy_string_append(self, tmp);
-    fancy_string_destroy(tmp);
+    return index_of_memory(self->value, self->n, view.value, view.n);
 }
 
-fancy_string_t *fancy_string_padded_end(fancy_string_t const *const self, size_t target_size, char value)
+ssize_t fancy_string_index_of(fancy_string_t const *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
+    assert(string != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_pad_end(clone, target_size, value);
-    return clone;
+    return index_of_memory(self->value, self->n, string->value, string->n);
 }
 
-void fancy_string_replace_value(fancy_string_t *const self, char const *const old_value, char const *const new_value, ssize_t replace_n)
+ssize_t fancy_string_last_index_of_value(fancy_string_t const *const self, char const *const value)
 {
     assert(self != NULL);
-    assert(old_value != NULL);
-    assert(new_value != NULL);
+    assert(value != NULL);
 
-    if (replace_n == 0)
-    {
-        return;
-    }
+    return last_index_of_memory(self->value, self->n, value, strlen(value));
+}
 
-    size_t n_old_value = strlen(old_value);
-    if (n_old_value == 0)
-    {
-        return;
-    }
+ssize_t fancy_string_last_index_of_value_n(fancy_string_t const *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-    fancy_string_t *tmp = fancy_string_clone(self);
-    size_t index_offset = 0;
+    return last_index_of_memory(self->value, self->n, value, n_value);
+}
 
-    size_t replace_count = 0;
-    while (replace_n == -1 || (size_t)replace_n > replace_count)
-    {
-        ssize_t index = fancy_string_index_of_value(tmp, old_value);
-        if (index == -1)
-        {
-            break;
-        }
+ssize_t fancy_string_last_index_of_view(fancy_string_t const *const self, fancy_string_view_t view)
+{
+    assert(self != NULL);
+    assert(view.value != NULL);
 
-        fancy_string_t *prefix = fancy_string_substring(self, 0, index + index_offset);
-        fancy_string_t *suffix = fancy_string_substring(self, index + index_offset + n_old_value, -1);
+    return last_index_of_memory(self->value, self->n, view.value, view.n);
+}
 
-        fancy_string_append_value(prefix, new_value);
-        index_offset = fancy_string_size(prefix);
+ssize_t fancy_string_last_index_of(fancy_string_t const *const self, fancy_string_t const *const string)
+{
+    assert(self != NULL);
+    assert(string != NULL);
 
-        fancy_string_append(prefix, suffix);
+    return last_index_of_memory(self->value, self->n, string->value, string->n);
+}
 
-        fancy_string_update(self, prefix);
+bool fancy_string_contains_value(fancy_string_t const *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-        fancy_string_destroy(prefix);
-        fancy_string_destroy(tmp);
+    return fancy_string_index_of_value(self, value) != -1;
+}
 
-        tmp = suffix;
-        replace_count++;
-    }
+bool fancy_string_contains_value_n(fancy_string_t const *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
 
-    fancy_string_destroy(tmp);
+    return index_of_memory(self->value, self->n, value, n_value) != -1;
 }
 
-void fancy_string_replace(fancy_string_t *const self, fancy_string_t const *const old_substring, fancy_string_t const *const new_substring, ssize_t replace_n)
+bool fancy_string_contains_view(fancy_string_t const *const self, fancy_string_view_t view)
 {
     assert(self != NULL);
-    assert(old_substring != NULL);
-    assert(new_substring != NULL);
+    assert(view.value != NULL);
 
-    fancy_string_replace_value(self, old_substring->value, new_substring->value, replace_n);
+    return index_of_memory(self->value, self->n, view.value, view.n) != -1;
 }
 
-fancy_string_t *fancy_string_replaced_value(fancy_string_t const *const self, char const *const old_value, char const *const new_value, ssize_t replace_n)
+bool fancy_string_contains(fancy_string_t const *const self, fancy_string_t const *const string)
 {
     assert(self != NULL);
-    assert(old_value != NULL);
-    assert(new_value != NULL);
+    assert(string != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_replace_value(clone, old_value, new_value, replace_n);
-    return clone;
+    return fancy_string_index_of(self, string) != -1;
 }
 
-fancy_string_t *fancy_string_replaced(fancy_string_t const *const self, fancy_string_t const *const old_substring, fancy_string_t const *const new_substring, ssize_t replace_n)
+fancy_string_t *fancy_string_substring(fancy_string_t const *const self, ssize_t start, ssize_t end)
 {
     assert(self != NULL);
-    assert(old_substring != NULL);
-    assert(new_substring != NULL);
 
-    return fancy_string_replaced_value(self, old_substring->value, new_substring->value, replace_n);
+    fancy_string_view_t substring = fancy_string_view_substring(fancy_string_view(self), start, end);
+    return create_from_memory(substring.value, substring.n);
 }
 
-void fancy_string_lowercase(fancy_string_t *const self)
+void fancy_string_trim_left(fancy_string_t *const self)
 {
     assert(self != NULL);
 
-    to_lower_or_upper_case(self, true);
+    size_t start, end;
+    whitespace_bounds(self, true, false, &start, &end);
+    keep_range(self, start, end);
 }
 
-fancy_string_t *fancy_string_lowercased(fancy_string_t const *const self)
+fancy_string_t *fancy_string_trimmed_left(fancy_string_t const *const self)
 {
     assert(self != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_lowercase(clone);
-    return clone;
+    size_t start, end;
+    whitespace_bounds(self, true, false, &start, &end);
+    return create_from_memory(&self->value[start], end - start);
 }
 
-void fancy_string_uppercase(fancy_string_t *const self)
+void fancy_string_trim_right(fancy_string_t *const self)
 {
     assert(self != NULL);
 
-    to_lower_or_upper_case(self, false);
+    size_t start, end;
+    whitespace_bounds(self, false, true, &start, &end);
+    keep_range(self, start, end);
 }
 
-fancy_string_t *fancy_string_uppercased(fancy_string_t const *const self)
+fancy_string_t *fancy_string_trimmed_right(fancy_string_t const *const self)
 {
     assert(self != NULL);
 
-    fancy_string_t *clone = fancy_string_clone(self);
-    fancy_string_uppercase(clone);
-    return clone;
+    size_t start, end;
+    whitespace_bounds(self, false, true, &start, &end);
+    return create_from_memory(&self->value[start], end - start);
 }
 
-void fancy_string_line_break(fancy_string_t *const self, bool with_carriage_return)
+void fancy_string_trim(fancy_string_t *const self)
 {
-    if (with_carriage_return)
-    {
-        fancy_string_append_value(self, "\r");
-    }
-    fancy_string_append_value(self, "\n");
+    assert(self != NULL);
+
+    size_t start, end;
+    whitespace_bounds(self, true, true, &start, &end);
+    keep_range(self, start, end);
 }
 
-fancy_string_regex_t *fancy_string_regex_create(fancy_string_t const *const string, fancy_string_t const *const pattern, ssize_t n_max_matches)
+fancy_string_t *fancy_string_trimmed(fancy_string_t const *const self)
 {
-    assert(string != NULL);
-    assert(pattern != NULL);
+    assert(self != NULL);
 
-    if (fancy_string_is_empty(pattern))
-    {
-        return NULL;
-    }
+    size_t start, end;
+    whitespace_bounds(self, true, true, &start, &end);
+    return create_from_memory(&self->value[start], end - start);
+}
 
-    size_t n_string = fancy_string_size(string);
-    if (n_string == 0)
-    {
-        return NULL;
-    }
+fancy_string_view_t fancy_string_trimmed_view(fancy_string_t const *const self)
+{
+    assert(self != NULL);
 
-    regex_t re;
-    int reason_code;
+    return fancy_string_view_trimmed(fancy_string_view(self));
+}
 
-    fancy_string_t *regular_expression_clone = fancy_string_clone(pattern);
-    // NOTE: Here we use the internal clone to avoid relying on an external value (i.e., we want
-    // `re` to use memory that belongs (in this case, will belong) to `self`.
-    reason_code = regcomp(&re, regular_expression_clone->value, REG_EXTENDED);
-    if (reason_code != 0)
-    {
-        // NOTE: `regcomp` does not appear to be using `errno` for error reporting. My
-        // understanding is that it returns the error code directly (see `man 3 regcomp`).
-        // So we don't need to bother about resetting `errno` if we encounter and error. For
-        // now, the API simply returns NULL if an error occurs.
-        regfree(&re);
-        fancy_string_destroy(regular_expression_clone);
-        return NULL;
-    }
+void fancy_string_trim_chars(fancy_string_t *const self, char const *const charset)
+{
+    assert(self != NULL);
+    assert(charset != NULL);
 
-    fancy_string_regex_t *self = my_malloc(sizeof(fancy_string_regex_t));
+    fancy_string_trim_chars_n(self, charset, strlen(charset));
+}
 
-    self->pattern = regular_expression_clone;
-    self->string = fancy_string_clone(string);
-    self->n_max_matches = n_max_matches;
-    self->n_matches = 0;
-    self->start_array = NULL;
-    self->end_array = NULL;
+void fancy_string_trim_chars_n(fancy_string_t *const self, char const *const charset, size_t n_charset)
+{
+    assert(self != NULL);
+    assert(charset != NULL);
 
-    char *tmp = self->string->value;
-    while (self->n_max_matches == -1 || self->n_matches < (size_t)self->n_max_matches)
-    {
-        regmatch_t match;
-        reason_code = regexec(&re, tmp, 1, &match, 0);
-        if (reason_code == 0)
-        {
-            if (
-                ((unsigned)match.rm_so) > n_string ||
-                ((unsigned)match.rm_eo) > n_string ||
-                match.rm_so > match.rm_eo)
-            {
-                // fprintf(stderr, "We probably have garbage. Please review this\n");
-                regfree(&re);
-                fancy_string_regex_destroy(self);
-                return NULL;
-            }
+    charset_t set;
+    charset_init(&set, charset, n_charset);
+    trim_charset(self, &set);
+}
 
-            if (match.rm_so == match.rm_eo)
-            {
-                // We need this, else the loop will go on forever
-                // in situations where we have a "wildcard match".
-                break;
-            }
+fancy_string_t *fancy_string_trimmed_chars(fancy_string_t const *const self, char const *const charset)
+{
+    assert(self != NULL);
+    assert(charset != NULL);
 
-            if (self->start_array == NULL)
-            {
-                self->start_array = my_malloc(sizeof(size_t));
-                self->end_array = my_malloc(sizeof(size_t));
-            }
-            else
-            {
-                self->start_array = my_realloc(self->start_array, sizeof(size_t) * (self->n_matches + 1));
-                self->end_array = my_realloc(self->end_array, sizeof(size_t) * (self->n_matches + 1));
-            }
-            size_t offset = self->n_matches > 0 ? self->end_array[self->n_matches - 1] : 0;
-            self->start_array[self->n_matches] = match.rm_so + offset;
-            self->end_array[self->n_matches] = match.rm_eo + offset;
-            self->n_matches += 1;
-            tmp += match.rm_eo;
-        }
-        else if (reason_code == REG_NOMATCH)
-        {
-            break;
-        }
-        else
-        {
-            regfree(&re);
-            fancy_string_regex_destroy(self);
-            return NULL;
-        }
-    }
+    charset_t set;
+    charset_init(&set, charset, strlen(charset));
+    size_t start, end;
+    charset_bounds(self, &set, &start, &end);
+    return create_from_memory(&self->value[start], end - start);
+}
 
-    regfree(&re);
+fancy_string_array_t *fancy_string_split_by_value(fancy_string_t const *const self, char const *const separator, ssize_t n_max_splits)
+{
+    assert(self != NULL);
+    assert(separator != NULL);
 
-    return self;
+    return split_memory(self, separator, strlen(separator), n_max_splits);
 }
 
-void fancy_string_regex_destroy(fancy_string_regex_t *const self)
+fancy_string_array_t *fancy_string_split_by_value_n(fancy_string_t const *const self, char const *const separator, size_t n_separator, ssize_t n_max_splits)
 {
     assert(self != NULL);
+    assert(separator != NULL);
 
-    if (self->start_array != NULL)
-    {
-        my_free(self->start_array);
-    }
-    if (self->end_array != NULL)
-    {
-        my_free(self->end_array);
-    }
-    fancy_string_destroy(self->pattern);
-    fancy_string_destroy(self->string);
-    my_free(self);
+    return split_memory(self, separator, n_separator, n_max_splits);
 }
 
-static void fancy_string_regex_debug_verbose_callback(fancy_string_t *const match, size_t start, size_t end, fancy_string_t const *const string, void *context)
+fancy_string_array_t *fancy_string_split(fancy_string_t const *const self, fancy_string_t const *const separator, ssize_t n_max_splits)
 {
-    IGNORE_UNUSED(start);
-    IGNORE_UNUSED(end);
-    IGNORE_UNUSED(string);
-    IGNORE_UNUSED(context);
+    assert(self != NULL);
+    assert(separator != NULL);
 
-    fancy_string_prepend_value(match, "{{");
-    fancy_string_append_value(match, "}}");
+    return split_memory(self, separator->value, separator->n, n_max_splits);
 }
 
-void fancy_string_regex_debug(fancy_string_regex_t const *const self, FILE *stream, bool verbose)
+fancy_string_array_t *fancy_string_split_by_any(fancy_string_t const *const self, char const *const charset, ssize_t n_max_splits)
 {
     assert(self != NULL);
+    assert(charset != NULL);
 
-    fancy_string_array_t *matches = NULL;
-    fancy_string_t *verbose_string = NULL;
+    return fancy_string_split_by_any_n(self, charset, strlen(charset), n_max_splits);
+}
 
-    if (verbose)
-    {
-        matches = fancy_string_regex_matches_to_strings(self);
-        verbose_string = fancy_string_regex_to_string_with_updated_matches(self, fancy_string_regex_debug_verbose_callback, NULL);
-    }
+fancy_string_array_t *fancy_string_split_by_any_n(fancy_string_t const *const self, char const *const charset, size_t n_charset, ssize_t n_max_splits)
+{
+    assert(self != NULL);
+    assert(charset != NULL);
 
-    fprintf(stream, "fancy_string_regex_t {\n");
-    fprintf(stream, "\t.string = fancy_string_t[%zu](%s),\n", self->string->n, self->string->value);
-    fprintf(stream, "\t.pattern = fancy_string_t[%zu](%s),\n", self->pattern->n, self->pattern->value);
-    fprintf(stream, "\t.n_matches = %zu,\n", self->n_matches);
-    fprintf(stream, "\t.n_max_matches = %zd,\n", self->n_max_matches);
-    fprintf(stream, "\t.matches = {\n");
-    for (size_t i = 0; i < self->n_matches; i++)
+    charset_t set;
+    charset_init(&set, charset, n_charset);
+    return split_any_memory(self, &set, n_max_splits);
+}
+
+fancy_string_array_t *fancy_string_split_arena(fancy_string_t const *const self, fancy_string_view_t separator, ssize_t n_max_splits)
+{
+    assert(self != NULL);
+    assert(separator.value != NULL);
+
+    return split_arena_memory(self, separator.value, separator.n, n_max_splits);
+}
+
+fancy_string_split_iter_t fancy_string_split_iter(fancy_string_t const *const self, fancy_string_view_t separator, ssize_t n_max_splits)
+{
+    assert(self != NULL);
+    assert(separator.value != NULL);
+
+    return (fancy_string_split_iter_t){
+        .value = self->value,
+        .n = self->n,
+        .separator = separator.value,
+        .n_separator = separator.n,
+        .pattern = NULL,
+        .n_splits = 0,
+        .n_max_splits = n_max_splits,
+        .position = 0,
+        .is_done = false,
+    };
+}
+
+fancy_string_split_iter_t fancy_string_split_iter_by_pattern(fancy_string_t const *const self, fancy_string_pattern_t const *const pattern, ssize_t n_max_splits)
+{
+    assert(self != NULL);
+    assert(pattern != NULL);
+
+    return (fancy_string_split_iter_t){
+        .value = self->value,
+        .n = self->n,
+        .separator = NULL,
+        .n_separator = 0,
+        .pattern = pattern,
+        .n_splits = 0,
+        .n_max_splits = n_max_splits,
+        .position = 0,
+        .is_done = false,
+    };
+}
+
+bool fancy_string_split_iter_next(fancy_string_split_iter_t *const self, fancy_string_view_t *const component)
+{
+    assert(self != NULL);
+    assert(component != NULL);
+
+    if (self->is_done)
     {
-        if (matches != NULL)
+        return false;
+    }
+    size_t start = self->position;
+    if (self->n_max_splits == -1 || self->n_splits < (size_t)self->n_max_splits)
+    {
+        ssize_t end = -1;
+        size_t next = 0;
+        if (self->pattern != NULL)
         {
-            fprintf(
-                stream,
-                "\t\t { .start = %zu, .end = %zu, .verbose_match[calculated] = fancy_string_t[%zu](%s) }\n",
-                self->start_array[i],
-                self->end_array[i],
-                matches->array[i]->n,
-                matches->array[i]->value);
+            // NOTE: The search stops once the next match is known, and the components that follow
+            // the first empty match are not split (see `fancy_string_regex_create_with_pattern`).
+            size_t match_start;
+            if (pattern_next_match(self->pattern, self->value, self->n, start, &match_start, &next))
+            {
+                end = (ssize_t)match_start;
+            }
         }
         else
         {
-            fprintf(stream, "\t\t { .start = %zu, .end = %zu }\n", self->start_array[i], self->end_array[i]);
+            // NOTE: The search stops at the first separator, such that its cost is proportional
+            // to the component, not to the remainder of the string.
+            ssize_t index = index_of_memory(&self->value[start], self->n - start, self->separator, self->n_separator);
+            if (index != -1)
+            {
+                end = (ssize_t)start + index;
+                next = (size_t)end + self->n_separator;
+            }
+        }
+        if (end != -1)
+        {
+            *component = (fancy_string_view_t){.value = &self->value[start], .n = (size_t)end - start};
+            self->position = next;
+            self->n_splits++;
+            return true;
         }
     }
-    fprintf(stream, "\t},\n");
-    if (verbose_string != NULL)
-    {
-        fprintf(stream, "\t.verbose_string[calculated] = fancy_string_t[%zu](%s),\n", verbose_string->n, verbose_string->value);
-    }
-    fprintf(stream, "}\n");
+    *component = (fancy_string_view_t){.value = &self->value[start], .n = self->n - start};
+    self->is_done = true;
+    return true;
+}
 
-    if (matches != NULL)
-    {
-        fancy_string_array_destroy(matches);
-        fancy_string_destroy(verbose_string);
-    }
+void fancy_string_pad_start(fancy_string_t *const self, size_t target_size, char value)
+{
+    assert(self != NULL);
+
+    pad_memory(self, target_size, value, true);
 }
 
-fancy_string_array_t *fancy_string_regex_matches_to_strings(fancy_string_regex_t const *const self)
+fancy_string_t *fancy_string_padded_start(fancy_string_t const *const self, size_t target_size, char value)
 {
     assert(self != NULL);
 
-    fancy_string_array_t *a = fancy_string_array_create();
+    return padded_memory(self, target_size, value, true);
+}
 
-    for (size_t i = 0; i < self->n_matches; i++)
-    {
-        size_t start = self->start_array[i];
-        size_t end = self->end_array[i];
-        fancy_string_t *s = fancy_string_substring(self->string, start, end);
-        fancy_string_array_push(a, s);
-        fancy_string_destroy(s);
-    }
+void fancy_string_pad_end(fancy_string_t *const self, size_t target_size, char value)
+{
+    assert(self != NULL);
 
-    return a;
+    pad_memory(self, target_size, value, false);
 }
 
-fancy_string_t *fancy_string_regex_replaced_matches(fancy_string_regex_t *const self, fancy_string_t *new_string)
+fancy_string_t *fancy_string_padded_end(fancy_string_t const *const self, size_t target_size, char value)
 {
     assert(self != NULL);
-    assert(new_string != NULL);
 
-    if (self->n_matches == 0)
-    {
-        return fancy_string_clone(self->string);
-    }
+    return padded_memory(self, target_size, value, false);
+}
 
-    fancy_string_t *string = fancy_string_create_empty();
+void fancy_string_replace_value(fancy_string_t *const self, char const *const old_value, char const *const new_value, ssize_t replace_n)
+{
+    assert(self != NULL);
+    assert(old_value != NULL);
+    assert(new_value != NULL);
 
-    size_t previous_end = 0;
-    for (size_t i = 0; i < self->n_matches; i++)
-    {
-        fancy_string_t *prefix = fancy_string_substring(self->string, previous_end, self->start_array[i]);
-        fancy_string_append(string, prefix);
-        fancy_string_destroy(prefix);
-        fancy_string_append(string, new_string);
-        previous_end = self->end_array[i];
-    }
+    replace_memory(self, old_value, strlen(old_value), new_value, strlen(new_value), replace_n);
+}
 
-    fancy_string_t *tmp = fancy_string_substring(self->string, previous_end, -1);
-    fancy_string_append(string, tmp);
-    fancy_string_destroy(tmp);
+void fancy_string_replace_value_n(fancy_string_t *const self, char const *const old_value, size_t n_old_value, char const *const new_value, size_t n_new_value, ssize_t replace_n)
+{
+    assert(self != NULL);
+    assert(old_value != NULL);
+    assert(new_value != NULL);
 
-    return string;
+    replace_memory(self, old_value, n_old_value, new_value, n_new_value, replace_n);
 }
 
-fancy_string_array_t *fancy_string_regex_split_at_matches(fancy_string_regex_t const *const self)
+void fancy_string_replace(fancy_string_t *const self, fancy_string_t const *const old_substring, fancy_string_t const *const new_substring, ssize_t replace_n)
 {
     assert(self != NULL);
+    assert(old_substring != NULL);
+    assert(new_substring != NULL);
 
-    if (self->n_matches == 0)
-    {
-        return fancy_string_array_create_with_values(self->string->value, NULL);
-    }
+    replace_memory(self, old_substring->value, old_substring->n, new_substring->value, new_substring->n, replace_n);
+}
 
-    fancy_string_array_t *array = fancy_string_array_create();
+fancy_string_t *fancy_string_replaced_value(fancy_string_t const *const self, char const *const old_value, char const *const new_value, ssize_t replace_n)
+{
+    assert(self != NULL);
+    assert(old_value != NULL);
+    assert(new_value != NULL);
 
-    size_t previous_end = 0;
-    for (size_t i = 0; i < self->n_matches; i++)
-    {
-        fancy_string_t *tmp = fancy_string_substring(self->string, previous_end, self->start_array[i]);
-        fancy_string_array_push(array, tmp);
-        fancy_string_destroy(tmp);
-        previous_end = self->end_array[i];
-    }
+    fancy_string_t *clone = fancy_string_clone(self);
+    fancy_string_replace_value(clone, old_value, new_value, replace_n);
+    return clone;
+}
 
-    fancy_string_t *tmp = fancy_string_substring(self->string, previous_end, -1);
-    // NOTE: We add it anyways, else it won't be consistent with `fancy_string_split`
-    // if (!fancy_string_is_empty(tmp))
-    // {
-    //     fancy_string_array_push(array, tmp);
-    // }
-    fancy_string_array_push(array, tmp);
-    fancy_string_destroy(tmp);
+fancy_string_t *fancy_string_replaced_value_n(fancy_string_t const *const self, char const *const old_value, size_t n_old_value, char const *const new_value, size_t n_new_value, ssize_t replace_n)
+{
+    assert(self != NULL);
+    assert(old_value != NULL);
+    assert(new_value != NULL);
 
-    return array;
+    fancy_string_t *clone = fancy_string_clone(self);
+    replace_memory(clone, old_value, n_old_value, new_value, n_new_value, replace_n);
+    return clone;
 }
 
-size_t fancy_string_regex_match_count(fancy_string_regex_t const *const self)
+fancy_string_t *fancy_string_replaced(fancy_string_t const *const self, fancy_string_t const *const old_substring, fancy_string_t const *const new_substring, ssize_t replace_n)
 {
     assert(self != NULL);
+    assert(old_substring != NULL);
+    assert(new_substring != NULL);
 
-    return self->n_matches;
+    fancy_string_t *clone = fancy_string_clone(self);
+    fancy_string_replace(clone, old_substring, new_substring, replace_n);
+    return clone;
 }
 
-bool fancy_string_regex_has_match(fancy_string_regex_t const *const self)
+void fancy_string_lowercase(fancy_string_t *const self)
 {
     assert(self != NULL);
 
-    return self->n_matches > 0 ? true : false;
+    to_lower_or_upper_case(self, true, false);
 }
 
-ssize_t fancy_string_regex_max_number_of_matches(fancy_string_regex_t const *const self)
+fancy_string_t *fancy_string_lowercased(fancy_string_t const *const self)
 {
     assert(self != NULL);
 
-    return self->n_max_matches;
+    return to_lower_or_upper_cased(self, true, false);
 }
 
-bool fancy_string_regex_max_number_of_matches_reached(fancy_string_regex_t const *const self)
+void fancy_string_lowercase_locale(fancy_string_t *const self)
 {
     assert(self != NULL);
 
-    if (self->n_max_matches == -1)
+    to_lower_or_upper_case(self, true, true);
+}
+
+fancy_string_t *fancy_string_lowercased_locale(fancy_string_t const *const self)
+{
+    assert(self != NULL);
+
+    return to_lower_or_upper_cased(self, true, true);
+}
+
+void fancy_string_uppercase(fancy_string_t *const self)
+{
+    assert(self != NULL);
+
+    to_lower_or_upper_case(self, false, false);
+}
+
+fancy_string_t *fancy_string_uppercased(fancy_string_t const *const self)
+{
+    assert(self != NULL);
+
+    return to_lower_or_upper_cased(self, false, false);
+}
+
+void fancy_string_uppercase_locale(fancy_string_t *const self)
+{
+    assert(self != NULL);
+
+    to_lower_or_upper_case(self, false, true);
+}
+
+fancy_string_t *fancy_string_uppercased_locale(fancy_string_t const *const self)
+{
+    assert(self != NULL);
+
+    return to_lower_or_upper_cased(self, false, true);
+}
+
+void fancy_string_line_break(fancy_string_t *const self, bool with_carriage_return)
+{
+    if (with_carriage_return)
     {
-        return false;
+        fancy_string_append_value(self, "\r");
     }
-
-    return self->n_matches == ((size_t)self->n_max_matches) ? true : false;
+    fancy_string_append_value(self, "\n");
 }
 
-fancy_string_t *fancy_string_regex_string(fancy_string_regex_t const *const self)
+fancy_string_view_t fancy_string_view(fancy_string_t const *const self)
 {
     assert(self != NULL);
 
-    return fancy_string_clone(self->string);
+    return (fancy_string_view_t){.value = self->value, .n = self->n};
+}
+
+fancy_string_view_t fancy_string_view_from_value(char const *const value)
+{
+    assert(value != NULL);
+
+    return (fancy_string_view_t){.value = value, .n = strlen(value)};
+}
+
+fancy_string_view_t fancy_string_view_from_memory(char const *const value, size_t n)
+{
+    assert(value != NULL);
+
+    return (fancy_string_view_t){.value = value, .n = n};
+}
+
+fancy_string_t *fancy_string_from_view(fancy_string_view_t view)
+{
+    assert(view.value != NULL);
+
+    return create_from_memory(view.value, view.n);
+}
+
+fancy_string_view_t fancy_string_view_substring(fancy_string_view_t view, ssize_t start, ssize_t end)
+{
+    assert(view.value != NULL);
+
+    fancy_string_view_t empty = {.value = view.value, .n = 0};
+
+    size_t n = view.n;
+    if (n == 0)
+    {
+        return empty;
+    }
+
+    size_t index_start = start == -1 ? 0 : (size_t)start;
+    size_t index_end = end == -1 ? n : (size_t)end;
+
+    if (index_start == index_end)
+    {
+        return empty;
+    }
+
+    if (index_start > index_end)
+    {
+        size_t index_tmp = index_start;
+        index_start = index_end;
+        index_end = index_tmp;
+    }
+
+    if (index_start >= n)
+    {
+        return empty;
+    }
+    if (index_end > n)
+    {
+        index_end = n;
+    }
+
+    return (fancy_string_view_t){.value = &view.value[index_start], .n = index_end - index_start};
+}
+
+fancy_string_view_t fancy_string_view_trimmed(fancy_string_view_t view)
+{
+    assert(view.value != NULL);
+
+    size_t start = 0;
+    size_t end = view.n;
+    while (start < end && is_whitespace(&view.value[start]))
+    {
+        start++;
+    }
+    while (end > start && is_whitespace(&view.value[end - 1]))
+    {
+        end--;
+    }
+    return (fancy_string_view_t){.value = &view.value[start], .n = end - start};
+}
+
+bool fancy_string_view_equals(fancy_string_view_t view, fancy_string_view_t other)
+{
+    assert(view.value != NULL);
+    assert(other.value != NULL);
+
+    return equals_memory(view.value, view.n, other.value, other.n);
+}
+
+bool fancy_string_view_starts_with(fancy_string_view_t view, fancy_string_view_t prefix)
+{
+    assert(view.value != NULL);
+    assert(prefix.value != NULL);
+
+    return starts_with_memory(view.value, view.n, prefix.value, prefix.n);
+}
+
+bool fancy_string_view_ends_with(fancy_string_view_t view, fancy_string_view_t suffix)
+{
+    assert(view.value != NULL);
+    assert(suffix.value != NULL);
+
+    return ends_with_memory(view.value, view.n, suffix.value, suffix.n);
+}
+
+ssize_t fancy_string_view_index_of(fancy_string_view_t view, fancy_string_view_t needle)
+{
+    assert(view.value != NULL);
+    assert(needle.value != NULL);
+
+    return index_of_memory(view.value, view.n, needle.value, needle.n);
+}
+
+fancy_string_searcher_t *fancy_string_searcher_create(fancy_string_view_t needle)
+{
+    assert(needle.value != NULL);
+
+    fancy_string_searcher_t *self = my_malloc(sizeof(fancy_string_searcher_t) + sizeof(char) * (needle.n + 1));
+    memcpy(self->value, needle.value, needle.n);
+    self->value[needle.n] = '\0';
+    searcher_init(self, self->value, needle.n);
+    return self;
+}
+
+void fancy_string_searcher_destroy(fancy_string_searcher_t *const self)
+{
+    assert(self != NULL);
+
+    my_free(self);
+}
+
+fancy_string_view_t fancy_string_searcher_needle(fancy_string_searcher_t const *const self)
+{
+    assert(self != NULL);
+
+    return (fancy_string_view_t){.value = self->needle, .n = self->n};
+}
+
+ssize_t fancy_string_searcher_find(fancy_string_searcher_t const *const self, fancy_string_view_t haystack)
+{
+    assert(self != NULL);
+    assert(haystack.value != NULL);
+
+    return searcher_find(self, haystack.value, haystack.n, 0);
+}
+
+ssize_t fancy_string_searcher_find_from(fancy_string_searcher_t const *const self, fancy_string_view_t haystack, size_t offset)
+{
+    assert(self != NULL);
+    assert(haystack.value != NULL);
+
+    return searcher_find(self, haystack.value, haystack.n, offset);
+}
+
+ssize_t fancy_string_searcher_find_last(fancy_string_searcher_t const *const self, fancy_string_view_t haystack)
+{
+    assert(self != NULL);
+    assert(haystack.value != NULL);
+
+    return searcher_find_last(self, haystack.value, haystack.n);
+}
+
+size_t fancy_string_searcher_count(fancy_string_searcher_t const *const self, fancy_string_view_t haystack)
+{
+    assert(self != NULL);
+    assert(haystack.value != NULL);
+
+    size_t count = 0;
+    ssize_t index = searcher_find(self, haystack.value, haystack.n, 0);
+    while (index != -1)
+    {
+        count++;
+        index = searcher_find(self, haystack.value, haystack.n, (size_t)index + self->n);
+    }
+    return count;
+}
+
+fancy_string_multi_matcher_t *fancy_string_multi_matcher_create(fancy_string_array_t const *const needles)
+{
+    assert(needles != NULL);
+
+    fancy_string_multi_matcher_t *self = my_malloc(sizeof(fancy_string_multi_matcher_t));
+    self->n_needles = needles->n;
+    self->offsets = my_malloc(sizeof(size_t) * (needles->n + 1));
+    size_t n_total = 0;
+    for (size_t i = 0; i < needles->n; i++)
+    {
+        self->offsets[i] = n_total;
+        n_total += needles->array[i]->n;
+    }
+    self->offsets[needles->n] = n_total;
+    self->needles = my_malloc(sizeof(char) * (n_total + 1));
+    for (size_t i = 0; i < needles->n; i++)
+    {
+        memcpy(&self->needles[self->offsets[i]], needles->array[i]->value, needles->array[i]->n);
+    }
+    self->needles[n_total] = '\0';
+    multi_matcher_build(self);
+    return self;
+}
+
+void fancy_string_multi_matcher_destroy(fancy_string_multi_matcher_t *const self)
+{
+    assert(self != NULL);
+
+    my_free(self->transitions);
+    my_free(self->states);
+    my_free(self->needles);
+    my_free(self->offsets);
+    my_free(self);
+}
+
+size_t fancy_string_multi_matcher_size(fancy_string_multi_matcher_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->n_needles;
+}
+
+fancy_string_view_t fancy_string_multi_matcher_needle(fancy_string_multi_matcher_t const *const self, size_t index)
+{
+    assert(self != NULL);
+
+    if (index >= self->n_needles)
+    {
+        return (fancy_string_view_t){.value = "", .n = 0};
+    }
+    return (fancy_string_view_t){.value = &self->needles[self->offsets[index]], .n = self->offsets[index + 1] - self->offsets[index]};
+}
+
+size_t fancy_string_multi_matcher_find_all(fancy_string_multi_matcher_t const *const self, fancy_string_view_t haystack, fancy_string_multi_match_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(haystack.value != NULL);
+
+    size_t count = 0;
+    uint32_t row = 0;
+    multi_matcher_scan(self, haystack.value, haystack.n, 0, &row, fn, context, &count);
+    return count;
+}
+
+size_t fancy_string_multi_matcher_find_all_in_stream(fancy_string_multi_matcher_t const *const self, FILE *stream, fancy_string_multi_match_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(stream != NULL);
+
+    // NOTE: The automaton's state is carried over from one block to the next, such
+    // that matches that straddle two blocks are found too.
+    char *buffer = my_malloc(sizeof(char) * FANCY_STRING_STREAM_BLOCK_SIZE);
+    size_t count = 0;
+    size_t offset = 0;
+    uint32_t row = 0;
+    size_t n_read;
+    while ((n_read = fread(buffer, sizeof(char), FANCY_STRING_STREAM_BLOCK_SIZE, stream)) > 0)
+    {
+        if (!multi_matcher_scan(self, buffer, n_read, offset, &row, fn, context, &count))
+        {
+            break;
+        }
+        offset += n_read;
+    }
+    my_free(buffer);
+    return count;
+}
+
+ssize_t fancy_string_multi_replace(fancy_string_t *const self, fancy_string_multi_matcher_t const *const matcher, fancy_string_array_t const *const replacements)
+{
+    assert(self != NULL);
+    assert(matcher != NULL);
+    assert(replacements != NULL);
+
+    if (replacements->n != 1 && replacements->n != matcher->n_needles)
+    {
+        return -1;
+    }
+
+    // NOTE: The first pass only computes the size of the result, such that the
+    // second one can write it into a buffer of the right size.
+    size_t n_replaced = 0;
+    size_t n_output = multi_replace_memory(matcher, self->value, self->n, replacements, NULL, &n_replaced);
+    if (n_replaced == 0)
+    {
+        return 0;
+    }
+    char *output = my_malloc(sizeof(char) * (n_output + 1));
+    multi_replace_memory(matcher, self->value, self->n, replacements, output, &n_replaced);
+    output[n_output] = '\0';
+    adopt_buffer(self, output, n_output);
+    return (ssize_t)n_replaced;
+}
+
+fancy_string_t *fancy_string_multi_replaced(fancy_string_t const *const self, fancy_string_multi_matcher_t const *const matcher, fancy_string_array_t const *const replacements)
+{
+    assert(self != NULL);
+    assert(matcher != NULL);
+    assert(replacements != NULL);
+
+    if (replacements->n != 1 && replacements->n != matcher->n_needles)
+    {
+        return NULL;
+    }
+
+    size_t n_replaced = 0;
+    size_t n_output = multi_replace_memory(matcher, self->value, self->n, replacements, NULL, &n_replaced);
+    fancy_string_t *replaced = allocate_string(n_output);
+    multi_replace_memory(matcher, self->value, self->n, replacements, replaced->value, &n_replaced);
+    replaced->value[n_output] = '\0';
+    replaced->n = n_output;
+    return replaced;
+}
+
+fancy_string_regex_t *fancy_string_regex_create(fancy_string_t const *const string, fancy_string_t const *const pattern, ssize_t n_max_matches)
+{
+    assert(string != NULL);
+    assert(pattern != NULL);
+
+    if (fancy_string_is_empty(pattern) || fancy_string_is_empty(string))
+    {
+        return NULL;
+    }
+
+    fancy_string_pattern_t *compiled_pattern = regex_cache_acquire(pattern, REG_EXTENDED);
+    if (compiled_pattern == NULL)
+    {
+        return NULL;
+    }
+    fancy_string_regex_t *self = fancy_string_regex_create_with_pattern(string, compiled_pattern, n_max_matches);
+    pattern_release(compiled_pattern);
+    return self;
+}
+
+fancy_string_pattern_t *fancy_string_pattern_create(fancy_string_t const *const pattern)
+{
+    assert(pattern != NULL);
+
+    if (fancy_string_is_empty(pattern))
+    {
+        return NULL;
+    }
+
+    return compile_pattern(pattern, REG_EXTENDED);
+}
+
+fancy_string_pattern_t *fancy_string_pattern_create_with_engine(fancy_string_t const *const pattern, fancy_string_regex_engine_t engine)
+{
+    assert(pattern != NULL);
+
+    fancy_string_pattern_t *self = fancy_string_pattern_create(pattern);
+    if (self != NULL && engine == FANCY_STRING_REGEX_ENGINE_DFA && !pattern_compile_dfa(self))
+    {
+        pattern_release(self);
+        return NULL;
+    }
+    return self;
+}
+
+fancy_string_regex_engine_t fancy_string_pattern_engine(fancy_string_pattern_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->engine;
+}
+
+void fancy_string_pattern_destroy(fancy_string_pattern_t *const self)
+{
+    assert(self != NULL);
+
+    pattern_release(self);
+}
+
+fancy_string_regex_t *fancy_string_regex_create_with_pattern(fancy_string_t const *const string, fancy_string_pattern_t const *const pattern, ssize_t n_max_matches)
+{
+    assert(string != NULL);
+    assert(pattern != NULL);
+
+    size_t n_string = fancy_string_size(string);
+    if (n_string == 0)
+    {
+        return NULL;
+    }
+
+    fancy_string_regex_t *self = my_malloc(sizeof(fancy_string_regex_t));
+
+    // NOTE: The regex object never mutates its copies of the pattern and of the string,
+    // so both are kept in shared mode, which makes `fancy_string_regex_string` and
+    // `fancy_string_regex_pattern` O(1).
+    self->pattern = fancy_string_clone(pattern->pattern);
+    self->string = create_shared_clone(string);
+    self->n_max_matches = n_max_matches;
+    self->n_matches = 0;
+    self->start_array = NULL;
+    self->end_array = NULL;
+
+    // NOTE: `regexec` is called from `position` onward, which is the end of the previous match, unless
+    // the prefilter showed that the input before some later position cannot contain the next match.
+    size_t position = 0;
+    fancy_string_prefilter_stats_t stats = {0};
+    regex_search_t search;
+    regex_search_init(&search, pattern, false);
+    bool is_streamed = false;
+    while (self->n_max_matches == -1 || self->n_matches < (size_t)self->n_max_matches)
+    {
+        // NOTE: With the built-in engine, once the scans for the longest matches have read much more than the
+        // input, the remaining matches are found by a `regex_stream_t`, which reads each byte only once.
+        if (search.n_read > FANCY_STRING_DFA_MAXIMUM_READ_FACTOR * n_string)
+        {
+            is_streamed = true;
+            break;
+        }
+        size_t skip;
+        if (!pattern_prefilter(pattern, self->string->value + position, n_string - position, &skip, &stats))
+        {
+            break;
+        }
+        position += skip;
+        regmatch_t match;
+        int reason_code = regex_search_exec(&search, self->string->value + position, n_string - position, &match);
+        if (reason_code == 0)
+        {
+            if (
+                ((unsigned)match.rm_so) > n_string - position ||
+                ((unsigned)match.rm_eo) > n_string - position ||
+                match.rm_so > match.rm_eo)
+            {
+                // fprintf(stderr, "We probably have garbage. Please review this\n");
+                regex_search_release(&search);
+                pattern_record_prefilter_stats(pattern, &stats);
+                fancy_string_regex_destroy(self);
+                return NULL;
+            }
+
+            if (match.rm_so == match.rm_eo)
+            {
+                // We need this, else the loop will go on forever
+                // in situations where we have a "wildcard match".
+                break;
+            }
+
+            regex_add_match(self, match.rm_so + position, match.rm_eo + position);
+            position += match.rm_eo;
+        }
+        else if (reason_code == REG_NOMATCH)
+        {
+            break;
+        }
+        else
+        {
+            regex_search_release(&search);
+            pattern_record_prefilter_stats(pattern, &stats);
+            fancy_string_regex_destroy(self);
+            return NULL;
+        }
+    }
+    regex_search_release(&search);
+    pattern_record_prefilter_stats(pattern, &stats);
+    if (is_streamed)
+    {
+        // NOTE: `^` holds at `position`, just like it does at the start of a `regexec` call.
+        regex_collector_t collector = {.regex = self, .offset = position};
+        regex_stream_t stream;
+        regex_stream_init(&stream, pattern, regex_collect_match, &collector);
+        regex_stream_run(&stream, self->string->value + position, n_string - position);
+        regex_stream_finish(&stream);
+        regex_stream_release(&stream);
+    }
+
+    return self;
+}
+
+fancy_string_regex_match_info_t fancy_string_pattern_find(fancy_string_pattern_t const *const self, fancy_string_view_t subject)
+{
+    assert(self != NULL);
+
+    fancy_string_regex_match_info_t info = {.index = -1, .start = 0, .end = 0};
+    if (subject.n == 0)
+    {
+        return info;
+    }
+    size_t skip;
+    fancy_string_prefilter_stats_t stats = {0};
+    bool is_candidate = pattern_prefilter(self, subject.value, subject.n, &skip, &stats);
+    pattern_record_prefilter_stats(self, &stats);
+    if (!is_candidate)
+    {
+        return info;
+    }
+#ifdef REG_STARTEND
+    char const *value = subject.value;
+#else
+    // NOTE: Without `REG_STARTEND`, the subject has to be null-terminated.
+    char *value = my_malloc(sizeof(char) * (subject.n + 1));
+    memcpy(value, subject.value, subject.n);
+    value[subject.n] = '\0';
+#endif
+    // NOTE: The match state lives on the caller's stack, such that many threads can use `self` at once.
+    regmatch_t match;
+    regex_search_t search;
+    regex_search_init(&search, self, true);
+    int reason_code = regex_search_exec(&search, value + skip, subject.n - skip, &match);
+    regex_search_release(&search);
+    if (reason_code == 0 && match.rm_so < match.rm_eo && (size_t)match.rm_eo <= subject.n - skip)
+    {
+        info.index = 0;
+        info.start = skip + (size_t)match.rm_so;
+        info.end = skip + (size_t)match.rm_eo;
+    }
+#ifndef REG_STARTEND
+    my_free(value);
+#endif
+    return info;
+}
+
+bool fancy_string_pattern_has_match(fancy_string_pattern_t const *const self, fancy_string_view_t subject)
+{
+    assert(self != NULL);
+
+    return fancy_string_pattern_find(self, subject).index != -1;
+}
+
+ssize_t fancy_string_pattern_find_all(fancy_string_pattern_t const *const self, fancy_string_view_t subject, fancy_string_pattern_match_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(subject.value != NULL);
+
+    if (self->engine != FANCY_STRING_REGEX_ENGINE_DFA)
+    {
+        return -1;
+    }
+    regex_stream_t stream;
+    regex_stream_init(&stream, self, fn, context);
+    regex_stream_run(&stream, subject.value, subject.n);
+    regex_stream_finish(&stream);
+    size_t count = stream.count;
+    regex_stream_release(&stream);
+    return (ssize_t)count;
+}
+
+ssize_t fancy_string_pattern_find_all_in_stream(fancy_string_pattern_t const *const self, FILE *stream, fancy_string_pattern_match_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(stream != NULL);
+
+    if (self->engine != FANCY_STRING_REGEX_ENGINE_DFA)
+    {
+        return -1;
+    }
+    // NOTE: The search never goes back, so a single block of the input is kept in memory.
+    char *buffer = my_malloc(sizeof(char) * FANCY_STRING_STREAM_BLOCK_SIZE);
+    regex_stream_t search;
+    regex_stream_init(&search, self, fn, context);
+    size_t n_read;
+    while (!search.is_done && (n_read = fread(buffer, sizeof(char), FANCY_STRING_STREAM_BLOCK_SIZE, stream)) > 0)
+    {
+        regex_stream_run(&search, buffer, n_read);
+    }
+    my_free(buffer);
+    if (ferror(stream))
+    {
+        regex_stream_release(&search);
+        return -1;
+    }
+    regex_stream_finish(&search);
+    size_t count = search.count;
+    regex_stream_release(&search);
+    return (ssize_t)count;
+}
+
+ssize_t fancy_string_pattern_find_all_in_fd(fancy_string_pattern_t const *const self, int fd, fancy_string_pattern_match_t fn, void *context)
+{
+    assert(self != NULL);
+
+    if (self->engine != FANCY_STRING_REGEX_ENGINE_DFA)
+    {
+        return -1;
+    }
+    char *buffer = my_malloc(sizeof(char) * FANCY_STRING_STREAM_BLOCK_SIZE);
+    regex_stream_t search;
+    regex_stream_init(&search, self, fn, context);
+    while (!search.is_done)
+    {
+        ssize_t n_read = read(fd, buffer, FANCY_STRING_STREAM_BLOCK_SIZE);
+        if (n_read == -1 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n_read == -1)
+        {
+            my_free(buffer);
+            regex_stream_release(&search);
+            return -1;
+        }
+        if (n_read == 0)
+        {
+            break;
+        }
+        regex_stream_run(&search, buffer, (size_t)n_read);
+    }
+    my_free(buffer);
+    regex_stream_finish(&search);
+    size_t count = search.count;
+    regex_stream_release(&search);
+    return (ssize_t)count;
+}
+
+void fancy_string_regex_cache_set_capacity(size_t capacity)
+{
+    regex_cache_lock();
+    regex_cache_entry_t *evicted = regex_cache_evict(capacity);
+    regex_cache.capacity = capacity;
+    // NOTE: The hash table has (at least) one bucket per entry.
+    size_t n_buckets = 0;
+    if (capacity != 0)
+    {
+        n_buckets = 16;
+        while (n_buckets < capacity)
+        {
+            n_buckets *= 2;
+        }
+    }
+    regex_cache_resize(n_buckets);
+    regex_cache_unlock();
+    regex_cache_release_entries(evicted);
+}
+
+fancy_string_regex_cache_stats_t fancy_string_regex_cache_stats(void)
+{
+    regex_cache_lock();
+    fancy_string_regex_cache_stats_t stats = {
+        .capacity = regex_cache.capacity,
+        .size = regex_cache.size,
+        .n_hits = regex_cache.n_hits,
+        .n_misses = regex_cache.n_misses,
+        .n_evictions = regex_cache.n_evictions,
+    };
+    regex_cache_unlock();
+    return stats;
+}
+
+void fancy_string_regex_cache_clear(void)
+{
+    regex_cache_lock();
+    regex_cache_entry_t *evicted = regex_cache_evict(0);
+    regex_cache.n_hits = 0;
+    regex_cache.n_misses = 0;
+    regex_cache.n_evictions = 0;
+    regex_cache_unlock();
+    regex_cache_release_entries(evicted);
+}
+
+fancy_string_prefilter_kind_t fancy_string_pattern_prefilter_kind(fancy_string_pattern_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->prefilter;
+}
+
+fancy_string_view_t fancy_string_pattern_prefilter_literal(fancy_string_pattern_t const *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_view_t view = {.value = self->literal, .n = self->n_literal};
+    if (self->literal == NULL)
+    {
+        view.value = "";
+    }
+    return view;
+}
+
+fancy_string_prefilter_stats_t fancy_string_pattern_prefilter_stats(fancy_string_pattern_t const *const self)
+{
+    assert(self != NULL);
+
+    return prefilter_counters_load(&self->counters);
+}
+
+fancy_string_prefilter_stats_t fancy_string_regex_prefilter_stats(void)
+{
+    return prefilter_counters_load(&prefilter_counters);
+}
+
+void fancy_string_regex_destroy(fancy_string_regex_t *const self)
+{
+    assert(self != NULL);
+
+    if (self->start_array != NULL)
+    {
+        my_free(self->start_array);
+    }
+    if (self->end_array != NULL)
+    {
+        my_free(self->end_array);
+    }
+    fancy_string_destroy(self->pattern);
+    fancy_string_destroy(self->string);
+    my_free(self);
+}
+
+static void fancy_string_regex_debug_verbose_callback(fancy_string_t *const match, size_t start, size_t end, fancy_string_t const *const string, void *context)
+{
+    IGNORE_UNUSED(start);
+    IGNORE_UNUSED(end);
+    IGNORE_UNUSED(string);
+    IGNORE_UNUSED(context);
+
+    fancy_string_prepend_value(match, "{{");
+    fancy_string_append_value(match, "}}");
+}
+
+void fancy_string_regex_debug(fancy_string_regex_t const *const self, FILE *stream, bool verbose)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *matches = NULL;
+    fancy_string_t *verbose_string = NULL;
+
+    if (verbose)
+    {
+        matches = fancy_string_regex_matches_to_strings(self);
+        verbose_string = fancy_string_regex_to_string_with_updated_matches(self, fancy_string_regex_debug_verbose_callback, NULL);
+    }
+
+    fprintf(stream, "fancy_string_regex_t {\n");
+    fprintf(stream, "\t.string = fancy_string_t[%zu](%s),\n", self->string->n, self->string->value);
+    fprintf(stream, "\t.pattern = fancy_string_t[%zu](%s),\n", self->pattern->n, self->pattern->value);
+    fprintf(stream, "\t.n_matches = %zu,\n", self->n_matches);
+    fprintf(stream, "\t.n_max_matches = %zd,\n", self->n_max_matches);
+    fprintf(stream, "\t.matches = {\n");
+    for (size_t i = 0; i < self->n_matches; i++)
+    {
+        if (matches != NULL)
+        {
+            fprintf(
+                stream,
+                "\t\t { .start = %zu, .end = %zu, .verbose_match[calculated] = fancy_string_t[%zu](%s) }\n",
+                self->start_array[i],
+                self->end_array[i],
+                matches->array[i]->n,
+                matches->array[i]->value);
+        }
+        else
+        {
+            fprintf(stream, "\t\t { .start = %zu, .end = %zu }\n", self->start_array[i], self->end_array[i]);
+        }
+    }
+    fprintf(stream, "\t},\n");
+    if (verbose_string != NULL)
+    {
+        fprintf(stream, "\t.verbose_string[calculated] = fancy_string_t[%zu](%s),\n", verbose_string->n, verbose_string->value);
+    }
+    fprintf(stream, "}\n");
+
+    if (matches != NULL)
+    {
+        fancy_string_array_destroy(matches);
+        fancy_string_destroy(verbose_string);
+    }
+}
+
+fancy_string_array_t *fancy_string_regex_matches_to_strings(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *a = fancy_string_array_create();
+
+    for (size_t i = 0; i < self->n_matches; i++)
+    {
+        size_t start = self->start_array[i];
+        size_t end = self->end_array[i];
+        fancy_string_t *s = fancy_string_substring(self->string, start, end);
+        fancy_string_array_push(a, s);
+        fancy_string_destroy(s);
+    }
+
+    return a;
+}
+
+fancy_string_t *fancy_string_regex_replaced_matches(fancy_string_regex_t *const self, fancy_string_t *new_string)
+{
+    assert(self != NULL);
+    assert(new_string != NULL);
+
+    if (self->n_matches == 0)
+    {
+        return fancy_string_clone(self->string);
+    }
+
+    fancy_string_t *string = fancy_string_create_empty();
+
+    size_t previous_end = 0;
+    for (size_t i = 0; i < self->n_matches; i++)
+    {
+        fancy_string_t *prefix = fancy_string_substring(self->string, previous_end, self->start_array[i]);
+        fancy_string_append(string, prefix);
+        fancy_string_destroy(prefix);
+        fancy_string_append(string, new_string);
+        previous_end = self->end_array[i];
+    }
+
+    fancy_string_t *tmp = fancy_string_substring(self->string, previous_end, -1);
+    fancy_string_append(string, tmp);
+    fancy_string_destroy(tmp);
+
+    return string;
+}
+
+fancy_string_array_t *fancy_string_regex_split_at_matches(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->n_matches == 0)
+    {
+        fancy_string_array_t *array = fancy_string_array_create();
+        fancy_string_array_push(array, self->string);
+        return array;
+    }
+
+    fancy_string_array_t *array = fancy_string_array_create();
+
+    size_t previous_end = 0;
+    for (size_t i = 0; i < self->n_matches; i++)
+    {
+        fancy_string_t *tmp = fancy_string_substring(self->string, previous_end, self->start_array[i]);
+        fancy_string_array_push(array, tmp);
+        fancy_string_destroy(tmp);
+        previous_end = self->end_array[i];
+    }
+
+    fancy_string_t *tmp = fancy_string_substring(self->string, previous_end, -1);
+    // NOTE: We add it anyways, else it won't be consistent with `fancy_string_split`
+    // if (!fancy_string_is_empty(tmp))
+    // {
+    //     fancy_string_array_push(array, tmp);
+    // }
+    fancy_string_array_push(array, tmp);
+    fancy_string_destroy(tmp);
+
+    return array;
+}
+
+size_t fancy_string_regex_match_count(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->n_matches;
+}
+
+bool fancy_string_regex_has_match(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->n_matches > 0 ? true : false;
+}
+
+ssize_t fancy_string_regex_max_number_of_matches(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->n_max_matches;
+}
+
+bool fancy_string_regex_max_number_of_matches_reached(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->n_max_matches == -1)
+    {
+        return false;
+    }
+
+    return self->n_matches == ((size_t)self->n_max_matches) ? true : false;
+}
+
+fancy_string_t *fancy_string_regex_string(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    return fancy_string_clone(self->string);
+}
+
+fancy_string_t *fancy_string_regex_pattern(fancy_string_regex_t const *const self)
+{
+    assert(self != NULL);
+
+    return fancy_string_clone(self->pattern);
+}
+
+fancy_string_t *fancy_string_regex_to_string_with_updated_matches(fancy_string_regex_t const *const self, fancy_string_regex_updater_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    if (self->n_matches == 0)
+    {
+        return fancy_string_clone(self->string);
+    }
+
+    fancy_string_t *updated_string = fancy_string_create_empty();
+
+    fancy_string_array_t *unmatched_components = fancy_string_regex_split_at_matches(self);
+    fancy_string_array_t *matched_components = fancy_string_regex_matches_to_strings(self);
+
+    for (size_t i = 0; i < self->n_matches; i++)
+    {
+        fancy_string_t *match = fancy_string_array_shift(matched_components);
+        size_t start = self->start_array[i];
+        size_t end = self->end_array[i];
+        //  This call (potentially) updates "match", which we then use to build the new string.
+        (*fn)(match, start, end, self->string, context);
+
+        if (i == 0 && start > 0)
+        {
+            fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
+            if (unmatched != NULL)
+            {
+                fancy_string_append(updated_string, unmatched);
+                fancy_string_destroy(unmatched);
+            }
+            fancy_string_append(updated_string, match);
+        }
+        else if (i == 0 && start == 0)
+        {
+            fancy_string_append(updated_string, match);
+            fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
+            if (unmatched != NULL)
+            {
+                fancy_string_append(updated_string, unmatched);
+                fancy_string_destroy(unmatched);
+            }
+        }
+        else
+        {
+            fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
+            if (unmatched != NULL)
+            {
+                fancy_string_append(updated_string, unmatched);
+                fancy_string_destroy(unmatched);
+            }
+            fancy_string_append(updated_string, match);
+        }
+
+        fancy_string_destroy(match);
+    }
+
+    fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
+    if (unmatched != NULL)
+    {
+        fancy_string_append(updated_string, unmatched);
+        fancy_string_destroy(unmatched);
+    }
+
+    fancy_string_array_destroy(unmatched_components);
+    fancy_string_array_destroy(matched_components);
+
+    return updated_string;
+}
+
+fancy_string_regex_match_info_t fancy_string_regex_match_info_for_index(fancy_string_regex_t const *const self, size_t index)
+{
+    assert(self != NULL);
+
+    fancy_string_regex_match_info_t info = {.index = -1, .start = 0, .end = 0};
+
+    if (self->n_matches <= index)
+    {
+        return info;
+    }
+
+    info.index = (ssize_t)index;
+    info.start = self->start_array[index];
+    info.end = self->end_array[index];
+
+    return info;
+}
+
+fancy_string_t *fancy_string_regex_string_for_match_at_index(fancy_string_regex_t const *const self, size_t index)
+{
+    assert(self != NULL);
+
+    if (self->n_matches <= index)
+    {
+        return NULL;
+    }
+    return fancy_string_substring(self->string, self->start_array[index], self->end_array[index]);
+}
+
+// -----------------------------------------------
+//                      ARRAY
+// -----------------------------------------------
+
+fancy_string_array_t *fancy_string_array_create(void)
+{
+    fancy_string_array_t *self = my_malloc(sizeof(fancy_string_array_t));
+    self->n = 0;
+    self->array = NULL;
+    self->shared = false;
+    self->slots = NULL;
+    self->n_slots = 0;
+    return self;
+}
+
+fancy_string_array_t *fancy_string_array_create_with_values(char const *const first_value, ...)
+{
+    fancy_string_array_t *a = fancy_string_array_create();
+
+    if (first_value == NULL)
+    {
+        return a;
+    }
+
+    va_list args;
+    va_start(args, first_value);
+
+    fancy_string_array_push_value(a, first_value);
+
+    while (true)
+    {
+        char *tmp = va_arg(args, char *);
+        if (tmp == NULL)
+        {
+            break;
+        }
+        fancy_string_array_push_value(a, tmp);
+    }
+
+    va_end(args);
+
+    return a;
+}
+
+fancy_string_array_t *fancy_string_array_clone(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *clone = fancy_string_array_create();
+    clone->shared = self->shared;
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        fancy_string_array_push(clone, self->array[i]);
+    }
+
+    return clone;
+}
+
+void fancy_string_array_share(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    self->shared = true;
+    for (size_t i = 0; i < self->n; i++)
+    {
+        fancy_string_t *string = self->array[i];
+        if (string->storage != NULL)
+        {
+            continue;
+        }
+        // NOTE: Unlike `fancy_string_share`, the element can be replaced, so its
+        // inline buffer does not need to be kept around.
+        self->array[i] = create_shared_from_memory(string->value, string->n);
+        array_destroy_element(self, string);
+    }
+}
+
+bool fancy_string_array_is_shared(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->shared;
+}
+
+void fancy_string_array_append(fancy_string_array_t *const self, fancy_string_array_t const *const array)
+{
+    assert(self != NULL);
+    assert(array != NULL);
+
+    for (size_t i = 0; i < array->n; i++)
+    {
+        fancy_string_array_push(self, array->array[i]);
+    }
+}
+
+void fancy_string_array_append_and_destroy(fancy_string_array_t *const self, fancy_string_array_t *array)
+{
+    assert(self != NULL);
+    assert(array != NULL);
+
+    fancy_string_array_append(self, array);
+    fancy_string_array_destroy(array);
+}
+
+void fancy_string_array_destroy(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_array_clear(self);
+    my_free(self);
+}
+
+void fancy_string_array_print(fancy_string_array_t const *const self, FILE *stream, bool debug)
+{
+    assert(self != NULL);
+    assert(stream != NULL);
+
+    if (debug)
+    {
+        fprintf(stream, "fancy_string_array_t[%zu] {\n", self->n);
+        for (size_t i = 0; i < self->n; i++)
+        {
+            fprintf(stream, "\tfancy_string_t[%zu](", fancy_string_size(self->array[i]));
+            print_memory(stream, self->array[i]->value, self->array[i]->n);
+            fprintf(stream, "),\n");
+        }
+        fprintf(stream, "}\n");
+    }
+    else
+    {
+        for (size_t i = 0; i < self->n; i++)
+        {
+            fancy_string_print(self->array[i], stream, false);
+        }
+    }
+}
+
+void fancy_string_array_clear(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        array_destroy_element(self, self->array[i]);
+    }
+    if (self->n > 0)
+    {
+        my_free(self->array);
+    }
+    if (self->slots != NULL)
+    {
+        my_free(self->slots);
+    }
+    self->array = NULL;
+    self->n = 0;
+    self->slots = NULL;
+    self->n_slots = 0;
+}
+
+size_t fancy_string_array_size(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    return self->n;
+}
+
+bool fancy_string_array_is_empty(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    return fancy_string_array_size(self) == 0;
+}
+
+void fancy_string_array_push_value(fancy_string_array_t *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    array_push_string(self, create_array_element(self, value, strlen(value)));
+}
+
+void fancy_string_array_push_value_n(fancy_string_array_t *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    array_push_string(self, create_array_element(self, value, n_value));
+}
+
+void fancy_string_array_push_values(fancy_string_array_t *const self, char const *const first_value, ...)
+{
+    assert(self != NULL);
+
+    if (first_value == NULL)
+    {
+        return;
+    }
+
+    fancy_string_array_t *a = fancy_string_array_create();
+
+    va_list args;
+    va_start(args, first_value);
+
+    fancy_string_array_push_value(a, first_value);
+
+    while (true)
+    {
+        char *tmp = va_arg(args, char *);
+        if (tmp == NULL)
+        {
+            break;
+        }
+        fancy_string_array_push_value(a, tmp);
+    }
+
+    va_end(args);
+
+    fancy_string_array_append_and_destroy(self, a);
+}
+
+void fancy_string_array_push(fancy_string_array_t *const self, fancy_string_t const *const string)
+{
+    assert(self != NULL);
+    assert(string != NULL);
+
+    array_push_string(self, self->shared ? create_shared_clone(string) : fancy_string_clone(string));
+}
+
+fancy_string_t *fancy_string_array_get(fancy_string_array_t const *const self, size_t index)
+{
+    assert(self != NULL);
+
+    if (self->n <= index)
+    {
+        return NULL;
+    }
+
+    return fancy_string_clone(self->array[index]);
+}
+
+char *fancy_string_array_get_value(fancy_string_array_t const *const self, size_t index)
+{
+    assert(self != NULL);
+
+    fancy_string_t *string = fancy_string_array_get(self, index);
+    if (string == NULL)
+    {
+        return NULL;
+    }
+    char *value = fancy_string_value(string);
+    fancy_string_destroy(string);
+    return value;
+}
+
+fancy_string_t *fancy_string_array_remove(fancy_string_array_t *const self, size_t index)
+{
+    assert(self != NULL);
+
+    if (self->n <= index)
+    {
+        return NULL;
+    }
+
+    // NOTE: Without this block, the code below (i.e., after this block)
+    // introduces a small leak. [This thread](https://stackoverflow.com/questions/16759849/using-realloc-x-0-instead-of-free-and-using-malloc-with-length-of-a-string)
+    //  suggests that calling `realloc` with size zero will not result in
+    // and internal call to `free`, depending on the implementation.
+    fancy_string_t *string = self->array[index];
+    if (array_owns_slot(self, string))
+    {
+        // NOTE: The caller owns (and eventually destroys) the removed string object, which
+        // cannot be done with a slot, so a clone is returned instead (in O(1), since the slot
+        // is in shared mode, unless it has been modified).
+        fancy_string_t *clone = fancy_string_clone(string);
+        release_value(string);
+        string = clone;
+    }
+
+    if (self->n == 1)
+    {
+        my_free(self->array);
+        self->array = NULL;
+        self->n = 0;
+        return string;
+    }
+
+    for (size_t i = index; i < self->n - 1; i++)
+    {
+        self->array[i] = self->array[i + 1];
+    }
+    self->n -= 1;
+    self->array = my_realloc(self->array, sizeof(fancy_string_t *) * self->n);
+
+    return string;
+}
+
+void fancy_string_array_remove_and_destroy(fancy_string_array_t *const self, size_t index)
+{
+    assert(self != NULL);
+
+    fancy_string_t *removed = fancy_string_array_remove(self, index);
+    if (removed != NULL)
+    {
+        fancy_string_destroy(removed);
+    }
+}
+
+fancy_string_t *fancy_string_array_pop(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    if (self->n == 0)
+    {
+        return NULL;
+    }
+
+    return fancy_string_array_remove(self, self->n - 1);
+}
+
+void fancy_string_array_pop_and_destroy(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_t *string = fancy_string_array_pop(self);
+    if (string != NULL)
+    {
+        fancy_string_destroy(string);
+    }
+}
+
+fancy_string_t *fancy_string_array_shift(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    if (self->n == 0)
+    {
+        return NULL;
+    }
+
+    return fancy_string_array_remove(self, 0);
+}
+
+void fancy_string_array_shift_and_destroy(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_t *string = fancy_string_array_shift(self);
+    if (string != NULL)
+    {
+        fancy_string_destroy(string);
+    }
+}
+
+void fancy_string_array_insert_value(fancy_string_array_t *const self, char const *const value, size_t index)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    array_insert_string(self, create_array_element(self, value, strlen(value)), index);
+}
+
+void fancy_string_array_insert_value_n(fancy_string_array_t *const self, char const *const value, size_t n_value, size_t index)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    array_insert_string(self, create_array_element(self, value, n_value), index);
+}
+
+void fancy_string_array_insert(fancy_string_array_t *const self, fancy_string_t const *const string, size_t index)
+{
+    assert(self != NULL);
+    assert(string != NULL);
+
+    array_insert_string(self, self->shared ? create_shared_clone(string) : fancy_string_clone(string), index);
+}
+
+fancy_string_t *fancy_string_array_first(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->n == 0)
+    {
+        return NULL;
+    }
+
+    return fancy_string_clone(self->array[0]);
+}
+
+char *fancy_string_array_first_value(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->n == 0)
+    {
+        return NULL;
+    }
+
+    return fancy_string_value(self->array[0]);
+}
+
+fancy_string_t *fancy_string_array_last(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->n == 0)
+    {
+        return NULL;
+    }
+
+    return fancy_string_clone(self->array[self->n - 1]);
+}
+
+char *fancy_string_array_last_value(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    if (self->n == 0)
+    {
+        return NULL;
+    }
+
+    return fancy_string_value(self->array[self->n - 1]);
+}
+
+fancy_string_t *fancy_string_array_join_by_value(fancy_string_array_t const *const self, char const *const separator)
+{
+    assert(self != NULL);
+    assert(separator != NULL);
+
+    return array_join_memory(self, separator, strlen(separator));
+}
+
+fancy_string_t *fancy_string_array_join_by_value_n(fancy_string_array_t const *const self, char const *const separator, size_t n_separator)
+{
+    assert(self != NULL);
+    assert(separator != NULL);
+
+    return array_join_memory(self, separator, n_separator);
+}
+
+fancy_string_t *fancy_string_array_join(fancy_string_array_t const *const self, fancy_string_t const *const separator)
+{
+    assert(self != NULL);
+    assert(separator != NULL);
+
+    return array_join_memory(self, separator->value, separator->n);
+}
+
+void fancy_string_array_reverse(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    if (self->n <= 1)
+    {
+        return;
+    }
+
+    fancy_string_t *tmp = NULL;
+
+    size_t bound = (self->n % 2) == 0 ? self->n / 2 : (self->n - 1) / 2;
+    for (size_t i = 0; i < bound; i++)
+    {
+        tmp = self->array[i];
+        self->array[i] = self->array[self->n - i - 1];
+        self->array[self->n - i - 1] = tmp;
+    }
+}
+
+fancy_string_array_t *fancy_string_array_reversed(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *clone = fancy_string_array_clone(self);
+    fancy_string_array_reverse(clone);
+    return clone;
+}
+
+void fancy_string_array_for_each(fancy_string_array_t *const self, fancy_string_for_each_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        fn(self->array[i], i, self, context);
+    }
+}
+
+fancy_string_array_t *fancy_string_array_mapped(fancy_string_array_t const *const self, fancy_string_mapped_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    fancy_string_array_t *array = fancy_string_array_create();
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        fancy_string_t *tmp = fn(self->array[i], i, self, context);
+        fancy_string_array_push(array, tmp);
+        fancy_string_destroy(tmp);
+    }
+
+    return array;
+}
+
+static bool simple_array_sorter(fancy_string_t const *const string_1, fancy_string_t const *const string_2, void *context)
+{
+    IGNORE_UNUSED(context);
+
+    size_t n_1 = fancy_string_size(string_1);
+    size_t n_2 = fancy_string_size(string_2);
+
+    size_t n = n_1 > n_2 ? n_2 : n_1;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        if (string_1->value[i] == string_2->value[i])
+        {
+            continue;
+        }
+
+        bool out = string_1->value[i] < string_2->value[i];
+        return out;
+    }
+
+    if (n_1 == n_2)
+    {
+        return true;
+    }
+    else if (n_2 < n_1)
+    {
+        return false;
+    }
+    else
+    {
+        return true;
+    }
+}
+
+void fancy_string_array_sort(fancy_string_array_t *const self, fancy_string_sort_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    if (self->n <= 1)
+    {
+        return;
+    }
+
+    fancy_string_t *tmp = NULL;
+
+    while (true)
+    {
+        for (size_t i = 0; i < self->n; i++)
+        {
+            for (size_t j = self->n - 1; j > i; j--)
+            {
+                if (!fn(self->array[i], self->array[j], context))
+                {
+                    tmp = self->array[i];
+                    self->array[i] = self->array[j];
+                    self->array[j] = tmp;
+                    i -= 1;
+                    break;
+                }
+            }
+        }
+        break;
+    }
+}
+
+fancy_string_array_t *fancy_string_array_sorted(fancy_string_array_t const *const self, fancy_string_sort_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    fancy_string_array_t *clone = fancy_string_array_clone(self);
+    fancy_string_array_sort(clone, fn, context);
+    return clone;
+}
+
+void fancy_string_array_sort_values(fancy_string_array_t *const self)
+{
+    assert(self != NULL);
+
+    fancy_string_array_sort(self, simple_array_sorter, NULL);
+}
+
+fancy_string_array_t *fancy_string_array_sorted_values(fancy_string_array_t const *const self)
+{
+    assert(self != NULL);
+
+    return fancy_string_array_sorted(self, simple_array_sorter, NULL);
+}
+
+void fancy_string_array_filter(fancy_string_array_t *const self, fancy_string_filter_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    if (self->n == 0)
+    {
+        return;
+    }
+
+    for (size_t i = self->n; i > 0; i--)
+    {
+        if (!fn(self->array[i - 1], i, self, context))
+        {
+            fancy_string_array_remove_and_destroy(self, i - 1);
+        }
+    }
+}
+
+fancy_string_array_t *fancy_string_array_filtered(fancy_string_array_t const *const self, fancy_string_filter_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    fancy_string_array_t *clone = fancy_string_array_clone(self);
+    fancy_string_array_filter(clone, fn, context);
+    return clone;
+}
+
+fancy_string_array_t *fancy_string_array_sliced(fancy_string_array_t const *const self, ssize_t start, ssize_t end)
+{
+    assert(self != NULL);
+
+    size_t n = fancy_string_array_size(self);
+    size_t index_start = (size_t)(start == -1 ? 0 : start);
+    size_t index_end = end == -1 ? n : (size_t)end;
+
+    fancy_string_array_t *sliced_array = fancy_string_array_create();
+
+    if (
+        index_start >= index_end ||
+        index_start >= n)
+    {
+        return sliced_array;
+    }
+
+    if (index_end > n)
+    {
+        index_end = n;
+    }
+
+    if (index_start >= index_end) //  NOTE: We check again because `index_end` might have been modified.
+    {
+        return sliced_array;
+    }
+
+    for (size_t i = index_start; i < index_end; i++)
+    {
+        fancy_string_array_push(sliced_array, self->array[i]);
+    }
+
+    return sliced_array;
+}
+
+void fancy_string_array_slice_and_destroy(fancy_string_array_t *const self, ssize_t start, ssize_t end)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *slice = fancy_string_array_sliced(self, start, end);
+    fancy_string_array_clear(self);
+    fancy_string_array_append_and_destroy(self, slice);
+}
+
+fancy_string_array_t *fancy_string_array_splice(fancy_string_array_t *const self, size_t index, ssize_t delete_count, fancy_string_array_t const *const optional_new_strings)
+{
+    assert(self != NULL);
+
+    size_t n = fancy_string_array_size(self);
+    size_t positive_delete_count = delete_count == -1 ? n - index : (size_t)delete_count;
+
+    fancy_string_array_t *removed_strings = fancy_string_array_create();
+
+    for (size_t i = index; (i < index + positive_delete_count) && (i < n); i++)
+    {
+        fancy_string_t *tmp = fancy_string_array_remove(self, index);
+        fancy_string_array_push(removed_strings, tmp);
+        fancy_string_destroy(tmp);
+    }
+
+    if (optional_new_strings != NULL)
+    {
+        for (size_t i = 0; i < optional_new_strings->n; i++)
+        {
+            fancy_string_array_insert(self, optional_new_strings->array[i], index + i);
+        }
+    }
+
+    return removed_strings;
+}
+
+void fancy_string_array_splice_and_destroy(fancy_string_array_t *const self, size_t index, ssize_t delete_count, fancy_string_array_t const *const optional_new_strings)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *removed_strings = fancy_string_array_splice(self, index, delete_count, optional_new_strings);
+    fancy_string_array_destroy(removed_strings);
+}
+
+fancy_string_array_t *fancy_string_array_spliced(fancy_string_array_t const *const self, size_t index, ssize_t delete_count, fancy_string_array_t const *const optional_new_strings)
+{
+    assert(self != NULL);
+
+    fancy_string_array_t *clone = fancy_string_array_clone(self);
+    fancy_string_array_splice_and_destroy(clone, index, delete_count, optional_new_strings);
+    return clone;
+}
+
+ssize_t fancy_string_array_find_index(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        if (fn(self->array[i], i, self, context))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+fancy_string_t *fancy_string_array_find(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    ssize_t index = fancy_string_array_find_index(self, fn, context);
+    if (index == -1)
+    {
+        return NULL;
+    }
+    return fancy_string_array_get(self, (size_t)index);
+}
+
+ssize_t fancy_string_array_find_last_index(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    for (size_t i = self->n; i > 0; i--)
+    {
+        size_t index = i - 1;
+        if (fn(self->array[index], index, self, context))
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+fancy_string_t *fancy_string_array_find_last(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    ssize_t index = fancy_string_array_find_last_index(self, fn, context);
+    if (index == -1)
+    {
+        return NULL;
+    }
+    return fancy_string_array_get(self, (size_t)index);
+}
+
+bool fancy_string_array_some(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    return fancy_string_array_find_index(self, fn, context) != -1;
+}
+
+bool fancy_string_array_none(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    return !fancy_string_array_some(self, fn, context);
+}
+
+bool fancy_string_array_every(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+{
+    assert(self != NULL);
+    assert(fn != NULL);
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        if (!fn(self->array[i], i, self, context))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+ssize_t fancy_string_array_index_of(fancy_string_array_t const *const self, fancy_string_t const *const string)
+{
+    assert(self != NULL);
+    assert(string != NULL);
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        if (fancy_string_equals(self->array[i], string))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ssize_t fancy_string_array_index_of_value(fancy_string_array_t const *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    return fancy_string_array_index_of_value_n(self, value, strlen(value));
+}
+
+ssize_t fancy_string_array_index_of_value_n(fancy_string_array_t const *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        if (equals_memory(self->array[i]->value, self->array[i]->n, value, n_value))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+ssize_t fancy_string_array_last_index_of(fancy_string_array_t const *const self, fancy_string_t const *const string)
+{
+    assert(self != NULL);
+    assert(string != NULL);
+
+    for (size_t i = self->n; i > 0; i--)
+    {
+        size_t index = i - 1;
+        if (fancy_string_equals(self->array[index], string))
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+ssize_t fancy_string_array_last_index_of_value(fancy_string_array_t const *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    return fancy_string_array_last_index_of_value_n(self, value, strlen(value));
+}
+
+ssize_t fancy_string_array_last_index_of_value_n(fancy_string_array_t const *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    for (size_t i = self->n; i > 0; i--)
+    {
+        size_t index = i - 1;
+        if (equals_memory(self->array[index]->value, self->array[index]->n, value, n_value))
+        {
+            return index;
+        }
+    }
+    return -1;
+}
+
+bool fancy_string_array_includes(fancy_string_array_t const *const self, fancy_string_t const *const string)
+{
+    assert(self != NULL);
+    assert(string != NULL);
+
+    return fancy_string_array_index_of(self, string) != -1;
+}
+
+bool fancy_string_array_includes_value(fancy_string_array_t const *const self, char const *const value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    return fancy_string_array_index_of_value(self, value) != -1;
+}
+
+bool fancy_string_array_includes_value_n(fancy_string_array_t const *const self, char const *const value, size_t n_value)
+{
+    assert(self != NULL);
+    assert(value != NULL);
+
+    return fancy_string_array_index_of_value_n(self, value, n_value) != -1;
+}
+
+// -----------------------------------------------
+//        PRIVATE HELPERS IMPLEMENTATIONS
+// -----------------------------------------------
+
+static fancy_string_t *allocate_string(size_t capacity)
+{
+    size_t inline_capacity = inline_capacity_for(capacity);
+    fancy_string_t *self = my_malloc(sizeof(fancy_string_t) + sizeof(char) * (inline_capacity + 1));
+    self->inline_capacity = inline_capacity;
+    self->value = self->inline_value;
+    self->capacity = inline_capacity;
+    self->value[0] = '\0';
+    self->n = 0;
+    self->storage = NULL;
+    return self;
+}
+
+static size_t inline_capacity_for(size_t capacity)
+{
+    if (capacity < FANCY_STRING_MINIMUM_INLINE_CAPACITY)
+    {
+        capacity = FANCY_STRING_MINIMUM_INLINE_CAPACITY;
+    }
+    // NOTE: The allocator hands out blocks in multiples of its granule anyway, so
+    // the padding is used as extra room for the value to grow in place.
+    size_t size = sizeof(fancy_string_t) + sizeof(char) * (capacity + 1);
+    size = (size + FANCY_STRING_ALLOCATION_GRANULE - 1) / FANCY_STRING_ALLOCATION_GRANULE * FANCY_STRING_ALLOCATION_GRANULE;
+    return size - sizeof(fancy_string_t) - 1;
+}
+
+static fancy_string_t *create_from_memory(char const *const value, size_t n)
+{
+    fancy_string_t *self = allocate_string(n);
+    memcpy(self->value, value, n);
+    self->value[n] = '\0';
+    self->n = n;
+    return self;
+}
+
+static void update_memory(fancy_string_t *const self, char const *const value, size_t n_value)
+{
+    if (n_value > self->capacity || self->storage != NULL)
+    {
+        // NOTE: `value` might point inside `self->value` (e.g., when calling
+        // `fancy_string_update(self, self)`), so the old buffer is only released
+        // after the copy has been made. The inline buffer is necessarily unused here.
+        bool use_inline_value = n_value <= self->inline_capacity;
+        char *new_value = use_inline_value ? self->inline_value : my_malloc(sizeof(char) * (n_value + 1));
+        memcpy(new_value, value, n_value);
+        release_value(self);
+        self->value = new_value;
+        self->capacity = use_inline_value ? self->inline_capacity : n_value;
+    }
+    else
+    {
+        memmove(self->value, value, n_value);
+    }
+    self->value[n_value] = '\0';
+    self->n = n_value;
+}
+
+static void reserve_capacity(fancy_string_t *const self, size_t n_required)
+{
+    if (n_required <= self->capacity && self->storage == NULL)
+    {
+        return;
+    }
+    // NOTE: Growing geometrically (i.e., doubling) is what makes repeated appends
+    // amortized O(n_value) instead of re-allocating on every call.
+    size_t new_capacity = self->capacity * 2;
+    if (new_capacity < FANCY_STRING_MINIMUM_GROWTH_CAPACITY)
+    {
+        new_capacity = FANCY_STRING_MINIMUM_GROWTH_CAPACITY;
+    }
+    if (new_capacity < n_required)
+    {
+        new_capacity = n_required;
+    }
+    resize_buffer(self, new_capacity);
+}
+
+static void resize_buffer(fancy_string_t *const self, size_t capacity)
+{
+    assert(capacity >= self->n);
+
+    bool is_inline = self->value == self->inline_value;
+    if (capacity <= self->inline_capacity)
+    {
+        if (!is_inline)
+        {
+            memcpy(self->inline_value, self->value, self->n);
+            self->inline_value[self->n] = '\0';
+            release_value(self);
+            self->value = self->inline_value;
+        }
+        self->capacity = self->inline_capacity;
+        return;
+    }
+
+    if (self->storage != NULL || is_inline)
+    {
+        // NOTE: This is where the "copy-on-write" happens for string objects whose
+        // value lives inside a read-only storage (e.g., a memory-mapped file), and
+        // where short values leave the inline buffer.
+        char *value = my_malloc(sizeof(char) * (capacity + 1));
+        memcpy(value, self->value, self->n);
+        value[self->n] = '\0';
+        release_value(self);
+        self->value = value;
+    }
+    else
+    {
+        self->value = my_realloc(self->value, sizeof(char) * (capacity + 1));
+    }
+    self->capacity = capacity;
+}
+
+static void release_value(fancy_string_t *const self)
+{
+    if (self->storage != NULL)
+    {
+        storage_release(self->storage);
+        self->storage = NULL;
+    }
+    else if (self->value != self->inline_value)
+    {
+        my_free(self->value);
+    }
+    self->value = NULL;
+}
+
+static void adopt_buffer(fancy_string_t *const self, char *const value, size_t n)
+{
+    // NOTE: `value` must be a heap buffer holding `n` characters followed by the terminating
+    // null character. Short values are moved to the inline buffer instead.
+    if (n <= self->inline_capacity)
+    {
+        update_memory(self, value, n);
+        my_free(value);
+        return;
+    }
+    release_value(self);
+    self->value = value;
+    self->n = n;
+    self->capacity = n;
+}
+
+static bool points_inside_value(fancy_string_t const *const self, char const *const pointer)
+{
+    uintptr_t start = (uintptr_t)self->value;
+    uintptr_t address = (uintptr_t)pointer;
+    return address >= start && address <= start + self->capacity;
+}
+
+static void apply_map_advice(void *address, size_t n, fancy_string_map_advice_t advice)
+{
+    // NOTE: The advice is only a hint, so failures are ignored.
+    switch (advice)
+    {
+    case FANCY_STRING_MAP_ADVICE_SEQUENTIAL:
+        posix_madvise(address, n, POSIX_MADV_SEQUENTIAL);
+        break;
+    case FANCY_STRING_MAP_ADVICE_RANDOM:
+        posix_madvise(address, n, POSIX_MADV_RANDOM);
+        break;
+    case FANCY_STRING_MAP_ADVICE_WILLNEED:
+        posix_madvise(address, n, POSIX_MADV_WILLNEED);
+        break;
+    default:
+        break;
+    }
+}
+
+static fancy_string_storage_t *storage_retain(fancy_string_storage_t *const storage)
+{
+    atomic_fetch_add_explicit(&storage->references, 1, memory_order_relaxed);
+    return storage;
+}
+
+static void storage_release(fancy_string_storage_t *const storage)
+{
+    if (atomic_fetch_sub_explicit(&storage->references, 1, memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    if (storage->address != NULL)
+    {
+        munmap(storage->address, storage->length);
+    }
+    my_free(storage);
+}
+
+static fancy_string_storage_t *create_storage(char const *const value, size_t n)
+{
+    fancy_string_storage_t *storage = my_malloc(sizeof(fancy_string_storage_t) + sizeof(char) * (n + 1));
+    atomic_init(&storage->references, 1);
+    storage->address = NULL;
+    storage->length = 0;
+    memcpy(storage->value, value, n);
+    storage->value[n] = '\0';
+    return storage;
+}
+
+static void share_value(fancy_string_t *const self)
+{
+    if (self->storage != NULL)
+    {
+        return;
+    }
+    fancy_string_storage_t *storage = create_storage(self->value, self->n);
+    // NOTE: The inline buffer stays unused until the next mutation, which copies
+    // the value back into it if it fits (i.e., copy-on-write).
+    release_value(self);
+    self->value = storage->value;
+    self->capacity = self->n;
+    self->storage = storage;
+}
+
+static fancy_string_t *create_shared_from_memory(char const *const value, size_t n)
+{
+    fancy_string_t *self = allocate_string(0);
+    self->storage = create_storage(value, n);
+    self->value = self->storage->value;
+    self->n = n;
+    self->capacity = n;
+    return self;
+}
+
+static fancy_string_t *create_shared_clone(fancy_string_t const *const string)
+{
+    if (string->storage != NULL)
+    {
+        return fancy_string_clone(string);
+    }
+    return create_shared_from_memory(string->value, string->n);
+}
+
+static fancy_string_t *create_array_element(fancy_string_array_t const *const self, char const *const value, size_t n)
+{
+    return self->shared ? create_shared_from_memory(value, n) : create_from_memory(value, n);
+}
+
+static void append_memory(fancy_string_t *const self, char const *const value, size_t n_value)
+{
+    if (n_value == 0)
+    {
+        return;
+    }
+    size_t n = self->n;
+    if (n + n_value > self->capacity)
+    {
+        // NOTE: `value` might point inside our own buffer (e.g., `fancy_string_append(self, self)`),
+        // in which case it would be invalidated by the re-allocation, so we keep its offset.
+        bool is_aliased = value >= self->value && value <= self->value + n;
+        size_t offset = is_aliased ? (size_t)(value - self->value) : 0;
+        reserve_capacity(self, n + n_value);
+        if (is_aliased)
+        {
+            memmove(&self->value[n], &self->value[offset], n_value);
+            self->value[n + n_value] = '\0';
+            self->n = n + n_value;
+            return;
+        }
+    }
+    memmove(&self->value[n], value, n_value);
+    self->value[n + n_value] = '\0';
+    self->n = n + n_value;
+}
+
+static void prepend_memory(fancy_string_t *const self, char const *const value, size_t n_value)
+{
+    if (n_value == 0)
+    {
+        return;
+    }
+    size_t n = fancy_string_size(self);
+    if (value >= self->value && value <= self->value + n)
+    {
+        // NOTE: `value` points inside our own buffer, which is about to be moved
+        // around, so we fall back on a temporary copy.
+        fancy_string_t *tmp = create_from_memory(value, n_value);
+        fancy_string_append(tmp, self);
+        fancy_string_update(self, tmp);
+        fancy_string_destroy(tmp);
+        return;
+    }
+    reserve_capacity(self, n + n_value);
+    memmove(&self->value[n_value], self->value, n + 1);
+    memcpy(self->value, value, n_value);
+    self->n = n + n_value;
+}
+
+static bool equals_memory(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    if (n_value != n)
+    {
+        return false;
+    }
+    return memcmp(haystack, value, n_value) == 0;
+}
+
+static bool starts_with_memory(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    if (n_value == 0 && n == 0)
+    {
+        // NOTE: The rational behind this is that if both values are "empty",
+        // then they are equal, and if they are equal, then it makes sense to
+        // say that they start with the same value.
+        return true;
+    }
+    if (n_value == 0 || n_value > n)
+    {
+        return false;
+    }
+    return memcmp(haystack, value, n_value) == 0;
+}
+
+static bool ends_with_memory(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    if (n_value == 0 && n == 0)
+    {
+        // NOTE: The rational behind this is that if both values are "empty",
+        // then they are equal, and if they are equal, then it makes sense to
+        // say that they end with the same value.
+        return true;
+    }
+    if (n_value == 0 || n_value > n)
+    {
+        return false;
+    }
+    return memcmp(&haystack[n - n_value], value, n_value) == 0;
+}
+
+static ssize_t index_of_memory(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    if (n_value > n)
+    {
+        return -1;
+    }
+    else if (n_value == 0 || n == 0)
+    {
+        return -1;
+    }
+    if (n_value == 1)
+    {
+        char *p = memchr(haystack, value[0], n);
+        return p == NULL ? -1 : (ssize_t)(p - haystack);
+    }
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+    if (n_value <= FANCY_STRING_SIMD_MAXIMUM_NEEDLE_SIZE)
+    {
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return index_of_memory_avx2(haystack, n, value, n_value);
+        }
+        return index_of_memory_sse2(haystack, n, value, n_value);
+    }
+#endif
+    // NOTE: Unlike `strstr`, `memmem` does not stop at the first null character.
+    char *p = memmem(haystack, n, value, n_value);
+    if (p == NULL)
+    {
+        return -1;
+    }
+    return (ssize_t)(p - haystack);
+}
+
+static ssize_t last_index_of_memory(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    if (n_value > n)
+    {
+        return -1;
+    }
+    else if (n_value == 0 || n == 0)
+    {
+        return -1;
+    }
+    if (n_value == 1)
+    {
+        char *p = memrchr(haystack, value[0], n);
+        return p == NULL ? -1 : (ssize_t)(p - haystack);
+    }
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+    if (n_value <= FANCY_STRING_SIMD_MAXIMUM_NEEDLE_SIZE)
+    {
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return last_index_of_memory_avx2(haystack, n, value, n_value);
+        }
+        return last_index_of_memory_sse2(haystack, n, value, n_value);
+    }
+#endif
+    return last_index_of_memory_scalar(haystack, n, value, n_value);
+}
+
+static ssize_t last_index_of_memory_scalar(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    // NOTE: Candidates are found by looking for the needle's first byte.
+    size_t n_candidates = n - n_value + 1;
+    char const *p;
+    while ((p = memrchr(haystack, value[0], n_candidates)) != NULL)
+    {
+        if (memcmp(p, value, n_value) == 0)
+        {
+            return (ssize_t)(p - haystack);
+        }
+        n_candidates = (size_t)(p - haystack);
+    }
+    return -1;
+}
+
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+// NOTE: The SIMD kernels below look at a whole block of candidate positions at
+// once: a position is only worth a `memcmp` if the haystack has the needle's first
+// byte at that position and the needle's last byte `n_value - 1` bytes further, which
+// two (unaligned) loads and two comparisons check for the whole block. The
+// remaining positions (i.e., those that do not fill a whole block) are handled by the
+// scalar code. All of them expect `2 <= n_value <= n`.
+
+static ssize_t index_of_memory_sse2(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    size_t n_candidates = n - n_value + 1;
+    size_t i = 0;
+    while (i + 16 <= n_candidates)
+    {
+        // NOTE: The block loop does not call anything (unlike the candidates loop), such
+        // that the compiler can keep the broadcast needle bytes in registers.
+        __m128i const first = _mm_set1_epi8(value[0]);
+        __m128i const last = _mm_set1_epi8(value[n_value - 1]);
+        unsigned int mask;
+        do
+        {
+            __m128i const block_first = _mm_loadu_si128((__m128i const *)&haystack[i]);
+            __m128i const block_last = _mm_loadu_si128((__m128i const *)&haystack[i + n_value - 1]);
+            mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+            i += 16;
+        } while (mask == 0 && i + 16 <= n_candidates);
+        while (mask != 0)
+        {
+            size_t position = i - 16 + (size_t)__builtin_ctz(mask);
+            if (memcmp(&haystack[position + 1], &value[1], n_value - 2) == 0)
+            {
+                return (ssize_t)position;
+            }
+            mask &= mask - 1;
+        }
+    }
+    char *p = memmem(&haystack[i], n - i, value, n_value);
+    return p == NULL ? -1 : (ssize_t)(p - haystack);
+}
+
+static ssize_t last_index_of_memory_sse2(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    size_t n_candidates = n - n_value + 1;
+    while (n_candidates >= 16)
+    {
+        __m128i const first = _mm_set1_epi8(value[0]);
+        __m128i const last = _mm_set1_epi8(value[n_value - 1]);
+        unsigned int mask;
+        do
+        {
+            n_candidates -= 16;
+            __m128i const block_first = _mm_loadu_si128((__m128i const *)&haystack[n_candidates]);
+            __m128i const block_last = _mm_loadu_si128((__m128i const *)&haystack[n_candidates + n_value - 1]);
+            mask = (unsigned int)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last)));
+        } while (mask == 0 && n_candidates >= 16);
+        while (mask != 0)
+        {
+            unsigned int bit = 31 - (unsigned int)__builtin_clz(mask);
+            if (memcmp(&haystack[n_candidates + bit + 1], &value[1], n_value - 2) == 0)
+            {
+                return (ssize_t)(n_candidates + bit);
+            }
+            mask ^= 1u << bit;
+        }
+    }
+    if (n_candidates == 0)
+    {
+        return -1;
+    }
+    return last_index_of_memory_scalar(haystack, n_candidates + n_value - 1, value, n_value);
+}
+
+__attribute__((target("avx2"))) static ssize_t index_of_memory_avx2(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    size_t n_candidates = n - n_value + 1;
+    size_t i = 0;
+    while (i + 32 <= n_candidates)
+    {
+        __m256i const first = _mm256_set1_epi8(value[0]);
+        __m256i const last = _mm256_set1_epi8(value[n_value - 1]);
+        unsigned int mask;
+        do
+        {
+            __m256i const block_first = _mm256_loadu_si256((__m256i const *)&haystack[i]);
+            __m256i const block_last = _mm256_loadu_si256((__m256i const *)&haystack[i + n_value - 1]);
+            mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+            i += 32;
+        } while (mask == 0 && i + 32 <= n_candidates);
+        while (mask != 0)
+        {
+            size_t position = i - 32 + (size_t)__builtin_ctz(mask);
+            if (memcmp(&haystack[position + 1], &value[1], n_value - 2) == 0)
+            {
+                return (ssize_t)position;
+            }
+            mask &= mask - 1;
+        }
+    }
+    ssize_t index = index_of_memory_sse2(&haystack[i], n - i, value, n_value);
+    return index == -1 ? -1 : (ssize_t)i + index;
+}
+
+__attribute__((target("avx2"))) static ssize_t last_index_of_memory_avx2(char const *const haystack, size_t n, char const *const value, size_t n_value)
+{
+    size_t n_candidates = n - n_value + 1;
+    while (n_candidates >= 32)
+    {
+        __m256i const first = _mm256_set1_epi8(value[0]);
+        __m256i const last = _mm256_set1_epi8(value[n_value - 1]);
+        unsigned int mask;
+        do
+        {
+            n_candidates -= 32;
+            __m256i const block_first = _mm256_loadu_si256((__m256i const *)&haystack[n_candidates]);
+            __m256i const block_last = _mm256_loadu_si256((__m256i const *)&haystack[n_candidates + n_value - 1]);
+            mask = (unsigned int)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last)));
+        } while (mask == 0 && n_candidates >= 32);
+        while (mask != 0)
+        {
+            unsigned int bit = 31 - (unsigned int)__builtin_clz(mask);
+            if (memcmp(&haystack[n_candidates + bit + 1], &value[1], n_value - 2) == 0)
+            {
+                return (ssize_t)(n_candidates + bit);
+            }
+            mask ^= 1u << bit;
+        }
+    }
+    if (n_candidates == 0)
+    {
+        return -1;
+    }
+    return last_index_of_memory_sse2(haystack, n_candidates + n_value - 1, value, n_value);
+}
+#endif
+
+static void charset_init(charset_t *const self, char const *const chars, size_t n)
+{
+    memset(self, 0, sizeof(charset_t));
+    for (size_t i = 0; i < n; i++)
+    {
+        unsigned char c = (unsigned char)chars[i];
+        self->bits[c / 8] |= (uint8_t)(1u << (c % 8));
+        self->low_nibbles[c >> 7][c & 0x0f] |= (uint8_t)(1u << ((c >> 4) & 0x07));
+    }
+}
+
+static bool charset_contains(charset_t const *const self, char c)
+{
+    unsigned char byte = (unsigned char)c;
+    return (self->bits[byte / 8] & (1u << (byte % 8))) != 0;
+}
+
+static size_t find_any_memory(char const *const haystack, size_t n, charset_t const *const charset, size_t *const positions, size_t n_max_positions)
+{
+    // NOTE: Finds (up to `n_max_positions` of) the positions of the bytes that belong to `charset`,
+    // which amortizes the cost of a call over many separators when they are close to one another.
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+    if (n >= 16)
+    {
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return find_any_memory_avx2(haystack, n, charset, positions, n_max_positions);
+        }
+        if (__builtin_cpu_supports("ssse3"))
+        {
+            return find_any_memory_ssse3(haystack, n, charset, positions, n_max_positions);
+        }
+    }
+#endif
+    return find_any_memory_scalar(haystack, 0, n, charset, positions, 0, n_max_positions);
+}
+
+static size_t find_any_memory_scalar(char const *const haystack, size_t start, size_t n, charset_t const *const charset, size_t *const positions, size_t n_positions, size_t n_max_positions)
+{
+    for (size_t i = start; i < n && n_positions < n_max_positions; i++)
+    {
+        if (charset_contains(charset, haystack[i]))
+        {
+            positions[n_positions++] = i;
+        }
+    }
+    return n_positions;
+}
+
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+__attribute__((target("ssse3"))) static size_t find_any_memory_ssse3(char const *const haystack, size_t n, charset_t const *const charset, size_t *const positions, size_t n_max_positions)
+{
+    // NOTE: Each byte is classified with two table lookups (i.e., shuffles): one by its low nibble,
+    // which gives the set of high nibbles that are in the set along with it, and one by its high
+    // nibble, which gives that high nibble's bit. The byte is in the set when the two intersect.
+    // Since a table entry only has 8 bits, the bytes below and above `0x80` have their own tables.
+    __m128i const low_nibbles_0 = _mm_loadu_si128((__m128i const *)charset->low_nibbles[0]);
+    __m128i const low_nibbles_1 = _mm_loadu_si128((__m128i const *)charset->low_nibbles[1]);
+    __m128i const high_bits_0 = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0);
+    __m128i const high_bits_1 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128);
+    __m128i const nibble_mask = _mm_set1_epi8(0x0f);
+    size_t n_positions = 0;
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i const block = _mm_loadu_si128((__m128i const *)&haystack[i]);
+        __m128i const low = _mm_and_si128(block, nibble_mask);
+        __m128i const high = _mm_and_si128(_mm_srli_epi16(block, 4), nibble_mask);
+        __m128i const hits_0 = _mm_and_si128(_mm_shuffle_epi8(low_nibbles_0, low), _mm_shuffle_epi8(high_bits_0, high));
+        __m128i const hits_1 = _mm_and_si128(_mm_shuffle_epi8(low_nibbles_1, low), _mm_shuffle_epi8(high_bits_1, high));
+        __m128i const misses = _mm_cmpeq_epi8(_mm_or_si128(hits_0, hits_1), _mm_setzero_si128());
+        unsigned int mask = (unsigned int)_mm_movemask_epi8(misses) ^ 0xffffu;
+        while (mask != 0)
+        {
+            positions[n_positions++] = i + (size_t)__builtin_ctz(mask);
+            if (n_positions == n_max_positions)
+            {
+                return n_positions;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_any_memory_scalar(haystack, i, n, charset, positions, n_positions, n_max_positions);
+}
+
+__attribute__((target("avx2"))) static size_t find_any_memory_avx2(char const *const haystack, size_t n, charset_t const *const charset, size_t *const positions, size_t n_max_positions)
+{
+    // NOTE: Same as `find_any_memory_ssse3`, except that the shuffles work within each 16-byte
+    // lane, so the tables are repeated in both lanes.
+    __m256i const low_nibbles_0 = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)charset->low_nibbles[0]));
+    __m256i const low_nibbles_1 = _mm256_broadcastsi128_si256(_mm_loadu_si128((__m128i const *)charset->low_nibbles[1]));
+    __m256i const high_bits_0 = _mm256_broadcastsi128_si256(_mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 0, 0, 0, 0, 0, 0, 0, 0));
+    __m256i const high_bits_1 = _mm256_broadcastsi128_si256(_mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 4, 8, 16, 32, 64, -128));
+    __m256i const nibble_mask = _mm256_set1_epi8(0x0f);
+    size_t n_positions = 0;
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i const block = _mm256_loadu_si256((__m256i const *)&haystack[i]);
+        __m256i const low = _mm256_and_si256(block, nibble_mask);
+        __m256i const high = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble_mask);
+        __m256i const hits_0 = _mm256_and_si256(_mm256_shuffle_epi8(low_nibbles_0, low), _mm256_shuffle_epi8(high_bits_0, high));
+        __m256i const hits_1 = _mm256_and_si256(_mm256_shuffle_epi8(low_nibbles_1, low), _mm256_shuffle_epi8(high_bits_1, high));
+        __m256i const misses = _mm256_cmpeq_epi8(_mm256_or_si256(hits_0, hits_1), _mm256_setzero_si256());
+        unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(misses);
+        while (mask != 0)
+        {
+            positions[n_positions++] = i + (size_t)__builtin_ctz(mask);
+            if (n_positions == n_max_positions)
+            {
+                return n_positions;
+            }
+            mask &= mask - 1;
+        }
+    }
+    return find_any_memory_scalar(haystack, i, n, charset, positions, n_positions, n_max_positions);
+}
+#endif
+
+static fancy_string_array_t *split_any_memory(fancy_string_t const *const self, charset_t const *const charset, ssize_t n_max_splits)
+{
+    // NOTE: Same as `split_memory`, except that each byte that belongs to `charset` is a separator,
+    // and that the separators are found in batches.
+    fancy_string_array_t *array = fancy_string_array_create();
+    size_t n_max_separators = n_max_splits == -1 ? SIZE_MAX : (size_t)n_max_splits;
+    size_t positions[FANCY_STRING_CHARSET_BATCH_SIZE];
+    size_t capacity = 0;
+    size_t start = 0;
+    while (true)
+    {
+        size_t n_wanted = n_max_separators - array->n < FANCY_STRING_CHARSET_BATCH_SIZE ? n_max_separators - array->n : FANCY_STRING_CHARSET_BATCH_SIZE;
+        size_t n_found = n_wanted == 0 ? 0 : find_any_memory(&self->value[start], self->n - start, charset, positions, n_wanted);
+        if (array->n + n_found + 1 > capacity)
+        {
+            capacity = capacity * 2 > array->n + n_found + 1 ? capacity * 2 : array->n + n_found + 1;
+            array->array = array->n == 0 ? my_malloc(sizeof(fancy_string_t *) * capacity) : my_realloc(array->array, sizeof(fancy_string_t *) * capacity);
+        }
+        size_t offset = start;
+        for (size_t i = 0; i < n_found; i++)
+        {
+            size_t end = offset + positions[i];
+            array->array[array->n++] = create_from_memory(&self->value[start], end - start);
+            start = end + 1;
+        }
+        if (n_found < n_wanted || n_wanted == 0)
+        {
+            break;
+        }
+    }
+    array->array[array->n] = create_from_memory(&self->value[start], self->n - start);
+    array->n++;
+    array->array = my_realloc(array->array, sizeof(fancy_string_t *) * array->n);
+    return array;
+}
+
+static void charset_bounds(fancy_string_t const *const self, charset_t const *const charset, size_t *const start, size_t *const end)
+{
+    *start = 0;
+    *end = self->n;
+    while (*start < *end && charset_contains(charset, self->value[*start]))
+    {
+        (*start)++;
+    }
+    while (*end > *start && charset_contains(charset, self->value[*end - 1]))
+    {
+        (*end)--;
+    }
+}
+
+static void trim_charset(fancy_string_t *const self, charset_t const *const charset)
+{
+    size_t start, end;
+    charset_bounds(self, charset, &start, &end);
+    keep_range(self, start, end);
+}
+
+static fancy_string_array_t *split_memory(fancy_string_t const *const self, char const *const separator, size_t n_separator, ssize_t n_max_splits)
+{
+    if (n_max_splits == 0)
+    {
+        fancy_string_array_t *a = fancy_string_array_create();
+        fancy_string_array_push(a, self);
+        return a;
+    }
+
+    // NOTE: The string is scanned once, and each component is copied straight from its offsets
+    // (i.e., a single allocation per component). The pointers array grows geometrically and is
+    // trimmed to its final size at the end.
+    fancy_string_array_t *array = fancy_string_array_create();
+    fancy_string_searcher_t searcher;
+    searcher_init(&searcher, separator, n_separator);
+    size_t n_max_components = n_max_splits == -1 ? SIZE_MAX : (size_t)n_max_splits + 1;
+    size_t capacity = 0;
+    size_t start = 0;
+    while (true)
+    {
+        ssize_t index = array->n + 1 < n_max_components ? searcher_find(&searcher, self->value, self->n, start) : -1;
+        size_t end = index == -1 ? self->n : (size_t)index;
+        if (array->n == capacity)
+        {
+            capacity = capacity == 0 ? 4 : capacity * 2;
+            array->array = array->n == 0 ? my_malloc(sizeof(fancy_string_t *) * capacity) : my_realloc(array->array, sizeof(fancy_string_t *) * capacity);
+        }
+        array->array[array->n++] = create_from_memory(&self->value[start], end - start);
+        if (index == -1)
+        {
+            break;
+        }
+        start = end + n_separator;
+    }
+    array->array = my_realloc(array->array, sizeof(fancy_string_t *) * array->n);
+    return array;
+}
+
+static fancy_string_array_t *split_arena_memory(fancy_string_t const *const self, char const *const separator, size_t n_separator, ssize_t n_max_splits)
+{
+    // NOTE: The components are counted first, such that everything can be allocated up front: a
+    // single copy of the string (i.e., a storage, which all the components share), a single block
+    // of slots for the string objects, and the pointers array.
+    fancy_string_searcher_t searcher;
+    searcher_init(&searcher, separator, n_separator);
+    size_t n_max_components = n_max_splits == -1 ? SIZE_MAX : (size_t)n_max_splits + 1;
+    size_t n_components = 1;
+    size_t start = 0;
+    ssize_t index;
+    while (n_components < n_max_components && (index = searcher_find(&searcher, self->value, self->n, start)) != -1)
+    {
+        n_components++;
+        start = (size_t)index + n_separator;
+    }
+
+    fancy_string_storage_t *storage = create_storage(self->value, self->n);
+    atomic_store_explicit(&storage->references, n_components, memory_order_relaxed);
+    fancy_string_array_t *array = fancy_string_array_create();
+    array->array = my_malloc(sizeof(fancy_string_t *) * n_components);
+    array->n = n_components;
+    array->shared = true;
+    array->slots = my_malloc(FANCY_STRING_ARRAY_SLOT_SIZE * n_components);
+    array->n_slots = n_components;
+    start = 0;
+    for (size_t i = 0; i < n_components; i++)
+    {
+        size_t end = i + 1 < n_components ? (size_t)searcher_find(&searcher, self->value, self->n, start) : self->n;
+        // NOTE: The separator's first byte is overwritten, such that each component is null-terminated.
+        storage->value[end] = '\0';
+        fancy_string_t *component = (fancy_string_t *)&array->slots[FANCY_STRING_ARRAY_SLOT_SIZE * i];
+        component->value = &storage->value[start];
+        component->n = end - start;
+        component->capacity = end - start;
+        component->storage = storage;
+        component->inline_capacity = FANCY_STRING_ARRAY_SLOT_SIZE - sizeof(fancy_string_t) - 1;
+        array->array[i] = component;
+        start = end + n_separator;
+    }
+    return array;
+}
+
+static void replace_memory(fancy_string_t *const self, char const *const old_value, size_t n_old_value, char const *const new_value, size_t n_new_value, ssize_t replace_n)
+{
+    if (replace_n == 0)
+    {
+        return;
+    }
+
+    if (n_old_value == 0)
+    {
+        return;
+    }
+
+    fancy_string_searcher_t searcher;
+    searcher_init(&searcher, old_value, n_old_value);
+    size_t n_max_replacements = replace_n == -1 ? SIZE_MAX : (size_t)replace_n;
+    size_t n_replacements = 0;
+    size_t n_read = 0;
+    size_t n_written = 0;
+    ssize_t index;
+
+    // NOTE: When the new value is not longer than the old one, the occurrences are replaced
+    // in place, from left to right, since the write position can never get ahead of the read
+    // position. This requires the buffer to be writable, and neither of the values to live
+    // inside it.
+    if (n_new_value <= n_old_value && self->storage == NULL && !points_inside_value(self, old_value) && !points_inside_value(self, new_value))
+    {
+        while (n_replacements < n_max_replacements && (index = searcher_find(&searcher, self->value, self->n, n_read)) != -1)
+        {
+            memmove(&self->value[n_written], &self->value[n_read], (size_t)index - n_read);
+            n_written += (size_t)index - n_read;
+            memcpy(&self->value[n_written], new_value, n_new_value);
+            n_written += n_new_value;
+            n_read = (size_t)index + n_old_value;
+            n_replacements++;
+        }
+        if (n_replacements == 0)
+        {
+            return;
+        }
+        memmove(&self->value[n_written], &self->value[n_read], self->n - n_read);
+        self->n = n_written + self->n - n_read;
+        self->value[self->n] = '\0';
+        return;
+    }
+
+    // NOTE: Otherwise, the occurrences are counted first, such that the result can be
+    // written into a single buffer of the right size.
+    while (n_replacements < n_max_replacements && (index = searcher_find(&searcher, self->value, self->n, n_read)) != -1)
+    {
+        n_read = (size_t)index + n_old_value;
+        n_replacements++;
+    }
+    if (n_replacements == 0)
+    {
+        return;
+    }
+    size_t n_output = self->n - n_replacements * n_old_value + n_replacements * n_new_value;
+    char *output = my_malloc(sizeof(char) * (n_output + 1));
+    n_read = 0;
+    for (size_t i = 0; i < n_replacements; i++)
+    {
+        index = searcher_find(&searcher, self->value, self->n, n_read);
+        memcpy(&output[n_written], &self->value[n_read], (size_t)index - n_read);
+        n_written += (size_t)index - n_read;
+        memcpy(&output[n_written], new_value, n_new_value);
+        n_written += n_new_value;
+        n_read = (size_t)index + n_old_value;
+    }
+    memcpy(&output[n_written], &self->value[n_read], self->n - n_read);
+    output[n_output] = '\0';
+    adopt_buffer(self, output, n_output);
+}
+
+static void print_memory(FILE *stream, char const *const value, size_t n)
+{
+    if (n > 0)
+    {
+        fwrite(value, sizeof(char), n, stream);
+    }
+}
+
+static void array_push_string(fancy_string_array_t *const self, fancy_string_t *const string)
+{
+    if (self->n == 0)
+    {
+        self->array = my_malloc(sizeof(fancy_string_t *));
+    }
+    else
+    {
+        self->array = my_realloc(self->array, sizeof(fancy_string_t *) * (self->n + 1));
+    }
+    self->array[self->n] = string;
+    self->n++;
+}
+
+static void array_insert_string(fancy_string_array_t *const self, fancy_string_t *const string, size_t index)
+{
+    if (index >= self->n)
+    {
+        while (self->n < index)
+        {
+            fancy_string_array_push_value(self, "");
+        }
+        array_push_string(self, string);
+        return;
+    }
+
+    self->array = my_realloc(self->array, sizeof(fancy_string_t *) * (self->n + 1));
+
+    for (size_t i = self->n; i > index; i--)
+    {
+        self->array[i] = self->array[i - 1];
+    }
+    self->array[index] = string;
+    self->n += 1;
+}
+
+static bool array_owns_slot(fancy_string_array_t const *const self, fancy_string_t const *const string)
+{
+    uintptr_t start = (uintptr_t)self->slots;
+    uintptr_t address = (uintptr_t)string;
+    return self->slots != NULL && address >= start && address < start + FANCY_STRING_ARRAY_SLOT_SIZE * self->n_slots;
+}
+
+static void array_destroy_element(fancy_string_array_t const *const self, fancy_string_t *const string)
+{
+    if (array_owns_slot(self, string))
+    {
+        // NOTE: The slot itself is freed along with the whole block.
+        release_value(string);
+        return;
+    }
+    fancy_string_destroy(string);
+}
+
+static fancy_string_t *array_join_memory(fancy_string_array_t const *const self, char const *const separator, size_t n_separator)
+{
+    fancy_string_t *string = fancy_string_create_empty();
+
+    if (self->n == 0)
+    {
+        return string;
+    }
+
+    for (size_t i = 0; i < self->n; i++)
+    {
+        if (i > 0)
+        {
+            append_memory(string, separator, n_separator);
+        }
+        fancy_string_append(string, self->array[i]);
+    }
+
+    return string;
+}
+
+static fancy_string_pattern_t *compile_pattern(fancy_string_t const *const pattern, int flags)
+{
+    fancy_string_pattern_t *self = my_malloc(sizeof(fancy_string_pattern_t));
+    // NOTE: Here we use the internal clone to avoid relying on an external value (i.e., we want
+    // `re` to use memory that belongs to `self`).
+    self->pattern = create_shared_clone(pattern);
+    int reason_code = regcomp(&self->re, self->pattern->value, flags);
+    if (reason_code != 0)
+    {
+        // NOTE: `regcomp` does not appear to be using `errno` for error reporting. My
+        // understanding is that it returns the error code directly (see `man 3 regcomp`).
+        // So we don't need to bother about resetting `errno` if we encounter and error. For
+        // now, the API simply returns NULL if an error occurs.
+        regfree(&self->re);
+        fancy_string_destroy(self->pattern);
+        my_free(self);
+        return NULL;
+    }
+    self->flags = flags;
+    atomic_init(&self->references, 1);
+    self->engine = FANCY_STRING_REGEX_ENGINE_POSIX;
+    self->has_begin = false;
+    self->forward_nfa = NULL;
+    self->reverse_nfa = NULL;
+    self->forward_dfa = NULL;
+    self->reverse_dfa = NULL;
+    self->stream_dfa = NULL;
+    pattern_analyze(self);
+    return self;
+}
+
+static fancy_string_pattern_t *pattern_retain(fancy_string_pattern_t *const self)
+{
+    atomic_fetch_add_explicit(&self->references, 1, memory_order_relaxed);
+    return self;
+}
+
+static void pattern_release(fancy_string_pattern_t *const self)
+{
+    if (atomic_fetch_sub_explicit(&self->references, 1, memory_order_acq_rel) != 1)
+    {
+        return;
+    }
+    regfree(&self->re);
+    fancy_string_destroy(self->pattern);
+    if (self->literal != NULL)
+    {
+        my_free(self->literal);
+    }
+    if (self->engine == FANCY_STRING_REGEX_ENGINE_DFA)
+    {
+        dfa_destroy(self->forward_dfa);
+        dfa_destroy(self->reverse_dfa);
+        dfa_destroy(self->stream_dfa);
+        nfa_destroy(self->forward_nfa);
+        nfa_destroy(self->reverse_nfa);
+        pthread_mutex_destroy(&self->dfa_mutex);
+    }
+    my_free(self);
+}
+
+static void pattern_analyze(fancy_string_pattern_t *const self)
+{
+    // NOTE: Extracts a prefilter from the pattern (an ERE), by walking through its top-level sequence of atoms
+    // (e.g., `a`, `\.`, `[0-9]`, `(...)`) and their quantifiers. The consecutive literal atoms that are neither
+    // optional nor repeated form literals that every match contains, and the longest one is kept. Failing that, a
+    // bracket expression that is not optional is kept instead. The analysis is conservative: anything that it does
+    // not understand (e.g., a group) only ends the current literal, and a top-level alternation disables it.
+    self->prefilter = FANCY_STRING_PREFILTER_KIND_NONE;
+    self->literal = NULL;
+    self->n_literal = 0;
+    self->is_prefix = false;
+    atomic_init(&self->counters.n_checks, 0);
+    atomic_init(&self->counters.n_rejections, 0);
+    atomic_init(&self->counters.n_skipped_bytes, 0);
+    if ((self->flags & REG_EXTENDED) == 0 || (self->flags & REG_ICASE) != 0)
+    {
+        return;
+    }
+
+    char const *const value = self->pattern->value;
+    size_t n = self->pattern->n;
+    // NOTE: In a multibyte locale, a quantifier applies to a whole (multibyte) character, and a byte of
+    // the pattern is not necessarily a character of its own, so only ASCII patterns are analyzed. An ASCII
+    // literal (or byte) still appears as is in any match, in any of the encodings that extend ASCII.
+    if (MB_CUR_MAX > 1)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            if ((unsigned char)value[i] >= 0x80)
+            {
+                return;
+            }
+        }
+    }
+    char *run = my_malloc(sizeof(char) * (n + 1));
+    char *best = my_malloc(sizeof(char) * (n + 1));
+    size_t n_run = 0;
+    size_t n_best = 0;
+    size_t run_start = 0;
+    bool is_best_prefix = false;
+    size_t n_members_best = SIZE_MAX;
+    bool is_charset_prefix = false;
+    // NOTE: Skipping input is only safe when matching from a later position cannot change the
+    // results, which is not the case with `^` (it matches where `regexec` starts) or with the
+    // escapes that look at the previous character (e.g., `\b`).
+    bool is_context_free = true;
+    bool is_valid = true;
+    size_t n_atoms = 0;
+    size_t i = 0;
+    while (i < n && is_valid)
+    {
+        bool is_literal = false;
+        bool is_charset = false;
+        char literal = value[i];
+        charset_t charset;
+        size_t n_members = 0;
+        size_t next = i + 1;
+        switch (value[i])
+        {
+        case '|':
+        case ')':
+        case '*':
+        case '+':
+        case '?':
+        case '{':
+            is_valid = false;
+            break;
+        case '(':
+            next = regex_group_end(value, n, i, &is_context_free);
+            is_valid = next != 0;
+            break;
+        case '[':
+            next = regex_bracket_parse(value, n, i, &charset, &n_members, &is_charset);
+            is_valid = next != 0;
+            break;
+        case '^':
+            is_context_free = false;
+            break;
+        case '.':
+        case '$':
+            break;
+        case '\\':
+            if (i + 1 == n)
+            {
+                is_valid = false;
+                break;
+            }
+            // NOTE: Only the special characters are literals when escaped (e.g., `\<` is a word boundary).
+            next = i + 2;
+            literal = value[i + 1];
+            is_literal = literal != '\0' && strchr(".[]()*+?{}|^$\\", literal) != NULL;
+            is_context_free = is_context_free && is_literal;
+            break;
+        default:
+            is_literal = true;
+            break;
+        }
+        bool is_optional = false;
+        bool is_repeated = false;
+        if (is_valid)
+        {
+            next = regex_quantifier_parse(value, n, next, &is_optional, &is_repeated);
+            is_valid = next != 0;
+        }
+        if (!is_valid)
+        {
+            break;
+        }
+
+        if (is_literal && !is_optional)
+        {
+            if (n_run == 0)
+            {
+                run_start = n_atoms;
+            }
+            run[n_run++] = literal;
+        }
+        if (!is_literal || is_optional || is_repeated)
+        {
+            if (n_run > n_best)
+            {
+                memcpy(best, run, n_run);
+                n_best = n_run;
+                is_best_prefix = run_start == 0;
+            }
+            n_run = 0;
+        }
+        if (is_charset && !is_optional && n_members < n_members_best)
+        {
+            self->charset = charset;
+            n_members_best = n_members;
+            is_charset_prefix = n_atoms == 0;
+        }
+        n_atoms += 1;
+        i = next;
+    }
+    if (n_run > n_best)
+    {
+        memcpy(best, run, n_run);
+        n_best = n_run;
+        is_best_prefix = run_start == 0;
+    }
+    my_free(run);
+
+    // NOTE: In a multibyte locale, an occurrence of the prefilter can start in the middle of a
+    // character (e.g., in a double-byte encoding), so it is only used to reject input.
+    bool can_skip = is_context_free && MB_CUR_MAX == 1;
+    if (is_valid && n_best > 0)
+    {
+        self->prefilter = FANCY_STRING_PREFILTER_KIND_LITERAL;
+        self->literal = my_realloc(best, sizeof(char) * (n_best + 1));
+        self->literal[n_best] = '\0';
+        self->n_literal = n_best;
+        self->is_prefix = can_skip && is_best_prefix;
+        return;
+    }
+    my_free(best);
+    if (is_valid && n_members_best != SIZE_MAX)
+    {
+        self->prefilter = FANCY_STRING_PREFILTER_KIND_BYTE_SET;
+        self->is_prefix = can_skip && is_charset_prefix;
+    }
+}
+
+static size_t regex_group_end(char const *const value, size_t n, size_t start, bool *const is_context_free)
+{
+    // NOTE: Returns the position right after the parenthesis that closes the group starting at `start`
+    // (or `0` if there is none).
+    size_t depth = 0;
+    size_t i = start;
+    while (i < n)
+    {
+        switch (value[i])
+        {
+        case '\\':
+            if (i + 1 < n && strchr(".[]()*+?{}|^$\\", value[i + 1]) == NULL)
+            {
+                *is_context_free = false;
+            }
+            i += 2;
+            continue;
+        case '[':
+        {
+            charset_t charset;
+            size_t n_members;
+            bool is_supported;
+            i = regex_bracket_parse(value, n, i, &charset, &n_members, &is_supported);
+            if (i == 0)
+            {
+                return 0;
+            }
+            continue;
+        }
+        case '^':
+            *is_context_free = false;
+            break;
+        case '(':
+            depth += 1;
+            break;
+        case ')':
+            depth -= 1;
+            if (depth == 0)
+            {
+                return i + 1;
+            }
+            break;
+        default:
+            break;
+        }
+        i += 1;
+    }
+    return 0;
+}
+
+static size_t regex_bracket_parse(char const *const value, size_t n, size_t start, charset_t *const charset, size_t *const n_members, bool *const is_supported)
+{
+    // NOTE: Parses the bracket expression starting at `start`, and returns the position right after it
+    // (or `0` if it is not terminated). `charset` is set to (a superset of) the bytes that a character it
+    // matches can start with, unless `is_supported` is set to `false` (e.g., for `[[=a=]]`, or a range
+    // that depends on the collation order). In a multibyte locale, all of the non-ASCII bytes are included.
+    static struct
+    {
+        char const *name;
+        int (*contains)(int);
+    } const classes[] = {
+        {"alnum", isalnum},
+        {"alpha", isalpha},
+        {"blank", isblank},
+        {"cntrl", iscntrl},
+        {"digit", isdigit},
+        {"graph", isgraph},
+        {"lower", islower},
+        {"print", isprint},
+        {"punct", ispunct},
+        {"space", isspace},
+        {"upper", isupper},
+        {"xdigit", isxdigit},
+    };
+    bool is_multibyte = MB_CUR_MAX > 1;
+    int n_bytes = is_multibyte ? 0x80 : UCHAR_MAX + 1;
+    // NOTE: Outside of the C locale, the ranges follow the collation order, which is only known for digits.
+    char const *collation = setlocale(LC_COLLATE, NULL);
+    bool is_c_collation = collation == NULL || strcmp(collation, "C") == 0 || strcmp(collation, "POSIX") == 0;
+    bool members[UCHAR_MAX + 1] = {false};
+    *is_supported = true;
+    size_t i = start + 1;
+    bool is_negated = i < n && value[i] == '^';
+    if (is_negated)
+    {
+        i += 1;
+    }
+    bool is_first = true;
+    while (i < n && (value[i] != ']' || is_first))
+    {
+        is_first = false;
+        if (value[i] == '[' && i + 1 < n && (value[i + 1] == ':' || value[i + 1] == '=' || value[i + 1] == '.'))
+        {
+            char delimiter = value[i + 1];
+            size_t end = i + 2;
+            while (end + 1 < n && (value[end] != delimiter || value[end + 1] != ']'))
+            {
+                end += 1;
+            }
+            if (end + 1 >= n)
+            {
+                return 0;
+            }
+            bool is_known = false;
+            for (size_t k = 0; delimiter == ':' && k < sizeof(classes) / sizeof(classes[0]); k++)
+            {
+                if (strlen(classes[k].name) == end - (i + 2) && memcmp(classes[k].name, value + i + 2, end - (i + 2)) == 0)
+                {
+                    for (int c = 0; c < n_bytes; c++)
+                    {
+                        members[c] = members[c] || classes[k].contains(c) != 0;
+                    }
+                    is_known = true;
+                }
+            }
+            *is_supported = *is_supported && is_known;
+            i = end + 2;
+            continue;
+        }
+        unsigned char first = (unsigned char)value[i];
+        unsigned char last = first;
+        if (i + 2 < n && value[i + 1] == '-' && value[i + 2] != ']')
+        {
+            last = (unsigned char)value[i + 2];
+            bool is_ordered = is_c_collation || (isdigit(first) && isdigit(last));
+            *is_supported = *is_supported && value[i + 2] != '[' && is_ordered;
+            i += 3;
+        }
+        else
+        {
+            i += 1;
+        }
+        for (unsigned c = first; c <= last; c++)
+        {
+            members[c] = true;
+        }
+    }
+    if (i == n)
+    {
+        return 0;
+    }
+
+    char bytes[UCHAR_MAX + 1];
+    *n_members = 0;
+    for (int c = 0; c <= UCHAR_MAX; c++)
+    {
+        if ((c >= n_bytes) || (members[c] != is_negated))
+        {
+            bytes[(*n_members)++] = (char)c;
+        }
+    }
+    charset_init(charset, bytes, *n_members);
+    return i + 1;
+}
+
+static size_t regex_quantifier_parse(char const *const value, size_t n, size_t start, bool *const is_optional, bool *const is_repeated)
+{
+    // NOTE: Skips the quantifiers (if any) following an atom, and returns the position right after
+    // them (or `0` if an interval expression is malformed).
+    size_t i = start;
+    while (i < n)
+    {
+        if (value[i] == '*' || value[i] == '?')
+        {
+            *is_optional = true;
+            i += 1;
+        }
+        else if (value[i] == '+')
+        {
+            i += 1;
+        }
+        else if (value[i] == '{')
+        {
+            i += 1;
+            if (i == n || !isdigit((unsigned char)value[i]))
+            {
+                return 0;
+            }
+            bool is_zero = true;
+            while (i < n && isdigit((unsigned char)value[i]))
+            {
+                is_zero = is_zero && value[i] == '0';
+                i += 1;
+            }
+            while (i < n && (value[i] == ',' || isdigit((unsigned char)value[i])))
+            {
+                i += 1;
+            }
+            if (i == n || value[i] != '}')
+            {
+                return 0;
+            }
+            *is_optional = *is_optional || is_zero;
+            i += 1;
+        }
+        else
+        {
+            break;
+        }
+        *is_repeated = true;
+    }
+    return i;
+}
+
+static bool pattern_prefilter(fancy_string_pattern_t const *const self, char const *const value, size_t n, size_t *const skip, fancy_string_prefilter_stats_t *const stats)
+{
+    // NOTE: Returns `false` if the input (i.e., the `n` bytes at `value`) cannot contain a match of the
+    // pattern, in which case `regexec` does not need to be called. Otherwise, `skip` is set to the number
+    // of bytes that `regexec` does not need to see.
+    *skip = 0;
+    ssize_t index = -1;
+    if (self->prefilter == FANCY_STRING_PREFILTER_KIND_LITERAL)
+    {
+        index = index_of_memory(value, n, self->literal, self->n_literal);
+    }
+    else if (self->prefilter == FANCY_STRING_PREFILTER_KIND_BYTE_SET)
+    {
+        size_t position;
+        if (find_any_memory(value, n, &self->charset, &position, 1) == 1)
+        {
+            index = (ssize_t)position;
+        }
+    }
+    else
+    {
+        return true;
+    }
+
+    stats->n_checks += 1;
+    if (index == -1)
+    {
+        stats->n_rejections += 1;
+        return false;
+    }
+    if (self->is_prefix)
+    {
+        *skip = (size_t)index;
+        stats->n_skipped_bytes += (size_t)index;
+    }
+    return true;
+}
+
+static void pattern_record_prefilter_stats(fancy_string_pattern_t const *const self, fancy_string_prefilter_stats_t const *const stats)
+{
+    if (stats->n_checks == 0)
+    {
+        return;
+    }
+    // NOTE: The counters are the only members of a pattern object that are modified after it is
+    // created, which is why a pattern object can otherwise be used through a const pointer.
+    prefilter_counters_add((prefilter_counters_t *)&self->counters, stats);
+    prefilter_counters_add(&prefilter_counters, stats);
+}
+
+static bool pattern_next_match(fancy_string_pattern_t const *const self, char const *const value, size_t n, size_t position, size_t *const start, size_t *const end)
+{
+    // NOTE: Finds the first (non-empty) match from `position` on, just like an iteration of the loop of
+    // `fancy_string_regex_create_with_pattern` (i.e., `^` holds at `position`), but without allocating.
+    size_t skip;
+    fancy_string_prefilter_stats_t stats = {0};
+    bool is_candidate = pattern_prefilter(self, value + position, n - position, &skip, &stats);
+    pattern_record_prefilter_stats(self, &stats);
+    if (!is_candidate)
+    {
+        return false;
+    }
+    position += skip;
+    regmatch_t match;
+    regex_search_t search;
+    regex_search_init(&search, self, true);
+    int reason_code = regex_search_exec(&search, value + position, n - position, &match);
+    regex_search_release(&search);
+    if (reason_code != 0 || match.rm_so >= match.rm_eo || (size_t)match.rm_eo > n - position)
+    {
+        return false;
+    }
+    *start = position + (size_t)match.rm_so;
+    *end = position + (size_t)match.rm_eo;
+    return true;
+}
+
+static void prefilter_counters_add(prefilter_counters_t *const self, fancy_string_prefilter_stats_t const *const stats)
+{
+    atomic_fetch_add_explicit(&self->n_checks, stats->n_checks, memory_order_relaxed);
+    atomic_fetch_add_explicit(&self->n_rejections, stats->n_rejections, memory_order_relaxed);
+    atomic_fetch_add_explicit(&self->n_skipped_bytes, stats->n_skipped_bytes, memory_order_relaxed);
+}
+
+static fancy_string_prefilter_stats_t prefilter_counters_load(prefilter_counters_t const *const self)
+{
+    fancy_string_prefilter_stats_t stats = {
+        .n_checks = atomic_load_explicit(&self->n_checks, memory_order_relaxed),
+        .n_rejections = atomic_load_explicit(&self->n_rejections, memory_order_relaxed),
+        .n_skipped_bytes = atomic_load_explicit(&self->n_skipped_bytes, memory_order_relaxed),
+    };
+    return stats;
+}
+
+static bool pattern_compile_dfa(fancy_string_pattern_t *const self)
+{
+    // NOTE: The engine works on bytes, so it does not support the multibyte locales.
+    if (MB_CUR_MAX > 1 || (self->flags & REG_EXTENDED) == 0 || (self->flags & (REG_ICASE | REG_NEWLINE)) != 0)
+    {
+        return false;
+    }
+    regex_parser_t parser = {
+        .value = self->pattern->value,
+        .n = self->pattern->n,
+        .i = 0,
+        .nodes = NULL,
+        .n_nodes = 0,
+        .capacity = 0,
+        .depth = 0,
+        .is_supported = true,
+        .has_begin = false,
+    };
+    uint32_t root = regex_parse_alternation(&parser);
+    nfa_t *forward = NULL;
+    nfa_t *reverse = NULL;
+    bool is_supported = parser.is_supported && parser.i == parser.n;
+    if (is_supported)
+    {
+        forward = nfa_create(parser.nodes, root, false);
+        reverse = nfa_create(parser.nodes, root, true);
+        is_supported = !forward->is_too_large && !reverse->is_too_large;
+    }
+    my_free(parser.nodes);
+    if (!is_supported)
+    {
+        if (forward != NULL)
+        {
+            nfa_destroy(forward);
+            nfa_destroy(reverse);
+        }
+        return false;
+    }
+
+    self->engine = FANCY_STRING_REGEX_ENGINE_DFA;
+    self->has_begin = parser.has_begin;
+    self->forward_nfa = forward;
+    self->reverse_nfa = reverse;
+    self->forward_dfa = dfa_create(forward, false);
+    self->reverse_dfa = dfa_create(reverse, false);
+    self->stream_dfa = dfa_create(forward, true);
+    pthread_mutex_init(&self->dfa_mutex, NULL);
+    return true;
+}
+
+static uint32_t regex_parser_add(regex_parser_t *const self, regex_node_kind_t kind)
+{
+    if (self->n_nodes == self->capacity)
+    {
+        self->capacity = self->capacity == 0 ? 16 : self->capacity * 2;
+        self->nodes = my_realloc(self->nodes, sizeof(regex_node_t) * self->capacity);
+    }
+    regex_node_t *node = &self->nodes[self->n_nodes];
+    memset(node, 0, sizeof(regex_node_t));
+    node->kind = kind;
+    node->child = FANCY_STRING_NFA_NONE;
+    node->sibling = FANCY_STRING_NFA_NONE;
+    return (uint32_t)self->n_nodes++;
+}
+
+static uint32_t regex_parse_alternation(regex_parser_t *const self)
+{
+    // NOTE: The nodes are referenced by index, since adding a node can move all of them.
+    self->depth += 1;
+    if (self->depth > FANCY_STRING_REGEX_MAXIMUM_DEPTH)
+    {
+        self->is_supported = false;
+    }
+    uint32_t node = regex_parse_concatenation(self);
+    if (self->is_supported && self->i < self->n && self->value[self->i] == '|')
+    {
+        uint32_t alternation = regex_parser_add(self, REGEX_NODE_ALTERNATION);
+        self->nodes[alternation].child = node;
+        uint32_t last = node;
+        while (self->is_supported && self->i < self->n && self->value[self->i] == '|')
+        {
+            self->i += 1;
+            uint32_t next = regex_parse_concatenation(self);
+            self->nodes[last].sibling = next;
+            last = next;
+        }
+        node = alternation;
+    }
+    self->depth -= 1;
+    return node;
+}
+
+static uint32_t regex_parse_concatenation(regex_parser_t *const self)
+{
+    uint32_t node = regex_parser_add(self, REGEX_NODE_CONCATENATION);
+    uint32_t last = FANCY_STRING_NFA_NONE;
+    bool has_end = false;
+    while (self->is_supported && self->i < self->n && self->value[self->i] != '|' && self->value[self->i] != ')')
+    {
+        // NOTE: glibc matches a `^` that something precedes, or a `$` that something follows, after (resp. before)
+        // a newline too in some cases (e.g., `b$.` matches `"b\nc"`, and `(b|$)[^a]` matches `"a\nc"`), so, to give
+        // the same matches, an item that contains `^` has to start the branch, and one that contains `$` has to end
+        // it. The nodes of an item are the ones that were added while parsing it.
+        size_t first = self->n_nodes;
+        uint32_t next = regex_parse_repetition(self);
+        bool is_begin = false;
+        bool is_end = false;
+        for (size_t i = first; i < self->n_nodes; i++)
+        {
+            is_begin = is_begin || self->nodes[i].kind == REGEX_NODE_BEGIN;
+            is_end = is_end || self->nodes[i].kind == REGEX_NODE_END;
+        }
+        if (has_end || (is_begin && last != FANCY_STRING_NFA_NONE))
+        {
+            self->is_supported = false;
+        }
+        has_end = is_end;
+        if (last == FANCY_STRING_NFA_NONE)
+        {
+            self->nodes[node].child = next;
+        }
+        else
+        {
+            self->nodes[last].sibling = next;
+        }
+        last = next;
+    }
+    return node;
+}
+
+static uint32_t regex_parse_repetition(regex_parser_t *const self)
+{
+    bool has_begin = self->has_begin;
+    self->has_begin = false;
+    size_t first = self->n_nodes;
+    uint32_t node = regex_parse_atom(self);
+    bool is_anchored = self->has_begin;
+    self->has_begin = has_begin || is_anchored;
+    bool is_end = false;
+    for (size_t i = first; i < self->n_nodes; i++)
+    {
+        is_end = is_end || self->nodes[i].kind == REGEX_NODE_END;
+    }
+    // NOTE: Stacked quantifiers (e.g., `a**`) nest repetitions, so they count towards the maximum depth.
+    size_t depth = self->depth;
+    while (self->is_supported && self->i < self->n)
+    {
+        char c = self->value[self->i];
+        int min = 0;
+        int max = -1;
+        if (c == '+')
+        {
+            min = 1;
+        }
+        else if (c == '?')
+        {
+            max = 1;
+        }
+        else if (c == '{')
+        {
+            // NOTE: The bounds are parsed the way `regcomp` does (i.e., `{m}`, `{m,}` or `{m,n}`).
+            size_t i = self->i + 1;
+            long bounds[2] = {0, -1};
+            size_t n_bounds = 0;
+            while (n_bounds < 2)
+            {
+                if (i == self->n || !isdigit((unsigned char)self->value[i]))
+                {
+                    break;
+                }
+                long bound = 0;
+                while (i < self->n && isdigit((unsigned char)self->value[i]) && bound <= RE_DUP_MAX)
+                {
+                    bound = bound * 10 + (self->value[i] - '0');
+                    i += 1;
+                }
+                bounds[n_bounds++] = bound;
+                if (i < self->n && self->value[i] == ',' && n_bounds == 1)
+                {
+                    i += 1;
+                    bounds[1] = -2;
+                }
+                else
+                {
+                    break;
+                }
+            }
+            if (n_bounds == 0 || i == self->n || self->value[i] != '}' || bounds[0] > RE_DUP_MAX || bounds[1] > RE_DUP_MAX)
+            {
+                self->is_supported = false;
+                break;
+            }
+            min = (int)bounds[0];
+            max = bounds[1] == -2 ? -1 : (n_bounds == 1 ? min : (int)bounds[1]);
+            if (max != -1 && max < min)
+            {
+                self->is_supported = false;
+                break;
+            }
+            self->i = i;
+        }
+        else if (c != '*')
+        {
+            break;
+        }
+        self->i += 1;
+        // NOTE: glibc does not keep the `^` of a group in the copies of it that it makes for some quantifiers
+        // (e.g., `(^a|b)+` matches `"ba"`), so, to give the same matches, a quantified group may not contain `^`.
+        // Nor may it contain `$`, which its next copy would follow (see `regex_parse_concatenation`).
+        if (self->nodes[node].kind == REGEX_NODE_BEGIN || is_end || is_anchored)
+        {
+            self->is_supported = false;
+            break;
+        }
+        if (++depth > FANCY_STRING_REGEX_MAXIMUM_DEPTH)
+        {
+            self->is_supported = false;
+            break;
+        }
+        uint32_t repetition = regex_parser_add(self, REGEX_NODE_REPETITION);
+        self->nodes[repetition].child = node;
+        self->nodes[repetition].min = min;
+        self->nodes[repetition].max = max;
+        node = repetition;
+    }
+    return node;
+}
+
+static uint32_t regex_parse_atom(regex_parser_t *const self)
+{
+    char c = self->value[self->i];
+    uint32_t node;
+    switch (c)
+    {
+    case '(':
+        self->i += 1;
+        node = regex_parse_alternation(self);
+        if (self->i == self->n || self->value[self->i] != ')')
+        {
+            self->is_supported = false;
+            return node;
+        }
+        self->i += 1;
+        return node;
+    case '[':
+    {
+        charset_t charset;
+        size_t n_members;
+        bool is_supported;
+        size_t next = regex_bracket_parse(self->value, self->n, self->i, &charset, &n_members, &is_supported);
+        node = regex_parser_add(self, REGEX_NODE_BYTES);
+        self->is_supported = self->is_supported && next != 0 && is_supported;
+        if (self->is_supported)
+        {
+            memcpy(self->nodes[node].bits, charset.bits, sizeof(charset.bits));
+            self->i = next;
+        }
+        return node;
+    }
+    case '.':
+        // NOTE: Like `regexec`, `.` does not match the null character.
+        node = regex_parser_add(self, REGEX_NODE_BYTES);
+        memset(self->nodes[node].bits, 0xff, sizeof(self->nodes[node].bits));
+        self->nodes[node].bits[0] &= (uint8_t)~1u;
+        self->i += 1;
+        return node;
+    case '^':
+        self->has_begin = true;
+        self->i += 1;
+        return regex_parser_add(self, REGEX_NODE_BEGIN);
+    case '$':
+        self->i += 1;
+        return regex_parser_add(self, REGEX_NODE_END);
+    case '*':
+    case '+':
+    case '?':
+    case '{':
+        self->is_supported = false;
+        return regex_parser_add(self, REGEX_NODE_EMPTY);
+    case '\\':
+        // NOTE: An escaped letter or digit is a back-reference or a GNU extension (e.g., `\w`), as are `\<`,
+        // `\>`, "\`" and `\'`.
+        if (self->i + 1 == self->n || !ispunct((unsigned char)self->value[self->i + 1]) || strchr("<>`'", self->value[self->i + 1]) != NULL)
+        {
+            self->is_supported = false;
+            return regex_parser_add(self, REGEX_NODE_EMPTY);
+        }
+        self->i += 1;
+        c = self->value[self->i];
+        break;
+    default:
+        break;
+    }
+    node = regex_parser_add(self, REGEX_NODE_BYTES);
+    self->nodes[node].bits[(unsigned char)c / 8] |= (uint8_t)(1u << ((unsigned char)c % 8));
+    self->i += 1;
+    return node;
+}
+
+static nfa_t *nfa_create(regex_node_t const *const nodes, uint32_t root, bool is_reverse)
+{
+    nfa_t *self = my_malloc(sizeof(nfa_t));
+    self->states = NULL;
+    self->n_states = 0;
+    self->capacity = 0;
+    self->is_too_large = false;
+    uint32_t match = nfa_add(self, NFA_STATE_MATCH, FANCY_STRING_NFA_NONE, FANCY_STRING_NFA_NONE);
+    self->start = nfa_compile(self, nodes, root, match, is_reverse);
+    self->any = nfa_add(self, NFA_STATE_BYTES, FANCY_STRING_NFA_NONE, FANCY_STRING_NFA_NONE);
+    self->loop = nfa_add(self, NFA_STATE_SPLIT, self->start, self->any);
+    if (!self->is_too_large)
+    {
+        memset(self->states[self->any].bits, 0xff, sizeof(self->states[self->any].bits));
+        self->states[self->any].out = self->loop;
+    }
+    if (is_reverse)
+    {
+        // NOTE: The reverse NFA finds all of the positions where a match starts in a single scan, so it is
+        // unanchored (i.e., a match of the pattern's reverse can start at any position of the scan).
+        self->start = self->loop;
+    }
+    nfa_build_classes(self);
+    return self;
 }
 
-fancy_string_t *fancy_string_regex_pattern(fancy_string_regex_t const *const self)
+static void nfa_destroy(nfa_t *const self)
 {
-    assert(self != NULL);
-
-    return fancy_string_clone(self->pattern);
+    my_free(self->states);
+    my_free(self);
 }
 
-fancy_string_t *fancy_string_regex_to_string_with_updated_matches(fancy_string_regex_t const *const self, fancy_string_regex_updater_t fn, void *context)
+static uint32_t nfa_add(nfa_t *const self, nfa_state_kind_t kind, uint32_t out, uint32_t out1)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    if (self->n_matches == 0)
+    if (self->n_states == FANCY_STRING_NFA_MAXIMUM_STATES)
     {
-        return fancy_string_clone(self->string);
+        self->is_too_large = true;
+        return 0;
     }
-
-    fancy_string_t *updated_string = fancy_string_create_empty();
-
-    fancy_string_array_t *unmatched_components = fancy_string_regex_split_at_matches(self);
-    fancy_string_array_t *matched_components = fancy_string_regex_matches_to_strings(self);
-
-    for (size_t i = 0; i < self->n_matches; i++)
+    if (self->n_states == self->capacity)
     {
-        fancy_string_t *match = fancy_string_array_shift(matched_components);
-        size_t start = self->start_array[i];
-        size_t end = self->end_array[i];
-        //  This call (potentially) updates "match", which we then use to build the new string.
-        (*fn)(match, start, end, self->string, context);
+        self->capacity = self->capacity == 0 ? 16 : self->capacity * 2;
+        self->states = my_realloc(self->states, sizeof(nfa_state_t) * self->capacity);
+    }
+    nfa_state_t *state = &self->states[self->n_states];
+    memset(state, 0, sizeof(nfa_state_t));
+    state->kind = kind;
+    state->out = out;
+    state->out1 = out1;
+    return (uint32_t)self->n_states++;
+}
 
-        if (i == 0 && start > 0)
+static uint32_t nfa_compile(nfa_t *const self, regex_node_t const *const nodes, uint32_t node, uint32_t next, bool is_reverse)
+{
+    // NOTE: Returns the start of the states that match `node`, then go on with `next` (i.e., the NFA is built
+    // from its end). A repetition simply compiles its child once per copy it needs (e.g., `a{2,3}` is `aa(a)?`).
+    if (self->is_too_large)
+    {
+        return next;
+    }
+    regex_node_t const *const current = &nodes[node];
+    switch (current->kind)
+    {
+    case REGEX_NODE_EMPTY:
+        return next;
+    case REGEX_NODE_BYTES:
+    {
+        uint32_t state = nfa_add(self, NFA_STATE_BYTES, next, FANCY_STRING_NFA_NONE);
+        if (!self->is_too_large)
         {
-            fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
-            if (unmatched != NULL)
-            {
-                fancy_string_append(updated_string, unmatched);
-                fancy_string_destroy(unmatched);
-            }
-            fancy_string_append(updated_string, match);
+            memcpy(self->states[state].bits, current->bits, sizeof(current->bits));
         }
-        else if (i == 0 && start == 0)
+        return state;
+    }
+    case REGEX_NODE_BEGIN:
+        return nfa_add(self, is_reverse ? NFA_STATE_SCAN_END : NFA_STATE_SCAN_START, next, FANCY_STRING_NFA_NONE);
+    case REGEX_NODE_END:
+        return nfa_add(self, is_reverse ? NFA_STATE_SCAN_START : NFA_STATE_SCAN_END, next, FANCY_STRING_NFA_NONE);
+    case REGEX_NODE_CONCATENATION:
+    {
+        // NOTE: Forward, the last child is compiled first. The reverse NFA matches the children backward.
+        size_t n_children = 0;
+        for (uint32_t child = current->child; child != FANCY_STRING_NFA_NONE; child = nodes[child].sibling)
         {
-            fancy_string_append(updated_string, match);
-            fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
-            if (unmatched != NULL)
+            n_children++;
+        }
+        uint32_t *children = my_malloc(sizeof(uint32_t) * (n_children + 1));
+        size_t i = 0;
+        for (uint32_t child = current->child; child != FANCY_STRING_NFA_NONE; child = nodes[child].sibling)
+        {
+            children[is_reverse ? i : n_children - 1 - i] = child;
+            i++;
+        }
+        for (i = 0; i < n_children; i++)
+        {
+            next = nfa_compile(self, nodes, children[i], next, is_reverse);
+        }
+        my_free(children);
+        return next;
+    }
+    case REGEX_NODE_ALTERNATION:
+    {
+        uint32_t start = FANCY_STRING_NFA_NONE;
+        for (uint32_t child = current->child; child != FANCY_STRING_NFA_NONE; child = nodes[child].sibling)
+        {
+            uint32_t alternative = nfa_compile(self, nodes, child, next, is_reverse);
+            start = start == FANCY_STRING_NFA_NONE ? alternative : nfa_add(self, NFA_STATE_SPLIT, alternative, start);
+        }
+        return start;
+    }
+    case REGEX_NODE_REPETITION:
+    {
+        uint32_t tail = next;
+        if (current->max == -1)
+        {
+            uint32_t loop = nfa_add(self, NFA_STATE_SPLIT, FANCY_STRING_NFA_NONE, next);
+            uint32_t body = nfa_compile(self, nodes, current->child, loop, is_reverse);
+            if (!self->is_too_large)
             {
-                fancy_string_append(updated_string, unmatched);
-                fancy_string_destroy(unmatched);
+                self->states[loop].out = body;
             }
+            tail = loop;
         }
         else
         {
-            fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
-            if (unmatched != NULL)
+            for (int i = current->min; i < current->max && !self->is_too_large; i++)
             {
-                fancy_string_append(updated_string, unmatched);
-                fancy_string_destroy(unmatched);
+                tail = nfa_add(self, NFA_STATE_SPLIT, nfa_compile(self, nodes, current->child, tail, is_reverse), next);
             }
-            fancy_string_append(updated_string, match);
         }
-
-        fancy_string_destroy(match);
+        for (int i = 0; i < current->min && !self->is_too_large; i++)
+        {
+            tail = nfa_compile(self, nodes, current->child, tail, is_reverse);
+        }
+        return tail;
     }
-
-    fancy_string_t *unmatched = fancy_string_array_shift(unmatched_components);
-    if (unmatched != NULL)
-    {
-        fancy_string_append(updated_string, unmatched);
-        fancy_string_destroy(unmatched);
     }
-
-    fancy_string_array_destroy(unmatched_components);
-    fancy_string_array_destroy(matched_components);
-
-    return updated_string;
+    return next;
 }
 
-fancy_string_regex_match_info_t fancy_string_regex_match_info_for_index(fancy_string_regex_t const *const self, size_t index)
+static void nfa_build_classes(nfa_t *const self)
 {
-    assert(self != NULL);
-
-    fancy_string_regex_match_info_t info = {.index = -1, .start = 0, .end = 0};
+    // NOTE: The classes are refined by each set of bytes in turn: two bytes stay in the same class
+    // as long as every set so far either has both of them or has neither.
+    memset(self->classes, 0, sizeof(self->classes));
+    self->n_classes = 1;
+    for (size_t s = 0; s < self->n_states && !self->is_too_large; s++)
+    {
+        if (self->states[s].kind != NFA_STATE_BYTES)
+        {
+            continue;
+        }
+        int16_t refined[2][UCHAR_MAX + 1];
+        memset(refined, 0xff, sizeof(refined));
+        size_t n_classes = 0;
+        for (size_t c = 0; c <= UCHAR_MAX; c++)
+        {
+            size_t is_member = (self->states[s].bits[c / 8] >> (c % 8)) & 1u;
+            int16_t *target = &refined[is_member][self->classes[c]];
+            if (*target < 0)
+            {
+                *target = (int16_t)n_classes++;
+            }
+            self->classes[c] = (uint8_t)*target;
+        }
+        self->n_classes = n_classes;
+    }
+}
+
+static dfa_t *dfa_create(nfa_t const *const nfa, bool is_seeded)
+{
+    dfa_t *self = my_malloc(sizeof(dfa_t));
+    self->nfa = nfa;
+    self->states = NULL;
+    self->capacity = 0;
+    self->transitions = NULL;
+    self->sets_capacity = 64;
+    self->sets = my_malloc(sizeof(uint32_t) * self->sets_capacity);
+    self->n_buckets = 2 * FANCY_STRING_DFA_MAXIMUM_STATES;
+    self->buckets = my_malloc(sizeof(uint32_t) * self->n_buckets);
+    self->marks = my_malloc(sizeof(uint32_t) * nfa->n_states);
+    memset(self->marks, 0, sizeof(uint32_t) * nfa->n_states);
+    self->generation = 0;
+    self->n_flushes = 0;
+    // NOTE: The states that a transition reads from may all be seeds too, in which case they are on the stack twice.
+    self->stack = my_malloc(sizeof(uint32_t) * nfa->n_states * (is_seeded ? 2 : 1));
+    self->closure = my_malloc(sizeof(uint32_t) * nfa->n_states);
+    self->seeds = NULL;
+    self->n_seeds = 0;
+    if (is_seeded)
+    {
+        self->stack[0] = nfa->start;
+        self->n_seeds = dfa_closure(self, 1, false, false);
+        self->seeds = my_malloc(sizeof(uint32_t) * (self->n_seeds + 1));
+        memcpy(self->seeds, self->closure, sizeof(uint32_t) * self->n_seeds);
+    }
+    dfa_flush(self);
+    return self;
+}
 
-    if (self->n_matches <= index)
+static void dfa_destroy(dfa_t *const self)
+{
+    my_free(self->states);
+    my_free(self->transitions);
+    my_free(self->sets);
+    my_free(self->buckets);
+    my_free(self->marks);
+    my_free(self->stack);
+    my_free(self->closure);
+    if (self->seeds != NULL)
     {
-        return info;
+        my_free(self->seeds);
     }
-
-    info.index = (ssize_t)index;
-    info.start = self->start_array[index];
-    info.end = self->end_array[index];
-
-    return info;
+    my_free(self);
 }
 
-fancy_string_t *fancy_string_regex_string_for_match_at_index(fancy_string_regex_t const *const self, size_t index)
+static void dfa_flush(dfa_t *const self)
 {
-    assert(self != NULL);
-
-    if (self->n_matches <= index)
+    // NOTE: Drops all of the states, except for the dead one (i.e., the empty set of NFA states).
+    self->n_states = 0;
+    self->n_sets = 0;
+    for (size_t i = 0; i < self->n_buckets; i++)
     {
-        return NULL;
+        self->buckets[i] = FANCY_STRING_DFA_UNKNOWN;
     }
-    return fancy_string_substring(self->string, self->start_array[index], self->end_array[index]);
+    self->starts[0] = FANCY_STRING_DFA_UNKNOWN;
+    self->starts[1] = FANCY_STRING_DFA_UNKNOWN;
+    self->unanchored_start = FANCY_STRING_DFA_UNKNOWN;
+    self->n_flushes += 1;
+    dfa_add(self, 0);
 }
 
-// -----------------------------------------------
-//                      ARRAY
-// -----------------------------------------------
-
-fancy_string_array_t *fancy_string_array_create(void)
+static int compare_uint32(void const *a, void const *b)
 {
-    fancy_string_array_t *self = my_malloc(sizeof(fancy_string_array_t));
-    self->n = 0;
-    self->array = NULL;
-    return self;
+    uint32_t x = *(uint32_t const *)a;
+    uint32_t y = *(uint32_t const *)b;
+    return (x > y) - (x < y);
 }
 
-fancy_string_array_t *fancy_string_array_create_with_values(char const *const first_value, ...)
+static size_t dfa_closure(dfa_t *const self, size_t n_seeds, bool is_scan_start, bool is_end)
 {
-    fancy_string_array_t *a = fancy_string_array_create();
-
-    if (first_value == NULL)
+    // NOTE: Replaces the `n_seeds` NFA states at the top of `stack` with the (sorted) states that they lead to
+    // without reading a byte (stored in `closure`), and returns their number. Only the states that read a byte,
+    // match, or assert the scan's end (unless `is_end`, in which case the assertion holds) are kept.
+    nfa_state_t const *const states = self->nfa->states;
+    self->generation += 1;
+    if (self->generation == 0)
     {
-        return a;
+        memset(self->marks, 0, sizeof(uint32_t) * self->nfa->n_states);
+        self->generation = 1;
     }
-
-    va_list args;
-    va_start(args, first_value);
-
-    fancy_string_array_push_value(a, first_value);
-
-    while (true)
+    size_t n_stack = 0;
+    for (size_t i = 0; i < n_seeds; i++)
     {
-        char *tmp = va_arg(args, char *);
-        if (tmp == NULL)
+        if (self->marks[self->stack[i]] != self->generation)
+        {
+            self->marks[self->stack[i]] = self->generation;
+            self->stack[n_stack++] = self->stack[i];
+        }
+    }
+    size_t n = 0;
+    while (n_stack > 0)
+    {
+        uint32_t state = self->stack[--n_stack];
+        uint32_t outs[2] = {FANCY_STRING_NFA_NONE, FANCY_STRING_NFA_NONE};
+        switch (states[state].kind)
         {
+        case NFA_STATE_SPLIT:
+            outs[0] = states[state].out;
+            outs[1] = states[state].out1;
+            break;
+        case NFA_STATE_SCAN_START:
+            outs[0] = is_scan_start ? states[state].out : FANCY_STRING_NFA_NONE;
+            break;
+        case NFA_STATE_SCAN_END:
+            if (is_end)
+            {
+                outs[0] = states[state].out;
+                break;
+            }
+            self->closure[n++] = state;
+            break;
+        default:
+            self->closure[n++] = state;
             break;
         }
-        fancy_string_array_push_value(a, tmp);
+        for (size_t i = 0; i < 2; i++)
+        {
+            if (outs[i] != FANCY_STRING_NFA_NONE && self->marks[outs[i]] != self->generation)
+            {
+                self->marks[outs[i]] = self->generation;
+                self->stack[n_stack++] = outs[i];
+            }
+        }
     }
-
-    va_end(args);
-
-    return a;
+    qsort(self->closure, n, sizeof(uint32_t), compare_uint32);
+    return n;
 }
 
-fancy_string_array_t *fancy_string_array_clone(fancy_string_array_t const *const self)
+static uint32_t dfa_add(dfa_t *const self, size_t n)
 {
-    assert(self != NULL);
+    // NOTE: Returns the state made of the first `n` NFA states of `closure`, which is added if needed. When
+    // the DFA is full, it is flushed first (i.e., all of the other state numbers become invalid).
+    uint32_t const *const set = self->closure;
+    uint64_t hash = UINT64_C(14695981039346656037);
+    for (size_t i = 0; i < n; i++)
+    {
+        hash = (hash ^ set[i]) * UINT64_C(1099511628211);
+    }
+    size_t bucket = (size_t)(hash & (self->n_buckets - 1));
+    for (uint32_t state = self->buckets[bucket]; state != FANCY_STRING_DFA_UNKNOWN; state = self->states[state].next_in_bucket)
+    {
+        if (self->states[state].n == n && memcmp(self->sets + self->states[state].first, set, sizeof(uint32_t) * n) == 0)
+        {
+            return state;
+        }
+    }
+    if (self->n_states == FANCY_STRING_DFA_MAXIMUM_STATES || self->n_sets + n > FANCY_STRING_DFA_MAXIMUM_SET_SIZE)
+    {
+        dfa_flush(self);
+        return dfa_add(self, n);
+    }
 
-    fancy_string_array_t *clone = fancy_string_array_create();
+    size_t n_classes = self->nfa->n_classes;
+    if (self->n_states == self->capacity)
+    {
+        self->capacity = self->capacity == 0 ? 16 : self->capacity * 2;
+        self->states = my_realloc(self->states, sizeof(dfa_state_t) * self->capacity);
+        self->transitions = my_realloc(self->transitions, sizeof(uint32_t) * self->capacity * n_classes);
+    }
+    if (self->n_sets + n > self->sets_capacity)
+    {
+        while (self->n_sets + n > self->sets_capacity)
+        {
+            self->sets_capacity *= 2;
+        }
+        self->sets = my_realloc(self->sets, sizeof(uint32_t) * self->sets_capacity);
+    }
+    memcpy(self->sets + self->n_sets, set, sizeof(uint32_t) * n);
 
-    for (size_t i = 0; i < self->n; i++)
+    // NOTE: At the scan's end, the scan end assertions hold, which can lead to a match.
+    nfa_state_t const *const states = self->nfa->states;
+    bool is_match = false;
+    size_t n_seeds = 0;
+    for (size_t i = 0; i < n; i++)
     {
-        fancy_string_array_push(clone, self->array[i]);
+        is_match = is_match || states[set[i]].kind == NFA_STATE_MATCH;
+        if (states[set[i]].kind == NFA_STATE_SCAN_END)
+        {
+            self->stack[n_seeds++] = states[set[i]].out;
+        }
+    }
+    bool is_match_at_end = is_match;
+    if (n_seeds > 0 && !is_match_at_end)
+    {
+        // NOTE: The scan end assertions may lead to other ones (e.g., with `$$` or `(a|$)*`), which hold too.
+        size_t n_end = dfa_closure(self, n_seeds, false, true);
+        for (size_t i = 0; i < n_end; i++)
+        {
+            is_match_at_end = is_match_at_end || states[self->closure[i]].kind == NFA_STATE_MATCH;
+        }
     }
 
-    return clone;
+    uint32_t state = (uint32_t)self->n_states++;
+    self->states[state].first = self->n_sets;
+    self->states[state].n = n;
+    self->states[state].is_match = is_match;
+    self->states[state].is_match_at_end = is_match_at_end;
+    self->states[state].next_in_bucket = self->buckets[bucket];
+    self->buckets[bucket] = state;
+    self->n_sets += n;
+    for (size_t c = 0; c < n_classes; c++)
+    {
+        self->transitions[state * n_classes + c] = FANCY_STRING_DFA_UNKNOWN;
+    }
+    return state;
 }
 
-void fancy_string_array_append(fancy_string_array_t *const self, fancy_string_array_t const *const array)
+static uint32_t dfa_start(dfa_t *const self, bool is_scan_start)
 {
-    assert(self != NULL);
-    assert(array != NULL);
-
-    for (size_t i = 0; i < array->n; i++)
+    if (self->starts[is_scan_start] == FANCY_STRING_DFA_UNKNOWN)
     {
-        fancy_string_array_push(self, array->array[i]);
+        self->stack[0] = self->nfa->start;
+        uint32_t state = dfa_add(self, dfa_closure(self, 1, is_scan_start, false));
+        self->starts[is_scan_start] = state;
     }
+    return self->starts[is_scan_start];
 }
 
-void fancy_string_array_append_and_destroy(fancy_string_array_t *const self, fancy_string_array_t *array)
+static uint32_t dfa_unanchored_start(dfa_t *const self)
 {
-    assert(self != NULL);
-    assert(array != NULL);
-
-    fancy_string_array_append(self, array);
-    fancy_string_array_destroy(array);
+    if (self->unanchored_start == FANCY_STRING_DFA_UNKNOWN)
+    {
+        self->stack[0] = self->nfa->loop;
+        uint32_t state = dfa_add(self, dfa_closure(self, 1, true, false));
+        self->unanchored_start = state;
+    }
+    return self->unanchored_start;
 }
 
-void fancy_string_array_destroy(fancy_string_array_t *const self)
+static uint32_t dfa_anchor(dfa_t *const self, uint32_t state)
 {
-    assert(self != NULL);
-
-    fancy_string_array_clear(self);
-    my_free(self);
+    // NOTE: Returns the state of an unanchored scan once it stops starting new matches (i.e., without `any`).
+    uint32_t const *const set = self->sets + self->states[state].first;
+    size_t n = 0;
+    for (size_t i = 0; i < self->states[state].n; i++)
+    {
+        if (set[i] != self->nfa->any)
+        {
+            self->closure[n++] = set[i];
+        }
+    }
+    return dfa_add(self, n);
 }
 
-void fancy_string_array_print(fancy_string_array_t const *const self, FILE *stream, bool debug)
+static uint32_t dfa_next(dfa_t *const self, uint32_t state, unsigned char byte)
 {
-    assert(self != NULL);
-    assert(stream != NULL);
-
-    if (debug)
+    size_t n_classes = self->nfa->n_classes;
+    size_t column = self->nfa->classes[byte];
+    uint32_t next = self->transitions[state * n_classes + column];
+    if (next != FANCY_STRING_DFA_UNKNOWN)
     {
-        fprintf(stream, "fancy_string_array_t[%zu] {\n", self->n);
-        for (size_t i = 0; i < self->n; i++)
+        return next;
+    }
+    nfa_state_t const *const states = self->nfa->states;
+    uint32_t const *const set = self->sets + self->states[state].first;
+    size_t n_seeds = 0;
+    for (size_t i = 0; i < self->states[state].n; i++)
+    {
+        nfa_state_t const *const nfa_state = &states[set[i]];
+        if (nfa_state->kind == NFA_STATE_BYTES && (nfa_state->bits[byte / 8] & (1u << (byte % 8))) != 0)
         {
-            fprintf(
-                stream, "\tfancy_string_t[%zu](%s),\n",
-                fancy_string_size(self->array[i]),
-                self->array[i]->value);
+            self->stack[n_seeds++] = nfa_state->out;
         }
-        fprintf(stream, "}\n");
     }
-    else
+    for (size_t i = 0; i < self->n_seeds; i++)
     {
-        for (size_t i = 0; i < self->n; i++)
+        nfa_state_t const *const nfa_state = &states[self->seeds[i]];
+        if (nfa_state->kind == NFA_STATE_BYTES && (nfa_state->bits[byte / 8] & (1u << (byte % 8))) != 0)
         {
-            fancy_string_print(self->array[i], stream, false);
+            self->stack[n_seeds++] = nfa_state->out;
         }
     }
+    size_t n_flushes = self->n_flushes;
+    next = dfa_add(self, dfa_closure(self, n_seeds, false, false));
+    // NOTE: When `dfa_add` flushed the DFA, `state` is gone, and so is the transition.
+    if (self->n_flushes == n_flushes)
+    {
+        self->transitions[state * n_classes + column] = next;
+    }
+    return next;
 }
 
-void fancy_string_array_clear(fancy_string_array_t *const self)
+static bool dfa_longest(dfa_t *const self, char const *const value, size_t n, size_t start, size_t *const end, size_t *const n_read)
 {
-    assert(self != NULL);
-
-    while (true)
+    // NOTE: Finds the longest match that starts at `start` (the scan starts at `0` and ends at `n`), and adds the
+    // number of bytes that were read to `n_read`.
+    uint32_t state = dfa_start(self, start == 0);
+    bool is_found = start == n ? self->states[state].is_match_at_end : self->states[state].is_match;
+    *end = start;
+    for (size_t i = start; i < n; i++)
     {
-        if (self->n == 0)
+        state = dfa_next(self, state, (unsigned char)value[i]);
+        *n_read += 1;
+        if (state == FANCY_STRING_DFA_DEAD)
         {
             break;
         }
-
-        fancy_string_destroy(self->array[self->n - 1]);
-        if (self->n == 1)
-        {
-            my_free(self->array);
-        }
-        else
+        if (i + 1 == n ? self->states[state].is_match_at_end : self->states[state].is_match)
         {
-            self->array = my_realloc(self->array, sizeof(fancy_string_t *) * (self->n - 1));
+            is_found = true;
+            *end = i + 1;
         }
-
-        self->n--;
     }
+    return is_found;
 }
 
-size_t fancy_string_array_size(fancy_string_array_t const *const self)
-{
-    assert(self != NULL);
-
-    return self->n;
-}
-
-bool fancy_string_array_is_empty(fancy_string_array_t const *const self)
-{
-    assert(self != NULL);
-
-    return fancy_string_array_size(self) == 0;
-}
-
-void fancy_string_array_push_value(fancy_string_array_t *const self, char const *const value)
+static bool dfa_scan_starts(dfa_t *const self, char const *const value, size_t n, bool is_scan_start, uint64_t *const starts, size_t *const leftmost)
 {
-    assert(self != NULL);
-    assert(value != NULL);
-
-    fancy_string_t *string = fancy_string_create(value);
-    if (self->n == 0)
+    // NOTE: Scans from `n` back to `0` (i.e., runs the reverse NFA), to find the positions where a match starts
+    // (`is_scan_start` tells whether `$` holds at `n`). When `starts` is not `NULL`, they are all set in it, except
+    // for the ones that need `^` (which is only known to hold at the start of a search). Otherwise, only the
+    // leftmost one is returned through `leftmost`.
+    uint32_t state = dfa_start(self, is_scan_start);
+    bool is_found = false;
+    for (size_t i = n;; i--)
     {
-        self->array = my_malloc(sizeof(fancy_string_t *));
-    }
-    else
-    {
-        self->array = my_realloc(self->array, sizeof(fancy_string_t *) * (self->n + 1));
+        if (starts == NULL && i == 0 ? self->states[state].is_match_at_end : self->states[state].is_match)
+        {
+            is_found = true;
+            *leftmost = i;
+            if (starts != NULL)
+            {
+                starts[i / 64] |= UINT64_C(1) << (i % 64);
+            }
+        }
+        if (i == 0)
+        {
+            break;
+        }
+        state = dfa_next(self, state, (unsigned char)value[i - 1]);
     }
-    self->array[self->n] = string;
-    self->n++;
+    return is_found;
 }
 
-void fancy_string_array_push_values(fancy_string_array_t *const self, char const *const first_value, ...)
+static bool dfa_find(dfa_t *const forward, dfa_t *const reverse, char const *const value, size_t n, size_t *const start, size_t *const end, size_t *const limit)
 {
-    assert(self != NULL);
-
-    if (first_value == NULL)
+    // NOTE: Finds the leftmost-longest match, while only reading the input up to where it is known (`limit`). A
+    // match is started at every position until one of them is found, after which the scan goes on (without starting
+    // new ones) until none of them can go on. The leftmost of the matches that ended so far is then found by
+    // scanning back from there, and its longest version by scanning forward from its start.
+    uint32_t state = dfa_unanchored_start(forward);
+    size_t i = 0;
+    while (!(i == n ? forward->states[state].is_match_at_end : forward->states[state].is_match))
     {
-        return;
+        if (i == n)
+        {
+            return false;
+        }
+        state = dfa_next(forward, state, (unsigned char)value[i++]);
     }
-
-    fancy_string_array_t *a = fancy_string_array_create();
-
-    va_list args;
-    va_start(args, first_value);
-
-    fancy_string_array_push_value(a, first_value);
-
-    while (true)
+    state = dfa_anchor(forward, state);
+    *limit = n;
+    for (; i < n; i++)
     {
-        char *tmp = va_arg(args, char *);
-        if (tmp == NULL)
+        state = dfa_next(forward, state, (unsigned char)value[i]);
+        if (state == FANCY_STRING_DFA_DEAD)
         {
+            *limit = i;
             break;
         }
-        fancy_string_array_push_value(a, tmp);
     }
-
-    va_end(args);
-
-    fancy_string_array_append_and_destroy(self, a);
+    dfa_scan_starts(reverse, value, *limit, *limit == n, NULL, start);
+    size_t n_read = 0;
+    return dfa_longest(forward, value, n, *start, end, &n_read);
 }
 
-void fancy_string_array_push(fancy_string_array_t *const self, fancy_string_t const *const string)
+static void regex_search_init(regex_search_t *const self, fancy_string_pattern_t const *const pattern, bool is_single)
 {
-    assert(self != NULL);
-    assert(string != NULL);
-
-    fancy_string_array_push_value(self, string->value);
+    self->pattern = pattern;
+    self->forward = NULL;
+    self->reverse = NULL;
+    self->is_shared = false;
+    self->is_single = is_single;
+    self->starts = NULL;
+    self->begin = NULL;
+    self->n_read = 0;
+    if (pattern->engine != FANCY_STRING_REGEX_ENGINE_DFA)
+    {
+        return;
+    }
+    // NOTE: The DFAs are (with the prefilter counters) the only members of a pattern object that are
+    // modified after it is created.
+    fancy_string_pattern_t *shared = (fancy_string_pattern_t *)pattern;
+    if (pthread_mutex_trylock(&shared->dfa_mutex) == 0)
+    {
+        self->is_shared = true;
+        self->forward = shared->forward_dfa;
+        self->reverse = shared->reverse_dfa;
+    }
+    else
+    {
+        self->forward = dfa_create(pattern->forward_nfa, false);
+        self->reverse = dfa_create(pattern->reverse_nfa, false);
+    }
 }
 
-fancy_string_t *fancy_string_array_get(fancy_string_array_t const *const self, size_t index)
+static void regex_search_release(regex_search_t *const self)
 {
-    assert(self != NULL);
-
-    if (self->n <= index)
+    if (self->starts != NULL)
     {
-        return NULL;
+        my_free(self->starts);
+    }
+    if (self->is_shared)
+    {
+        pthread_mutex_unlock(&((fancy_string_pattern_t *)self->pattern)->dfa_mutex);
+    }
+    else if (self->forward != NULL)
+    {
+        dfa_destroy(self->forward);
+        dfa_destroy(self->reverse);
     }
-
-    return fancy_string_clone(self->array[index]);
 }
 
-char *fancy_string_array_get_value(fancy_string_array_t const *const self, size_t index)
+static int regex_search_exec(regex_search_t *const self, char const *const value, size_t n, regmatch_t *const match)
 {
-    assert(self != NULL);
+    // NOTE: Same as `regex_exec` (i.e., finds the leftmost-longest match in the `n` bytes at `value`, where `^`
+    // holds at `value` and `$` at `value + n`). For a search made of many calls, every call is given a suffix of
+    // the previous one's input.
+    if (self->pattern->engine != FANCY_STRING_REGEX_ENGINE_DFA)
+    {
+        return regex_exec(&self->pattern->re, value, n, match);
+    }
 
-    fancy_string_t *string = fancy_string_array_get(self, index);
-    if (string == NULL)
+    size_t start = 0;
+    size_t end = 0;
+    bool is_found = false;
+    if (self->is_single)
     {
-        return NULL;
+        size_t limit;
+        is_found = dfa_find(self->forward, self->reverse, value, n, &start, &end, &limit);
     }
-    char *value = fancy_string_value(string);
-    fancy_string_destroy(string);
-    return value;
+    else
+    {
+        // NOTE: The matches that need `^` can only start at `value`.
+        if (self->pattern->has_begin && dfa_longest(self->forward, value, n, 0, &end, &self->n_read))
+        {
+            match->rm_so = 0;
+            match->rm_eo = (regoff_t)end;
+            return 0;
+        }
+        if (self->starts == NULL)
+        {
+            size_t n_words = n / 64 + 1;
+            self->starts = my_malloc(sizeof(uint64_t) * n_words);
+            memset(self->starts, 0, sizeof(uint64_t) * n_words);
+            self->begin = value;
+            dfa_scan_starts(self->reverse, value, n, true, self->starts, &start);
+        }
+        // NOTE: Finds the first start at or after `value`, which amortizes to a single pass over `starts`.
+        size_t offset = (size_t)(value - self->begin);
+        size_t n_total = offset + n;
+        size_t word = offset / 64;
+        uint64_t bits = self->starts[word] & (~UINT64_C(0) << (offset % 64));
+        while (bits == 0 && word < n_total / 64)
+        {
+            bits = self->starts[++word];
+        }
+        if (bits != 0)
+        {
+            start = word * 64 + (size_t)__builtin_ctzll(bits) - offset;
+            is_found = dfa_longest(self->forward, value, n, start, &end, &self->n_read);
+        }
+    }
+    if (!is_found)
+    {
+        return REG_NOMATCH;
+    }
+    match->rm_so = (regoff_t)start;
+    match->rm_eo = (regoff_t)end;
+    return 0;
 }
 
-fancy_string_t *fancy_string_array_remove(fancy_string_array_t *const self, size_t index)
+static void regex_stream_init(regex_stream_t *const self, fancy_string_pattern_t const *const pattern, fancy_string_pattern_match_t fn, void *context)
 {
-    assert(self != NULL);
+    size_t n_states = pattern->forward_nfa->n_states;
+    self->pattern = pattern;
+    self->fn = fn;
+    self->context = context;
+    self->states = my_malloc(sizeof(uint32_t) * n_states);
+    self->starts = my_malloc(sizeof(size_t) * n_states);
+    self->next_states = my_malloc(sizeof(uint32_t) * n_states);
+    self->next_starts = my_malloc(sizeof(size_t) * n_states);
+    self->marks = my_malloc(sizeof(uint32_t) * n_states);
+    memset(self->marks, 0, sizeof(uint32_t) * n_states);
+    self->generation = 0;
+    self->stack = my_malloc(sizeof(uint32_t) * n_states);
 
-    if (self->n <= index)
+    nfa_state_t const *const states = pattern->forward_nfa->states;
+    regex_stream_prepare(self);
+    regex_stream_add(self, pattern->forward_nfa->start, 0, false, false);
+    bool is_scanned = true;
+    for (size_t i = 0; i < self->n_next; i++)
     {
-        return NULL;
+        is_scanned = is_scanned && states[self->next_states[i]].kind == NFA_STATE_BYTES;
     }
-
-    // NOTE: Without this block, the code below (i.e., after this block)
-    // introduces a small leak. [This thread](https://stackoverflow.com/questions/16759849/using-realloc-x-0-instead-of-free-and-using-malloc-with-length-of-a-string)
-    //  suggests that calling `realloc` with size zero will not result in
-    // and internal call to `free`, depending on the implementation.
-    if (self->n == 1)
+    char chars[UCHAR_MAX + 1];
+    size_t n_chars = 0;
+    for (size_t c = 0; c <= UCHAR_MAX; c++)
     {
-        fancy_string_t *tmp = self->array[0];
-        my_free(self->array);
-        self->array = NULL;
-        self->n = 0;
-        return tmp;
+        bool is_first = false;
+        for (size_t i = 0; i < self->n_next; i++)
+        {
+            nfa_state_t const *const state = &states[self->next_states[i]];
+            is_first = is_first || (state->kind == NFA_STATE_BYTES && (state->bits[c / 8] & (1u << (c % 8))) != 0);
+        }
+        if (is_first)
+        {
+            chars[n_chars++] = (char)c;
+        }
     }
-
-    fancy_string_t *string = self->array[index];
-
-    for (size_t i = index; i < self->n - 1; i++)
+    self->has_first_bytes = is_scanned && n_chars <= UCHAR_MAX;
+    charset_init(&self->first_bytes, chars, n_chars);
+    regex_search_init(&self->search, pattern, true);
+    self->dfa = NULL;
+    if (is_scanned)
     {
-        self->array[i] = self->array[i + 1];
+        self->dfa = self->search.is_shared ? pattern->stream_dfa : dfa_create(pattern->forward_nfa, true);
     }
-    self->n -= 1;
-    self->array = my_realloc(self->array, sizeof(fancy_string_t *) * self->n);
 
-    return string;
+    self->candidate_starts = NULL;
+    self->candidate_ends = NULL;
+    self->first_candidate = 0;
+    self->n_candidates = 0;
+    self->candidates_capacity = 0;
+    self->position = 0;
+    self->search_start = 0;
+    self->count = 0;
+    self->is_done = false;
+    self->n_threads = 0;
 }
 
-void fancy_string_array_remove_and_destroy(fancy_string_array_t *const self, size_t index)
+static void regex_stream_release(regex_stream_t *const self)
 {
-    assert(self != NULL);
-
-    fancy_string_t *removed = fancy_string_array_remove(self, index);
-    if (removed != NULL)
+    my_free(self->states);
+    my_free(self->starts);
+    my_free(self->next_states);
+    my_free(self->next_starts);
+    my_free(self->marks);
+    my_free(self->stack);
+    if (self->candidate_starts != NULL)
     {
-        fancy_string_destroy(removed);
+        my_free(self->candidate_starts);
+        my_free(self->candidate_ends);
     }
-}
-
-fancy_string_t *fancy_string_array_pop(fancy_string_array_t *const self)
-{
-    assert(self != NULL);
-
-    if (self->n == 0)
+    if (self->dfa != NULL && !self->search.is_shared)
     {
-        return NULL;
+        dfa_destroy(self->dfa);
     }
-
-    return fancy_string_array_remove(self, self->n - 1);
+    regex_search_release(&self->search);
 }
 
-void fancy_string_array_pop_and_destroy(fancy_string_array_t *const self)
+static void regex_stream_prepare(regex_stream_t *const self)
 {
-    assert(self != NULL);
-
-    fancy_string_t *string = fancy_string_array_pop(self);
-    if (string != NULL)
+    self->n_next = 0;
+    self->generation += 1;
+    if (self->generation == 0)
     {
-        fancy_string_destroy(string);
+        memset(self->marks, 0, sizeof(uint32_t) * self->pattern->forward_nfa->n_states);
+        self->generation = 1;
     }
 }
 
-fancy_string_t *fancy_string_array_shift(fancy_string_array_t *const self)
+static void regex_stream_add(regex_stream_t *const self, uint32_t state, size_t start, bool is_scan_start, bool is_end)
 {
-    assert(self != NULL);
-
-    if (self->n == 0)
+    // NOTE: Adds a thread that started at `start` to each of the states that `state` leads to without reading a
+    // byte, unless they already have one. Since the threads are added by increasing start, the leftmost one stays.
+    nfa_state_t const *const states = self->pattern->forward_nfa->states;
+    if (self->marks[state] == self->generation)
     {
-        return NULL;
+        return;
+    }
+    self->marks[state] = self->generation;
+    size_t n_stack = 0;
+    self->stack[n_stack++] = state;
+    while (n_stack > 0)
+    {
+        uint32_t current = self->stack[--n_stack];
+        uint32_t outs[2] = {FANCY_STRING_NFA_NONE, FANCY_STRING_NFA_NONE};
+        switch (states[current].kind)
+        {
+        case NFA_STATE_SPLIT:
+            outs[0] = states[current].out;
+            outs[1] = states[current].out1;
+            break;
+        case NFA_STATE_SCAN_START:
+            outs[0] = is_scan_start ? states[current].out : FANCY_STRING_NFA_NONE;
+            break;
+        case NFA_STATE_SCAN_END:
+            if (is_end)
+            {
+                outs[0] = states[current].out;
+                break;
+            }
+            self->next_states[self->n_next] = current;
+            self->next_starts[self->n_next++] = start;
+            break;
+        default:
+            self->next_states[self->n_next] = current;
+            self->next_starts[self->n_next++] = start;
+            break;
+        }
+        for (size_t i = 0; i < 2; i++)
+        {
+            if (outs[i] != FANCY_STRING_NFA_NONE && self->marks[outs[i]] != self->generation)
+            {
+                self->marks[outs[i]] = self->generation;
+                self->stack[n_stack++] = outs[i];
+            }
+        }
     }
-
-    return fancy_string_array_remove(self, 0);
 }
 
-void fancy_string_array_shift_and_destroy(fancy_string_array_t *const self)
+static void regex_stream_swap(regex_stream_t *const self)
 {
-    assert(self != NULL);
+    uint32_t *states = self->states;
+    size_t *starts = self->starts;
+    self->states = self->next_states;
+    self->starts = self->next_starts;
+    self->n_threads = self->n_next;
+    self->next_states = states;
+    self->next_starts = starts;
+}
 
-    fancy_string_t *string = fancy_string_array_shift(self);
-    if (string != NULL)
+static size_t regex_stream_search(regex_stream_t const *const self, size_t start)
+{
+    // NOTE: Returns the index of the candidate of the search that a thread which started at `start` belongs to (i.e.,
+    // of the first candidate that ends after `start`), which is `n_candidates` for the search that has no candidate
+    // yet. Since the searches stop at the first empty match, no search follows an empty candidate.
+    size_t low = self->first_candidate;
+    size_t high = self->n_candidates;
+    while (low < high)
     {
-        fancy_string_destroy(string);
+        size_t middle = low + (high - low) / 2;
+        if (self->candidate_ends[middle] <= start)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    if (low == self->n_candidates && low > self->first_candidate && self->candidate_starts[low - 1] == self->candidate_ends[low - 1])
+    {
+        return low - 1;
     }
+    return low;
 }
 
-void fancy_string_array_insert_value(fancy_string_array_t *const self, char const *const value, size_t index)
+static void regex_stream_propose(regex_stream_t *const self, size_t start, size_t end)
 {
-    assert(self != NULL);
-    assert(value != NULL);
-
-    if (index >= self->n)
+    // NOTE: When a search finds a better match, the searches that started at the end of its previous one are dropped.
+    size_t index = regex_stream_search(self, start);
+    if (index < self->n_candidates)
     {
-        while (self->n < index)
+        if (start < self->candidate_starts[index] || (start == self->candidate_starts[index] && end > self->candidate_ends[index]))
         {
-            fancy_string_array_push_value(self, "");
+            self->candidate_starts[index] = start;
+            self->candidate_ends[index] = end;
+            self->n_candidates = index + 1;
         }
-        fancy_string_array_push_value(self, value);
         return;
     }
-
-    self->array = my_realloc(self->array, sizeof(fancy_string_t *) * (self->n + 1));
-
-    for (size_t i = self->n; i > index; i--)
+    if (self->n_candidates == self->candidates_capacity)
     {
-        self->array[i] = self->array[i - 1];
+        // NOTE: The reported candidates are only dropped from the front once they make up half of the array.
+        if (self->first_candidate > 0 && 2 * self->first_candidate >= self->n_candidates)
+        {
+            size_t n = self->n_candidates - self->first_candidate;
+            memmove(self->candidate_starts, self->candidate_starts + self->first_candidate, sizeof(size_t) * n);
+            memmove(self->candidate_ends, self->candidate_ends + self->first_candidate, sizeof(size_t) * n);
+            self->first_candidate = 0;
+            self->n_candidates = n;
+        }
+        else
+        {
+            self->candidates_capacity = self->candidates_capacity == 0 ? 16 : self->candidates_capacity * 2;
+            self->candidate_starts = my_realloc(self->candidate_starts, sizeof(size_t) * self->candidates_capacity);
+            self->candidate_ends = my_realloc(self->candidate_ends, sizeof(size_t) * self->candidates_capacity);
+        }
     }
-    self->array[index] = fancy_string_create(value);
-    self->n += 1;
+    self->candidate_starts[self->n_candidates] = start;
+    self->candidate_ends[self->n_candidates] = end;
+    self->n_candidates += 1;
 }
 
-void fancy_string_array_insert(fancy_string_array_t *const self, fancy_string_t const *const string, size_t index)
+static void regex_stream_check(regex_stream_t *const self)
 {
-    assert(self != NULL);
-    assert(string != NULL);
-
-    fancy_string_array_insert_value(self, string->value, index);
+    // NOTE: Updates the candidates with the threads that match at the current position (from the leftmost one on),
+    // then drops them, along with the threads that started after their search's candidate (which can no longer
+    // lead to a better one). The remaining threads that read a byte, or that wait for the end of the input, may
+    // still lead to a better one.
+    nfa_state_t const *const states = self->pattern->forward_nfa->states;
+    for (size_t i = 0; i < self->n_threads; i++)
+    {
+        if (states[self->states[i]].kind == NFA_STATE_MATCH)
+        {
+            regex_stream_propose(self, self->starts[i], self->position);
+        }
+    }
+    size_t n = 0;
+    for (size_t i = 0; i < self->n_threads; i++)
+    {
+        if (states[self->states[i]].kind == NFA_STATE_MATCH)
+        {
+            continue;
+        }
+        size_t index = regex_stream_search(self, self->starts[i]);
+        if (index == self->n_candidates || self->starts[i] <= self->candidate_starts[index])
+        {
+            self->states[n] = self->states[i];
+            self->starts[n++] = self->starts[i];
+        }
+    }
+    self->n_threads = n;
 }
 
-fancy_string_t *fancy_string_array_first(fancy_string_array_t const *const self)
+static void regex_stream_seed(regex_stream_t *const self, bool has_byte, unsigned char byte)
 {
-    assert(self != NULL);
-
-    if (self->n == 0)
+    // NOTE: Starts a match at the current position (before `byte`, if `has_byte`), where `^` holds if a search starts
+    // there (just like it does at the start of each of the `regexec` calls made by
+    // `fancy_string_regex_create_with_pattern`). A thread that is already in one of the NFA states it begins with
+    // started earlier, so either it leads to the same match for an earlier start, or it leads to a better match for
+    // a search that precedes this one (which then drops it).
+    size_t search_start = self->search_start;
+    if (self->n_candidates > self->first_candidate)
     {
-        return NULL;
+        size_t last = self->n_candidates - 1;
+        if (self->candidate_starts[last] == self->candidate_ends[last])
+        {
+            return;
+        }
+        search_start = self->candidate_ends[last];
+    }
+    if (has_byte && self->has_first_bytes && self->position != search_start && !charset_contains(&self->first_bytes, (char)byte))
+    {
+        return;
+    }
+    regex_stream_prepare(self);
+    for (size_t i = 0; i < self->n_threads; i++)
+    {
+        self->marks[self->states[i]] = self->generation;
+        self->next_states[self->n_next] = self->states[i];
+        self->next_starts[self->n_next++] = self->starts[i];
+    }
+    regex_stream_add(self, self->pattern->forward_nfa->start, self->position, self->position == search_start, false);
+    bool has_match = false;
+    for (size_t i = self->n_threads; i < self->n_next; i++)
+    {
+        has_match = has_match || self->pattern->forward_nfa->states[self->next_states[i]].kind == NFA_STATE_MATCH;
+    }
+    regex_stream_swap(self);
+    if (has_match)
+    {
+        regex_stream_check(self);
     }
-
-    return fancy_string_clone(self->array[0]);
 }
 
-char *fancy_string_array_first_value(fancy_string_array_t const *const self)
+static void regex_stream_step(regex_stream_t *const self, unsigned char byte)
 {
-    assert(self != NULL);
-
-    if (self->n == 0)
+    nfa_state_t const *const states = self->pattern->forward_nfa->states;
+    regex_stream_seed(self, true, byte);
+    regex_stream_prepare(self);
+    for (size_t i = 0; i < self->n_threads; i++)
     {
-        return NULL;
+        nfa_state_t const *const state = &states[self->states[i]];
+        if (state->kind == NFA_STATE_BYTES && (state->bits[byte / 8] & (1u << (byte % 8))) != 0)
+        {
+            regex_stream_add(self, state->out, self->starts[i], false, false);
+        }
+    }
+    regex_stream_swap(self);
+    self->position += 1;
+    regex_stream_check(self);
+}
+
+static void regex_stream_scan(regex_stream_t *const self, char const *const data, size_t end)
+{
+    // NOTE: When there is neither a thread nor a pending match (and `^` does not hold), the DFA's states are made
+    // of the simulation's threads (without their starts), so the input is scanned with it instead, until a match
+    // ends or the data does. The threads that are then left all started after the last position where there
+    // was none (`resume`), which is where the simulation resumes (i.e., it reads these bytes again). Once there has
+    // been none for a few bytes in a row (i.e., when calling them is likely worth it), the input that precedes the
+    // next byte that a match can start with (or the next occurrence of the pattern's prefilter, when every match
+    // starts with it) is skipped using the SIMD search kernels.
+    fancy_string_pattern_t const *const pattern = self->pattern;
+    bool has_literal = pattern->is_prefix && pattern->prefilter == FANCY_STRING_PREFILTER_KIND_LITERAL;
+    dfa_t *const dfa = self->dfa;
+    size_t data_start = self->position;
+    while (dfa != NULL && !self->is_done && self->n_candidates == self->first_candidate && self->n_threads == 0 && !(pattern->has_begin && self->position == self->search_start))
+    {
+        char const *const value = data + (self->position - data_start);
+        size_t n = end - self->position;
+        uint32_t state = FANCY_STRING_DFA_DEAD;
+        size_t resume = 0;
+        size_t n_dead = FANCY_STRING_DFA_MINIMUM_DEAD_RUN;
+        size_t i = 0;
+        while (i < n)
+        {
+            if (state == FANCY_STRING_DFA_DEAD && n_dead >= FANCY_STRING_DFA_MINIMUM_DEAD_RUN)
+            {
+                n_dead = 0;
+                if (has_literal)
+                {
+                    // NOTE: An occurrence may straddle the end of the data, so its first bytes are not skipped.
+                    ssize_t index = index_of_memory(value + i, n - i, pattern->literal, pattern->n_literal);
+                    i += index != -1 ? (size_t)index : (n - i >= pattern->n_literal ? n - i - (pattern->n_literal - 1) : 0);
+                }
+                else if (self->has_first_bytes)
+                {
+                    size_t position;
+                    i = find_any_memory(value + i, n - i, &self->first_bytes, &position, 1) == 1 ? i + position : n;
+                }
+                if (i == n)
+                {
+                    resume = i;
+                    break;
+                }
+            }
+            if (state == FANCY_STRING_DFA_DEAD)
+            {
+                resume = i;
+            }
+            state = dfa_next(dfa, state, (unsigned char)value[i]);
+            i += 1;
+            if (dfa->states[state].is_match)
+            {
+                break;
+            }
+            n_dead = state == FANCY_STRING_DFA_DEAD ? n_dead + 1 : 0;
+        }
+        if (state == FANCY_STRING_DFA_DEAD)
+        {
+            self->position += i;
+            return;
+        }
+        // NOTE: A match ends at `i`. Unless `^` can hold, the match that the simulation would find from `resume` is
+        // found by `dfa_find` instead, as long as it is known before the end of the data (i.e., no later byte can
+        // make it longer, nor lead to a match that starts before it). Just like in `regex_search_exec`, once these
+        // scans have read much more than the input (e.g., `"a|a+b"` on a run of `"a"`), the simulation finds the
+        // remaining matches.
+        size_t start;
+        size_t match_end;
+        size_t limit;
+        if (pattern->has_begin || self->search.n_read > FANCY_STRING_DFA_MAXIMUM_READ_FACTOR * end || !dfa_find(self->search.forward, self->search.reverse, value + resume, n - resume, &start, &match_end, &limit) || limit == n - resume)
+        {
+            self->position += resume;
+            return;
+        }
+        self->search.n_read += limit;
+        regex_stream_propose(self, self->position + resume + start, self->position + resume + match_end);
+        self->position += resume + match_end;
+        regex_stream_emit(self);
     }
-
-    return fancy_string_value(self->array[0]);
 }
 
-fancy_string_t *fancy_string_array_last(fancy_string_array_t const *const self)
+static void regex_stream_emit(regex_stream_t *const self)
 {
-    assert(self != NULL);
-
-    if (self->n == 0)
+    // NOTE: Reports the current search's match once none of its threads is left (the threads are sorted by start,
+    // and the ones of the following searches started at or after its end).
+    while (!self->is_done && self->n_candidates > self->first_candidate)
     {
-        return NULL;
+        size_t start = self->candidate_starts[self->first_candidate];
+        size_t end = self->candidate_ends[self->first_candidate];
+        if (self->n_threads > 0 && (start == end || self->starts[0] < end))
+        {
+            return;
+        }
+        // NOTE: Just like `fancy_string_regex_create_with_pattern`, the search stops at the first empty match.
+        if (start == end)
+        {
+            self->is_done = true;
+            return;
+        }
+        self->count += 1;
+        self->first_candidate += 1;
+        if (self->first_candidate == self->n_candidates)
+        {
+            self->first_candidate = 0;
+            self->n_candidates = 0;
+        }
+        self->search_start = end;
+        if (self->fn != NULL && !self->fn(self->pattern, start, end, self->context))
+        {
+            self->is_done = true;
+        }
     }
-
-    return fancy_string_clone(self->array[self->n - 1]);
 }
 
-char *fancy_string_array_last_value(fancy_string_array_t const *const self)
+static void regex_stream_run(regex_stream_t *const self, char const *const data, size_t n)
 {
-    assert(self != NULL);
-
-    if (self->n == 0)
+    // NOTE: Reads the next `n` bytes of the input (i.e., the ones from `position` on), which are never needed again.
+    size_t data_start = self->position;
+    size_t end = data_start + n;
+    while (!self->is_done && self->position < end)
     {
-        return NULL;
+        regex_stream_scan(self, data + (self->position - data_start), end);
+        if (self->position == end)
+        {
+            break;
+        }
+        regex_stream_step(self, (unsigned char)data[self->position - data_start]);
+        regex_stream_emit(self);
     }
-
-    return fancy_string_value(self->array[self->n - 1]);
 }
 
-fancy_string_t *fancy_string_array_join_by_value(fancy_string_array_t const *const self, char const *const separator)
+static void regex_stream_finish(regex_stream_t *const self)
 {
-    assert(self != NULL);
-    assert(separator != NULL);
-
-    fancy_string_t *string = fancy_string_create_empty();
-
-    if (self->n == 0)
+    // NOTE: At the end of the input, `$` holds, and none of the threads can go on.
+    nfa_state_t const *const states = self->pattern->forward_nfa->states;
+    if (self->is_done)
     {
-        return string;
+        return;
     }
-
-    for (size_t i = 0; i < self->n; i++)
+    regex_stream_seed(self, false, 0);
+    regex_stream_prepare(self);
+    for (size_t i = 0; i < self->n_threads; i++)
     {
-        if (i > 0)
+        if (states[self->states[i]].kind == NFA_STATE_SCAN_END)
         {
-            fancy_string_append_value(string, separator);
+            regex_stream_add(self, self->states[i], self->starts[i], false, true);
         }
-        fancy_string_append(string, self->array[i]);
     }
-
-    return string;
-}
-
-fancy_string_t *fancy_string_array_join(fancy_string_array_t const *const self, fancy_string_t const *const separator)
-{
-    assert(self != NULL);
-    assert(separator != NULL);
-
-    return fancy_string_array_join_by_value(self, separator->value);
+    for (size_t i = 0; i < self->n_next; i++)
+    {
+        if (states[self->next_states[i]].kind == NFA_STATE_MATCH)
+        {
+            regex_stream_propose(self, self->next_starts[i], self->position);
+        }
+    }
+    self->n_threads = 0;
+    regex_stream_emit(self);
 }
 
-void fancy_string_array_reverse(fancy_string_array_t *const self)
+static void regex_add_match(fancy_string_regex_t *const self, size_t start, size_t end)
 {
-    assert(self != NULL);
-
-    if (self->n <= 1)
+    // NOTE: The arrays' capacity is the smallest power of two that is not less than `n_matches`, such that they
+    // are only re-allocated when it is reached (i.e., a logarithmic number of times).
+    if (self->start_array == NULL)
     {
-        return;
+        self->start_array = my_malloc(sizeof(size_t));
+        self->end_array = my_malloc(sizeof(size_t));
     }
-
-    fancy_string_t *tmp = NULL;
-
-    size_t bound = (self->n % 2) == 0 ? self->n / 2 : (self->n - 1) / 2;
-    for (size_t i = 0; i < bound; i++)
+    else if ((self->n_matches & (self->n_matches - 1)) == 0)
     {
-        tmp = self->array[i];
-        self->array[i] = self->array[self->n - i - 1];
-        self->array[self->n - i - 1] = tmp;
+        self->start_array = my_realloc(self->start_array, sizeof(size_t) * self->n_matches * 2);
+        self->end_array = my_realloc(self->end_array, sizeof(size_t) * self->n_matches * 2);
     }
+    self->start_array[self->n_matches] = start;
+    self->end_array[self->n_matches] = end;
+    self->n_matches += 1;
 }
 
-fancy_string_array_t *fancy_string_array_reversed(fancy_string_array_t const *const self)
+static bool regex_collect_match(fancy_string_pattern_t const *const pattern, size_t start, size_t end, void *context)
 {
-    assert(self != NULL);
-
-    fancy_string_array_t *clone = fancy_string_array_clone(self);
-    fancy_string_array_reverse(clone);
-    return clone;
+    IGNORE_UNUSED(pattern);
+    regex_collector_t *collector = context;
+    fancy_string_regex_t *self = collector->regex;
+    regex_add_match(self, collector->offset + start, collector->offset + end);
+    return self->n_max_matches == -1 || self->n_matches < (size_t)self->n_max_matches;
 }
 
-void fancy_string_array_for_each(fancy_string_array_t *const self, fancy_string_for_each_t fn, void *context)
+static void regex_cache_lock(void)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    for (size_t i = 0; i < self->n; i++)
+    if (pthread_mutex_lock(&regex_cache.mutex) != 0)
     {
-        fn(self->array[i], i, self, context);
+        FAIL_WITH_MESSAGE("Failed to acquire regex cache mutex.");
     }
 }
 
-fancy_string_array_t *fancy_string_array_mapped(fancy_string_array_t const *const self, fancy_string_mapped_t fn, void *context)
+static void regex_cache_unlock(void)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    fancy_string_array_t *array = fancy_string_array_create();
-
-    for (size_t i = 0; i < self->n; i++)
+    if (pthread_mutex_unlock(&regex_cache.mutex) != 0)
     {
-        fancy_string_t *tmp = fn(self->array[i], i, self, context);
-        fancy_string_array_push(array, tmp);
-        fancy_string_destroy(tmp);
+        FAIL_WITH_MESSAGE("Failed to release regex cache mutex.");
     }
-
-    return array;
 }
 
-static bool simple_array_sorter(fancy_string_t const *const string_1, fancy_string_t const *const string_2, void *context)
+static uint64_t regex_cache_hash(char const *const value, size_t n, int flags)
 {
-    IGNORE_UNUSED(context);
-
-    size_t n_1 = fancy_string_size(string_1);
-    size_t n_2 = fancy_string_size(string_2);
-
-    size_t n = n_1 > n_2 ? n_2 : n_1;
-
+    // NOTE: 64-bit FNV-1a, over the flags and then over the pattern's bytes.
+    uint64_t hash = 14695981039346656037ULL ^ (uint64_t)(unsigned)flags;
+    hash *= 1099511628211ULL;
     for (size_t i = 0; i < n; i++)
     {
-        if (string_1->value[i] == string_2->value[i])
+        hash ^= (unsigned char)value[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static regex_cache_entry_t *regex_cache_find(uint64_t hash, char const *const value, size_t n, int flags)
+{
+    if (regex_cache.n_buckets == 0)
+    {
+        return NULL;
+    }
+    regex_cache_entry_t *entry = regex_cache.buckets[hash & (regex_cache.n_buckets - 1)];
+    while (entry != NULL)
+    {
+        fancy_string_t const *pattern = entry->pattern->pattern;
+        if (entry->hash == hash && entry->pattern->flags == flags && equals_memory(pattern->value, pattern->n, value, n))
         {
-            continue;
+            return entry;
         }
+        entry = entry->next_in_bucket;
+    }
+    return NULL;
+}
 
-        bool out = string_1->value[i] < string_2->value[i];
-        return out;
+static void regex_cache_link(regex_cache_entry_t *const entry)
+{
+    entry->previous = NULL;
+    entry->next = regex_cache.first;
+    if (regex_cache.first != NULL)
+    {
+        regex_cache.first->previous = entry;
     }
+    regex_cache.first = entry;
+    if (regex_cache.last == NULL)
+    {
+        regex_cache.last = entry;
+    }
+}
 
-    if (n_1 == n_2)
+static void regex_cache_unlink(regex_cache_entry_t *const entry)
+{
+    if (entry->previous != NULL)
     {
-        return true;
+        entry->previous->next = entry->next;
     }
-    else if (n_2 < n_1)
+    else
     {
-        return false;
+        regex_cache.first = entry->next;
+    }
+    if (entry->next != NULL)
+    {
+        entry->next->previous = entry->previous;
     }
     else
     {
-        return true;
+        regex_cache.last = entry->previous;
     }
 }
 
-void fancy_string_array_sort(fancy_string_array_t *const self, fancy_string_sort_t fn, void *context)
+static void regex_cache_resize(size_t n_buckets)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    if (self->n <= 1)
+    if (n_buckets == regex_cache.n_buckets)
     {
         return;
     }
-
-    fancy_string_t *tmp = NULL;
-
-    while (true)
+    if (regex_cache.buckets != NULL)
     {
-        for (size_t i = 0; i < self->n; i++)
-        {
-            for (size_t j = self->n - 1; j > i; j--)
-            {
-                if (!fn(self->array[i], self->array[j], context))
-                {
-                    tmp = self->array[i];
-                    self->array[i] = self->array[j];
-                    self->array[j] = tmp;
-                    i -= 1;
-                    break;
-                }
-            }
-        }
-        break;
+        my_free(regex_cache.buckets);
+        regex_cache.buckets = NULL;
     }
-}
-
-fancy_string_array_t *fancy_string_array_sorted(fancy_string_array_t const *const self, fancy_string_sort_t fn, void *context)
-{
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    fancy_string_array_t *clone = fancy_string_array_clone(self);
-    fancy_string_array_sort(clone, fn, context);
-    return clone;
-}
-
-void fancy_string_array_sort_values(fancy_string_array_t *const self)
-{
-    assert(self != NULL);
-
-    fancy_string_array_sort(self, simple_array_sorter, NULL);
-}
-
-fancy_string_array_t *fancy_string_array_sorted_values(fancy_string_array_t const *const self)
-{
-    assert(self != NULL);
-
-    return fancy_string_array_sorted(self, simple_array_sorter, NULL);
-}
-
-void fancy_string_array_filter(fancy_string_array_t *const self, fancy_string_filter_t fn, void *context)
-{
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    if (self->n == 0)
+    regex_cache.n_buckets = n_buckets;
+    if (n_buckets == 0)
     {
         return;
     }
-
-    for (size_t i = self->n; i > 0; i--)
+    regex_cache.buckets = my_malloc(sizeof(regex_cache_entry_t *) * n_buckets);
+    memset(regex_cache.buckets, 0, sizeof(regex_cache_entry_t *) * n_buckets);
+    for (regex_cache_entry_t *entry = regex_cache.first; entry != NULL; entry = entry->next)
     {
-        if (!fn(self->array[i - 1], i, self, context))
-        {
-            fancy_string_array_remove_and_destroy(self, i - 1);
-        }
+        regex_cache_entry_t **bucket = &regex_cache.buckets[entry->hash & (n_buckets - 1)];
+        entry->next_in_bucket = *bucket;
+        *bucket = entry;
     }
 }
 
-fancy_string_array_t *fancy_string_array_filtered(fancy_string_array_t const *const self, fancy_string_filter_t fn, void *context)
+static regex_cache_entry_t *regex_cache_evict(size_t capacity)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    fancy_string_array_t *clone = fancy_string_array_clone(self);
-    fancy_string_array_filter(clone, fn, context);
-    return clone;
+    // NOTE: The evicted entries are returned (as a list linked through `next`), such that they
+    // can be released once the lock is no longer held.
+    regex_cache_entry_t *evicted = NULL;
+    while (regex_cache.size > capacity)
+    {
+        regex_cache_entry_t *entry = regex_cache.last;
+        regex_cache_unlink(entry);
+        regex_cache_entry_t **bucket = &regex_cache.buckets[entry->hash & (regex_cache.n_buckets - 1)];
+        while (*bucket != entry)
+        {
+            bucket = &(*bucket)->next_in_bucket;
+        }
+        *bucket = entry->next_in_bucket;
+        regex_cache.size--;
+        regex_cache.n_evictions++;
+        entry->next = evicted;
+        evicted = entry;
+    }
+    return evicted;
 }
 
-fancy_string_array_t *fancy_string_array_sliced(fancy_string_array_t const *const self, ssize_t start, ssize_t end)
+static void regex_cache_release_entries(regex_cache_entry_t *entry)
 {
-    assert(self != NULL);
-
-    size_t n = fancy_string_array_size(self);
-    size_t index_start = (size_t)(start == -1 ? 0 : start);
-    size_t index_end = end == -1 ? n : (size_t)end;
-
-    fancy_string_array_t *sliced_array = fancy_string_array_create();
-
-    if (
-        index_start >= index_end ||
-        index_start >= n)
+    while (entry != NULL)
     {
-        return sliced_array;
+        regex_cache_entry_t *next = entry->next;
+        pattern_release(entry->pattern);
+        my_free(entry);
+        entry = next;
     }
+}
 
-    if (index_end > n)
+static fancy_string_pattern_t *regex_cache_acquire(fancy_string_t const *const pattern, int flags)
+{
+    uint64_t hash = regex_cache_hash(pattern->value, pattern->n, flags);
+    regex_cache_lock();
+    if (regex_cache.capacity == 0)
     {
-        index_end = n;
+        regex_cache_unlock();
+        return compile_pattern(pattern, flags);
     }
-
-    if (index_start >= index_end) //  NOTE: We check again because `index_end` might have been modified.
+    regex_cache_entry_t *entry = regex_cache_find(hash, pattern->value, pattern->n, flags);
+    if (entry != NULL)
     {
-        return sliced_array;
+        regex_cache.n_hits++;
+        regex_cache_unlink(entry);
+        regex_cache_link(entry);
+        fancy_string_pattern_t *compiled_pattern = pattern_retain(entry->pattern);
+        regex_cache_unlock();
+        return compiled_pattern;
     }
+    regex_cache.n_misses++;
+    regex_cache_unlock();
 
-    for (size_t i = index_start; i < index_end; i++)
+    // NOTE: The pattern is compiled without holding the lock, such that the other threads are not
+    // kept waiting. If two threads miss the same pattern at once, only the first compilation is cached.
+    fancy_string_pattern_t *compiled_pattern = compile_pattern(pattern, flags);
+    if (compiled_pattern == NULL)
     {
-        fancy_string_array_push(sliced_array, self->array[i]);
+        return NULL;
     }
-
-    return sliced_array;
+    regex_cache_entry_t *evicted = NULL;
+    regex_cache_lock();
+    if (regex_cache.capacity != 0 && regex_cache_find(hash, pattern->value, pattern->n, flags) == NULL)
+    {
+        entry = my_malloc(sizeof(regex_cache_entry_t));
+        entry->pattern = pattern_retain(compiled_pattern);
+        entry->hash = hash;
+        regex_cache_link(entry);
+        regex_cache_entry_t **bucket = &regex_cache.buckets[hash & (regex_cache.n_buckets - 1)];
+        entry->next_in_bucket = *bucket;
+        *bucket = entry;
+        regex_cache.size++;
+        evicted = regex_cache_evict(regex_cache.capacity);
+    }
+    regex_cache_unlock();
+    regex_cache_release_entries(evicted);
+    return compiled_pattern;
+}
+
+static int regex_exec(regex_t const *const re, char const *const value, size_t n, regmatch_t *const match)
+{
+    int flags = 0;
+#ifdef REG_STARTEND
+    // NOTE: With `REG_STARTEND`, the end of the string is given by `match->rm_eo`
+    // instead of by its first null character.
+    match->rm_so = 0;
+    match->rm_eo = (regoff_t)n;
+    flags |= REG_STARTEND;
+#else
+    IGNORE_UNUSED(n);
+#endif
+    return regexec(re, value, 1, match, flags);
 }
 
-void fancy_string_array_slice_and_destroy(fancy_string_array_t *const self, ssize_t start, ssize_t end)
+static void read_stream(fancy_string_t *const self, FILE *stream)
 {
-    assert(self != NULL);
+    // NOTE: When the stream is backed by a regular file, we know (from `fstat`) how
+    // many bytes are left to be read, so the whole buffer can be allocated at once.
+    // For other streams (e.g., pipes, sockets, or `fmemopen` streams, for which
+    // `fileno` returns -1), we rely on the buffer's geometric growth instead.
+    int fd = fileno(stream);
+    struct stat info;
+    if (fd != -1 && fstat(fd, &info) == 0 && S_ISREG(info.st_mode))
+    {
+        off_t position = ftello(stream);
+        if (position != -1 && info.st_size > position)
+        {
+            reserve_capacity(self, self->n + (size_t)(info.st_size - position));
+        }
+    }
 
-    fancy_string_array_t *slice = fancy_string_array_sliced(self, start, end);
-    fancy_string_array_clear(self);
-    fancy_string_array_append_and_destroy(self, slice);
+    while (true)
+    {
+        size_t n_available = self->capacity - self->n;
+        if (n_available == 0)
+        {
+            // NOTE: Either the buffer was sized exactly using `fstat` (in which case we
+            // expect `EOF` here), or the stream's size was unknown, so we probe for
+            // one more character before growing the buffer by a whole block.
+            int c = getc(stream);
+            if (c == EOF)
+            {
+                break;
+            }
+            reserve_capacity(self, self->n + FANCY_STRING_STREAM_BLOCK_SIZE);
+            self->value[self->n] = (char)c;
+            self->n += 1;
+            n_available = self->capacity - self->n;
+        }
+        size_t n_read = fread(&self->value[self->n], sizeof(char), n_available, stream);
+        self->n += n_read;
+        if (n_read < n_available)
+        {
+            // NOTE: `fread` only returns less than requested on `EOF` or on error.
+            break;
+        }
+    }
+    self->value[self->n] = '\0';
 }
 
-fancy_string_array_t *fancy_string_array_splice(fancy_string_array_t *const self, size_t index, ssize_t delete_count, fancy_string_array_t const *const optional_new_strings)
+static void line_reader_fill(fancy_string_line_reader_t *const self)
 {
-    assert(self != NULL);
-
-    size_t n = fancy_string_array_size(self);
-    size_t positive_delete_count = delete_count == -1 ? n - index : (size_t)delete_count;
-
-    fancy_string_array_t *removed_strings = fancy_string_array_create();
-
-    for (size_t i = index; (i < index + positive_delete_count) && (i < n); i++)
+    if (self->start > 0)
     {
-        fancy_string_t *tmp = fancy_string_array_remove(self, index);
-        fancy_string_array_push(removed_strings, tmp);
-        fancy_string_destroy(tmp);
+        // NOTE: The lines that were already returned are discarded, such that the
+        // current (partial) line is moved to the beginning of the buffer.
+        size_t n_pending = self->end - self->start;
+        memmove(self->buffer, &self->buffer[self->start], n_pending);
+        self->scanned -= self->start;
+        self->end = n_pending;
+        self->start = 0;
     }
-
-    if (optional_new_strings != NULL)
+    else if (self->end == self->capacity)
     {
-        for (size_t i = 0; i < optional_new_strings->n; i++)
+        // NOTE: The current line does not fit inside the buffer.
+        self->capacity *= 2;
+        self->buffer = my_realloc(self->buffer, sizeof(char) * (self->capacity + 1));
+    }
+    size_t n_read = 0;
+    if (self->is_interactive)
+    {
+        // NOTE: `fread` would wait until the whole block has been filled, which never happens
+        // for a pipe (or a terminal) whose writer waits for a line to be processed. Reading
+        // bytes up to the next line break only waits for the data the caller needs.
+        char *const free_space = &self->buffer[self->end];
+        size_t n_free = self->capacity - self->end;
+        flockfile(self->stream);
+        int c;
+        while (n_read < n_free && (c = getc_unlocked(self->stream)) != EOF)
         {
-            fancy_string_array_insert(self, optional_new_strings->array[i], index + i);
+            free_space[n_read++] = (char)c;
+            if (c == '\n')
+            {
+                break;
+            }
         }
+        funlockfile(self->stream);
+    }
+    else
+    {
+        n_read = fread(&self->buffer[self->end], sizeof(char), self->capacity - self->end, self->stream);
+    }
+    self->end += n_read;
+    if (n_read == 0)
+    {
+        self->eof = true;
     }
-
-    return removed_strings;
 }
 
-void fancy_string_array_splice_and_destroy(fancy_string_array_t *const self, size_t index, ssize_t delete_count, fancy_string_array_t const *const optional_new_strings)
+static size_t searcher_hash(char const *const pair_end)
 {
-    assert(self != NULL);
-
-    fancy_string_array_t *removed_strings = fancy_string_array_splice(self, index, delete_count, optional_new_strings);
-    fancy_string_array_destroy(removed_strings);
+    // NOTE: Hashes the byte at `pair_end` along with the one right before it.
+    return (((size_t)(unsigned char)pair_end[-1] << 3) ^ (size_t)(unsigned char)pair_end[0]) & UCHAR_MAX;
 }
 
-fancy_string_array_t *fancy_string_array_spliced(fancy_string_array_t const *const self, size_t index, ssize_t delete_count, fancy_string_array_t const *const optional_new_strings)
+static void searcher_init(fancy_string_searcher_t *const self, char const *const needle, size_t n)
 {
-    assert(self != NULL);
-
-    fancy_string_array_t *clone = fancy_string_array_clone(self);
-    fancy_string_array_splice_and_destroy(clone, index, delete_count, optional_new_strings);
-    return clone;
+    self->needle = needle;
+    self->n = n;
+    if (n < FANCY_STRING_SEARCHER_MINIMUM_SKIP_SIZE)
+    {
+        // NOTE: Short needles do not use the tables (see `searcher_find`), which
+        // keeps the internal (per-call) searchers cheap to set up.
+        return;
+    }
+    for (size_t c = 0; c <= UCHAR_MAX; c++)
+    {
+        self->pair_position[c] = 0;
+        self->reverse_shift[c] = n;
+    }
+    // NOTE: Later (resp. earlier) occurrences overwrite the previous ones, which
+    // gives the smallest safe shift for each pair (resp. byte).
+    for (size_t i = 1; i + 1 < n; i++)
+    {
+        self->pair_position[searcher_hash(&needle[i])] = i;
+    }
+    size_t last_pair = searcher_hash(&needle[n - 1]);
+    self->last_pair_shift = n - 1 - self->pair_position[last_pair];
+    self->pair_position[last_pair] = n - 1;
+    for (size_t i = n; i > 1; i--)
+    {
+        self->reverse_shift[(unsigned char)needle[i - 1]] = i - 1;
+    }
 }
 
-ssize_t fancy_string_array_find_index(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+static ssize_t searcher_find(fancy_string_searcher_t const *const self, char const *const haystack, size_t n, size_t offset)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    for (size_t i = 0; i < self->n; i++)
+    size_t n_needle = self->n;
+    if (n_needle == 0 || offset > n || n_needle > n - offset)
     {
-        if (fn(self->array[i], i, self, context))
+        return -1;
+    }
+    if (n_needle < FANCY_STRING_SEARCHER_MINIMUM_SKIP_SIZE)
+    {
+        // NOTE: For short needles, the skips are too small to beat the search
+        // kernels used by `index_of_memory` (e.g., `memchr` or SIMD ones).
+        ssize_t index = index_of_memory(&haystack[offset], n - offset, self->needle, n_needle);
+        return index == -1 ? -1 : (ssize_t)offset + index;
+    }
+    size_t last = n_needle - 1;
+    size_t last_start = n - n_needle;
+    size_t i = offset;
+    while (i <= last_start)
+    {
+        // NOTE: Most windows end with a pair that does not appear in the needle. Those
+        // are skipped by a loop whose next position does not depend on the table lookup,
+        // such that the lookups do not need to wait on one another.
+        size_t position = self->pair_position[searcher_hash(&haystack[i + last])];
+        while (position == 0)
         {
-            return i;
+            i += last;
+            if (i > last_start)
+            {
+                return -1;
+            }
+            position = self->pair_position[searcher_hash(&haystack[i + last])];
+        }
+        // NOTE: Aligns the needle's pair at `position` with the window's last pair.
+        i += last - position;
+        if (position < last)
+        {
+            continue;
+        }
+        // NOTE: Different pairs can have the same hash, so the whole window is compared.
+        if (memcmp(&haystack[i], self->needle, n_needle) == 0)
+        {
+            return (ssize_t)i;
         }
+        i += self->last_pair_shift;
     }
     return -1;
 }
 
-fancy_string_t *fancy_string_array_find(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+static ssize_t searcher_find_last(fancy_string_searcher_t const *const self, char const *const haystack, size_t n)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    ssize_t index = fancy_string_array_find_index(self, fn, context);
-    if (index == -1)
+    size_t n_needle = self->n;
+    if (n_needle == 0 || n_needle > n)
     {
-        return NULL;
+        return -1;
     }
-    return fancy_string_array_get(self, (size_t)index);
-}
-
-ssize_t fancy_string_array_find_last_index(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
-{
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    for (size_t i = self->n; i > 0; i--)
+    if (n_needle < FANCY_STRING_SEARCHER_MINIMUM_SKIP_SIZE)
     {
-        size_t index = i - 1;
-        if (fn(self->array[index], index, self, context))
+        return last_index_of_memory(haystack, n, self->needle, n_needle);
+    }
+    unsigned char first_byte = (unsigned char)self->needle[0];
+    size_t i = n - n_needle;
+    while (true)
+    {
+        unsigned char c = (unsigned char)haystack[i];
+        if (c == first_byte && memcmp(&haystack[i + 1], &self->needle[1], n_needle - 1) == 0)
         {
-            return index;
+            return (ssize_t)i;
+        }
+        size_t shift = self->reverse_shift[c];
+        if (shift > i)
+        {
+            return -1;
         }
+        i -= shift;
     }
-    return -1;
 }
 
-fancy_string_t *fancy_string_array_find_last(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+static void multi_matcher_build(fancy_string_multi_matcher_t *const self)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
+    size_t n_total = self->offsets[self->n_needles];
+    bool is_present[UCHAR_MAX + 1] = {false};
+    size_t n_present = 0;
+    for (size_t i = 0; i < n_total; i++)
+    {
+        unsigned char c = (unsigned char)self->needles[i];
+        if (!is_present[c])
+        {
+            is_present[c] = true;
+            n_present++;
+        }
+    }
+    // NOTE: Class `0` is for the bytes that appear in no needle, unless there is no such byte.
+    size_t n_classes = n_present == UCHAR_MAX + 1 ? 0 : 1;
+    for (size_t c = 0; c <= UCHAR_MAX; c++)
+    {
+        self->classes[c] = is_present[c] ? (uint8_t)n_classes++ : 0;
+    }
+    self->n_classes = n_classes;
 
-    ssize_t index = fancy_string_array_find_last_index(self, fn, context);
-    if (index == -1)
+    // NOTE: The trie cannot have more states than the needles have bytes (plus the root).
+    size_t n_max_states = n_total + 1;
+    if (n_max_states > FANCY_STRING_MULTI_MATCHER_OUTPUT / n_classes)
     {
-        return NULL;
+        FAIL_WITH_MESSAGE("The needles are too large for a multi matcher object.");
     }
-    return fancy_string_array_get(self, (size_t)index);
-}
+    uint32_t *transitions = my_malloc(sizeof(uint32_t) * n_max_states * n_classes);
+    memset(transitions, 0, sizeof(uint32_t) * n_max_states * n_classes);
+    multi_matcher_state_t *states = my_malloc(sizeof(multi_matcher_state_t) * n_max_states);
+    states[0] = (multi_matcher_state_t){.fail = 0, .depth = 0, .needle = FANCY_STRING_MULTI_MATCHER_NONE, .output = FANCY_STRING_MULTI_MATCHER_NONE};
+    size_t n_states = 1;
 
-bool fancy_string_array_some(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
-{
-    assert(self != NULL);
-    assert(fn != NULL);
+    // NOTE: First, the needles are inserted into the trie, whose edges are the only non-zero
+    // entries of the table at this point (the root is never the target of an edge).
+    for (size_t i = 0; i < self->n_needles; i++)
+    {
+        uint32_t row = 0;
+        for (size_t j = self->offsets[i]; j < self->offsets[i + 1]; j++)
+        {
+            uint32_t *entry = &transitions[row + self->classes[(unsigned char)self->needles[j]]];
+            if (*entry == 0)
+            {
+                states[n_states] = (multi_matcher_state_t){
+                    .fail = 0,
+                    .depth = states[row / n_classes].depth + 1,
+                    .needle = FANCY_STRING_MULTI_MATCHER_NONE,
+                    .output = FANCY_STRING_MULTI_MATCHER_NONE,
+                };
+                *entry = (uint32_t)(n_states * n_classes);
+                n_states++;
+            }
+            row = *entry;
+        }
+        // NOTE: Empty needles (which would end at the root) never match.
+        if (row != 0 && states[row / n_classes].needle == FANCY_STRING_MULTI_MATCHER_NONE)
+        {
+            states[row / n_classes].needle = (uint32_t)i;
+        }
+    }
 
-    return fancy_string_array_find_index(self, fn, context) != -1;
-}
+    // NOTE: Then, the states are visited in breadth-first order, such that a state's failure
+    // target (which is shallower) always has its row completed before the state itself. When
+    // a row is visited, its non-zero entries are still the trie's edges, and the missing
+    // entries are copied from the row of the state's failure target.
+    uint32_t *queue = my_malloc(sizeof(uint32_t) * n_states);
+    size_t n_queued = 1;
+    queue[0] = 0;
+    for (size_t head = 0; head < n_queued; head++)
+    {
+        uint32_t state = queue[head];
+        multi_matcher_state_t *current = &states[state];
+        if (current->needle != FANCY_STRING_MULTI_MATCHER_NONE)
+        {
+            current->output = state;
+        }
+        else if (state != 0)
+        {
+            current->output = states[current->fail].output;
+        }
+        uint32_t *row = &transitions[state * n_classes];
+        uint32_t const *fail_row = &transitions[current->fail * n_classes];
+        for (size_t c = 0; c < n_classes; c++)
+        {
+            if (row[c] != 0)
+            {
+                uint32_t child = row[c] / (uint32_t)n_classes;
+                states[child].fail = state == 0 ? 0 : fail_row[c] / (uint32_t)n_classes;
+                queue[n_queued++] = child;
+            }
+            else
+            {
+                row[c] = state == 0 ? 0 : fail_row[c];
+            }
+        }
+    }
+    my_free(queue);
 
-bool fancy_string_array_none(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
-{
-    assert(self != NULL);
-    assert(fn != NULL);
+    for (size_t i = 0; i < n_states * n_classes; i++)
+    {
+        if (states[transitions[i] / n_classes].output != FANCY_STRING_MULTI_MATCHER_NONE)
+        {
+            transitions[i] |= FANCY_STRING_MULTI_MATCHER_OUTPUT;
+        }
+    }
 
-    return !fancy_string_array_some(self, fn, context);
+    self->transitions = my_realloc(transitions, sizeof(uint32_t) * n_states * n_classes);
+    self->states = my_realloc(states, sizeof(multi_matcher_state_t) * n_states);
+    self->n_states = n_states;
 }
 
-bool fancy_string_array_every(fancy_string_array_t const *const self, fancy_string_find_t fn, void *context)
+static bool multi_matcher_scan(fancy_string_multi_matcher_t const *const self, char const *const haystack, size_t n, size_t offset, uint32_t *const row, fancy_string_multi_match_t fn, void *context, size_t *const count)
 {
-    assert(self != NULL);
-    assert(fn != NULL);
-
-    for (size_t i = 0; i < self->n; i++)
+    uint32_t current = *row;
+    for (size_t i = 0; i < n; i++)
     {
-        if (!fn(self->array[i], i, self, context))
+        uint32_t next = self->transitions[current + self->classes[(unsigned char)haystack[i]]];
+        current = next & ~FANCY_STRING_MULTI_MATCHER_OUTPUT;
+        if ((next & FANCY_STRING_MULTI_MATCHER_OUTPUT) == 0)
         {
-            return false;
+            continue;
+        }
+        size_t end = offset + i + 1;
+        uint32_t state = self->states[current / self->n_classes].output;
+        while (state != FANCY_STRING_MULTI_MATCHER_NONE)
+        {
+            multi_matcher_state_t const *match = &self->states[state];
+            *count += 1;
+            if (fn != NULL && !fn(self, match->needle, end - match->depth, end, context))
+            {
+                *row = current;
+                return false;
+            }
+            state = self->states[match->fail].output;
         }
     }
+    *row = current;
     return true;
 }
 
-ssize_t fancy_string_array_index_of(fancy_string_array_t const *const self, fancy_string_t const *const string)
+static size_t multi_replace_memory(fancy_string_multi_matcher_t const *const self, char const *const value, size_t n, fancy_string_array_t const *const replacements, char *const output, size_t *const n_replaced)
 {
-    assert(self != NULL);
-    assert(string != NULL);
-
-    for (size_t i = 0; i < self->n; i++)
-    {
-        if (fancy_string_equals(self->array[i], string))
+    // NOTE: Matches are selected from left to right and, among the needles that match at the same
+    // position, the longest one wins. The automaton reports matches by their end, so the best match
+    // found so far is kept until the current state is too shallow for any upcoming match to start
+    // at or before it. Scanning then resumes right after it, from the root.
+    size_t n_output = 0;
+    size_t n_copied = 0;
+    size_t i = 0;
+    uint32_t row = 0;
+    bool has_match = false;
+    size_t match_start = 0;
+    size_t match_end = 0;
+    uint32_t match_needle = 0;
+    *n_replaced = 0;
+    while (i < n || has_match)
+    {
+        if (i < n)
         {
-            return i;
+            uint32_t next = self->transitions[row + self->classes[(unsigned char)value[i]]];
+            row = next & ~FANCY_STRING_MULTI_MATCHER_OUTPUT;
+            i++;
+            if ((next & FANCY_STRING_MULTI_MATCHER_OUTPUT) != 0)
+            {
+                // NOTE: The output state is the longest needle ending here, i.e., the one that starts first.
+                multi_matcher_state_t const *match = &self->states[self->states[row / self->n_classes].output];
+                size_t start = i - match->depth;
+                if (!has_match || start <= match_start)
+                {
+                    has_match = true;
+                    match_start = start;
+                    match_end = i;
+                    match_needle = match->needle;
+                }
+            }
+            if (!has_match || match_start >= i - self->states[row / self->n_classes].depth)
+            {
+                continue;
+            }
+        }
+        fancy_string_t const *replacement = replacements->array[replacements->n == 1 ? 0 : match_needle];
+        if (output != NULL)
+        {
+            memcpy(&output[n_output], &value[n_copied], match_start - n_copied);
+            memcpy(&output[n_output + match_start - n_copied], replacement->value, replacement->n);
         }
+        n_output += match_start - n_copied + replacement->n;
+        *n_replaced += 1;
+        n_copied = match_end;
+        i = match_end;
+        row = 0;
+        has_match = false;
     }
-    return -1;
+    if (output != NULL)
+    {
+        memcpy(&output[n_output], &value[n_copied], n - n_copied);
+    }
+    return n_output + n - n_copied;
 }
 
-ssize_t fancy_string_array_index_of_value(fancy_string_array_t const *const self, char const *const value)
-{
-    assert(self != NULL);
-    assert(value != NULL);
 
-    for (size_t i = 0; i < self->n; i++)
+static bool is_whitespace(char const *c)
+{
+    // NOTE: The same bytes as `isspace` in the "C" locale, but without the locale lookup.
+    switch (*c)
     {
-        if (fancy_string_equals_value(self->array[i], value))
-        {
-            return i;
-        }
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\v':
+    case '\f':
+    case '\r':
+        return true;
+    default:
+        return false;
     }
-    return -1;
 }
 
-ssize_t fancy_string_array_last_index_of(fancy_string_array_t const *const self, fancy_string_t const *const string)
+static void whitespace_bounds(fancy_string_t const *const self, bool trim_left, bool trim_right, size_t *const start, size_t *const end)
 {
-    assert(self != NULL);
-    assert(string != NULL);
-
-    for (size_t i = self->n; i > 0; i--)
+    *start = 0;
+    *end = self->n;
+    while (trim_left && *start < *end && is_whitespace(&self->value[*start]))
     {
-        size_t index = i - 1;
-        if (fancy_string_equals(self->array[index], string))
-        {
-            return index;
-        }
+        (*start)++;
+    }
+    while (trim_right && *end > *start && is_whitespace(&self->value[*end - 1]))
+    {
+        (*end)--;
     }
-    return -1;
 }
 
-ssize_t fancy_string_array_last_index_of_value(fancy_string_array_t const *const self, char const *const value)
+static void keep_range(fancy_string_t *const self, size_t start, size_t end)
 {
-    assert(self != NULL);
-    assert(value != NULL);
-
-    for (size_t i = self->n; i > 0; i--)
+    if (start == 0 && end == self->n)
     {
-        size_t index = i - 1;
-        if (fancy_string_equals_value(self->array[index], value))
-        {
-            return index;
-        }
+        return;
     }
-    return -1;
+    if (start == 0 && self->storage == NULL)
+    {
+        self->value[end] = '\0';
+        self->n = end;
+        return;
+    }
+    // NOTE: The value is moved in place (unless it is shared, in which case it gets copied).
+    update_memory(self, &self->value[start], end - start);
 }
 
-bool fancy_string_array_includes(fancy_string_array_t const *const self, fancy_string_t const *const string)
+static void pad_memory(fancy_string_t *const self, size_t target_size, char value, bool at_start)
 {
-    assert(self != NULL);
-    assert(string != NULL);
-
-    return fancy_string_array_index_of(self, string) != -1;
+    size_t n = self->n;
+    if (n >= target_size)
+    {
+        return;
+    }
+    size_t n_padding = target_size - n;
+    reserve_capacity(self, target_size);
+    if (at_start)
+    {
+        memmove(&self->value[n_padding], self->value, n);
+        memset(self->value, value, n_padding);
+    }
+    else
+    {
+        memset(&self->value[n], value, n_padding);
+    }
+    self->value[target_size] = '\0';
+    self->n = target_size;
 }
 
-bool fancy_string_array_includes_value(fancy_string_array_t const *const self, char const *const value)
+static fancy_string_t *padded_memory(fancy_string_t const *const self, size_t target_size, char value, bool at_start)
 {
-    assert(self != NULL);
-    assert(value != NULL);
-
-    return fancy_string_array_index_of_value(self, value) != -1;
+    size_t n = self->n;
+    size_t n_padding = n < target_size ? target_size - n : 0;
+    fancy_string_t *padded = allocate_string(n + n_padding);
+    memset(at_start ? padded->value : &padded->value[n], value, n_padding);
+    memcpy(at_start ? &padded->value[n_padding] : padded->value, self->value, n);
+    padded->value[n + n_padding] = '\0';
+    padded->n = n + n_padding;
+    return padded;
 }
 
-// -----------------------------------------------
-//        PRIVATE HELPERS IMPLEMENTATIONS
-// -----------------------------------------------
-
-static char *copy_value(char const *const value)
+static void to_lower_or_upper_case(fancy_string_t *const self, bool use_lower, bool use_locale)
 {
-    assert(value != NULL);
-
-    char *copied_value;
-
-    size_t n = strlen(value);
+    size_t n = self->n;
     if (n == 0)
     {
-        copied_value = my_malloc(sizeof(char));
-        copied_value[0] = '\0';
+        return;
     }
-    else
+
+    if (self->storage != NULL)
     {
-        copied_value = my_malloc(sizeof(char) * (n + 1));
-        memcpy(copied_value, value, n);
-        copied_value[n] = '\0';
+        // NOTE: The shared (or memory-mapped) value cannot be written to, so the converted
+        // copy is written straight into the string's own buffer (see `update_memory`).
+        bool use_inline_value = n <= self->inline_capacity;
+        char *new_value = use_inline_value ? self->inline_value : my_malloc(sizeof(char) * (n + 1));
+        change_case_memory(new_value, self->value, n, use_lower, use_locale);
+        new_value[n] = '\0';
+        release_value(self);
+        self->value = new_value;
+        self->capacity = use_inline_value ? self->inline_capacity : n;
+        return;
     }
-
-    return copied_value;
+    change_case_memory(self->value, self->value, n, use_lower, use_locale);
 }
 
-static bool is_whitespace(char *c)
+static fancy_string_t *to_lower_or_upper_cased(fancy_string_t const *const self, bool use_lower, bool use_locale)
 {
-    //  NOTE: Start with `isspace` for now, but check [this](https://en.wikipedia.org/wiki/Whitespace_character)
-    //  out if not enough...
-    return isspace((int)*c) != 0;
-    // switch (*c)
-    // {
-    // case 0x20: // space
-    //     return true;
-    // case 0x09: // tab
-    //     return true;
-    // case 0x0a: // new line
-    //     return true;
-    // case 0x0d: // ...
-    //     return true;
-    // default:
-    //     return false;
-    // }
+    fancy_string_t *cased = allocate_string(self->n);
+    change_case_memory(cased->value, self->value, self->n, use_lower, use_locale);
+    cased->value[self->n] = '\0';
+    cased->n = self->n;
+    return cased;
 }
 
-static void to_lower_or_upper_case(fancy_string_t *const self, bool use_lower)
+static void change_case_memory(char *const output, char const *const value, size_t n, bool use_lower, bool use_locale)
 {
-    size_t n = fancy_string_size(self);
-    if (n == 0)
+    // NOTE: `output` is either `value` itself (in place) or a distinct buffer of at least `n` bytes.
+    if (use_locale)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            unsigned char c = (unsigned char)value[i];
+            output[i] = (char)(use_lower ? tolower(c) : toupper(c));
+        }
+        return;
+    }
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+    if (n >= 32 && __builtin_cpu_supports("avx2"))
+    {
+        change_case_memory_avx2(output, value, n, use_lower);
+        return;
+    }
+    if (n >= 16)
     {
+        change_case_memory_sse2(output, value, n, use_lower);
         return;
     }
+#endif
+    change_case_memory_scalar(output, value, n, use_lower);
+}
 
-    char *new_value = my_malloc(sizeof(char) * (n + 1));
+static void change_case_memory_scalar(char *const output, char const *const value, size_t n, bool use_lower)
+{
+    unsigned char first = use_lower ? 'A' : 'a';
     for (size_t i = 0; i < n; i++)
     {
-        if (use_lower)
-        {
-            new_value[i] = tolower(self->value[i]);
-        }
-        else
-        {
-            new_value[i] = toupper(self->value[i]);
-        }
+        // NOTE: ASCII letters only differ by the 0x20 bit between cases, and the unsigned
+        // subtraction rejects every byte outside of the range with a single comparison.
+        unsigned char c = (unsigned char)value[i];
+        output[i] = (char)((unsigned char)(c - first) < 26 ? c ^ 0x20 : c);
+    }
+}
+
+#if (FANCY_STRING_SIMD_X86_64 == 1)
+// NOTE: The case conversion kernels compare whole blocks against the letter range as
+// signed bytes, which leaves the non-ASCII bytes (i.e., the negative ones) untouched.
+
+static void change_case_memory_sse2(char *const output, char const *const value, size_t n, bool use_lower)
+{
+    __m128i before_first = _mm_set1_epi8(use_lower ? 'A' - 1 : 'a' - 1);
+    __m128i after_last = _mm_set1_epi8(use_lower ? 'Z' + 1 : 'z' + 1);
+    __m128i case_bit = _mm_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i block = _mm_loadu_si128((__m128i const *)(value + i));
+        __m128i is_letter = _mm_and_si128(_mm_cmpgt_epi8(block, before_first), _mm_cmpgt_epi8(after_last, block));
+        _mm_storeu_si128((__m128i *)(output + i), _mm_xor_si128(block, _mm_and_si128(is_letter, case_bit)));
+    }
+    change_case_memory_scalar(output + i, value + i, n - i, use_lower);
+}
+
+__attribute__((target("avx2"))) static void change_case_memory_avx2(char *const output, char const *const value, size_t n, bool use_lower)
+{
+    __m256i before_first = _mm256_set1_epi8(use_lower ? 'A' - 1 : 'a' - 1);
+    __m256i after_last = _mm256_set1_epi8(use_lower ? 'Z' + 1 : 'z' + 1);
+    __m256i case_bit = _mm256_set1_epi8(0x20);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i block = _mm256_loadu_si256((__m256i const *)(value + i));
+        __m256i is_letter = _mm256_and_si256(_mm256_cmpgt_epi8(block, before_first), _mm256_cmpgt_epi8(after_last, block));
+        _mm256_storeu_si256((__m256i *)(output + i), _mm256_xor_si256(block, _mm256_and_si256(is_letter, case_bit)));
     }
-    new_value[n] = '\0';
-    fancy_string_update_value(self, new_value);
-    my_free(new_value);
+    change_case_memory_sse2(output + i, value + i, n - i, use_lower);
 }
+#endif
 
 #if (FANCY_STRING_MEMORY_USAGE_FEATURE_ENABLED == 1)
 // Note about the difference between `_Thread_local` and `__thread`:
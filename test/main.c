@@ -25,8 +25,11 @@
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <ctype.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <errno.h>
+#include <time.h>
 
 #include "fancy_string.h"
 
@@ -50,6 +53,106 @@
 #define LOG() (void)0
 #endif
 
+void test_fancy_string_pattern_find_all_in_fd(void);
+void test_fancy_string_pattern_find_all_in_stream(void);
+void test_fancy_string_pattern_find_all(void);
+void test_fancy_string_pattern_engine(void);
+void test_fancy_string_pattern_create_with_engine(void);
+void test_fancy_string_regex_prefilter_stats(void);
+void test_fancy_string_pattern_prefilter_stats(void);
+void test_fancy_string_pattern_prefilter_literal(void);
+void test_fancy_string_pattern_prefilter_kind(void);
+void test_fancy_string_regex_cache_clear(void);
+void test_fancy_string_regex_cache_stats(void);
+void test_fancy_string_regex_cache_set_capacity(void);
+void test_fancy_string_pattern_has_match(void);
+void test_fancy_string_pattern_find(void);
+void test_fancy_string_regex_create_with_pattern(void);
+void test_fancy_string_pattern_destroy(void);
+void test_fancy_string_pattern_create(void);
+void test_fancy_string_uppercased_locale(void);
+void test_fancy_string_uppercase_locale(void);
+void test_fancy_string_lowercased_locale(void);
+void test_fancy_string_lowercase_locale(void);
+void test_fancy_string_trimmed_chars(void);
+void test_fancy_string_trim_chars_n(void);
+void test_fancy_string_trim_chars(void);
+void test_fancy_string_split_by_any_n(void);
+void test_fancy_string_split_by_any(void);
+void test_fancy_string_split_arena(void);
+void test_fancy_string_split_iter_by_pattern(void);
+void test_fancy_string_split_iter_next(void);
+void test_fancy_string_split_iter(void);
+void test_fancy_string_multi_replaced(void);
+void test_fancy_string_multi_replace(void);
+void test_fancy_string_multi_matcher_find_all_in_stream(void);
+void test_fancy_string_multi_matcher_find_all(void);
+void test_fancy_string_multi_matcher_needle(void);
+void test_fancy_string_multi_matcher_size(void);
+void test_fancy_string_multi_matcher_destroy(void);
+void test_fancy_string_multi_matcher_create(void);
+void test_fancy_string_last_index_of(void);
+void test_fancy_string_last_index_of_view(void);
+void test_fancy_string_last_index_of_value_n(void);
+void test_fancy_string_last_index_of_value(void);
+void test_fancy_string_searcher_count(void);
+void test_fancy_string_searcher_find_last(void);
+void test_fancy_string_searcher_find_from(void);
+void test_fancy_string_searcher_find(void);
+void test_fancy_string_searcher_needle(void);
+void test_fancy_string_searcher_destroy(void);
+void test_fancy_string_searcher_create(void);
+void test_fancy_string_array_is_shared(void);
+void test_fancy_string_array_share(void);
+void test_fancy_string_is_shared(void);
+void test_fancy_string_share(void);
+void test_fancy_string_line_reader_next_view(void);
+void test_fancy_string_contains_view(void);
+void test_fancy_string_index_of_view(void);
+void test_fancy_string_ends_with_view(void);
+void test_fancy_string_starts_with_view(void);
+void test_fancy_string_equals_view(void);
+void test_fancy_string_view_index_of(void);
+void test_fancy_string_view_ends_with(void);
+void test_fancy_string_view_starts_with(void);
+void test_fancy_string_view_equals(void);
+void test_fancy_string_trimmed_view(void);
+void test_fancy_string_view_trimmed(void);
+void test_fancy_string_view_substring(void);
+void test_fancy_string_from_view(void);
+void test_fancy_string_view_from_memory(void);
+void test_fancy_string_view_from_value(void);
+void test_fancy_string_view(void);
+void test_fancy_string_array_includes_value_n(void);
+void test_fancy_string_array_last_index_of_value_n(void);
+void test_fancy_string_array_index_of_value_n(void);
+void test_fancy_string_array_join_by_value_n(void);
+void test_fancy_string_array_insert_value_n(void);
+void test_fancy_string_array_push_value_n(void);
+void test_fancy_string_replaced_value_n(void);
+void test_fancy_string_replace_value_n(void);
+void test_fancy_string_split_by_value_n(void);
+void test_fancy_string_contains_value_n(void);
+void test_fancy_string_index_of_value_n(void);
+void test_fancy_string_ends_with_value_n(void);
+void test_fancy_string_starts_with_value_n(void);
+void test_fancy_string_equals_value_n(void);
+void test_fancy_string_prepend_value_n(void);
+void test_fancy_string_append_value_n(void);
+void test_fancy_string_update_value_n(void);
+void test_fancy_string_line_reader_offset(void);
+void test_fancy_string_line_reader_line_number(void);
+void test_fancy_string_line_reader_next_borrowed(void);
+void test_fancy_string_line_reader_next(void);
+void test_fancy_string_line_reader_destroy(void);
+void test_fancy_string_line_reader_create(void);
+void test_fancy_string_is_mapped(void);
+void test_fancy_string_from_fd_mapped(void);
+void test_fancy_string_from_file_mapped(void);
+void test_fancy_string_from_stream_without_closing(void);
+void test_fancy_string_shrink_to_fit(void);
+void test_fancy_string_reserve(void);
+void test_fancy_string_capacity(void);
 void test_fancy_string_from_copied_memory(void);
 void test_fancy_string_regex_string_for_match_at_index(void);
 void test_fancy_string_line_break(void);
@@ -302,6 +405,106 @@ void run_tests(void)
     test_fancy_string_line_break();
     test_fancy_string_regex_string_for_match_at_index();
     test_fancy_string_from_copied_memory();
+    test_fancy_string_capacity();
+    test_fancy_string_reserve();
+    test_fancy_string_shrink_to_fit();
+    test_fancy_string_from_stream_without_closing();
+    test_fancy_string_from_file_mapped();
+    test_fancy_string_from_fd_mapped();
+    test_fancy_string_is_mapped();
+    test_fancy_string_line_reader_create();
+    test_fancy_string_line_reader_destroy();
+    test_fancy_string_line_reader_next();
+    test_fancy_string_line_reader_next_borrowed();
+    test_fancy_string_line_reader_line_number();
+    test_fancy_string_line_reader_offset();
+    test_fancy_string_update_value_n();
+    test_fancy_string_append_value_n();
+    test_fancy_string_prepend_value_n();
+    test_fancy_string_equals_value_n();
+    test_fancy_string_starts_with_value_n();
+    test_fancy_string_ends_with_value_n();
+    test_fancy_string_index_of_value_n();
+    test_fancy_string_contains_value_n();
+    test_fancy_string_split_by_value_n();
+    test_fancy_string_replace_value_n();
+    test_fancy_string_replaced_value_n();
+    test_fancy_string_array_push_value_n();
+    test_fancy_string_array_insert_value_n();
+    test_fancy_string_array_join_by_value_n();
+    test_fancy_string_array_index_of_value_n();
+    test_fancy_string_array_last_index_of_value_n();
+    test_fancy_string_array_includes_value_n();
+    test_fancy_string_view();
+    test_fancy_string_view_from_value();
+    test_fancy_string_view_from_memory();
+    test_fancy_string_from_view();
+    test_fancy_string_view_substring();
+    test_fancy_string_view_trimmed();
+    test_fancy_string_trimmed_view();
+    test_fancy_string_view_equals();
+    test_fancy_string_view_starts_with();
+    test_fancy_string_view_ends_with();
+    test_fancy_string_view_index_of();
+    test_fancy_string_equals_view();
+    test_fancy_string_starts_with_view();
+    test_fancy_string_ends_with_view();
+    test_fancy_string_index_of_view();
+    test_fancy_string_contains_view();
+    test_fancy_string_line_reader_next_view();
+    test_fancy_string_share();
+    test_fancy_string_is_shared();
+    test_fancy_string_array_share();
+    test_fancy_string_array_is_shared();
+    test_fancy_string_searcher_create();
+    test_fancy_string_searcher_destroy();
+    test_fancy_string_searcher_needle();
+    test_fancy_string_searcher_find();
+    test_fancy_string_searcher_find_from();
+    test_fancy_string_searcher_find_last();
+    test_fancy_string_searcher_count();
+    test_fancy_string_last_index_of_value();
+    test_fancy_string_last_index_of_value_n();
+    test_fancy_string_last_index_of_view();
+    test_fancy_string_last_index_of();
+    test_fancy_string_multi_matcher_create();
+    test_fancy_string_multi_matcher_destroy();
+    test_fancy_string_multi_matcher_size();
+    test_fancy_string_multi_matcher_needle();
+    test_fancy_string_multi_matcher_find_all();
+    test_fancy_string_multi_matcher_find_all_in_stream();
+    test_fancy_string_multi_replace();
+    test_fancy_string_multi_replaced();
+    test_fancy_string_split_iter();
+    test_fancy_string_split_iter_next();
+    test_fancy_string_split_iter_by_pattern();
+    test_fancy_string_split_arena();
+    test_fancy_string_split_by_any();
+    test_fancy_string_split_by_any_n();
+    test_fancy_string_trim_chars();
+    test_fancy_string_trim_chars_n();
+    test_fancy_string_trimmed_chars();
+    test_fancy_string_lowercase_locale();
+    test_fancy_string_lowercased_locale();
+    test_fancy_string_uppercase_locale();
+    test_fancy_string_uppercased_locale();
+    test_fancy_string_pattern_create();
+    test_fancy_string_pattern_destroy();
+    test_fancy_string_regex_create_with_pattern();
+    test_fancy_string_pattern_find();
+    test_fancy_string_pattern_has_match();
+    test_fancy_string_regex_cache_set_capacity();
+    test_fancy_string_regex_cache_stats();
+    test_fancy_string_regex_cache_clear();
+    test_fancy_string_pattern_prefilter_kind();
+    test_fancy_string_pattern_prefilter_literal();
+    test_fancy_string_pattern_prefilter_stats();
+    test_fancy_string_regex_prefilter_stats();
+    test_fancy_string_pattern_create_with_engine();
+    test_fancy_string_pattern_engine();
+    test_fancy_string_pattern_find_all();
+    test_fancy_string_pattern_find_all_in_stream();
+    test_fancy_string_pattern_find_all_in_fd();
 }
 
 int main(void)
@@ -338,6 +541,3091 @@ int main(void)
     return 0;
 }
 
+typedef struct test_fancy_string_pattern_record_s
+{
+    size_t n;
+    size_t n_max;
+    size_t start[16];
+    size_t end[16];
+} test_fancy_string_pattern_record_t;
+
+static bool test_fancy_string_pattern_find_all_callback(fancy_string_pattern_t const *const pattern, size_t start, size_t end, void *context)
+{
+    test_fancy_string_pattern_record_t *record = context;
+    assert(pattern != NULL && start < end);
+    record->start[record->n] = start;
+    record->end[record->n] = end;
+    record->n++;
+    return record->n < record->n_max;
+}
+
+static bool test_fancy_string_pattern_memory_usage_callback(fancy_string_pattern_t const *const pattern, size_t start, size_t end, void *context)
+{
+    (void)pattern;
+    (void)start;
+    (void)end;
+    *(size_t *)context = fancy_string_memory_usage_get();
+    return true;
+}
+
+void test_fancy_string_pattern_find_all_in_fd(void)
+{
+    LOG();
+    {
+        fancy_string_t *pattern = fancy_string_create("key=[0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        int fds[2];
+        assert(pipe(fds) == 0);
+        char const *data = "key=1;key=;key=22";
+        assert(write(fds[1], data, strlen(data)) == (ssize_t)strlen(data));
+        close(fds[1]);
+        test_fancy_string_pattern_record_t record = {.n_max = 16};
+        assert(fancy_string_pattern_find_all_in_fd(p, fds[0], test_fancy_string_pattern_find_all_callback, &record) == 2);
+        assert(record.start[0] == 0 && record.end[0] == 5);
+        assert(record.start[1] == 11 && record.end[1] == 17);
+        close(fds[0]);
+
+        // NOTE: `read` fails on an invalid file descriptor.
+        assert(fancy_string_pattern_find_all_in_fd(p, -1, NULL, NULL) == -1);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        fancy_string_t *pattern = fancy_string_create("key=[0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        assert(fancy_string_pattern_find_all_in_fd(p, STDIN_FILENO, NULL, NULL) == -1);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_pattern_find_all_in_stream(void)
+{
+    LOG();
+    {
+        fancy_string_t *pattern = fancy_string_create("error: [0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        // NOTE: The stream is larger than the internal block, such that a match straddles two blocks (and the
+        // last one ends with the stream).
+        size_t n_data = 3 * 65536;
+        char *data = malloc(n_data);
+        memset(data, '.', n_data);
+        memcpy(&data[10], "error: 1", 8);
+        memcpy(&data[65536 - 4], "error: 123", 10);
+        memcpy(&data[n_data - 9], "error: 42", 9);
+        FILE *stream = fmemopen(data, n_data, "r");
+        test_fancy_string_pattern_record_t record = {.n_max = 16};
+        assert(fancy_string_pattern_find_all_in_stream(p, stream, test_fancy_string_pattern_find_all_callback, &record) == 3);
+        assert(record.start[0] == 10 && record.end[0] == 18);
+        assert(record.start[1] == 65536 - 4 && record.end[1] == 65536 + 6);
+        assert(record.start[2] == n_data - 9 && record.end[2] == n_data);
+        fclose(stream);
+        free(data);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: A match may be larger than a block.
+        fancy_string_t *pattern = fancy_string_create("<[^>]*>");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        size_t n_data = 200000;
+        char *data = malloc(n_data);
+        memset(data, '.', n_data);
+        data[10] = '<';
+        data[150010] = '>';
+        data[150020] = '<';
+        FILE *stream = fmemopen(data, n_data, "r");
+        test_fancy_string_pattern_record_t record = {.n_max = 16};
+        assert(fancy_string_pattern_find_all_in_stream(p, stream, test_fancy_string_pattern_find_all_callback, &record) == 1);
+        assert(record.start[0] == 10 && record.end[0] == 150011);
+        fclose(stream);
+        free(data);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: The match of `"ab"` is only known once the longer candidate fails (at the `'\n'`), and the
+        // input that was read meanwhile is not kept in memory, whatever its size.
+        fancy_string_t *pattern = fancy_string_create("ab|a[^c\n]*c");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        size_t memory_usage[2] = {0};
+        size_t const n_x[2] = {2 * 65536, 64 * 65536};
+        for (size_t i = 0; i < 2; i++)
+        {
+            size_t n_data = n_x[i] + 3;
+            char *data = malloc(n_data);
+            memcpy(data, "ab", 2);
+            memset(&data[2], 'x', n_x[i]);
+            data[n_data - 1] = '\n';
+            FILE *stream = fmemopen(data, n_data, "r");
+            assert(fancy_string_pattern_find_all_in_stream(p, stream, test_fancy_string_pattern_memory_usage_callback, &memory_usage[i]) == 1);
+            fclose(stream);
+            free(data);
+        }
+        assert(memory_usage[0] != 0 && memory_usage[1] == memory_usage[0]);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        fancy_string_t *pattern = fancy_string_create("a");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        FILE *stream = fmemopen("aaa", 3, "r");
+        assert(fancy_string_pattern_find_all_in_stream(p, stream, NULL, NULL) == -1);
+        fclose(stream);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_pattern_find_all(void)
+{
+    LOG();
+    {
+        fancy_string_t *pattern = fancy_string_create("[0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        test_fancy_string_pattern_record_t record = {.n_max = 16};
+        assert(fancy_string_pattern_find_all(p, fancy_string_view_from_value("a1 22 333"), test_fancy_string_pattern_find_all_callback, &record) == 3);
+        assert(record.n == 3);
+        assert(record.start[0] == 1 && record.end[0] == 2);
+        assert(record.start[1] == 3 && record.end[1] == 5);
+        assert(record.start[2] == 6 && record.end[2] == 9);
+
+        // NOTE: The search stops as soon as the callback returns `false`.
+        record = (test_fancy_string_pattern_record_t){.n_max = 2};
+        assert(fancy_string_pattern_find_all(p, fancy_string_view_from_value("a1 22 333"), test_fancy_string_pattern_find_all_callback, &record) == 2);
+        assert(record.n == 2);
+
+        assert(fancy_string_pattern_find_all(p, fancy_string_view_from_value("1 2 3 4"), NULL, NULL) == 4);
+        assert(fancy_string_pattern_find_all(p, fancy_string_view_from_value(""), NULL, NULL) == 0);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: The pattern object has to use the built-in engine.
+        fancy_string_t *pattern = fancy_string_create("[0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        assert(fancy_string_pattern_find_all(p, fancy_string_view_from_value("a1"), NULL, NULL) == -1);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: The matches are the same as those of `fancy_string_regex_create_with_pattern`, including when the
+        // search has to go back to the end of a match (e.g., `"ab|a"` in `"aab"`), for `^` and `$`, and when the
+        // search stops at an empty match.
+        char const *cases[][2] = {
+            {"ab|a", "aab"},
+            {"ab|a", "acaab"},
+            {"(a|ab)(c|bcd)(d*)", "abcd abcdd acd"},
+            {"a.*b", "a..b..b.."},
+            {"^a|b", "aab"},
+            {"a$|b", "abba"},
+            {"b*(a$|b)", "bba"},
+            {"x*", "xxaxx"},
+            {"a|x*", "aax"},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(cases[i][0]);
+            fancy_string_t *s = fancy_string_create(cases[i][1]);
+            fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+            fancy_string_pattern_t *expected_p = fancy_string_pattern_create(pattern);
+            fancy_string_regex_t *expected = fancy_string_regex_create_with_pattern(s, expected_p, -1);
+            test_fancy_string_pattern_record_t record = {.n_max = 16};
+            assert(fancy_string_pattern_find_all(p, fancy_string_view(s), test_fancy_string_pattern_find_all_callback, &record) == (ssize_t)fancy_string_regex_match_count(expected));
+            for (size_t m = 0; m < record.n; m++)
+            {
+                fancy_string_regex_match_info_t info = fancy_string_regex_match_info_for_index(expected, m);
+                assert(record.start[m] == info.start && record.end[m] == info.end);
+            }
+            fancy_string_regex_destroy(expected);
+            fancy_string_pattern_destroy(expected_p);
+            fancy_string_pattern_destroy(p);
+            fancy_string_destroy(s);
+            fancy_string_destroy(pattern);
+        }
+    }
+}
+
+void test_fancy_string_pattern_engine(void)
+{
+    LOG();
+    fancy_string_t *pattern = fancy_string_create("[a-z]+");
+    fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+    assert(fancy_string_pattern_engine(p) == FANCY_STRING_REGEX_ENGINE_POSIX);
+    fancy_string_pattern_destroy(p);
+    p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+    assert(fancy_string_pattern_engine(p) == FANCY_STRING_REGEX_ENGINE_DFA);
+    fancy_string_pattern_destroy(p);
+    fancy_string_destroy(pattern);
+}
+
+void test_fancy_string_pattern_create_with_engine(void)
+{
+    LOG();
+    {
+        char const *patterns[] = {"[0-9]+", "^(GET|POST) /[a-z]*$", "a{2,3}|b?", "[[:alpha:]_][[:alnum:]_]*", "\\.\\*\\{"};
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+            assert(p != NULL);
+            assert(fancy_string_pattern_engine(p) == FANCY_STRING_REGEX_ENGINE_DFA);
+            fancy_string_pattern_destroy(p);
+            p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_POSIX);
+            assert(fancy_string_pattern_engine(p) == FANCY_STRING_REGEX_ENGINE_POSIX);
+            fancy_string_pattern_destroy(p);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        // NOTE: Invalid patterns, and the features that the built-in engine does not have.
+        char const *patterns[] = {"", "a(", "(a)\\1", "\\bword", "\\w+", "\\<a", "[[=a=]]", "(^a|b)+"};
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            assert(fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA) == NULL);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        // NOTE: The matches are the same as those found by `regexec` (i.e., the leftmost-longest ones).
+        char const *atoms[] = {"a", "b", "ab", "\\.", "[ab]", "[^a]", "[0-9]", "[[:alpha:]]", ".", "(a|b)", "(ab|a)", "(a|ab)(c|bcd)", "()", "(a*)*", "(a|)", "(a$|b)", "(b|$)", "(^a|b)"};
+        char const *quantifiers[] = {"", "", "", "*", "+", "?", "{2}", "{0,1}", "{1,}", "{2,3}", "+*"};
+        char const *anchors[] = {"^", "$", "|"};
+        char const alphabet[] = "abcd1.\n";
+        srand(31);
+        for (size_t i = 0; i < 3000; i++)
+        {
+            fancy_string_t *pattern = fancy_string_create_empty();
+            size_t n_atoms = 1 + (size_t)rand() % 5;
+            bool is_branch_start = true;
+            for (size_t j = 0; j < n_atoms; j++)
+            {
+                bool is_anchor = rand() % 10 == 0;
+                char const *atom = is_anchor ? anchors[rand() % 3] : atoms[(size_t)rand() % (sizeof(atoms) / sizeof(atoms[0]))];
+                // NOTE: Nothing may precede `^`, and nothing may follow `$` (see below).
+                if (strchr(atom, '^') != NULL && !is_branch_start)
+                {
+                    continue;
+                }
+                fancy_string_append_value(pattern, atom);
+                // NOTE: A quantified group may not contain `^` (see above), nor `$`.
+                if (!is_anchor && strchr(atom, '^') == NULL && strchr(atom, '$') == NULL)
+                {
+                    fancy_string_append_value(pattern, quantifiers[(size_t)rand() % (sizeof(quantifiers) / sizeof(quantifiers[0]))]);
+                }
+                if (strchr(atom, '$') != NULL && j + 1 < n_atoms)
+                {
+                    fancy_string_append_value(pattern, "|");
+                }
+                is_branch_start = atom[0] == '|' || strchr(atom, '$') != NULL;
+            }
+            fancy_string_pattern_t *expected_p = fancy_string_pattern_create(pattern);
+            if (expected_p == NULL)
+            {
+                fancy_string_destroy(pattern);
+                continue;
+            }
+            fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+            assert(p != NULL);
+
+            // NOTE: Unlike `.`, a negated bracket expression matches the null character.
+            char value[41];
+            size_t n = 1 + (size_t)rand() % (sizeof(value) - 1);
+            for (size_t j = 0; j < n; j++)
+            {
+                value[j] = rand() % 32 == 0 ? '\0' : alphabet[rand() % (sizeof(alphabet) - 1)];
+            }
+            value[n] = '\0';
+            fancy_string_view_t subject = {.value = value, .n = n};
+            fancy_string_t *s = fancy_string_from_view(subject);
+            fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+            fancy_string_regex_t *expected = fancy_string_regex_create_with_pattern(s, expected_p, -1);
+            assert(fancy_string_regex_match_count(regex) == fancy_string_regex_match_count(expected));
+            for (size_t m = 0; m < fancy_string_regex_match_count(regex); m++)
+            {
+                fancy_string_regex_match_info_t info = fancy_string_regex_match_info_for_index(regex, m);
+                fancy_string_regex_match_info_t expected_info = fancy_string_regex_match_info_for_index(expected, m);
+                assert(info.start == expected_info.start && info.end == expected_info.end);
+            }
+            fancy_string_regex_match_info_t info = fancy_string_pattern_find(p, subject);
+            fancy_string_regex_match_info_t expected_info = fancy_string_pattern_find(expected_p, subject);
+            assert(info.index == expected_info.index && info.start == expected_info.start && info.end == expected_info.end);
+            fancy_string_regex_destroy(expected);
+            fancy_string_regex_destroy(regex);
+            fancy_string_destroy(s);
+            fancy_string_pattern_destroy(p);
+            fancy_string_pattern_destroy(expected_p);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        // NOTE: glibc matches a `^` that something precedes, or a `$` that something follows, around newlines, so the
+        // built-in engine does not support them.
+        char const *patterns[] = {"b$.", ".^c", "[ab]$.{1,2}", "(b|$)[^a]"};
+        char const *values[] = {"ab\nc", "a\nc", "ab\ncd", "a\nc"};
+        size_t const ends[] = {3, 3, 4, 2};
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            assert(fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA) == NULL);
+            fancy_string_pattern_t *expected_p = fancy_string_pattern_create(pattern);
+            fancy_string_regex_match_info_t info = fancy_string_pattern_find(expected_p, fancy_string_view_from_value(values[i]));
+            assert(info.index == 0 && info.start == 1 && info.end == ends[i]);
+            fancy_string_pattern_destroy(expected_p);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        // NOTE: A pattern that makes a backtracking matcher take exponential time.
+        fancy_string_t *pattern = fancy_string_create("(x+x+)+y");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        fancy_string_t *s = fancy_string_create("y");
+        for (size_t i = 0; i < 100000; i++)
+        {
+            fancy_string_append_value(s, "x");
+        }
+        fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+        assert(fancy_string_regex_match_count(regex) == 0);
+        fancy_string_append_value(s, "y");
+        assert(fancy_string_pattern_find(p, fancy_string_view(s)).end == 100002);
+        fancy_string_regex_destroy(regex);
+        fancy_string_destroy(s);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: A pattern with more DFA states than the DFA keeps at once (i.e., they get dropped and built again).
+        fancy_string_t *pattern = fancy_string_create("a(a|b){12}b");
+        fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+        fancy_string_pattern_t *expected_p = fancy_string_pattern_create(pattern);
+        fancy_string_t *s = fancy_string_create_empty();
+        srand(37);
+        for (size_t i = 0; i < 50000; i++)
+        {
+            fancy_string_append_value(s, rand() % 2 == 0 ? "a" : "b");
+        }
+        fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+        fancy_string_regex_t *expected = fancy_string_regex_create_with_pattern(s, expected_p, -1);
+        assert(fancy_string_regex_match_count(regex) == fancy_string_regex_match_count(expected));
+        for (size_t m = 0; m < fancy_string_regex_match_count(regex); m++)
+        {
+            fancy_string_regex_match_info_t info = fancy_string_regex_match_info_for_index(regex, m);
+            fancy_string_regex_match_info_t expected_info = fancy_string_regex_match_info_for_index(expected, m);
+            assert(info.start == expected_info.start && info.end == expected_info.end);
+        }
+        fancy_string_regex_destroy(expected);
+        fancy_string_regex_destroy(regex);
+        fancy_string_destroy(s);
+        fancy_string_pattern_destroy(expected_p);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: Patterns for which each match is only known once the rest of the input has been read (e.g., the
+        // `"a"` of `"a|a[^z]*z"`, until it is known that no `"z"` follows). With eight times more input, the
+        // search takes about eight times longer, rather than sixty-four times (which would be quadratic). With
+        // `"a|a+b"`, the longest-match scans stop at the `"c"` that ends the input instead.
+        char const *patterns[] = {"a|a[^z]*z", "ab|a.*c", "a|a+b"};
+        char const *units[] = {"a", "ab", "a"};
+        char const *suffixes[] = {"", "", "c"};
+        for (size_t i = 0; i < 3; i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            fancy_string_pattern_t *p = fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA);
+            size_t const n_repeats[2] = {(size_t)1 << 13, (size_t)1 << 16};
+            double seconds[2] = {0};
+            for (size_t j = 0; j < 2; j++)
+            {
+                fancy_string_t *s = fancy_string_create_repeat(units[i], n_repeats[j]);
+                fancy_string_append_value(s, suffixes[i]);
+                size_t n = fancy_string_size(s) - strlen(suffixes[i]);
+                // NOTE: The best of a few runs, which is less sensitive to the load of the machine.
+                for (size_t k = 0; k < 3; k++)
+                {
+                    struct timespec before;
+                    struct timespec after;
+                    clock_gettime(CLOCK_MONOTONIC, &before);
+                    fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+                    clock_gettime(CLOCK_MONOTONIC, &after);
+                    double elapsed = (double)(after.tv_sec - before.tv_sec) + (double)(after.tv_nsec - before.tv_nsec) / 1e9;
+                    seconds[j] = k == 0 || elapsed < seconds[j] ? elapsed : seconds[j];
+                    size_t n_matches = n / strlen(units[i]);
+                    assert(fancy_string_regex_match_count(regex) == n_matches);
+                    fancy_string_regex_match_info_t info = fancy_string_regex_match_info_for_index(regex, n_matches - 1);
+                    assert(info.end == n && info.start == info.end - strlen(units[i]));
+                    fancy_string_regex_destroy(regex);
+                }
+                fancy_string_destroy(s);
+            }
+            assert(seconds[1] < 24 * seconds[0]);
+            fancy_string_pattern_destroy(p);
+            fancy_string_destroy(pattern);
+        }
+    }
+}
+
+void test_fancy_string_regex_prefilter_stats(void)
+{
+    LOG();
+    fancy_string_prefilter_stats_t before = fancy_string_regex_prefilter_stats();
+    fancy_string_t *pattern = fancy_string_create("[0-9]+");
+    fancy_string_t *s = fancy_string_create("no digits here");
+    // NOTE: The counters of the patterns compiled by `fancy_string_regex_create` are included.
+    fancy_string_regex_t *regex = fancy_string_regex_create(s, pattern, -1);
+    assert(fancy_string_regex_match_count(regex) == 0);
+    fancy_string_prefilter_stats_t after = fancy_string_regex_prefilter_stats();
+    assert(after.n_checks == before.n_checks + 1);
+    assert(after.n_rejections == before.n_rejections + 1);
+    assert(after.n_skipped_bytes == before.n_skipped_bytes);
+    fancy_string_regex_destroy(regex);
+    fancy_string_destroy(s);
+    fancy_string_destroy(pattern);
+}
+
+void test_fancy_string_pattern_prefilter_stats(void)
+{
+    LOG();
+    {
+        fancy_string_t *pattern = fancy_string_create("error: [0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        fancy_string_prefilter_stats_t stats = fancy_string_pattern_prefilter_stats(p);
+        assert(stats.n_checks == 0 && stats.n_rejections == 0 && stats.n_skipped_bytes == 0);
+        // NOTE: The line does not contain the literal, so `regexec` is not called.
+        assert(!fancy_string_pattern_has_match(p, fancy_string_view_from_value("warning: 12")));
+        stats = fancy_string_pattern_prefilter_stats(p);
+        assert(stats.n_checks == 1 && stats.n_rejections == 1 && stats.n_skipped_bytes == 0);
+        // NOTE: Every match starts with the literal, so the bytes before it are skipped.
+        fancy_string_regex_match_info_t info = fancy_string_pattern_find(p, fancy_string_view_from_value("12 error: 34"));
+        assert(info.index == 0 && info.start == 3 && info.end == 12);
+        stats = fancy_string_pattern_prefilter_stats(p);
+        assert(stats.n_checks == 2 && stats.n_rejections == 1 && stats.n_skipped_bytes == 3);
+        // NOTE: Two matches, then a last check that finds no more occurrences of the literal.
+        fancy_string_t *s = fancy_string_create("error: 1 ok error: 2 ok");
+        fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+        assert(fancy_string_regex_match_count(regex) == 2);
+        stats = fancy_string_pattern_prefilter_stats(p);
+        assert(stats.n_checks == 5 && stats.n_rejections == 2 && stats.n_skipped_bytes == 7);
+        fancy_string_regex_destroy(regex);
+        fancy_string_destroy(s);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: With `^`, the literal can only be used to reject input.
+        fancy_string_t *pattern = fancy_string_create("^[a-z]+ error");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        assert(!fancy_string_pattern_has_match(p, fancy_string_view_from_value("1 x error")));
+        assert(!fancy_string_pattern_has_match(p, fancy_string_view_from_value("abc")));
+        fancy_string_prefilter_stats_t stats = fancy_string_pattern_prefilter_stats(p);
+        assert(stats.n_checks == 2 && stats.n_rejections == 1 && stats.n_skipped_bytes == 0);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        fancy_string_t *pattern = fancy_string_create("a|b");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        assert(fancy_string_pattern_has_match(p, fancy_string_view_from_value("cab")));
+        fancy_string_prefilter_stats_t stats = fancy_string_pattern_prefilter_stats(p);
+        assert(stats.n_checks == 0);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_pattern_prefilter_literal(void)
+{
+    LOG();
+    struct
+    {
+        char const *pattern;
+        char const *literal;
+    } cases[] = {
+        {"error: [0-9]+", "error: "},
+        {"^sensor/.*/temp$", "sensor/"},
+        {"[a-z]+@[a-z]+\\.com", ".com"},
+        {"colou?r", "colo"},
+        {"ab+cde", "cde"},
+        {"(foo|bar)baz", "baz"},
+        {"[0-9]+", ""},
+        {"a|b", ""},
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        fancy_string_t *pattern = fancy_string_create(cases[i].pattern);
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        fancy_string_view_t literal = fancy_string_pattern_prefilter_literal(p);
+        assert(literal.n == strlen(cases[i].literal) && memcmp(literal.value, cases[i].literal, literal.n) == 0);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_pattern_prefilter_kind(void)
+{
+    LOG();
+    {
+        struct
+        {
+            char const *pattern;
+            fancy_string_prefilter_kind_t kind;
+        } cases[] = {
+            {"error: [0-9]+", FANCY_STRING_PREFILTER_KIND_LITERAL},
+            {"^sensor/.*/temp$", FANCY_STRING_PREFILTER_KIND_LITERAL},
+            {"[0-9]+", FANCY_STRING_PREFILTER_KIND_BYTE_SET},
+            {"[[:digit:]]{2,}", FANCY_STRING_PREFILTER_KIND_BYTE_SET},
+            {"error|warning", FANCY_STRING_PREFILTER_KIND_NONE},
+            {"(error)", FANCY_STRING_PREFILTER_KIND_NONE},
+            {"a*", FANCY_STRING_PREFILTER_KIND_NONE},
+            {"[0-9]?", FANCY_STRING_PREFILTER_KIND_NONE},
+            {".", FANCY_STRING_PREFILTER_KIND_NONE},
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(cases[i].pattern);
+            fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+            assert(fancy_string_pattern_prefilter_kind(p) == cases[i].kind);
+            fancy_string_pattern_destroy(p);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        // NOTE: A pattern `P` and the pattern `(P)` have the same matches, but the latter has no
+        // prefilter, so the prefilter must not change the results.
+        char const *atoms[] = {"a", "b", "ab", "\\.", "[ab]", "[^a]", "[0-9]", ".", "(a|b)", "(ab)+"};
+        char const *quantifiers[] = {"", "", "", "*", "+", "?", "{2}", "{0,1}"};
+        char const *anchors[] = {"^", "$"};
+        char const alphabet[] = "ab1. ";
+        srand(23);
+        for (size_t i = 0; i < 500; i++)
+        {
+            fancy_string_t *pattern = fancy_string_create_empty();
+            size_t n_atoms = 1 + (size_t)rand() % 5;
+            for (size_t j = 0; j < n_atoms; j++)
+            {
+                if (rand() % 8 == 0)
+                {
+                    fancy_string_append_value(pattern, anchors[rand() % 2]);
+                    continue;
+                }
+                fancy_string_append_value(pattern, atoms[(size_t)rand() % (sizeof(atoms) / sizeof(atoms[0]))]);
+                fancy_string_append_value(pattern, quantifiers[(size_t)rand() % (sizeof(quantifiers) / sizeof(quantifiers[0]))]);
+            }
+            fancy_string_t *grouped = fancy_string_create("(");
+            fancy_string_append(grouped, pattern);
+            fancy_string_append_value(grouped, ")");
+            fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+            fancy_string_pattern_t *reference = fancy_string_pattern_create(grouped);
+            assert(p != NULL && reference != NULL);
+            assert(fancy_string_pattern_prefilter_kind(reference) == FANCY_STRING_PREFILTER_KIND_NONE);
+
+            char value[41];
+            size_t n = (size_t)rand() % sizeof(value);
+            for (size_t j = 0; j < n; j++)
+            {
+                value[j] = alphabet[rand() % (sizeof(alphabet) - 1)];
+            }
+            value[n] = '\0';
+            fancy_string_t *s = fancy_string_create(value);
+            fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+            fancy_string_regex_t *expected = fancy_string_regex_create_with_pattern(s, reference, -1);
+            assert((regex == NULL) == (expected == NULL));
+            if (regex != NULL)
+            {
+                assert(fancy_string_regex_match_count(regex) == fancy_string_regex_match_count(expected));
+                for (size_t m = 0; m < fancy_string_regex_match_count(regex); m++)
+                {
+                    fancy_string_regex_match_info_t info = fancy_string_regex_match_info_for_index(regex, m);
+                    fancy_string_regex_match_info_t expected_info = fancy_string_regex_match_info_for_index(expected, m);
+                    assert(info.start == expected_info.start && info.end == expected_info.end);
+                }
+                fancy_string_regex_destroy(regex);
+                fancy_string_regex_destroy(expected);
+            }
+            fancy_string_regex_match_info_t info = fancy_string_pattern_find(p, fancy_string_view(s));
+            fancy_string_regex_match_info_t expected_info = fancy_string_pattern_find(reference, fancy_string_view(s));
+            assert(info.index == expected_info.index && info.start == expected_info.start && info.end == expected_info.end);
+            fancy_string_destroy(s);
+            fancy_string_pattern_destroy(reference);
+            fancy_string_pattern_destroy(p);
+            fancy_string_destroy(grouped);
+            fancy_string_destroy(pattern);
+        }
+    }
+}
+
+void test_fancy_string_regex_cache_clear(void)
+{
+    LOG();
+    fancy_string_regex_cache_set_capacity(10);
+    fancy_string_t *s = fancy_string_create("one two");
+    fancy_string_t *pattern = fancy_string_create("o");
+    fancy_string_regex_t *regex = fancy_string_regex_create(s, pattern, -1);
+    fancy_string_regex_cache_clear();
+    fancy_string_regex_cache_stats_t stats = fancy_string_regex_cache_stats();
+    assert(stats.capacity == 10 && stats.size == 0);
+    assert(stats.n_hits == 0 && stats.n_misses == 0 && stats.n_evictions == 0);
+    // NOTE: The regex objects do not depend on the cache.
+    assert(fancy_string_regex_match_count(regex) == 2);
+    fancy_string_regex_destroy(regex);
+    fancy_string_destroy(pattern);
+    fancy_string_destroy(s);
+    fancy_string_regex_cache_set_capacity(0);
+}
+
+void test_fancy_string_regex_cache_stats(void)
+{
+    LOG();
+    fancy_string_regex_cache_set_capacity(10);
+    fancy_string_t *s = fancy_string_create("one two");
+    fancy_string_t *pattern = fancy_string_create("[a-z]+");
+    for (size_t i = 0; i < 5; i++)
+    {
+        fancy_string_regex_t *regex = fancy_string_regex_create(s, pattern, -1);
+        assert(fancy_string_regex_match_count(regex) == 2);
+        fancy_string_regex_destroy(regex);
+    }
+    fancy_string_regex_cache_stats_t stats = fancy_string_regex_cache_stats();
+    assert(stats.capacity == 10 && stats.size == 1);
+    assert(stats.n_hits == 4 && stats.n_misses == 1 && stats.n_evictions == 0);
+    fancy_string_destroy(pattern);
+    fancy_string_destroy(s);
+    fancy_string_regex_cache_set_capacity(0);
+    fancy_string_regex_cache_clear();
+}
+
+void test_fancy_string_regex_cache_set_capacity(void)
+{
+    LOG();
+    {
+        // NOTE: The cache is disabled by default.
+        fancy_string_regex_cache_stats_t stats = fancy_string_regex_cache_stats();
+        assert(stats.capacity == 0 && stats.size == 0);
+    }
+    {
+        // NOTE: The least recently used pattern gets evicted, and the results are the same either way.
+        fancy_string_regex_cache_set_capacity(2);
+        fancy_string_t *s = fancy_string_create("a1 b22 c333");
+        char const *patterns[] = {"[0-9]+", "[a-z]", "[0-9]+", "[0-9]{2}", "[a-z]", "[0-9]+"};
+        size_t n_expected_matches[] = {3, 3, 3, 2, 3, 3};
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            fancy_string_regex_t *regex = fancy_string_regex_create(s, pattern, -1);
+            assert(fancy_string_regex_match_count(regex) == n_expected_matches[i]);
+            fancy_string_regex_destroy(regex);
+            fancy_string_destroy(pattern);
+        }
+        fancy_string_regex_cache_stats_t stats = fancy_string_regex_cache_stats();
+        assert(stats.capacity == 2 && stats.size == 2);
+        // NOTE: "[0-9]+" hits once, then "[a-z]" is evicted by "[0-9]{2}", and "[0-9]+" by "[a-z]".
+        assert(stats.n_hits == 1 && stats.n_misses == 5 && stats.n_evictions == 3);
+        fancy_string_regex_cache_set_capacity(1);
+        stats = fancy_string_regex_cache_stats();
+        assert(stats.capacity == 1 && stats.size == 1 && stats.n_evictions == 4);
+        fancy_string_regex_cache_set_capacity(0);
+        stats = fancy_string_regex_cache_stats();
+        assert(stats.capacity == 0 && stats.size == 0);
+        fancy_string_regex_cache_clear();
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Invalid patterns are not cached.
+        fancy_string_regex_cache_set_capacity(4);
+        fancy_string_t *s = fancy_string_create("abc");
+        fancy_string_t *pattern = fancy_string_create("([a-z]");
+        assert(fancy_string_regex_create(s, pattern, -1) == NULL);
+        assert(fancy_string_regex_create(s, pattern, -1) == NULL);
+        fancy_string_regex_cache_stats_t stats = fancy_string_regex_cache_stats();
+        assert(stats.size == 0 && stats.n_hits == 0 && stats.n_misses == 2);
+        fancy_string_destroy(pattern);
+        fancy_string_destroy(s);
+        fancy_string_regex_cache_set_capacity(0);
+        fancy_string_regex_cache_clear();
+    }
+}
+
+void test_fancy_string_pattern_has_match(void)
+{
+    LOG();
+    fancy_string_t *pattern = fancy_string_create("^GET /api/");
+    fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+    assert(fancy_string_pattern_has_match(p, fancy_string_view_from_value("GET /api/users")));
+    assert(!fancy_string_pattern_has_match(p, fancy_string_view_from_value("POST /api/users")));
+    assert(!fancy_string_pattern_has_match(p, fancy_string_view_from_value("")));
+    fancy_string_pattern_destroy(p);
+    fancy_string_destroy(pattern);
+}
+
+static void *test_fancy_string_pattern_find_thread(void *context)
+{
+    fancy_string_pattern_t const *p = context;
+    size_t n_found = 0;
+    char value[64];
+    for (size_t i = 0; i < 1000; i++)
+    {
+        int n = snprintf(value, sizeof(value), "user=x id=%zu end", i);
+        fancy_string_regex_match_info_t info = fancy_string_pattern_find(p, fancy_string_view_from_memory(value, (size_t)n));
+        if (info.index == 0 && info.start == 7 && strncmp(&value[info.start], "id=", 3) == 0)
+        {
+            n_found++;
+        }
+    }
+    return (void *)n_found;
+}
+
+void test_fancy_string_pattern_find(void)
+{
+    LOG();
+    {
+        fancy_string_t *pattern = fancy_string_create("[0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        fancy_string_regex_match_info_t info = fancy_string_pattern_find(p, fancy_string_view_from_value("abc 123 45"));
+        assert(info.index == 0 && info.start == 4 && info.end == 7);
+        // NOTE: The subject does not need to be null-terminated.
+        info = fancy_string_pattern_find(p, fancy_string_view_from_memory("ab12", 3));
+        assert(info.index == 0 && info.start == 2 && info.end == 3);
+        info = fancy_string_pattern_find(p, fancy_string_view_from_memory("ab12", 2));
+        assert(info.index == -1 && info.start == 0 && info.end == 0);
+        info = fancy_string_pattern_find(p, fancy_string_view_from_value(""));
+        assert(info.index == -1);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: Empty matches are ignored.
+        fancy_string_t *pattern = fancy_string_create("x*");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        assert(fancy_string_pattern_find(p, fancy_string_view_from_value("abc")).index == -1);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+    {
+        // NOTE: The same pattern object can be used by many threads at once.
+        fancy_string_t *pattern = fancy_string_create("id=([0-9]+)");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        pthread_t threads[4];
+        for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+        {
+            assert(pthread_create(&threads[i], NULL, test_fancy_string_pattern_find_thread, p) == 0);
+        }
+        for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++)
+        {
+            void *n_found;
+            assert(pthread_join(threads[i], &n_found) == 0);
+            assert((size_t)n_found == 1000);
+        }
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_regex_create_with_pattern(void)
+{
+    LOG();
+    {
+        // NOTE: The results are the same as those of `fancy_string_regex_create`.
+        char const *patterns[] = {"[0-9]+", "a|b", "x*", "^[a-z]+", "[[:space:]]"};
+        char const *strings[] = {"a1b22c333", "abcabc", "xxaxx", "one two", " a b c "};
+        ssize_t n_max_matches[] = {-1, 0, 1, 2};
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+            for (size_t j = 0; j < sizeof(strings) / sizeof(strings[0]); j++)
+            {
+                for (size_t k = 0; k < sizeof(n_max_matches) / sizeof(n_max_matches[0]); k++)
+                {
+                    fancy_string_t *s = fancy_string_create(strings[j]);
+                    fancy_string_regex_t *expected = fancy_string_regex_create(s, pattern, n_max_matches[k]);
+                    fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, n_max_matches[k]);
+                    assert(fancy_string_regex_match_count(regex) == fancy_string_regex_match_count(expected));
+                    for (size_t m = 0; m < fancy_string_regex_match_count(regex); m++)
+                    {
+                        fancy_string_regex_match_info_t info = fancy_string_regex_match_info_for_index(regex, m);
+                        fancy_string_regex_match_info_t expected_info = fancy_string_regex_match_info_for_index(expected, m);
+                        assert(info.start == expected_info.start && info.end == expected_info.end);
+                    }
+                    fancy_string_regex_destroy(regex);
+                    fancy_string_regex_destroy(expected);
+                    fancy_string_destroy(s);
+                }
+            }
+            fancy_string_pattern_destroy(p);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        fancy_string_t *pattern = fancy_string_create("a");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        fancy_string_t *s = fancy_string_create_empty();
+        assert(fancy_string_regex_create_with_pattern(s, p, -1) == NULL);
+        fancy_string_destroy(s);
+        fancy_string_pattern_destroy(p);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_pattern_destroy(void)
+{
+    LOG();
+    fancy_string_t *pattern = fancy_string_create("b+");
+    fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+    fancy_string_t *s = fancy_string_create("abbbc");
+    fancy_string_regex_t *regex = fancy_string_regex_create_with_pattern(s, p, -1);
+    // NOTE: The regex object does not depend on the pattern object.
+    fancy_string_pattern_destroy(p);
+    assert(fancy_string_regex_match_count(regex) == 1);
+    fancy_string_t *regex_pattern = fancy_string_regex_pattern(regex);
+    assert(fancy_string_equals(regex_pattern, pattern));
+    fancy_string_destroy(regex_pattern);
+    fancy_string_regex_destroy(regex);
+    fancy_string_destroy(s);
+    fancy_string_destroy(pattern);
+}
+
+void test_fancy_string_pattern_create(void)
+{
+    LOG();
+    {
+        fancy_string_t *pattern = fancy_string_create("[0-9]+");
+        fancy_string_pattern_t *p = fancy_string_pattern_create(pattern);
+        fancy_string_destroy(pattern);
+        assert(p != NULL);
+        assert(fancy_string_pattern_has_match(p, fancy_string_view_from_value("abc 123")));
+        fancy_string_pattern_destroy(p);
+    }
+    {
+        fancy_string_t *pattern = fancy_string_create_empty();
+        assert(fancy_string_pattern_create(pattern) == NULL);
+        fancy_string_update_value(pattern, "([0-9]");
+        assert(fancy_string_pattern_create(pattern) == NULL);
+        fancy_string_destroy(pattern);
+    }
+}
+
+void test_fancy_string_uppercased_locale(void)
+{
+    LOG();
+    fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
+    fancy_string_t *s_uppercased = fancy_string_uppercased_locale(s);
+    assert(fancy_string_equals_value(s, "One Two Three Four FIVE"));
+    assert(fancy_string_equals_value(s_uppercased, "ONE TWO THREE FOUR FIVE"));
+    fancy_string_destroy(s_uppercased);
+    fancy_string_destroy(s);
+}
+
+void test_fancy_string_uppercase_locale(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
+        fancy_string_uppercase_locale(s);
+        assert(fancy_string_equals_value(s, "ONE TWO THREE FOUR FIVE"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Every byte goes through `toupper`, according to the current (i.e., "C") locale.
+        char value[256];
+        for (size_t i = 0; i < sizeof(value); i++)
+        {
+            value[i] = (char)i;
+        }
+        fancy_string_t *s = fancy_string_from_view(fancy_string_view_from_memory(value, sizeof(value)));
+        fancy_string_uppercase_locale(s);
+        for (size_t i = 0; i < sizeof(value); i++)
+        {
+            assert((unsigned char)fancy_string_view(s).value[i] == toupper((int)i));
+        }
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_lowercased_locale(void)
+{
+    LOG();
+    fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
+    fancy_string_t *s_lowercased = fancy_string_lowercased_locale(s);
+    assert(fancy_string_equals_value(s, "One Two Three Four FIVE"));
+    assert(fancy_string_equals_value(s_lowercased, "one two three four five"));
+    fancy_string_destroy(s_lowercased);
+    fancy_string_destroy(s);
+}
+
+void test_fancy_string_lowercase_locale(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
+        fancy_string_lowercase_locale(s);
+        assert(fancy_string_equals_value(s, "one two three four five"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Every byte goes through `tolower`, according to the current (i.e., "C") locale.
+        char value[256];
+        for (size_t i = 0; i < sizeof(value); i++)
+        {
+            value[i] = (char)i;
+        }
+        fancy_string_t *s = fancy_string_from_view(fancy_string_view_from_memory(value, sizeof(value)));
+        fancy_string_lowercase_locale(s);
+        for (size_t i = 0; i < sizeof(value); i++)
+        {
+            assert((unsigned char)fancy_string_view(s).value[i] == tolower((int)i));
+        }
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_trimmed_chars(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create(" \t[value]\t ");
+        fancy_string_t *trimmed = fancy_string_trimmed_chars(s, " \t[]");
+        assert(fancy_string_equals_value(trimmed, "value"));
+        assert(fancy_string_equals_value(s, " \t[value]\t "));
+        fancy_string_destroy(trimmed);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_trim_chars_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("\0\xfe" "a\0b\xfe\0", 7);
+        fancy_string_trim_chars_n(s, "\xfe\0", 2);
+        assert(fancy_string_equals_value_n(s, "a\0b", 3));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_trim_chars(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("--==value=-=--");
+        fancy_string_trim_chars(s, "=-");
+        assert(fancy_string_equals_value(s, "value"));
+        fancy_string_trim_chars(s, "");
+        assert(fancy_string_equals_value(s, "value"));
+        fancy_string_trim_chars(s, "eulav");
+        assert(fancy_string_size(s) == 0);
+        fancy_string_trim_chars(s, "x");
+        assert(fancy_string_size(s) == 0);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Shared values are copied, not modified.
+        fancy_string_t *s = fancy_string_create("000120");
+        fancy_string_share(s);
+        fancy_string_t *clone = fancy_string_clone(s);
+        fancy_string_trim_chars(s, "0");
+        assert(fancy_string_equals_value(s, "12"));
+        assert(fancy_string_equals_value(clone, "000120"));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_split_by_any_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("a\0b\xff" "c", 5);
+        fancy_string_array_t *a = fancy_string_split_by_any_n(s, "\xff\0", 2, -1);
+        assert(fancy_string_array_size(a) == 3);
+        assert(fancy_string_array_index_of_value(a, "c") == 2);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Compares against a naive split, with sizes that cover the edges of the (16- and
+        // 32-byte) blocks used by the SIMD kernels, and sets that include bytes above `0x7f`.
+        srand(18);
+        char value[100];
+        unsigned char charset[8];
+        for (size_t round = 0; round < 2000; round++)
+        {
+            size_t n = (size_t)rand() % sizeof(value);
+            size_t n_charset = 1 + (size_t)rand() % sizeof(charset);
+            for (size_t i = 0; i < n_charset; i++)
+            {
+                charset[i] = (unsigned char)(rand() % 256);
+            }
+            bool is_member[256] = {false};
+            for (size_t i = 0; i < n_charset; i++)
+            {
+                is_member[charset[i]] = true;
+            }
+            // NOTE: Separators are sparse, so that components are usually longer than a block.
+            size_t n_separators = 0;
+            for (size_t i = 0; i < n; i++)
+            {
+                do
+                {
+                    value[i] = (char)(rand() % 256);
+                } while (is_member[(unsigned char)value[i]] && rand() % 32 != 0);
+                n_separators += is_member[(unsigned char)value[i]] ? 1 : 0;
+            }
+            fancy_string_t *s = fancy_string_from_copied_memory(value, n);
+            fancy_string_array_t *a = fancy_string_split_by_any_n(s, (char const *)charset, n_charset, -1);
+            assert(fancy_string_array_size(a) == n_separators + 1);
+            size_t start = 0;
+            size_t index = 0;
+            for (size_t i = 0; i <= n; i++)
+            {
+                if (i == n || is_member[(unsigned char)value[i]])
+                {
+                    fancy_string_t *component = fancy_string_array_get(a, index++);
+                    assert(fancy_string_equals_value_n(component, &value[start], i - start));
+                    fancy_string_destroy(component);
+                    start = i + 1;
+                }
+            }
+            fancy_string_array_destroy(a);
+            fancy_string_destroy(s);
+        }
+    }
+}
+
+void test_fancy_string_split_by_any(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("a,b;c|d e\tf");
+        fancy_string_array_t *a = fancy_string_split_by_any(s, ",;| \t", -1);
+        assert(fancy_string_array_size(a) == 6);
+        assert(fancy_string_array_index_of_value(a, "d") == 3);
+        assert(fancy_string_array_index_of_value(a, "f") == 5);
+        fancy_string_array_destroy(a);
+        a = fancy_string_split_by_any(s, ",;| \t", 2);
+        assert(fancy_string_array_size(a) == 3);
+        assert(fancy_string_array_index_of_value(a, "c|d e\tf") == 2);
+        fancy_string_array_destroy(a);
+        a = fancy_string_split_by_any(s, ",;| \t", 0);
+        assert(fancy_string_array_size(a) == 1);
+        fancy_string_array_destroy(a);
+        a = fancy_string_split_by_any(s, "", -1);
+        assert(fancy_string_array_size(a) == 1);
+        assert(fancy_string_array_index_of(a, s) == 0);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Consecutive (and leading or trailing) separators give empty components.
+        fancy_string_t *s = fancy_string_create(";a,;b,");
+        fancy_string_array_t *a = fancy_string_split_by_any(s, ",;", -1);
+        assert(fancy_string_array_size(a) == 5);
+        assert(fancy_string_array_index_of_value(a, "") == 0);
+        assert(fancy_string_array_last_index_of_value(a, "") == 4);
+        assert(fancy_string_array_index_of_value(a, "b") == 3);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+}
+
+static void test_fancy_string_split_arena_callback(fancy_string_t *const string, size_t index, fancy_string_array_t const *const array, void *context)
+{
+    IGNORE_UNUSED(array);
+    IGNORE_UNUSED(context);
+    if (index == 1)
+    {
+        fancy_string_append_value(string, "0123456789abcdefghijklmnopqrstuvwxyz");
+    }
+}
+
+void test_fancy_string_split_arena(void)
+{
+    LOG();
+    {
+        // NOTE: The components are the same as those returned by `fancy_string_split`.
+        char const *values[] = {"a,b,,c", ",a,", "", "abc", ",,,"};
+        ssize_t n_max_splits[] = {-1, 0, 1, 2, 10};
+        fancy_string_t *separator = fancy_string_create(",");
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+        {
+            for (size_t j = 0; j < sizeof(n_max_splits) / sizeof(n_max_splits[0]); j++)
+            {
+                fancy_string_t *s = fancy_string_create(values[i]);
+                fancy_string_array_t *expected = fancy_string_split(s, separator, n_max_splits[j]);
+                fancy_string_array_t *a = fancy_string_split_arena(s, fancy_string_view(separator), n_max_splits[j]);
+                assert(fancy_string_array_is_shared(a));
+                assert(fancy_string_array_size(a) == fancy_string_array_size(expected));
+                for (size_t k = 0; k < fancy_string_array_size(a); k++)
+                {
+                    fancy_string_t *component = fancy_string_array_get(expected, k);
+                    assert(fancy_string_array_index_of(a, component) != -1);
+                    fancy_string_destroy(component);
+                }
+                fancy_string_t *joined = fancy_string_array_join(a, separator);
+                fancy_string_t *expected_joined = fancy_string_array_join(expected, separator);
+                assert(fancy_string_equals(joined, expected_joined));
+                fancy_string_destroy(expected_joined);
+                fancy_string_destroy(joined);
+                fancy_string_array_destroy(a);
+                fancy_string_array_destroy(expected);
+                fancy_string_destroy(s);
+            }
+        }
+        fancy_string_destroy(separator);
+    }
+    {
+        // NOTE: The components are null-terminated, and can be removed, modified, and outlive the array.
+        fancy_string_t *s = fancy_string_create("one::two::three::four");
+        fancy_string_array_t *a = fancy_string_split_arena(s, fancy_string_view_from_value("::"), -1);
+        fancy_string_destroy(s);
+        assert(fancy_string_array_size(a) == 4);
+        char *value = fancy_string_array_get_value(a, 1);
+        assert(strcmp(value, "two") == 0);
+        free(value);
+        fancy_string_t *first = fancy_string_array_shift(a);
+        assert(fancy_string_equals_value(first, "one"));
+        fancy_string_append_value(first, " more");
+        assert(fancy_string_equals_value(first, "one more"));
+        fancy_string_t *last = fancy_string_array_get(a, 2);
+        fancy_string_array_pop_and_destroy(a);
+        fancy_string_array_push_value(a, "five");
+        fancy_string_array_insert_value(a, "zero", 0);
+        assert(fancy_string_array_index_of_value(a, "five") == 3);
+        assert(fancy_string_array_index_of_value(a, "three") == 2);
+        fancy_string_array_destroy(a);
+        assert(fancy_string_equals_value(last, "four"));
+        fancy_string_destroy(last);
+        fancy_string_destroy(first);
+    }
+    {
+        // NOTE: Elements modified in place (e.g., through `fancy_string_array_for_each`) are copied first.
+        fancy_string_t *s = fancy_string_create("a b c");
+        fancy_string_array_t *a = fancy_string_split_arena(s, fancy_string_view_from_value(" "), -1);
+        fancy_string_array_for_each(a, test_fancy_string_split_arena_callback, NULL);
+        assert(fancy_string_array_index_of_value(a, "b0123456789abcdefghijklmnopqrstuvwxyz") == 1);
+        assert(fancy_string_equals_value(s, "a b c"));
+        fancy_string_array_clear(a);
+        assert(fancy_string_array_size(a) == 0);
+        fancy_string_array_push_value(a, "again");
+        assert(fancy_string_array_size(a) == 1);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_split_iter_by_pattern(void)
+{
+    LOG();
+    {
+        // NOTE: The components are the same as those of `fancy_string_regex_split_at_matches`, with both engines.
+        char const *subjects[] = {"one1two22three333", "xx1x2", "no digits", "aaab", "abab", "1a1b11c"};
+        char const *patterns[] = {"[0-9]+", "^x|[0-9]", "a|a[^z]*z", "ab|a.*c", "b*"};
+        for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++)
+        {
+            fancy_string_t *pattern = fancy_string_create(patterns[i]);
+            fancy_string_pattern_t *compiled_patterns[2] = {
+                fancy_string_pattern_create(pattern),
+                fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA),
+            };
+            for (size_t j = 0; j < sizeof(subjects) / sizeof(subjects[0]); j++)
+            {
+                fancy_string_t *s = fancy_string_create(subjects[j]);
+                for (size_t k = 0; k < 2; k++)
+                {
+                    fancy_string_regex_t *re = fancy_string_regex_create_with_pattern(s, compiled_patterns[k], -1);
+                    fancy_string_array_t *a = fancy_string_regex_split_at_matches(re);
+                    fancy_string_split_iter_t iter = fancy_string_split_iter_by_pattern(s, compiled_patterns[k], -1);
+                    fancy_string_view_t component;
+                    for (size_t m = 0; m < fancy_string_array_size(a); m++)
+                    {
+                        assert(fancy_string_split_iter_next(&iter, &component));
+                        fancy_string_t *expected = fancy_string_array_get(a, m);
+                        assert(fancy_string_equals_view(expected, component));
+                        fancy_string_destroy(expected);
+                    }
+                    assert(!fancy_string_split_iter_next(&iter, &component));
+                    fancy_string_array_destroy(a);
+                    fancy_string_regex_destroy(re);
+                }
+                fancy_string_destroy(s);
+            }
+            fancy_string_pattern_destroy(compiled_patterns[0]);
+            fancy_string_pattern_destroy(compiled_patterns[1]);
+            fancy_string_destroy(pattern);
+        }
+    }
+    {
+        // NOTE: Without any match, the only component is the whole string.
+        fancy_string_t *s = fancy_string_create("no digits");
+        fancy_string_t *pattern = fancy_string_create("[0-9]+");
+        fancy_string_pattern_t *compiled_pattern = fancy_string_pattern_create(pattern);
+        fancy_string_split_iter_t iter = fancy_string_split_iter_by_pattern(s, compiled_pattern, -1);
+        fancy_string_view_t component;
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(fancy_string_equals_view(s, component));
+        assert(!fancy_string_split_iter_next(&iter, &component));
+        fancy_string_pattern_destroy(compiled_pattern);
+        fancy_string_destroy(pattern);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Once `n_max_splits` matches have been found, the remainder is the last component.
+        fancy_string_t *s = fancy_string_create("one1two22three333");
+        fancy_string_t *pattern = fancy_string_create("[0-9]+");
+        fancy_string_pattern_t *compiled_pattern = fancy_string_pattern_create(pattern);
+        fancy_string_split_iter_t iter = fancy_string_split_iter_by_pattern(s, compiled_pattern, 1);
+        fancy_string_view_t component;
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 3 && memcmp(component.value, "one", 3) == 0);
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 13 && memcmp(component.value, "two22three333", 13) == 0);
+        assert(!fancy_string_split_iter_next(&iter, &component));
+        fancy_string_pattern_destroy(compiled_pattern);
+        fancy_string_destroy(pattern);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Splitting does not allocate (the memory in use stays the same from one component to the
+        // next), and the components point inside the string object.
+        fancy_string_t *s = fancy_string_create_empty();
+        for (size_t i = 0; i < 1000; i++)
+        {
+            fancy_string_append_value(s, "field, ");
+        }
+        fancy_string_t *pattern = fancy_string_create(", *");
+        fancy_string_pattern_t *compiled_patterns[2] = {
+            fancy_string_pattern_create(pattern),
+            fancy_string_pattern_create_with_engine(pattern, FANCY_STRING_REGEX_ENGINE_DFA),
+        };
+        for (size_t k = 0; k < 2; k++)
+        {
+            // NOTE: The DFA's states are built by the first search.
+            fancy_string_split_iter_t iter = fancy_string_split_iter_by_pattern(s, compiled_patterns[k], -1);
+            fancy_string_view_t component;
+            assert(fancy_string_split_iter_next(&iter, &component));
+            fancy_string_view_t view = fancy_string_view(s);
+            size_t memory_usage = fancy_string_memory_usage_get();
+            size_t n_components = 1;
+            while (fancy_string_split_iter_next(&iter, &component))
+            {
+                assert(fancy_string_memory_usage_get() == memory_usage);
+                assert(component.value >= view.value && component.value + component.n <= view.value + view.n);
+                n_components++;
+            }
+            assert(n_components == 1001);
+            assert(component.n == 0);
+        }
+        fancy_string_pattern_destroy(compiled_patterns[0]);
+        fancy_string_pattern_destroy(compiled_patterns[1]);
+        fancy_string_destroy(pattern);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_split_iter_next(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("key: value: more");
+        fancy_string_split_iter_t iter = fancy_string_split_iter(s, fancy_string_view_from_value(": "), -1);
+        fancy_string_view_t component = {.value = NULL, .n = 0};
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 3 && memcmp(component.value, "key", 3) == 0);
+        // NOTE: The views point inside the string object.
+        assert(component.value == fancy_string_view(s).value);
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 5 && memcmp(component.value, "value", 5) == 0);
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 4 && memcmp(component.value, "more", 4) == 0);
+        assert(!fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 4 && memcmp(component.value, "more", 4) == 0);
+        assert(!fancy_string_split_iter_next(&iter, &component));
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("a\0b", 3);
+        fancy_string_split_iter_t iter = fancy_string_split_iter(s, fancy_string_view_from_memory("\0", 1), -1);
+        fancy_string_view_t component;
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 1 && component.value[0] == 'a');
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(component.n == 1 && component.value[0] == 'b');
+        assert(!fancy_string_split_iter_next(&iter, &component));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_split_iter(void)
+{
+    LOG();
+    {
+        // NOTE: The components are the same as those returned by `fancy_string_split`.
+        char const *values[] = {"a,b,,c", ",a,", "", "abc", ",,,"};
+        ssize_t n_max_splits[] = {-1, 0, 1, 2, 10};
+        fancy_string_t *separator = fancy_string_create(",");
+        for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++)
+        {
+            for (size_t j = 0; j < sizeof(n_max_splits) / sizeof(n_max_splits[0]); j++)
+            {
+                fancy_string_t *s = fancy_string_create(values[i]);
+                fancy_string_array_t *a = fancy_string_split(s, separator, n_max_splits[j]);
+                fancy_string_split_iter_t iter = fancy_string_split_iter(s, fancy_string_view(separator), n_max_splits[j]);
+                fancy_string_view_t component;
+                size_t n_components = 0;
+                while (fancy_string_split_iter_next(&iter, &component))
+                {
+                    fancy_string_t *expected = fancy_string_array_get(a, n_components);
+                    assert(fancy_string_equals_view(expected, component));
+                    fancy_string_destroy(expected);
+                    n_components++;
+                }
+                assert(n_components == fancy_string_array_size(a));
+                fancy_string_array_destroy(a);
+                fancy_string_destroy(s);
+            }
+        }
+        fancy_string_destroy(separator);
+    }
+    {
+        // NOTE: An empty separator gives the whole string.
+        fancy_string_t *s = fancy_string_create("one two");
+        fancy_string_split_iter_t iter = fancy_string_split_iter(s, fancy_string_view_from_value(""), -1);
+        fancy_string_view_t component;
+        assert(fancy_string_split_iter_next(&iter, &component));
+        assert(fancy_string_equals_view(s, component));
+        assert(!fancy_string_split_iter_next(&iter, &component));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_multi_replaced(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("cat", "dog", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_array_t *replacements = fancy_string_array_create_with_values("dog", "cat", NULL);
+        fancy_string_t *s = fancy_string_create("cat chases dog");
+        fancy_string_t *replaced = fancy_string_multi_replaced(s, matcher, replacements);
+        assert(fancy_string_equals_value(replaced, "dog chases cat"));
+        assert(fancy_string_equals_value(s, "cat chases dog"));
+        fancy_string_destroy(replaced);
+        fancy_string_array_push_value(replacements, "bird");
+        assert(fancy_string_multi_replaced(s, matcher, replacements) == NULL);
+        fancy_string_destroy(s);
+        fancy_string_array_destroy(replacements);
+        fancy_string_array_destroy(needles);
+        fancy_string_multi_matcher_destroy(matcher);
+    }
+}
+
+void test_fancy_string_multi_replace(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("ab", "abcd", "cd", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_array_t *replacements = fancy_string_array_create_with_values("1", "2", "3", NULL);
+        fancy_string_t *s = fancy_string_create("abcdcd ab abc");
+        assert(fancy_string_multi_replace(s, matcher, replacements) == 4);
+        assert(fancy_string_equals_value(s, "23 1 1c"));
+        fancy_string_destroy(s);
+        fancy_string_array_destroy(replacements);
+        fancy_string_array_destroy(needles);
+        fancy_string_multi_matcher_destroy(matcher);
+    }
+    {
+        // NOTE: A single replacement is used for all the needles, and a wrongly sized array is rejected.
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("password=hunter2", "4111-1111", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_array_t *replacements = fancy_string_array_create_with_values("[redacted]", NULL);
+        fancy_string_t *s = fancy_string_create("user=bob password=hunter2 card=4111-1111 (this line is long enough to live on the heap)");
+        assert(fancy_string_multi_replace(s, matcher, replacements) == 2);
+        assert(fancy_string_equals_value(s, "user=bob [redacted] card=[redacted] (this line is long enough to live on the heap)"));
+        assert(fancy_string_multi_replace(s, matcher, replacements) == 0);
+        fancy_string_array_push_value(replacements, "a");
+        fancy_string_array_push_value(replacements, "b");
+        assert(fancy_string_multi_replace(s, matcher, replacements) == -1);
+        assert(fancy_string_equals_value(s, "user=bob [redacted] card=[redacted] (this line is long enough to live on the heap)"));
+        fancy_string_destroy(s);
+        fancy_string_array_destroy(replacements);
+        fancy_string_array_destroy(needles);
+        fancy_string_multi_matcher_destroy(matcher);
+    }
+    {
+        // NOTE: Compares the result against a naive implementation (i.e., at each position, the longest
+        // needle that matches there, if any, gets replaced), on random needles and strings.
+        srand(13);
+        for (size_t round = 0; round < 500; round++)
+        {
+            fancy_string_array_t *needles = fancy_string_array_create();
+            fancy_string_array_t *replacements = fancy_string_array_create();
+            size_t n_needles = 1 + (size_t)rand() % 6;
+            for (size_t i = 0; i < n_needles; i++)
+            {
+                char needle[4];
+                size_t n_needle = 1 + (size_t)rand() % sizeof(needle);
+                for (size_t j = 0; j < n_needle; j++)
+                {
+                    needle[j] = "abc"[rand() % 3];
+                }
+                fancy_string_array_push_value_n(needles, needle, n_needle);
+                char replacement[2] = {(char)('0' + i), '\0'};
+                fancy_string_array_push_value_n(replacements, replacement, (size_t)rand() % 2);
+            }
+            char value[64];
+            size_t n_value = (size_t)rand() % sizeof(value);
+            for (size_t i = 0; i < n_value; i++)
+            {
+                value[i] = "abcd"[rand() % 4];
+            }
+
+            fancy_string_t *expected = fancy_string_create_empty();
+            size_t expected_count = 0;
+            for (size_t i = 0; i < n_value;)
+            {
+                ssize_t best = -1;
+                size_t n_best = 0;
+                for (size_t k = 0; k < n_needles; k++)
+                {
+                    fancy_string_t *needle = fancy_string_array_get(needles, k);
+                    fancy_string_view_t view = fancy_string_view(needle);
+                    if (view.n > n_best && view.n <= n_value - i && memcmp(&value[i], view.value, view.n) == 0)
+                    {
+                        best = (ssize_t)k;
+                        n_best = view.n;
+                    }
+                    fancy_string_destroy(needle);
+                }
+                if (best == -1)
+                {
+                    fancy_string_append_value_n(expected, &value[i], 1);
+                    i++;
+                    continue;
+                }
+                fancy_string_t *replacement = fancy_string_array_get(replacements, (size_t)best);
+                fancy_string_append(expected, replacement);
+                fancy_string_destroy(replacement);
+                expected_count++;
+                i += n_best;
+            }
+
+            fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+            fancy_string_t *s = fancy_string_from_copied_memory(value, n_value);
+            fancy_string_t *replaced = fancy_string_multi_replaced(s, matcher, replacements);
+            assert(fancy_string_multi_replace(s, matcher, replacements) == (ssize_t)expected_count);
+            assert(fancy_string_equals(s, expected));
+            assert(fancy_string_equals(replaced, expected));
+            fancy_string_destroy(replaced);
+            fancy_string_destroy(s);
+            fancy_string_multi_matcher_destroy(matcher);
+            fancy_string_destroy(expected);
+            fancy_string_array_destroy(replacements);
+            fancy_string_array_destroy(needles);
+        }
+    }
+}
+
+typedef struct test_fancy_string_multi_matcher_record_s
+{
+    size_t n;
+    size_t n_max;
+    size_t needle_index[16];
+    size_t start[16];
+    size_t end[16];
+} test_fancy_string_multi_matcher_record_t;
+
+static bool test_fancy_string_multi_matcher_find_all_callback(fancy_string_multi_matcher_t const *const matcher, size_t needle_index, size_t start, size_t end, void *context)
+{
+    test_fancy_string_multi_matcher_record_t *record = context;
+    assert(end - start == fancy_string_multi_matcher_needle(matcher, needle_index).n);
+    record->needle_index[record->n] = needle_index;
+    record->start[record->n] = start;
+    record->end[record->n] = end;
+    record->n++;
+    return record->n < record->n_max;
+}
+
+void test_fancy_string_multi_matcher_find_all_in_stream(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("secret", "token", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_array_destroy(needles);
+        // NOTE: The stream is larger than the internal block, such that a match straddles two blocks.
+        size_t n_data = 3 * 65536;
+        char *data = malloc(n_data);
+        memset(data, '.', n_data);
+        memcpy(&data[10], "token", 5);
+        memcpy(&data[65536 - 3], "secret", 6);
+        memcpy(&data[n_data - 6], "secret", 6);
+        FILE *stream = fmemopen(data, n_data, "r");
+        test_fancy_string_multi_matcher_record_t record = {.n_max = 16};
+        assert(fancy_string_multi_matcher_find_all_in_stream(matcher, stream, test_fancy_string_multi_matcher_find_all_callback, &record) == 3);
+        assert(record.needle_index[0] == 1 && record.start[0] == 10);
+        assert(record.needle_index[1] == 0 && record.start[1] == 65536 - 3 && record.end[1] == 65536 + 3);
+        assert(record.needle_index[2] == 0 && record.end[2] == n_data);
+        fclose(stream);
+        free(data);
+        fancy_string_multi_matcher_destroy(matcher);
+    }
+}
+
+void test_fancy_string_multi_matcher_find_all(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("he", "she", "his", "hers", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        test_fancy_string_multi_matcher_record_t record = {.n_max = 16};
+        assert(fancy_string_multi_matcher_find_all(matcher, fancy_string_view_from_value("ushers"), test_fancy_string_multi_matcher_find_all_callback, &record) == 3);
+        assert(record.n == 3);
+        assert(record.needle_index[0] == 1 && record.start[0] == 1 && record.end[0] == 4);
+        assert(record.needle_index[1] == 0 && record.start[1] == 2 && record.end[1] == 4);
+        assert(record.needle_index[2] == 3 && record.start[2] == 2 && record.end[2] == 6);
+        fancy_string_multi_matcher_destroy(matcher);
+        fancy_string_array_destroy(needles);
+    }
+    {
+        // NOTE: The search stops as soon as the callback returns `false`.
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("a", "aa", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        test_fancy_string_multi_matcher_record_t record = {.n_max = 2};
+        assert(fancy_string_multi_matcher_find_all(matcher, fancy_string_view_from_value("aaaa"), test_fancy_string_multi_matcher_find_all_callback, &record) == 2);
+        assert(record.needle_index[0] == 0 && record.start[0] == 0);
+        assert(record.needle_index[1] == 1 && record.start[1] == 0 && record.end[1] == 2);
+        assert(fancy_string_multi_matcher_find_all(matcher, fancy_string_view_from_value("aaaa"), NULL, NULL) == 7);
+        fancy_string_multi_matcher_destroy(matcher);
+        fancy_string_array_destroy(needles);
+    }
+}
+
+void test_fancy_string_multi_matcher_needle(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("first", "", "third", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_array_destroy(needles);
+        assert(fancy_string_view_equals(fancy_string_multi_matcher_needle(matcher, 0), fancy_string_view_from_value("first")));
+        assert(fancy_string_multi_matcher_needle(matcher, 1).n == 0);
+        assert(fancy_string_view_equals(fancy_string_multi_matcher_needle(matcher, 2), fancy_string_view_from_value("third")));
+        assert(fancy_string_multi_matcher_needle(matcher, 3).n == 0);
+        fancy_string_multi_matcher_destroy(matcher);
+    }
+}
+
+void test_fancy_string_multi_matcher_size(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("a", "a", "", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        assert(fancy_string_multi_matcher_size(matcher) == 3);
+        fancy_string_multi_matcher_destroy(matcher);
+        fancy_string_array_destroy(needles);
+    }
+}
+
+void test_fancy_string_multi_matcher_destroy(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("a", "b", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_multi_matcher_destroy(matcher);
+        fancy_string_array_destroy(needles);
+    }
+}
+
+void test_fancy_string_multi_matcher_create(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *needles = fancy_string_array_create_with_values("he", "she", "his", "hers", NULL);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        fancy_string_array_destroy(needles);
+        assert(fancy_string_multi_matcher_size(matcher) == 4);
+        assert(fancy_string_multi_matcher_find_all(matcher, fancy_string_view_from_value("ushers"), NULL, NULL) == 3);
+        fancy_string_multi_matcher_destroy(matcher);
+    }
+    {
+        fancy_string_array_t *needles = fancy_string_array_create();
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        assert(fancy_string_multi_matcher_size(matcher) == 0);
+        assert(fancy_string_multi_matcher_find_all(matcher, fancy_string_view_from_value("abc"), NULL, NULL) == 0);
+        fancy_string_multi_matcher_destroy(matcher);
+        fancy_string_array_destroy(needles);
+    }
+    {
+        // NOTE: Empty needles never match, and needles may contain null characters.
+        fancy_string_array_t *needles = fancy_string_array_create();
+        fancy_string_array_push_value(needles, "");
+        fancy_string_array_push_value_n(needles, "a\0b", 3);
+        fancy_string_multi_matcher_t *matcher = fancy_string_multi_matcher_create(needles);
+        assert(fancy_string_multi_matcher_find_all(matcher, fancy_string_view_from_memory("xa\0ba\0b", 7), NULL, NULL) == 2);
+        fancy_string_multi_matcher_destroy(matcher);
+        fancy_string_array_destroy(needles);
+    }
+}
+
+void test_fancy_string_last_index_of(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("/usr/local/lib");
+        fancy_string_t *slash = fancy_string_create("/");
+        fancy_string_t *missing = fancy_string_create("\\");
+        assert(fancy_string_last_index_of(s, slash) == 10);
+        assert(fancy_string_last_index_of(s, missing) == -1);
+        assert(fancy_string_last_index_of(s, s) == 0);
+        fancy_string_destroy(missing);
+        fancy_string_destroy(slash);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_last_index_of_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("one, two, three");
+        assert(fancy_string_last_index_of_view(s, fancy_string_view_from_value(", ")) == 8);
+        assert(fancy_string_last_index_of_view(s, fancy_string_view_from_memory(", four", 2)) == 8);
+        assert(fancy_string_last_index_of_view(s, fancy_string_view_from_value("four")) == -1);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_last_index_of_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("a\0b\0a\0b", 7);
+        assert(fancy_string_last_index_of_value_n(s, "\0", 1) == 5);
+        assert(fancy_string_last_index_of_value_n(s, FANCY_STRING_LIT("a\0")) == 4);
+        assert(fancy_string_last_index_of_value_n(s, "b\0c", 2) == 2);
+        assert(fancy_string_last_index_of_value_n(s, "b\0c", 3) == -1);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_last_index_of_value(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("This is a test.");
+        assert(fancy_string_last_index_of_value(s, "Hello") == -1);
+        assert(fancy_string_last_index_of_value(s, "This") == 0);
+        assert(fancy_string_last_index_of_value(s, "is") == 5);
+        assert(fancy_string_last_index_of_value(s, "t") == 13);
+        assert(fancy_string_last_index_of_value(s, ".") == 14);
+        assert(fancy_string_last_index_of_value(s, "This is a test.") == 0);
+        assert(fancy_string_last_index_of_value(s, "This is a test..") == -1);
+        assert(fancy_string_last_index_of_value(s, "") == -1);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Long enough for the SIMD kernels to go through a few blocks.
+        fancy_string_t *s = fancy_string_create_repeat("key=value;", 19);
+        assert(fancy_string_last_index_of_value(s, "key=") == 190);
+        assert(fancy_string_last_index_of_value(s, ";key") == 189);
+        assert(fancy_string_last_index_of_value(s, "value;key=value;") == 184);
+        assert(fancy_string_last_index_of_value(s, "value;value") == -1);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_searcher_count(void)
+{
+    LOG();
+    {
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("aa"));
+        assert(fancy_string_searcher_count(searcher, fancy_string_view_from_value("aaaaa")) == 2);
+        assert(fancy_string_searcher_count(searcher, fancy_string_view_from_value("abab")) == 0);
+        fancy_string_searcher_destroy(searcher);
+    }
+    {
+        fancy_string_t *s = fancy_string_create("<tag></tag><tag></tag>");
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("</tag>"));
+        assert(fancy_string_searcher_count(searcher, fancy_string_view(s)) == 2);
+        fancy_string_searcher_destroy(searcher);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_searcher_find_last(void)
+{
+    LOG();
+    {
+        fancy_string_view_t haystack = fancy_string_view_from_value("separator, separator, separator!");
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("separator"));
+        assert(fancy_string_searcher_find_last(searcher, haystack) == 22);
+        assert(fancy_string_searcher_find_last(searcher, fancy_string_view_from_value("separato")) == -1);
+        fancy_string_searcher_destroy(searcher);
+    }
+    {
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("a"));
+        assert(fancy_string_searcher_find_last(searcher, fancy_string_view_from_value("banana")) == 5);
+        assert(fancy_string_searcher_find_last(searcher, fancy_string_view_from_value("a")) == 0);
+        assert(fancy_string_searcher_find_last(searcher, fancy_string_view_from_value("")) == -1);
+        fancy_string_searcher_destroy(searcher);
+    }
+}
+
+void test_fancy_string_searcher_find_from(void)
+{
+    LOG();
+    {
+        fancy_string_view_t haystack = fancy_string_view_from_value("abc--abc--abc");
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("abc"));
+        assert(fancy_string_searcher_find_from(searcher, haystack, 0) == 0);
+        assert(fancy_string_searcher_find_from(searcher, haystack, 1) == 5);
+        assert(fancy_string_searcher_find_from(searcher, haystack, 6) == 10);
+        assert(fancy_string_searcher_find_from(searcher, haystack, 11) == -1);
+        assert(fancy_string_searcher_find_from(searcher, haystack, 100) == -1);
+        fancy_string_searcher_destroy(searcher);
+    }
+    {
+        fancy_string_view_t haystack = fancy_string_view_from_value("separator, separator, separator");
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("separator"));
+        assert(fancy_string_searcher_find_from(searcher, haystack, 1) == 11);
+        assert(fancy_string_searcher_find_from(searcher, haystack, 22) == 22);
+        assert(fancy_string_searcher_find_from(searcher, haystack, 23) == -1);
+        fancy_string_searcher_destroy(searcher);
+    }
+}
+
+void test_fancy_string_searcher_find(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("the quick brown fox jumps over the lazy dog");
+        fancy_string_searcher_t *short_searcher = fancy_string_searcher_create(fancy_string_view_from_value("the"));
+        fancy_string_searcher_t *long_searcher = fancy_string_searcher_create(fancy_string_view_from_value("over the lazy"));
+        fancy_string_searcher_t *missing_searcher = fancy_string_searcher_create(fancy_string_view_from_value("over the lazy cat"));
+        assert(fancy_string_searcher_find(short_searcher, fancy_string_view(s)) == 0);
+        assert(fancy_string_searcher_find(long_searcher, fancy_string_view(s)) == 26);
+        assert(fancy_string_searcher_find(missing_searcher, fancy_string_view(s)) == -1);
+        assert(fancy_string_searcher_find(long_searcher, fancy_string_view_from_value("over")) == -1);
+        fancy_string_searcher_destroy(missing_searcher);
+        fancy_string_searcher_destroy(long_searcher);
+        fancy_string_searcher_destroy(short_searcher);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Binary-safe, for both short and long needles.
+        fancy_string_view_t haystack = fancy_string_view_from_memory(FANCY_STRING_LIT("x\0\0\0\0\0\0\0\0\0y\0\0\0\0\0\0\0\0z"));
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_memory(FANCY_STRING_LIT("\0\0\0\0\0\0\0\0z")));
+        assert(fancy_string_searcher_find(searcher, haystack) == 11);
+        fancy_string_searcher_destroy(searcher);
+    }
+    {
+        // NOTE: Compares against a naive search, over an alphabet small enough to produce
+        // many partial matches.
+        srand(42);
+        char haystack[512];
+        char needle[24];
+        for (size_t round = 0; round < 200; round++)
+        {
+            size_t n = (size_t)rand() % sizeof(haystack);
+            size_t n_needle = 1 + (size_t)rand() % sizeof(needle);
+            for (size_t i = 0; i < n; i++)
+            {
+                haystack[i] = "ab"[rand() % 2];
+            }
+            for (size_t i = 0; i < n_needle; i++)
+            {
+                needle[i] = "ab"[rand() % 2];
+            }
+            ssize_t expected_first = -1;
+            ssize_t expected_last = -1;
+            for (size_t i = 0; i + n_needle <= n; i++)
+            {
+                if (memcmp(&haystack[i], needle, n_needle) == 0)
+                {
+                    expected_first = expected_first == -1 ? (ssize_t)i : expected_first;
+                    expected_last = (ssize_t)i;
+                }
+            }
+            fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_memory(needle, n_needle));
+            assert(fancy_string_searcher_find(searcher, fancy_string_view_from_memory(haystack, n)) == expected_first);
+            assert(fancy_string_searcher_find_last(searcher, fancy_string_view_from_memory(haystack, n)) == expected_last);
+            fancy_string_searcher_destroy(searcher);
+        }
+    }
+}
+
+void test_fancy_string_searcher_needle(void)
+{
+    LOG();
+    {
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_memory(FANCY_STRING_LIT("a\0b")));
+        fancy_string_view_t needle = fancy_string_searcher_needle(searcher);
+        assert(fancy_string_view_equals(needle, fancy_string_view_from_memory(FANCY_STRING_LIT("a\0b"))));
+        fancy_string_searcher_destroy(searcher);
+    }
+}
+
+void test_fancy_string_searcher_destroy(void)
+{
+    LOG();
+    {
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value("abc"));
+        fancy_string_searcher_destroy(searcher);
+    }
+}
+
+void test_fancy_string_searcher_create(void)
+{
+    LOG();
+    {
+        char needle[] = "needle";
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value(needle));
+        // NOTE: The needle is copied.
+        needle[0] = 'x';
+        assert(fancy_string_searcher_find(searcher, fancy_string_view_from_value("a needle")) == 2);
+        fancy_string_searcher_destroy(searcher);
+    }
+    {
+        fancy_string_searcher_t *searcher = fancy_string_searcher_create(fancy_string_view_from_value(""));
+        assert(fancy_string_searcher_find(searcher, fancy_string_view_from_value("abc")) == -1);
+        assert(fancy_string_searcher_find_last(searcher, fancy_string_view_from_value("abc")) == -1);
+        assert(fancy_string_searcher_count(searcher, fancy_string_view_from_value("abc")) == 0);
+        fancy_string_searcher_destroy(searcher);
+    }
+}
+
+void test_fancy_string_array_is_shared(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create();
+        assert(!fancy_string_array_is_shared(a));
+        fancy_string_array_share(a);
+        assert(fancy_string_array_is_shared(a));
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_array_share(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create_with_values("first", "second", NULL);
+        fancy_string_array_share(a);
+        fancy_string_array_push_value(a, "third");
+        fancy_string_t *fourth = fancy_string_create("fourth");
+        fancy_string_array_insert(a, fourth, 0);
+        fancy_string_destroy(fourth);
+        assert(fancy_string_array_size(a) == 4);
+
+        fancy_string_t *first = fancy_string_array_first(a);
+        fancy_string_t *second = fancy_string_array_get(a, 2);
+        fancy_string_t *last = fancy_string_array_last(a);
+        assert(fancy_string_is_shared(first) && fancy_string_equals_value(first, "fourth"));
+        assert(fancy_string_is_shared(second) && fancy_string_equals_value(second, "second"));
+        assert(fancy_string_is_shared(last) && fancy_string_equals_value(last, "third"));
+
+        // NOTE: Mutating a retrieved element does not affect the array.
+        fancy_string_append_value(second, "!");
+        fancy_string_t *second_again = fancy_string_array_get(a, 2);
+        assert(fancy_string_equals_value(second_again, "second"));
+
+        fancy_string_array_t *clone = fancy_string_array_clone(a);
+        assert(fancy_string_array_is_shared(clone));
+        fancy_string_array_destroy(a);
+        fancy_string_t *clone_first = fancy_string_array_first(clone);
+        assert(fancy_string_equals_value(clone_first, "fourth"));
+
+        fancy_string_destroy(clone_first);
+        fancy_string_array_destroy(clone);
+        fancy_string_destroy(second_again);
+        fancy_string_destroy(last);
+        fancy_string_destroy(second);
+        fancy_string_destroy(first);
+    }
+}
+
+void test_fancy_string_is_shared(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello");
+        assert(!fancy_string_is_shared(s));
+        fancy_string_t *clone = fancy_string_clone(s);
+        assert(!fancy_string_is_shared(clone));
+        fancy_string_destroy(clone);
+        fancy_string_share(s);
+        assert(fancy_string_is_shared(s));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_share(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello world");
+        fancy_string_share(s);
+        assert(fancy_string_is_shared(s));
+        assert(!fancy_string_is_mapped(s));
+        assert(fancy_string_equals_value(s, "hello world"));
+        fancy_string_t *clone = fancy_string_clone(s);
+        assert(fancy_string_is_shared(clone));
+        assert(fancy_string_view(clone).value == fancy_string_view(s).value);
+        // NOTE: Mutating the clone makes it copy the shared buffer first.
+        fancy_string_append_value(clone, "!");
+        assert(!fancy_string_is_shared(clone));
+        assert(fancy_string_equals_value(clone, "hello world!"));
+        assert(fancy_string_equals_value(s, "hello world"));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: The shared buffer outlives the string object that created it.
+        fancy_string_t *s = fancy_string_create("hello world");
+        fancy_string_share(s);
+        fancy_string_t *clone = fancy_string_clone(s);
+        fancy_string_destroy(s);
+        assert(fancy_string_equals_value(clone, "hello world"));
+        fancy_string_destroy(clone);
+    }
+    {
+        fancy_string_t *s = fancy_string_create("  Hello  ");
+        fancy_string_share(s);
+        fancy_string_t *clone = fancy_string_clone(s);
+        fancy_string_trim(s);
+        fancy_string_lowercase(clone);
+        assert(fancy_string_equals_value(s, "Hello"));
+        assert(fancy_string_equals_value(clone, "  hello  "));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_create("a-b");
+        fancy_string_share(s);
+        fancy_string_t *clone = fancy_string_clone(s);
+        fancy_string_replace_value(clone, "-", "+", -1);
+        fancy_string_prepend_value(s, ">");
+        assert(fancy_string_equals_value(clone, "a+b"));
+        assert(fancy_string_equals_value(s, ">a-b"));
+        fancy_string_clear(clone);
+        assert(fancy_string_is_empty(clone));
+        assert(!fancy_string_is_shared(clone));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_create("");
+        fancy_string_share(s);
+        fancy_string_share(s);
+        assert(fancy_string_is_shared(s));
+        assert(fancy_string_is_empty(s));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_line_reader_next_view(void)
+{
+    LOG();
+    {
+        char *data = "name = first\nvalue = second\n";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_view_t line;
+        assert(fancy_string_line_reader_next_view(reader, &line));
+        ssize_t index = fancy_string_view_index_of(line, fancy_string_view_from_value("="));
+        assert(index == 5);
+        fancy_string_view_t key = fancy_string_view_trimmed(fancy_string_view_substring(line, -1, index));
+        fancy_string_view_t value = fancy_string_view_trimmed(fancy_string_view_substring(line, index + 1, -1));
+        assert(fancy_string_view_equals(key, fancy_string_view_from_value("name")));
+        assert(fancy_string_view_equals(value, fancy_string_view_from_value("first")));
+        assert(fancy_string_line_reader_next_view(reader, &line));
+        assert(fancy_string_view_equals(line, fancy_string_view_from_value("value = second")));
+        assert(!fancy_string_line_reader_next_view(reader, &line));
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+}
+
+void test_fancy_string_contains_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello world");
+        assert(fancy_string_contains_view(s, fancy_string_view_from_value("lo w")));
+        assert(!fancy_string_contains_view(s, fancy_string_view_from_value("low")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_index_of_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello world");
+        assert(fancy_string_index_of_view(s, fancy_string_view_from_value("o")) == 4);
+        assert(fancy_string_index_of_view(s, fancy_string_view_from_value("world")) == 6);
+        assert(fancy_string_index_of_view(s, fancy_string_view_from_value("x")) == -1);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_ends_with_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello world");
+        assert(fancy_string_ends_with_view(s, fancy_string_view_from_value("world")));
+        assert(!fancy_string_ends_with_view(s, fancy_string_view_from_value("hello")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_starts_with_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello world");
+        assert(fancy_string_starts_with_view(s, fancy_string_view_from_value("hello")));
+        assert(!fancy_string_starts_with_view(s, fancy_string_view_from_value("world")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_equals_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello");
+        assert(fancy_string_equals_view(s, fancy_string_view_from_memory("hello world", 5)));
+        assert(!fancy_string_equals_view(s, fancy_string_view_from_memory("hello world", 6)));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_view_index_of(void)
+{
+    LOG();
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("key=value");
+        assert(fancy_string_view_index_of(view, fancy_string_view_from_value("=")) == 3);
+        assert(fancy_string_view_index_of(view, fancy_string_view_from_value("value")) == 4);
+        assert(fancy_string_view_index_of(view, fancy_string_view_from_value("x")) == -1);
+    }
+    {
+        fancy_string_view_t view = fancy_string_view_from_memory(FANCY_STRING_LIT("a\0b\0c"));
+        assert(fancy_string_view_index_of(view, fancy_string_view_from_memory(FANCY_STRING_LIT("\0c"))) == 3);
+    }
+}
+
+void test_fancy_string_view_ends_with(void)
+{
+    LOG();
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("key=value");
+        assert(fancy_string_view_ends_with(view, fancy_string_view_from_value("value")));
+        assert(!fancy_string_view_ends_with(view, fancy_string_view_from_value("key")));
+        assert(!fancy_string_view_ends_with(view, fancy_string_view_from_value("!key=value")));
+    }
+}
+
+void test_fancy_string_view_starts_with(void)
+{
+    LOG();
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("key=value");
+        assert(fancy_string_view_starts_with(view, fancy_string_view_from_value("key")));
+        assert(!fancy_string_view_starts_with(view, fancy_string_view_from_value("value")));
+        assert(!fancy_string_view_starts_with(view, fancy_string_view_from_value("key=value!")));
+    }
+}
+
+void test_fancy_string_view_equals(void)
+{
+    LOG();
+    {
+        assert(fancy_string_view_equals(fancy_string_view_from_value("abc"), fancy_string_view_from_memory("abcdef", 3)));
+        assert(!fancy_string_view_equals(fancy_string_view_from_value("abc"), fancy_string_view_from_value("abd")));
+        assert(!fancy_string_view_equals(fancy_string_view_from_value("abc"), fancy_string_view_from_value("ab")));
+        assert(fancy_string_view_equals(fancy_string_view_from_value(""), fancy_string_view_from_value("")));
+    }
+}
+
+void test_fancy_string_trimmed_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("  hello  ");
+        fancy_string_view_t trimmed = fancy_string_trimmed_view(s);
+        assert(fancy_string_view_equals(trimmed, fancy_string_view_from_value("hello")));
+        // NOTE: The string object itself is left untouched.
+        assert(fancy_string_equals_value(s, "  hello  "));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_view_trimmed(void)
+{
+    LOG();
+    {
+        fancy_string_view_t view = fancy_string_view_from_value(" \t hello world \n");
+        fancy_string_view_t trimmed = fancy_string_view_trimmed(view);
+        assert(trimmed.value == &view.value[3]);
+        assert(fancy_string_view_equals(trimmed, fancy_string_view_from_value("hello world")));
+    }
+    {
+        fancy_string_view_t view = fancy_string_view_from_value(" \t \n");
+        assert(fancy_string_view_trimmed(view).n == 0);
+    }
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("");
+        assert(fancy_string_view_trimmed(view).n == 0);
+    }
+}
+
+void test_fancy_string_view_substring(void)
+{
+    LOG();
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("Hello World!");
+        fancy_string_view_t substring = fancy_string_view_substring(view, 6, 11);
+        assert(substring.n == 5);
+        assert(substring.value == &view.value[6]);
+        assert(fancy_string_view_equals(substring, fancy_string_view_from_value("World")));
+    }
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("Hello World!");
+        assert(fancy_string_view_equals(fancy_string_view_substring(view, -1, 5), fancy_string_view_from_value("Hello")));
+        assert(fancy_string_view_equals(fancy_string_view_substring(view, 6, -1), fancy_string_view_from_value("World!")));
+        assert(fancy_string_view_equals(fancy_string_view_substring(view, 5, 0), fancy_string_view_from_value("Hello")));
+        assert(fancy_string_view_equals(fancy_string_view_substring(view, 6, 100), fancy_string_view_from_value("World!")));
+        assert(fancy_string_view_substring(view, 100, 200).n == 0);
+        assert(fancy_string_view_substring(view, 3, 3).n == 0);
+    }
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("");
+        assert(fancy_string_view_substring(view, -1, -1).n == 0);
+    }
+}
+
+void test_fancy_string_from_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_from_view(fancy_string_view_from_memory("hello world", 5));
+        assert(fancy_string_equals_value(s, "hello"));
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_from_view(fancy_string_view_from_memory(FANCY_STRING_LIT("a\0b")));
+        assert(fancy_string_size(s) == 3);
+        assert(fancy_string_equals_value_n(s, FANCY_STRING_LIT("a\0b")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_view_from_memory(void)
+{
+    LOG();
+    {
+        char const data[] = {'a', '\0', 'b'};
+        fancy_string_view_t view = fancy_string_view_from_memory(data, sizeof(data));
+        assert(view.n == 3);
+        assert(view.value == data);
+    }
+}
+
+void test_fancy_string_view_from_value(void)
+{
+    LOG();
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("hello");
+        assert(view.n == 5);
+        assert(memcmp(view.value, "hello", 5) == 0);
+    }
+    {
+        fancy_string_view_t view = fancy_string_view_from_value("");
+        assert(view.n == 0);
+    }
+}
+
+void test_fancy_string_view(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello");
+        fancy_string_view_t view = fancy_string_view(s);
+        assert(view.n == 5);
+        assert(memcmp(view.value, "hello", 5) == 0);
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_create_empty();
+        fancy_string_view_t view = fancy_string_view(s);
+        assert(view.n == 0);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_array_includes_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create_with_values("a", "b", NULL);
+        assert(fancy_string_array_includes_value_n(a, "bc", 1));
+        assert(!fancy_string_array_includes_value_n(a, "bc", 2));
+        assert(fancy_string_array_includes_value_n(a, FANCY_STRING_LIT("a")));
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_array_last_index_of_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create_with_values("a", "b", "a", NULL);
+        assert(fancy_string_array_last_index_of_value_n(a, "ab", 1) == 2);
+        assert(fancy_string_array_last_index_of_value_n(a, "ab", 2) == -1);
+        assert(fancy_string_array_last_index_of_value_n(a, FANCY_STRING_LIT("b")) == 1);
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_array_index_of_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create_with_values("a", "b", "a", NULL);
+        assert(fancy_string_array_index_of_value_n(a, "ab", 1) == 0);
+        assert(fancy_string_array_index_of_value_n(a, "ab", 2) == -1);
+        assert(fancy_string_array_index_of_value_n(a, FANCY_STRING_LIT("b")) == 1);
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_array_join_by_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create_with_values("a", "b", "c", NULL);
+        fancy_string_t *joined = fancy_string_array_join_by_value_n(a, ", and so on", 2);
+        assert(fancy_string_equals_value(joined, "a, b, c"));
+        fancy_string_destroy(joined);
+        joined = fancy_string_array_join_by_value_n(a, FANCY_STRING_LIT("\0"));
+        assert(fancy_string_size(joined) == 5);
+        fancy_string_destroy(joined);
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_array_insert_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create_with_values("a", "c", NULL);
+        fancy_string_array_insert_value_n(a, "bbb", 1, 1);
+        fancy_string_array_insert_value_n(a, FANCY_STRING_LIT("e"), 4);
+        assert(fancy_string_array_size(a) == 5);
+        fancy_string_t *joined = fancy_string_array_join_by_value(a, "");
+        assert(fancy_string_equals_value(joined, "abce"));
+        fancy_string_destroy(joined);
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_array_push_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_array_t *a = fancy_string_array_create();
+        fancy_string_array_push_value_n(a, "abcdef", 3);
+        fancy_string_array_push_value_n(a, FANCY_STRING_LIT("x\0y"));
+        assert(fancy_string_array_size(a) == 2);
+        assert(fancy_string_array_index_of_value(a, "abc") == 0);
+        assert(fancy_string_array_index_of_value_n(a, FANCY_STRING_LIT("x\0y")) == 1);
+        fancy_string_array_destroy(a);
+    }
+}
+
+void test_fancy_string_replaced_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("one two three four");
+        fancy_string_t *r = fancy_string_replaced_value_n(s, FANCY_STRING_LIT("t"), FANCY_STRING_LIT("T"), -1);
+        assert(fancy_string_equals_value(r, "one Two Three four"));
+        assert(fancy_string_equals_value(s, "one two three four"));
+        fancy_string_destroy(r);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_replace_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("one two three four");
+        fancy_string_replace_value_n(s, "two!", 3, "2!", 1, -1);
+        assert(fancy_string_equals_value(s, "one 2 three four"));
+        fancy_string_replace_value_n(s, FANCY_STRING_LIT(" "), FANCY_STRING_LIT("_"), 2);
+        assert(fancy_string_equals_value(s, "one_2_three four"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: The values may live inside the string object's own buffer.
+        fancy_string_t *s = fancy_string_create("abcabc");
+        fancy_string_view_t view = fancy_string_view(s);
+        fancy_string_replace_value_n(s, view.value, 1, &view.value[1], 2, -1);
+        assert(fancy_string_equals_value(s, "bcbcbcbc"));
+        view = fancy_string_view(s);
+        fancy_string_replace_value_n(s, &view.value[1], 2, view.value, 1, -1);
+        assert(fancy_string_equals_value(s, "bbbbc"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: A shared value is copied before being modified, even when the result is shorter.
+        fancy_string_t *s = fancy_string_create("one, two, three");
+        fancy_string_share(s);
+        fancy_string_t *clone = fancy_string_clone(s);
+        fancy_string_replace_value_n(s, FANCY_STRING_LIT(", "), FANCY_STRING_LIT(","), -1);
+        assert(fancy_string_equals_value(s, "one,two,three"));
+        assert(fancy_string_equals_value(clone, "one, two, three"));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Compares the result against a naive implementation (i.e., occurrences are replaced from
+        // left to right, without overlapping), for new values that are shorter, as long as, and longer
+        // than the old ones.
+        srand(21);
+        for (size_t round = 0; round < 2000; round++)
+        {
+            char value[64];
+            char old_value[4];
+            char new_value[6];
+            size_t n_value = (size_t)rand() % sizeof(value);
+            size_t n_old_value = 1 + (size_t)rand() % sizeof(old_value);
+            size_t n_new_value = (size_t)rand() % sizeof(new_value);
+            ssize_t replace_n = (ssize_t)(rand() % 5) - 1;
+            for (size_t i = 0; i < n_value; i++)
+            {
+                value[i] = "ab\0"[rand() % 3];
+            }
+            for (size_t i = 0; i < n_old_value; i++)
+            {
+                old_value[i] = "ab\0"[rand() % 3];
+            }
+            for (size_t i = 0; i < n_new_value; i++)
+            {
+                new_value[i] = "xyab"[rand() % 4];
+            }
+
+            fancy_string_t *expected = fancy_string_create_empty();
+            ssize_t n_replacements = 0;
+            for (size_t i = 0; i < n_value;)
+            {
+                if ((replace_n == -1 || n_replacements < replace_n) && n_old_value <= n_value - i && memcmp(&value[i], old_value, n_old_value) == 0)
+                {
+                    fancy_string_append_value_n(expected, new_value, n_new_value);
+                    n_replacements++;
+                    i += n_old_value;
+                }
+                else
+                {
+                    fancy_string_append_value_n(expected, &value[i], 1);
+                    i++;
+                }
+            }
+
+            fancy_string_t *s = fancy_string_from_copied_memory(value, n_value);
+            fancy_string_replace_value_n(s, old_value, n_old_value, new_value, n_new_value, replace_n);
+            assert(fancy_string_equals(s, expected));
+            fancy_string_destroy(s);
+            fancy_string_destroy(expected);
+        }
+    }
+}
+
+void test_fancy_string_split_by_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("a, b, c");
+        fancy_string_array_t *a = fancy_string_split_by_value_n(s, FANCY_STRING_LIT(", "), -1);
+        assert(fancy_string_array_size(a) == 3);
+        assert(fancy_string_array_index_of_value(a, "c") == 2);
+        fancy_string_array_destroy(a);
+        a = fancy_string_split_by_value_n(s, ", ", 1, 1);
+        assert(fancy_string_array_size(a) == 2);
+        assert(fancy_string_array_index_of_value(a, " b, c") == 1);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Leading, trailing and consecutive separators give empty components.
+        fancy_string_t *s = fancy_string_create(",,a,,b,");
+        fancy_string_array_t *a = fancy_string_split_by_value_n(s, FANCY_STRING_LIT(","), -1);
+        assert(fancy_string_array_size(a) == 6);
+        assert(fancy_string_array_index_of_value(a, "a") == 2);
+        assert(fancy_string_array_index_of_value(a, "b") == 4);
+        fancy_string_t *last = fancy_string_array_get(a, 5);
+        assert(fancy_string_size(last) == 0);
+        fancy_string_destroy(last);
+        fancy_string_array_destroy(a);
+        // NOTE: More splits than there are separators.
+        a = fancy_string_split_by_value_n(s, FANCY_STRING_LIT(","), 100);
+        assert(fancy_string_array_size(a) == 6);
+        fancy_string_array_destroy(a);
+        a = fancy_string_split_by_value_n(s, FANCY_STRING_LIT(","), 3);
+        assert(fancy_string_array_size(a) == 4);
+        assert(fancy_string_array_index_of_value(a, ",b,") == 3);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Many components, such that the array has to grow several times.
+        fancy_string_t *s = fancy_string_create_repeat("field;", 999);
+        fancy_string_array_t *a = fancy_string_split_by_value_n(s, FANCY_STRING_LIT(";"), -1);
+        assert(fancy_string_array_size(a) == 1001);
+        assert(fancy_string_array_last_index_of_value(a, "field") == 999);
+        fancy_string_t *joined = fancy_string_array_join_by_value(a, ";");
+        assert(fancy_string_equals(joined, s));
+        fancy_string_destroy(joined);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_contains_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("This is a test");
+        assert(fancy_string_contains_value_n(s, "a test!", 6));
+        assert(!fancy_string_contains_value_n(s, "a test!", 7));
+        assert(!fancy_string_contains_value_n(s, FANCY_STRING_LIT("")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_index_of_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("This is a test");
+        assert(fancy_string_index_of_value_n(s, "test!", 4) == 10);
+        assert(fancy_string_index_of_value_n(s, "test!", 5) == -1);
+        assert(fancy_string_index_of_value_n(s, FANCY_STRING_LIT("is")) == 2);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Compares against a naive search, with haystack sizes that cover the edges of
+        // the (16- and 32-byte) blocks used by the SIMD kernels, and needles that are just
+        // below and above the size up to which those kernels are used.
+        srand(7);
+        char haystack[200];
+        char needle[40];
+        for (size_t round = 0; round < 2000; round++)
+        {
+            size_t n = (size_t)rand() % sizeof(haystack);
+            size_t n_needle = 1 + (size_t)rand() % sizeof(needle);
+            for (size_t i = 0; i < n; i++)
+            {
+                haystack[i] = "ab\0"[rand() % 3];
+            }
+            for (size_t i = 0; i < n_needle; i++)
+            {
+                needle[i] = "ab\0"[rand() % 3];
+            }
+            ssize_t expected_first = -1;
+            ssize_t expected_last = -1;
+            for (size_t i = 0; i + n_needle <= n; i++)
+            {
+                if (memcmp(&haystack[i], needle, n_needle) == 0)
+                {
+                    expected_first = expected_first == -1 ? (ssize_t)i : expected_first;
+                    expected_last = (ssize_t)i;
+                }
+            }
+            fancy_string_t *s = fancy_string_from_copied_memory(haystack, n);
+            assert(fancy_string_index_of_value_n(s, needle, n_needle) == expected_first);
+            assert(fancy_string_last_index_of_value_n(s, needle, n_needle) == expected_last);
+            fancy_string_destroy(s);
+        }
+    }
+}
+
+void test_fancy_string_ends_with_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("topic/a/b");
+        assert(fancy_string_ends_with_value_n(s, "/b/c", 2));
+        assert(!fancy_string_ends_with_value_n(s, "/b/c", 3));
+        assert(fancy_string_ends_with_value_n(s, FANCY_STRING_LIT("a/b")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_starts_with_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("topic/a/b");
+        assert(fancy_string_starts_with_value_n(s, "topic/x", 6));
+        assert(!fancy_string_starts_with_value_n(s, "topic/x", 7));
+        assert(fancy_string_starts_with_value_n(s, FANCY_STRING_LIT("topic/")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_equals_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("hello");
+        assert(fancy_string_equals_value_n(s, "hello world", 5));
+        assert(!fancy_string_equals_value_n(s, "hello world", 6));
+        assert(fancy_string_equals_value_n(s, FANCY_STRING_LIT("hello")));
+        assert(!fancy_string_equals_value_n(s, FANCY_STRING_LIT("hello\0")));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_prepend_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("World");
+        fancy_string_prepend_value_n(s, "Hello, there", 7);
+        assert(fancy_string_equals_value(s, "Hello, World"));
+        fancy_string_prepend_value_n(s, FANCY_STRING_LIT(""));
+        assert(fancy_string_equals_value(s, "Hello, World"));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_append_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("Hello");
+        fancy_string_append_value_n(s, ", World! Not this.", 8);
+        assert(fancy_string_equals_value(s, "Hello, World!"));
+        fancy_string_append_value_n(s, FANCY_STRING_LIT("\0"));
+        assert(fancy_string_size(s) == 14);
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_update_value_n(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("Hello");
+        fancy_string_update_value_n(s, "World!!!", 5);
+        assert(fancy_string_equals_value(s, "World"));
+        fancy_string_update_value_n(s, FANCY_STRING_LIT("a\0b"));
+        assert(fancy_string_size(s) == 3);
+        fancy_string_update_value_n(s, "", 0);
+        assert(fancy_string_is_empty(s));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_line_reader_offset(void)
+{
+    LOG();
+    {
+        char *data = "ab\r\ncde\n\nf";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        char const *value;
+        size_t n;
+        size_t offsets[] = {0, 4, 8, 9};
+        for (size_t i = 0; i < 4; i++)
+        {
+            assert(fancy_string_line_reader_next_borrowed(reader, &value, &n));
+            assert(fancy_string_line_reader_offset(reader) == offsets[i]);
+            assert(strncmp(&data[offsets[i]], value, n) == 0);
+        }
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+}
+
+void test_fancy_string_line_reader_line_number(void)
+{
+    LOG();
+    {
+        char *data = "a\nb\n\nc";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        char const *value;
+        size_t n;
+        size_t expected = 0;
+        while (fancy_string_line_reader_next_borrowed(reader, &value, &n))
+        {
+            expected += 1;
+            assert(fancy_string_line_reader_line_number(reader) == expected);
+        }
+        assert(expected == 4);
+        assert(fancy_string_line_reader_line_number(reader) == 4);
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+}
+
+void test_fancy_string_line_reader_next_borrowed(void)
+{
+    LOG();
+    {
+        char *data = "first\r\nsecond\n\r\nlast\r";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        char const *value;
+        size_t n;
+        assert(fancy_string_line_reader_next_borrowed(reader, &value, &n));
+        assert(n == 5 && strcmp(value, "first") == 0);
+        assert(fancy_string_line_reader_next_borrowed(reader, &value, &n));
+        assert(n == 6 && strcmp(value, "second") == 0);
+        assert(fancy_string_line_reader_next_borrowed(reader, &value, &n));
+        assert(n == 0 && strcmp(value, "") == 0);
+        // NOTE: A carriage return is only stripped when it is followed by a line feed.
+        assert(fancy_string_line_reader_next_borrowed(reader, &value, &n));
+        assert(n == 5 && strcmp(value, "last\r") == 0);
+        assert(!fancy_string_line_reader_next_borrowed(reader, &value, &n));
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+}
+
+void test_fancy_string_line_reader_next(void)
+{
+    LOG();
+    {
+        char *data = "This is a title\n\nThis is the first line.\r\nThis is another line.\n\nBye bye line.";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_array_t *a = fancy_string_array_create();
+        fancy_string_t *line = fancy_string_create_empty();
+        while (fancy_string_line_reader_next(reader, line))
+        {
+            fancy_string_array_push(a, line);
+        }
+        assert(fancy_string_array_size(a) == 6);
+        fancy_string_array_t *b = fancy_string_array_create_with_values("This is a title", "", "This is the first line.", "This is another line.", "", "Bye bye line.", NULL);
+        for (size_t i = 0; i < 6; i++)
+        {
+            fancy_string_t *x = fancy_string_array_get(a, i);
+            fancy_string_t *y = fancy_string_array_get(b, i);
+            assert(fancy_string_equals(x, y));
+            fancy_string_destroy(x);
+            fancy_string_destroy(y);
+        }
+        assert(fancy_string_equals_value(line, "Bye bye line."));
+        assert(!fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, "Bye bye line."));
+        fancy_string_array_destroy(a);
+        fancy_string_array_destroy(b);
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+    {
+        // NOTE: A trailing line break does not produce an extra empty line.
+        char *data = "a\n\nb\n";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_t *line = fancy_string_create_empty();
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, "a"));
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, ""));
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, "b"));
+        assert(!fancy_string_line_reader_next(reader, line));
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+    {
+        // NOTE: A line written to a pipe must be returned while the writer is still waiting,
+        // instead of blocking until a whole block has been written.
+        int fds[2];
+        assert(pipe(fds) == 0);
+        FILE *stream = fdopen(fds[0], "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_t *line = fancy_string_create_empty();
+        assert(write(fds[1], "first\nsec", 9) == 9);
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, "first"));
+        assert(write(fds[1], "ond\nthird", 9) == 9);
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, "second"));
+        close(fds[1]);
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_equals_value(line, "third"));
+        assert(!fancy_string_line_reader_next(reader, line));
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+    }
+    {
+        // NOTE: Reading the same file with `fancy_string_from_stream_next_line` must give the same lines.
+        FILE *file_pointer = fopen("./test/assets/big-text-file.txt", "r");
+        FILE *other_file_pointer = fopen("./test/assets/big-text-file.txt", "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(file_pointer);
+        fancy_string_t *line = fancy_string_create_empty();
+        size_t n_lines = 0;
+        while (fancy_string_line_reader_next(reader, line))
+        {
+            fancy_string_t *expected = fancy_string_from_stream_next_line(other_file_pointer);
+            assert(expected != NULL);
+            assert(fancy_string_equals(line, expected));
+            fancy_string_destroy(expected);
+            n_lines += 1;
+        }
+        assert(fancy_string_from_stream_next_line(other_file_pointer) == NULL);
+        assert(n_lines > 1);
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        fclose(file_pointer);
+        fclose(other_file_pointer);
+    }
+    {
+        // NOTE: Lines that are larger than the internal buffer.
+        size_t n = 200000;
+        char *data = malloc(sizeof(char) * (2 * n + 3));
+        memset(data, 'x', n);
+        data[n] = '\n';
+        memset(&data[n + 1], 'y', n);
+        data[2 * n + 1] = '\n';
+        data[2 * n + 2] = '\0';
+        FILE *stream = fmemopen(data, 2 * n + 2, "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_t *line = fancy_string_create_empty();
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_size(line) == n);
+        assert(fancy_string_ends_with_value(line, "xx"));
+        assert(fancy_string_line_reader_next(reader, line));
+        assert(fancy_string_size(line) == n);
+        assert(fancy_string_starts_with_value(line, "yy"));
+        assert(fancy_string_line_reader_offset(reader) == n + 1);
+        assert(!fancy_string_line_reader_next(reader, line));
+        fancy_string_destroy(line);
+        fancy_string_line_reader_destroy(reader);
+        fclose(stream);
+        free(data);
+    }
+}
+
+void test_fancy_string_line_reader_destroy(void)
+{
+    LOG();
+    {
+        char *data = "a\nb";
+        FILE *stream = fmemopen(data, strlen(data), "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(stream);
+        fancy_string_t *line = fancy_string_create_empty();
+        assert(fancy_string_line_reader_next(reader, line));
+        fancy_string_line_reader_destroy(reader);
+        fancy_string_destroy(line);
+        fclose(stream);
+    }
+}
+
+void test_fancy_string_line_reader_create(void)
+{
+    LOG();
+    {
+        FILE *file_pointer = fopen("./test/assets/multi-line-file.txt", "r");
+        fancy_string_line_reader_t *reader = fancy_string_line_reader_create(file_pointer);
+        assert(fancy_string_line_reader_line_number(reader) == 0);
+        assert(fancy_string_line_reader_offset(reader) == 0);
+        fancy_string_line_reader_destroy(reader);
+        // NOTE: The line reader does not close the stream.
+        assert(fgetc(file_pointer) != EOF);
+        fclose(file_pointer);
+    }
+}
+
+void test_fancy_string_is_mapped(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("Hello, World!");
+        assert(!fancy_string_is_mapped(s));
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_from_file_mapped("./test/assets/multi-line-file.txt", FANCY_STRING_MAP_ADVICE_RANDOM);
+        assert(fancy_string_is_mapped(s));
+        fancy_string_uppercase(s);
+        assert(!fancy_string_is_mapped(s));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_from_fd_mapped(void)
+{
+    LOG();
+    {
+        // NOTE: A file whose size is a multiple of the page size is the case where the
+        // mapping itself has no zero-filled padding after the file's content.
+        long page_size = sysconf(_SC_PAGESIZE);
+        FILE *stream = tmpfile();
+        assert(stream != NULL);
+        for (long i = 0; i < page_size; i++)
+        {
+            fputc('a', stream);
+        }
+        fflush(stream);
+        fancy_string_t *s = fancy_string_from_fd_mapped(fileno(stream), FANCY_STRING_MAP_ADVICE_WILLNEED);
+        fclose(stream);
+        assert(s != NULL);
+        assert(fancy_string_size(s) == (size_t)page_size);
+        fancy_string_t *pattern = fancy_string_create("a+$");
+        fancy_string_regex_t *re = fancy_string_regex_create(s, pattern, -1);
+        assert(re != NULL);
+        assert(fancy_string_regex_match_count(re) == 1);
+        assert(fancy_string_regex_match_info_for_index(re, 0).end == (size_t)page_size);
+        fancy_string_regex_destroy(re);
+        fancy_string_destroy(pattern);
+        fancy_string_destroy(s);
+    }
+    {
+        FILE *stream = tmpfile();
+        assert(stream != NULL);
+        fancy_string_t *s = fancy_string_from_fd_mapped(fileno(stream), FANCY_STRING_MAP_ADVICE_NORMAL);
+        assert(s != NULL);
+        assert(fancy_string_is_empty(s));
+        fancy_string_destroy(s);
+        fclose(stream);
+    }
+    {
+        fancy_string_t *should_be_null = fancy_string_from_fd_mapped(-1, FANCY_STRING_MAP_ADVICE_NORMAL);
+        assert(should_be_null == NULL);
+    }
+}
+
+void test_fancy_string_from_file_mapped(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_from_file_mapped("./test/assets/big-text-file.txt", FANCY_STRING_MAP_ADVICE_SEQUENTIAL);
+        assert(s != NULL);
+        assert(fancy_string_is_mapped(s));
+        assert(fancy_string_size(s) == 56788);
+        assert(fancy_string_starts_with_value(s, "Lorem ipsum dolor sit amet"));
+        assert(fancy_string_index_of_value(s, "ipsum") == 6);
+        {
+            fancy_string_array_t *a = fancy_string_split_by_value(s, " ", 3);
+            assert(fancy_string_array_size(a) == 4);
+            assert(fancy_string_array_includes_value(a, "dolor"));
+            fancy_string_array_destroy(a);
+        }
+        {
+            fancy_string_t *pattern = fancy_string_create("Lorem ipsum");
+            fancy_string_regex_t *re = fancy_string_regex_create(s, pattern, -1);
+            assert(re != NULL);
+            assert(fancy_string_regex_match_count(re) > 0);
+            fancy_string_regex_destroy(re);
+            fancy_string_destroy(pattern);
+        }
+        {
+            // NOTE: The first mutation makes a copy, which does not affect the clone.
+            fancy_string_t *clone = fancy_string_clone(s);
+            assert(fancy_string_is_mapped(clone));
+            fancy_string_append_value(s, "!");
+            assert(!fancy_string_is_mapped(s));
+            assert(fancy_string_size(s) == 56789);
+            assert(fancy_string_ends_with_value(s, "!"));
+            assert(fancy_string_size(clone) == 56788);
+            assert(!fancy_string_ends_with_value(clone, "!"));
+            fancy_string_destroy(clone);
+        }
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_from_file_mapped("./test/assets/hello-world.txt", FANCY_STRING_MAP_ADVICE_NORMAL);
+        assert(s != NULL);
+        fancy_string_t *clone = fancy_string_clone(s);
+        // NOTE: Nothing to trim, so nothing gets copied.
+        fancy_string_trim(s);
+        assert(fancy_string_is_mapped(s));
+        fancy_string_replace_value(s, "MONDE", "World", -1);
+        assert(!fancy_string_is_mapped(s));
+        assert(fancy_string_equals_value(s, "Hello, World!\nAllo, World!"));
+        assert(fancy_string_is_mapped(clone));
+        fancy_string_clear(clone);
+        assert(!fancy_string_is_mapped(clone));
+        assert(fancy_string_is_empty(clone));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *should_be_null = fancy_string_from_file_mapped("./test/assets/does-not-exist.txt", FANCY_STRING_MAP_ADVICE_NORMAL);
+        assert(should_be_null == NULL);
+        should_be_null = fancy_string_from_file_mapped("./test/assets", FANCY_STRING_MAP_ADVICE_NORMAL);
+        assert(should_be_null == NULL);
+    }
+}
+
+void test_fancy_string_from_stream_without_closing(void)
+{
+    LOG();
+    {
+        char *value = "This is a test";
+        FILE *stream = fmemopen(value, strlen(value), "r");
+        fancy_string_t *s = fancy_string_from_stream_without_closing(stream);
+        assert(fancy_string_equals_value(s, value));
+        fancy_string_destroy(s);
+        // NOTE: The stream is still open, so we can rewind it and read it again.
+        rewind(stream);
+        s = fancy_string_from_stream_without_closing(stream);
+        assert(fancy_string_equals_value(s, value));
+        fancy_string_destroy(s);
+        fclose(stream);
+    }
+    {
+        FILE *file_pointer = fopen("./test/assets/big-text-file.txt", "r");
+        assert(file_pointer != NULL);
+        assert(fseek(file_pointer, 0, SEEK_END) == 0);
+        long file_size = ftell(file_pointer);
+        assert(fseek(file_pointer, 6, SEEK_SET) == 0);
+        fancy_string_t *s = fancy_string_from_stream_without_closing(file_pointer);
+        assert(fancy_string_size(s) == (size_t)file_size - 6);
+        assert(fancy_string_starts_with_value(s, "ipsum dolor sit amet"));
+        fancy_string_destroy(s);
+        fclose(file_pointer);
+    }
+    {
+        fancy_string_t *s = fancy_string_from_stream_without_closing(NULL);
+        assert(fancy_string_is_empty(s));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_shrink_to_fit(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create_repeat("This will get cleared up!", 99);
+        fancy_string_clear(s);
+        assert(fancy_string_capacity(s) >= 2500);
+        fancy_string_shrink_to_fit(s);
+        assert(fancy_string_capacity(s) < 2500);
+        assert(fancy_string_is_empty(s));
+        fancy_string_append_value(s, "Hello");
+        assert(fancy_string_equals_value(s, "Hello"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: A string object created with a long value can grow past it, and shrink back.
+        fancy_string_t *s = fancy_string_create(
+            "0123456789012345678901234567890123456789012345678901234567890123456789"
+            "012345678901234567890123456789");
+        size_t initial_capacity = fancy_string_capacity(s);
+        assert(initial_capacity >= 100);
+        fancy_string_append_value(s, "0123456789");
+        fancy_string_append_value(s, "0123456789");
+        assert(fancy_string_size(s) == 120);
+        assert(fancy_string_capacity(s) > initial_capacity);
+        fancy_string_update_value(s, "0123456789");
+        fancy_string_shrink_to_fit(s);
+        assert(fancy_string_capacity(s) <= initial_capacity);
+        assert(fancy_string_equals_value(s, "0123456789"));
+        fancy_string_append_value(s, "!");
+        assert(fancy_string_equals_value(s, "0123456789!"));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_reserve(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("Hello");
+        fancy_string_reserve(s, 100);
+        size_t capacity = fancy_string_capacity(s);
+        assert(capacity >= 100);
+        assert(fancy_string_equals_value(s, "Hello"));
+        for (size_t i = 0; i < 19; i++)
+        {
+            fancy_string_append_value(s, "World");
+        }
+        assert(fancy_string_size(s) == 100);
+        assert(fancy_string_capacity(s) == capacity);
+        fancy_string_reserve(s, 10);
+        assert(fancy_string_capacity(s) == capacity);
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_create("abc");
+        fancy_string_append(s, s);
+        assert(fancy_string_equals_value(s, "abcabc"));
+        fancy_string_prepend(s, s);
+        assert(fancy_string_equals_value(s, "abcabcabcabc"));
+        fancy_string_update(s, s);
+        assert(fancy_string_equals_value(s, "abcabcabcabc"));
+        fancy_string_destroy(s);
+    }
+}
+
+void test_fancy_string_capacity(void)
+{
+    LOG();
+    {
+        fancy_string_t *s = fancy_string_create("Hello");
+        assert(fancy_string_capacity(s) >= fancy_string_size(s));
+        fancy_string_destroy(s);
+    }
+    {
+        fancy_string_t *s = fancy_string_create_empty();
+        size_t previous_capacity = fancy_string_capacity(s);
+        size_t n_growths = 0;
+        for (size_t i = 0; i < 10000; i++)
+        {
+            fancy_string_append_value(s, "ab");
+            assert(fancy_string_capacity(s) >= fancy_string_size(s));
+            if (fancy_string_capacity(s) != previous_capacity)
+            {
+                n_growths++;
+                previous_capacity = fancy_string_capacity(s);
+            }
+        }
+        assert(fancy_string_size(s) == 20000);
+        // NOTE: Geometric growth means a logarithmic number of re-allocations.
+        assert(n_growths < 20);
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Short values are stored inline, and move to (and back from) the heap as needed.
+        fancy_string_t *s = fancy_string_create("short");
+        fancy_string_t *clone = fancy_string_clone(s);
+        for (size_t i = 0; i < 10; i++)
+        {
+            fancy_string_append(s, clone);
+            assert(fancy_string_capacity(s) >= fancy_string_size(s));
+        }
+        assert(fancy_string_size(s) == 55);
+        assert(fancy_string_starts_with_value(s, "shortshortshort"));
+        fancy_string_update_value(s, "tiny");
+        fancy_string_shrink_to_fit(s);
+        assert(fancy_string_capacity(s) < 55);
+        assert(fancy_string_equals_value(s, "tiny"));
+        fancy_string_prepend_value(s, "a not so ");
+        assert(fancy_string_equals_value(s, "a not so tiny"));
+        fancy_string_prepend(s, s);
+        assert(fancy_string_equals_value(s, "a not so tinya not so tiny"));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(s);
+    }
+}
+
 void test_fancy_string_from_copied_memory(void)
 {
     LOG();
@@ -350,10 +3638,22 @@ void test_fancy_string_from_copied_memory(void)
         }
     }
     {
-        char tmp[6] = {'h', 'e', 'l', 'l', 'o', '\0'};
+        char tmp[8] = {'h', 'e', 'l', 'l', 'o', '\0', '!', '!'};
         {
-            fancy_string_t *s = fancy_string_from_copied_memory(tmp, 10);
-            assert(fancy_string_equals_value(s, "hello"));
+            // NOTE: Null characters are kept (i.e., the string object is binary-safe).
+            fancy_string_t *s = fancy_string_from_copied_memory(tmp, 8);
+            assert(fancy_string_size(s) == 8);
+            assert(fancy_string_starts_with_value(s, "hello"));
+            assert(!fancy_string_equals_value(s, "hello"));
+            assert(fancy_string_ends_with_value(s, "!!"));
+            fancy_string_t *other = fancy_string_from_copied_memory(tmp, 8);
+            assert(fancy_string_equals(s, other));
+            fancy_string_destroy(other);
+            fancy_string_destroy(s);
+        }
+        {
+            fancy_string_t *s = fancy_string_from_copied_memory(tmp, 0);
+            assert(fancy_string_is_empty(s));
             fancy_string_destroy(s);
         }
     }
@@ -714,6 +4014,15 @@ void test_fancy_string_regex_match_count(void)
         fancy_string_destroy(p);
         fancy_string_destroy(s);
     }
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("a1\0b2\0c3", 8);
+        fancy_string_t *pattern = fancy_string_create("[0-9]");
+        fancy_string_regex_t *r = fancy_string_regex_create(s, pattern, -1);
+        assert(fancy_string_regex_match_count(r) == 3);
+        fancy_string_regex_destroy(r);
+        fancy_string_destroy(pattern);
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_regex_has_match(void)
@@ -820,6 +4129,12 @@ void test_fancy_string_regex_string(void)
     fancy_string_regex_t *re = fancy_string_regex_create(s, p, -1);
     fancy_string_t *string = fancy_string_regex_string(re);
     assert(fancy_string_equals(string, s));
+    assert(fancy_string_is_shared(string));
+    // NOTE: The returned string object is independent from the regex object's copy.
+    fancy_string_append_value(string, "!");
+    fancy_string_t *string_again = fancy_string_regex_string(re);
+    assert(fancy_string_equals(string_again, s));
+    fancy_string_destroy(string_again);
     fancy_string_destroy(string);
     fancy_string_regex_destroy(re);
     fancy_string_destroy(p);
@@ -834,6 +4149,12 @@ void test_fancy_string_regex_pattern(void)
     fancy_string_regex_t *re = fancy_string_regex_create(s, p, -1);
     fancy_string_t *pattern = fancy_string_regex_pattern(re);
     assert(fancy_string_equals(pattern, p));
+    assert(fancy_string_is_shared(pattern));
+    // NOTE: The returned string object is independent from the regex object's copy.
+    fancy_string_append_value(pattern, "!");
+    fancy_string_t *pattern_again = fancy_string_regex_pattern(re);
+    assert(fancy_string_equals(pattern_again, p));
+    fancy_string_destroy(pattern_again);
     fancy_string_destroy(pattern);
     fancy_string_regex_destroy(re);
     fancy_string_destroy(p);
@@ -2361,6 +5682,17 @@ void test_fancy_string_array_push(void)
     fancy_string_destroy(s_joined);
     fancy_string_destroy(s);
     fancy_string_array_destroy(a);
+    {
+        fancy_string_array_t *a = fancy_string_array_create();
+        fancy_string_t *s = fancy_string_from_copied_memory("x\0y", 3);
+        fancy_string_array_push(a, s);
+        fancy_string_array_insert(a, s, 0);
+        assert(fancy_string_array_index_of(a, s) == 0);
+        assert(fancy_string_array_last_index_of(a, s) == 1);
+        assert(fancy_string_array_index_of_value(a, "x") == -1);
+        fancy_string_destroy(s);
+        fancy_string_array_destroy(a);
+    }
 }
 
 void test_fancy_string_array_push_values(void)
@@ -2617,10 +5949,31 @@ void test_fancy_string_uppercased(void)
 void test_fancy_string_uppercase(void)
 {
     LOG();
-    fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
-    fancy_string_uppercase(s);
-    assert(fancy_string_equals_value(s, "ONE TWO THREE FOUR FIVE"));
-    fancy_string_destroy(s);
+    {
+        fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
+        fancy_string_uppercase(s);
+        assert(fancy_string_equals_value(s, "ONE TWO THREE FOUR FIVE"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Only the ASCII letters are transformed, whatever the length and the alignment.
+        char value[300] = {0};
+        char expected[300] = {0};
+        for (size_t n = 0; n < sizeof(value); n += 7)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                value[i] = (char)(rand() % 256);
+                unsigned char c = (unsigned char)value[i];
+                expected[i] = (char)(c >= 'a' && c <= 'z' ? c - ('a' - 'A') : c);
+            }
+            fancy_string_t *s = fancy_string_from_view(fancy_string_view_from_memory(value, n));
+            fancy_string_uppercase(s);
+            assert(fancy_string_size(s) == n);
+            assert(memcmp(fancy_string_view(s).value, expected, n) == 0);
+            fancy_string_destroy(s);
+        }
+    }
 }
 
 void test_fancy_string_lowercased(void)
@@ -2637,10 +5990,45 @@ void test_fancy_string_lowercased(void)
 void test_fancy_string_lowercase(void)
 {
     LOG();
-    fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
-    fancy_string_lowercase(s);
-    assert(fancy_string_equals_value(s, "one two three four five"));
-    fancy_string_destroy(s);
+    {
+        fancy_string_t *s = fancy_string_create("One Two Three Four FIVE");
+        fancy_string_lowercase(s);
+        assert(fancy_string_equals_value(s, "one two three four five"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Only the ASCII letters are transformed, whatever the length and the alignment.
+        char value[300] = {0};
+        char expected[300] = {0};
+        for (size_t n = 0; n < sizeof(value); n += 7)
+        {
+            for (size_t i = 0; i < n; i++)
+            {
+                value[i] = (char)(rand() % 256);
+                unsigned char c = (unsigned char)value[i];
+                expected[i] = (char)(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+            }
+            fancy_string_t *s = fancy_string_from_view(fancy_string_view_from_memory(value, n));
+            fancy_string_lowercase(s);
+            assert(fancy_string_size(s) == n);
+            assert(memcmp(fancy_string_view(s).value, expected, n) == 0);
+            fancy_string_destroy(s);
+        }
+    }
+    {
+        // NOTE: A shared value is copied before being transformed.
+        fancy_string_t *s = fancy_string_create("KEY-ONE: A, KEY-TWO: THE SECOND VALUE IS A LONGER ONE");
+        fancy_string_array_t *a = fancy_string_split_arena(s, fancy_string_view_from_value(", "), -1);
+        fancy_string_t *element = fancy_string_array_get(a, 1);
+        fancy_string_lowercase(element);
+        assert(fancy_string_equals_value(element, "key-two: the second value is a longer one"));
+        char *value = fancy_string_array_get_value(a, 1);
+        assert(strcmp(value, "KEY-TWO: THE SECOND VALUE IS A LONGER ONE") == 0);
+        free(value);
+        fancy_string_destroy(element);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_replaced(void)
@@ -2704,6 +6092,21 @@ void test_fancy_string_replace(void)
         fancy_string_destroy(s_old);
         fancy_string_destroy(s);
     }
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("a\0b\0c", 5);
+        fancy_string_t *s_old = fancy_string_from_copied_memory("\0", 1);
+        fancy_string_t *s_new = fancy_string_from_copied_memory("\0\0", 2);
+        fancy_string_replace(s, s_old, s_new, -1);
+        assert(fancy_string_size(s) == 7);
+        fancy_string_t *expected = fancy_string_from_copied_memory("a\0\0b\0\0c", 7);
+        assert(fancy_string_equals(s, expected));
+        fancy_string_replace(s, s_new, s_old, 1);
+        assert(fancy_string_size(s) == 6);
+        fancy_string_destroy(expected);
+        fancy_string_destroy(s_new);
+        fancy_string_destroy(s_old);
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_replace_value(void)
@@ -2850,16 +6253,33 @@ void test_fancy_string_padded_end(void)
 void test_fancy_string_pad_end(void)
 {
     LOG();
-    fancy_string_t *s = fancy_string_create("11");
-    fancy_string_pad_end(s, 4, '0');
-    assert(fancy_string_equals_value(s, "1100"));
-    fancy_string_update_value(s, "11");
-    fancy_string_pad_end(s, 2, '0');
-    assert(fancy_string_equals_value(s, "11"));
-    fancy_string_clear(s);
-    fancy_string_pad_end(s, 2, '0');
-    assert(fancy_string_equals_value(s, "00"));
-    fancy_string_destroy(s);
+    {
+        fancy_string_t *s = fancy_string_create("11");
+        fancy_string_pad_end(s, 4, '0');
+        assert(fancy_string_equals_value(s, "1100"));
+        fancy_string_update_value(s, "11");
+        fancy_string_pad_end(s, 2, '0');
+        assert(fancy_string_equals_value(s, "11"));
+        fancy_string_clear(s);
+        fancy_string_pad_end(s, 2, '0');
+        assert(fancy_string_equals_value(s, "00"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Padding a shared value leaves the other string objects sharing it untouched.
+        fancy_string_t *s = fancy_string_create("1|2");
+        fancy_string_array_t *a = fancy_string_split_arena(s, fancy_string_view_from_value("|"), -1);
+        fancy_string_t *element = fancy_string_array_get(a, 0);
+        fancy_string_pad_end(element, 100, '0');
+        assert(fancy_string_size(element) == 100);
+        assert(fancy_string_starts_with_value(element, "1000"));
+        char *value = fancy_string_array_get_value(a, 0);
+        assert(strcmp(value, "1") == 0);
+        free(value);
+        fancy_string_destroy(element);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_padded_start(void)
@@ -2935,6 +6355,19 @@ void test_fancy_string_split(void)
         fancy_string_destroy(s);
         fancy_string_array_destroy(a);
     }
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("one\0two\0three", 13);
+        fancy_string_t *sep = fancy_string_from_copied_memory("\0", 1);
+        fancy_string_array_t *a = fancy_string_split(s, sep, -1);
+        assert(fancy_string_array_size(a) == 3);
+        assert(fancy_string_array_index_of_value(a, "two") == 1);
+        fancy_string_t *joined = fancy_string_array_join(a, sep);
+        assert(fancy_string_equals(joined, s));
+        fancy_string_destroy(joined);
+        fancy_string_destroy(sep);
+        fancy_string_destroy(s);
+        fancy_string_array_destroy(a);
+    }
 }
 
 void test_fancy_string_split_by_value(void)
@@ -3088,18 +6521,34 @@ void test_fancy_string_trimmed(void)
 void test_fancy_string_trim(void)
 {
     LOG();
-    fancy_string_t *s = fancy_string_create(" \n\t\v\f\r hey\n\t\v\f\r ");
-    fancy_string_trim(s);
-    assert(fancy_string_equals_value(s, "hey"));
-    fancy_string_trim(s);
-    assert(fancy_string_equals_value(s, "hey"));
-    fancy_string_clear(s);
-    fancy_string_trim(s);
-    assert(fancy_string_equals_value(s, ""));
-    fancy_string_update_value(s, ". this is a test .");
-    fancy_string_trim(s);
-    assert(fancy_string_equals_value(s, ". this is a test ."));
-    fancy_string_destroy(s);
+    {
+        fancy_string_t *s = fancy_string_create(" \n\t\v\f\r hey\n\t\v\f\r ");
+        fancy_string_trim(s);
+        assert(fancy_string_equals_value(s, "hey"));
+        fancy_string_trim(s);
+        assert(fancy_string_equals_value(s, "hey"));
+        fancy_string_clear(s);
+        fancy_string_trim(s);
+        assert(fancy_string_equals_value(s, ""));
+        fancy_string_update_value(s, ". this is a test .");
+        fancy_string_trim(s);
+        assert(fancy_string_equals_value(s, ". this is a test ."));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: Trimming a shared value leaves the other string objects sharing it untouched.
+        fancy_string_t *s = fancy_string_create("  one  |  two  ");
+        fancy_string_array_t *a = fancy_string_split_arena(s, fancy_string_view_from_value("|"), -1);
+        fancy_string_t *element = fancy_string_array_get(a, 0);
+        fancy_string_trim(element);
+        assert(fancy_string_equals_value(element, "one"));
+        char *value = fancy_string_array_get_value(a, 0);
+        assert(strcmp(value, "  one  ") == 0);
+        free(value);
+        fancy_string_destroy(element);
+        fancy_string_array_destroy(a);
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_trimmed_right(void)
@@ -3298,6 +6747,15 @@ void test_fancy_string_index_of(void)
     assert(fancy_string_index_of(haystack, needle) == 0);
     fancy_string_destroy(needle);
     fancy_string_destroy(haystack);
+    {
+        fancy_string_t *binary_haystack = fancy_string_from_copied_memory("a\0b\0c", 5);
+        fancy_string_t *binary_needle = fancy_string_from_copied_memory("\0c", 2);
+        assert(fancy_string_index_of(binary_haystack, binary_needle) == 3);
+        assert(fancy_string_index_of_value(binary_haystack, "c") == 4);
+        assert(fancy_string_contains(binary_haystack, binary_needle));
+        fancy_string_destroy(binary_needle);
+        fancy_string_destroy(binary_haystack);
+    }
 }
 
 void test_fancy_string_index_of_value(void)
@@ -3398,6 +6856,18 @@ void test_fancy_string_equals(void)
     assert(fancy_string_equals(s_1, s_2));
     fancy_string_destroy(s_2);
     fancy_string_destroy(s_1);
+    {
+        fancy_string_t *s_3 = fancy_string_from_copied_memory("ab\0cd", 5);
+        fancy_string_t *s_4 = fancy_string_from_copied_memory("ab\0ce", 5);
+        fancy_string_t *s_5 = fancy_string_create("ab");
+        assert(!fancy_string_equals(s_3, s_4));
+        assert(!fancy_string_equals(s_3, s_5));
+        fancy_string_update(s_4, s_3);
+        assert(fancy_string_equals(s_3, s_4));
+        fancy_string_destroy(s_5);
+        fancy_string_destroy(s_4);
+        fancy_string_destroy(s_3);
+    }
 }
 
 void test_fancy_string_equals_value(void)
@@ -3456,6 +6926,21 @@ void test_fancy_string_append(void)
         fancy_string_destroy(s_2);
     }
     fancy_string_destroy(s);
+    {
+        fancy_string_t *s = fancy_string_from_copied_memory("a\0", 2);
+        fancy_string_t *other = fancy_string_from_copied_memory("\0b", 2);
+        fancy_string_append(s, other);
+        fancy_string_prepend(s, other);
+        assert(fancy_string_size(s) == 6);
+        fancy_string_t *expected = fancy_string_from_copied_memory("\0ba\0\0b", 6);
+        assert(fancy_string_equals(s, expected));
+        fancy_string_t *clone = fancy_string_clone(s);
+        assert(fancy_string_equals(clone, expected));
+        fancy_string_destroy(clone);
+        fancy_string_destroy(expected);
+        fancy_string_destroy(other);
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_append_value(void)
@@ -3624,6 +7109,18 @@ void test_fancy_string_print(void)
     //     fclose(fp);
     //     // exit(0);
     // }
+    {
+        char *buffer;
+        size_t buffer_size;
+        FILE *fake_stdout = open_memstream(&buffer, &buffer_size);
+        fancy_string_t *s = fancy_string_from_copied_memory("a\0b", 3);
+        fancy_string_print(s, fake_stdout, false);
+        fclose(fake_stdout);
+        assert(buffer_size == 3);
+        assert(memcmp(buffer, "a\0b", 3) == 0);
+        fancy_string_destroy(s);
+        free(buffer);
+    }
 }
 
 void test_fancy_string_destroy(void)
@@ -3666,6 +7163,24 @@ void test_fancy_string_create_repeat(void)
         assert(fancy_string_equals_value(s, "abc"));
         fancy_string_destroy(s);
     }
+    {
+        // NOTE: The value is followed by `n_repeat` copies of itself, whatever that number.
+        for (size_t n_repeat = 0; n_repeat < 100; n_repeat++)
+        {
+            fancy_string_t *s = fancy_string_create_repeat("xyz", n_repeat);
+            assert(fancy_string_size(s) == 3 * (n_repeat + 1));
+            for (size_t i = 0; i < fancy_string_size(s); i++)
+            {
+                assert(fancy_string_view(s).value[i] == "xyz"[i % 3]);
+            }
+            fancy_string_destroy(s);
+        }
+    }
+    {
+        fancy_string_t *s = fancy_string_create_repeat("", 1000);
+        assert(fancy_string_is_empty(s));
+        fancy_string_destroy(s);
+    }
 }
 
 void test_fancy_string_from_stream(void)
@@ -3684,6 +7199,30 @@ void test_fancy_string_from_stream(void)
         assert(fancy_string_equals_value(s, value));
         fancy_string_destroy(s);
     }
+    {
+        // NOTE: This file is larger than the internal read block size.
+        FILE *file_pointer = fopen("./test/assets/big-text-file.txt", "r");
+        assert(file_pointer != NULL);
+        fancy_string_t *s = fancy_string_from_stream(file_pointer);
+        assert(fancy_string_size(s) == 56788);
+        assert(fancy_string_starts_with_value(s, "Lorem ipsum dolor sit amet"));
+        fancy_string_destroy(s);
+    }
+    {
+        // NOTE: A stream whose size cannot be known in advance and that spans several read blocks.
+        size_t n = 200000;
+        char *value = malloc(sizeof(char) * n);
+        for (size_t i = 0; i < n; i++)
+        {
+            value[i] = 'a' + (i % 26);
+        }
+        FILE *stream = fmemopen(value, n, "r");
+        fancy_string_t *s = fancy_string_from_stream(stream);
+        assert(fancy_string_size(s) == n);
+        assert(fancy_string_ends_with_value(s, "zabcdefgh"));
+        fancy_string_destroy(s);
+        free(value);
+    }
 }
 
 void test_fancy_string_from_stream_next_line(void)